@@ -28,6 +28,7 @@ import android.os.Bundle;
 import android.provider.Settings;
 import androidx.appcompat.app.AppCompatActivity;
 import android.util.Log;
+import android.view.Choreographer;
 import android.view.MenuInflater;
 import android.view.MenuItem;
 import android.view.MotionEvent;
@@ -64,6 +65,16 @@ public class VrActivity extends AppCompatActivity implements PopupMenu.OnMenuIte
 
   private GLSurfaceView glView;
 
+  // Feeds the display vsync timestamps to the native head tracker pose prediction.
+  private final Choreographer.FrameCallback vsyncCallback =
+      new Choreographer.FrameCallback() {
+        @Override
+        public void doFrame(long frameTimeNanos) {
+          nativeOnVsync(nativeApp, frameTimeNanos);
+          Choreographer.getInstance().postFrameCallback(this);
+        }
+      };
+
   @SuppressLint("ClickableViewAccessibility")
   @Override
   public void onCreate(Bundle savedInstance) {
@@ -113,6 +124,7 @@ public class VrActivity extends AppCompatActivity implements PopupMenu.OnMenuIte
   @Override
   protected void onPause() {
     super.onPause();
+    Choreographer.getInstance().removeFrameCallback(vsyncCallback);
     nativeOnPause(nativeApp);
     glView.onPause();
   }
@@ -132,6 +144,7 @@ public class VrActivity extends AppCompatActivity implements PopupMenu.OnMenuIte
 
     glView.onResume();
     nativeOnResume(nativeApp);
+    Choreographer.getInstance().postFrameCallback(vsyncCallback);
   }
 
   @Override
@@ -261,6 +274,8 @@ public class VrActivity extends AppCompatActivity implements PopupMenu.OnMenuIte
 
   private native void nativeOnResume(long nativeApp);
 
+  private native void nativeOnVsync(long nativeApp, long frameTimeNanos);
+
   private native void nativeSetScreenParams(long nativeApp, int width, int height);
 
   private native void nativeSwitchViewer(long nativeApp);
@@ -40,8 +40,6 @@ constexpr float kMaxTargetHeight = kMinTargetHeight + 3.0f;
 
 constexpr float kDefaultFloorHeight = -1.7f;
 
-constexpr uint64_t kPredictionTimeWithoutVsyncNanos = 50000000;
-
 // Angle threshold for determining whether the controller is pointing at the
 // object.
 constexpr float kAngleLimit = 0.2f;
@@ -241,6 +239,11 @@ void HelloCardboardApp::OnResume() {
   CardboardQrCode_destroy(buffer);
 }
 
+void HelloCardboardApp::OnVsync(int64_t frame_time_nanos) {
+  CardboardHeadTracker_addVsyncTimestamp(
+      head_tracker_, MonotonicToBootTimeNano(frame_time_nanos));
+}
+
 void HelloCardboardApp::SwitchViewer() {
   CardboardQrCode_scanQrCodeAndSaveDeviceParams();
 }
@@ -273,16 +276,17 @@ bool HelloCardboardApp::UpdateDeviceParams() {
   const CardboardOpenGlEsDistortionRendererConfig config{kGlTexture2D};
   distortion_renderer_ = CardboardOpenGlEs2DistortionRenderer_create(&config);
 
-  CardboardMesh left_mesh;
-  CardboardMesh right_mesh;
-  CardboardLensDistortion_getDistortionMesh(lens_distortion_, kLeft,
-                                            &left_mesh);
-  CardboardLensDistortion_getDistortionMesh(lens_distortion_, kRight,
-                                            &right_mesh);
+  CardboardChromaticMesh left_mesh;
+  CardboardChromaticMesh right_mesh;
+  CardboardLensDistortion_getChromaticDistortionMesh(lens_distortion_, kLeft,
+                                                     &left_mesh);
+  CardboardLensDistortion_getChromaticDistortionMesh(lens_distortion_, kRight,
+                                                     &right_mesh);
 
-  CardboardDistortionRenderer_setMesh(distortion_renderer_, &left_mesh, kLeft);
-  CardboardDistortionRenderer_setMesh(distortion_renderer_, &right_mesh,
-                                      kRight);
+  CardboardDistortionRenderer_setChromaticMesh(distortion_renderer_,
+                                               &left_mesh, kLeft);
+  CardboardDistortionRenderer_setChromaticMesh(distortion_renderer_,
+                                               &right_mesh, kRight);
 
   // Get eye matrices
   CardboardLensDistortion_getEyeFromHeadMatrix(lens_distortion_, kLeft,
@@ -368,7 +372,8 @@ Matrix4x4 HelloCardboardApp::GetPose() {
   std::array<float, 4> out_orientation;
   std::array<float, 3> out_position;
   CardboardHeadTracker_getPose(
-      head_tracker_, GetBootTimeNano() + kPredictionTimeWithoutVsyncNanos,
+      head_tracker_,
+      CardboardHeadTracker_getPredictedDisplayTime(head_tracker_),
       kLandscapeLeft, &out_position[0], &out_orientation[0]);
   return GetTranslationMatrix(out_position) *
          Quatf::FromXYZW(&out_orientation[0]).ToMatrix();
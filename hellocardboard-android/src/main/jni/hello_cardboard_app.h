@@ -84,6 +84,14 @@ class HelloCardboardApp {
    */
   void OnResume();
 
+  /**
+   * Feeds a display vsync timestamp to the head tracker pose prediction.
+   *
+   * @param frame_time_nanos Vsync timestamp reported by Choreographer, in
+   *        CLOCK_MONOTONIC nanoseconds.
+   */
+  void OnVsync(int64_t frame_time_nanos);
+
   /**
    * Allows user to switch viewer.
    */
@@ -81,6 +81,11 @@ JNI_METHOD(void, nativeOnResume)
   native(native_app)->OnResume();
 }
 
+JNI_METHOD(void, nativeOnVsync)
+(JNIEnv* /*env*/, jobject /*obj*/, jlong native_app, jlong frame_time_nanos) {
+  native(native_app)->OnVsync(frame_time_nanos);
+}
+
 JNI_METHOD(void, nativeSetScreenParams)
 (JNIEnv* /*env*/, jobject /*obj*/, jlong native_app, jint width, jint height) {
   native(native_app)->SetScreenParams(width, height);
@@ -434,6 +434,13 @@ int64_t GetBootTimeNano() {
   return (res.tv_sec * kNanosInSeconds) + res.tv_nsec;
 }
 
+int64_t MonotonicToBootTimeNano(int64_t monotonic_time_nanos) {
+  struct timespec res;
+  clock_gettime(CLOCK_MONOTONIC, &res);
+  const int64_t monotonic_now = (res.tv_sec * kNanosInSeconds) + res.tv_nsec;
+  return monotonic_time_nanos + (GetBootTimeNano() - monotonic_now);
+}
+
 float RandomUniformFloat(float min, float max) {
   static std::random_device random_device;
   static std::mt19937 random_generator(random_device());
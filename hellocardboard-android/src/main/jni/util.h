@@ -99,6 +99,15 @@ float AngleBetweenVectors(const std::array<float, 4>& vec1,
  */
 int64_t GetBootTimeNano();
 
+/**
+ * Converts a CLOCK_MONOTONIC timestamp, like the ones reported by
+ * Choreographer, into system boot time.
+ *
+ * @param monotonic_time_nanos Timestamp in CLOCK_MONOTONIC nanoseconds.
+ * @return Timestamp in system boot time nanoseconds.
+ */
+int64_t MonotonicToBootTimeNano(int64_t monotonic_time_nanos);
+
 /**
  * Generates a random floating point number between |min| and |max|.
  *
@@ -39,8 +39,6 @@ static constexpr float kMaxTargetHeight = kMinTargetHeight + 3.0f;
 
 static constexpr float kDefaultFloorHeight = -1.7f;
 
-static constexpr uint64_t kPredictionTimeWithoutVsyncNanos = 50000000;
-
 /**
  * Default near clip plane z-axis coordinate.
  */
@@ -178,15 +176,15 @@ void HelloCardboardRenderer::InitializeGl() {
   CardboardLensDistortion_getProjectionMatrix(_lensDistortion, kRight, kZNear, kZFar,
                                               _projMatrices[kRight]);
 
-  CardboardMesh leftMesh;
-  CardboardMesh rightMesh;
-  CardboardLensDistortion_getDistortionMesh(_lensDistortion, kLeft, &leftMesh);
-  CardboardLensDistortion_getDistortionMesh(_lensDistortion, kRight, &rightMesh);
+  CardboardChromaticMesh leftMesh;
+  CardboardChromaticMesh rightMesh;
+  CardboardLensDistortion_getChromaticDistortionMesh(_lensDistortion, kLeft, &leftMesh);
+  CardboardLensDistortion_getChromaticDistortionMesh(_lensDistortion, kRight, &rightMesh);
 
   const CardboardOpenGlEsDistortionRendererConfig config{kGlTexture2D};
   _distortionRenderer = CardboardOpenGlEs2DistortionRenderer_create(&config);
-  CardboardDistortionRenderer_setMesh(_distortionRenderer, &leftMesh, kLeft);
-  CardboardDistortionRenderer_setMesh(_distortionRenderer, &rightMesh, kRight);
+  CardboardDistortionRenderer_setChromaticMesh(_distortionRenderer, &leftMesh, kLeft);
+  CardboardDistortionRenderer_setChromaticMesh(_distortionRenderer, &rightMesh, kRight);
   CheckGLError("Cardboard distortion renderer set up");
 }
 
@@ -241,8 +239,8 @@ GLKMatrix4 HelloCardboardRenderer::GetPose() {
   float outPosition[3];
   float outOrientation[4];
   CardboardHeadTracker_getPose(
-      _headTracker, clock_gettime_nsec_np(CLOCK_UPTIME_RAW) + kPredictionTimeWithoutVsyncNanos,
-      kLandscapeLeft, outPosition, outOrientation);
+      _headTracker, CardboardHeadTracker_getPredictedDisplayTime(_headTracker), kLandscapeLeft,
+      outPosition, outOrientation);
   return GLKMatrix4Multiply(
       GLKMatrix4MakeTranslation(outPosition[0], outPosition[1], outPosition[2]),
       GLKMatrix4MakeWithQuaternion(GLKQuaternionMakeWithArray(outOrientation)));
@@ -16,6 +16,8 @@
 
 #import "HelloCardboardViewController.h"
 
+#import <QuartzCore/QuartzCore.h>
+
 #import "HelloCardboardOverlayView.h"
 #import "HelloCardboardRenderer.h"
 #import "cardboard.h"
@@ -25,6 +27,9 @@
   CardboardHeadTracker *_cardboardHeadTracker;
   std::unique_ptr<cardboard::hello_cardboard::HelloCardboardRenderer> _renderer;
 
+  // Feeds the display vsync timestamps to the head tracker pose prediction.
+  CADisplayLink *_vsyncDisplayLink;
+
   // This counter keeps track of the successful device parameters save operations count.
   int _deviceParamsChangedCount;
 }
@@ -156,6 +161,8 @@
 
 - (void)pauseCardboard {
   self.paused = true;
+  [_vsyncDisplayLink invalidate];
+  _vsyncDisplayLink = nil;
   CardboardHeadTracker_pause(_cardboardHeadTracker);
 }
 
@@ -172,6 +179,16 @@
 
   CardboardHeadTracker_resume(_cardboardHeadTracker);
   self.paused = false;
+
+  [_vsyncDisplayLink invalidate];
+  _vsyncDisplayLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(onVsync:)];
+  [_vsyncDisplayLink addToRunLoop:NSRunLoop.mainRunLoop forMode:NSRunLoopCommonModes];
+}
+
+- (void)onVsync:(CADisplayLink *)displayLink {
+  // CADisplayLink timestamps are in the same clock as CLOCK_UPTIME_RAW.
+  CardboardHeadTracker_addVsyncTimestamp(_cardboardHeadTracker,
+                                         (int64_t)(displayLink.timestamp * NSEC_PER_SEC));
 }
 
 - (void)switchViewer {
@@ -18,6 +18,7 @@ constexpr DeviceParams::DeviceParams(
   ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
   : left_eye_field_of_view_angles_()
   , distortion_coefficients_()
+  , chromatic_aberration_scales_()
   , vendor_(&::PROTOBUF_NAMESPACE_ID::internal::fixed_address_empty_string)
   , model_(&::PROTOBUF_NAMESPACE_ID::internal::fixed_address_empty_string)
   , screen_to_lens_distance_(0)
@@ -202,7 +203,8 @@ DeviceParams::DeviceParams(::PROTOBUF_NAMESPACE_ID::Arena* arena,
                          bool is_message_owned)
   : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned),
   left_eye_field_of_view_angles_(arena),
-  distortion_coefficients_(arena) {
+  distortion_coefficients_(arena),
+  chromatic_aberration_scales_(arena) {
   SharedCtor();
   if (!is_message_owned) {
     RegisterArenaDtor(arena);
@@ -213,7 +215,8 @@ DeviceParams::DeviceParams(const DeviceParams& from)
   : ::PROTOBUF_NAMESPACE_ID::MessageLite(),
       _has_bits_(from._has_bits_),
       left_eye_field_of_view_angles_(from.left_eye_field_of_view_angles_),
-      distortion_coefficients_(from.distortion_coefficients_) {
+      distortion_coefficients_(from.distortion_coefficients_),
+      chromatic_aberration_scales_(from.chromatic_aberration_scales_) {
   _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
   vendor_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
   if (from._internal_has_vendor()) {
@@ -272,6 +275,7 @@ void DeviceParams::Clear() {
 
   left_eye_field_of_view_angles_.Clear();
   distortion_coefficients_.Clear();
+  chromatic_aberration_scales_.Clear();
   cached_has_bits = _has_bits_[0];
   if (cached_has_bits & 0x00000003u) {
     if (cached_has_bits & 0x00000001u) {
@@ -391,6 +395,17 @@ const char* DeviceParams::_InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_I
         } else
           goto handle_unusual;
         continue;
+      // repeated float chromatic_aberration_scales = 13 [packed = true];
+      case 13:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 106)) {
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::PackedFloatParser(_internal_mutable_chromatic_aberration_scales(), ptr, ctx);
+          CHK_(ptr);
+        } else if (static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 109) {
+          _internal_add_chromatic_aberration_scales(::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<float>(ptr));
+          ptr += sizeof(float);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -476,6 +491,11 @@ failure:
       12, this->_internal_primary_button(), target);
   }
 
+  // repeated float chromatic_aberration_scales = 13 [packed = true];
+  if (this->_internal_chromatic_aberration_scales_size() > 0) {
+    target = stream->WriteFixedPacked(13, _internal_chromatic_aberration_scales(), target);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
         static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
@@ -516,6 +536,18 @@ size_t DeviceParams::ByteSizeLong() const {
     total_size += data_size;
   }
 
+  // repeated float chromatic_aberration_scales = 13 [packed = true];
+  {
+    unsigned int count = static_cast<unsigned int>(this->_internal_chromatic_aberration_scales_size());
+    size_t data_size = 4UL * count;
+    if (data_size > 0) {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int32Size(
+            static_cast<::PROTOBUF_NAMESPACE_ID::int32>(data_size));
+    }
+    total_size += data_size;
+  }
+
   cached_has_bits = _has_bits_[0];
   if (cached_has_bits & 0x0000007fu) {
     // optional string vendor = 1;
@@ -582,6 +614,7 @@ void DeviceParams::MergeFrom(const DeviceParams& from) {
 
   left_eye_field_of_view_angles_.MergeFrom(from.left_eye_field_of_view_angles_);
   distortion_coefficients_.MergeFrom(from.distortion_coefficients_);
+  chromatic_aberration_scales_.MergeFrom(from.chromatic_aberration_scales_);
   cached_has_bits = from._has_bits_[0];
   if (cached_has_bits & 0x0000007fu) {
     if (cached_has_bits & 0x00000001u) {
@@ -629,6 +662,7 @@ void DeviceParams::InternalSwap(DeviceParams* other) {
   swap(_has_bits_[0], other->_has_bits_[0]);
   left_eye_field_of_view_angles_.InternalSwap(&other->left_eye_field_of_view_angles_);
   distortion_coefficients_.InternalSwap(&other->distortion_coefficients_);
+  chromatic_aberration_scales_.InternalSwap(&other->chromatic_aberration_scales_);
   ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
       &::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(),
       &vendor_, lhs_arena,
@@ -275,6 +275,7 @@ class DeviceParams final :
   enum : int {
     kLeftEyeFieldOfViewAnglesFieldNumber = 5,
     kDistortionCoefficientsFieldNumber = 7,
+    kChromaticAberrationScalesFieldNumber = 13,
     kVendorFieldNumber = 1,
     kModelFieldNumber = 2,
     kScreenToLensDistanceFieldNumber = 3,
@@ -327,6 +328,28 @@ class DeviceParams final :
   ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >*
       mutable_distortion_coefficients();
 
+  // repeated float chromatic_aberration_scales = 13 [packed = true];
+  int chromatic_aberration_scales_size() const;
+  private:
+  int _internal_chromatic_aberration_scales_size() const;
+  public:
+  void clear_chromatic_aberration_scales();
+  private:
+  float _internal_chromatic_aberration_scales(int index) const;
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >&
+      _internal_chromatic_aberration_scales() const;
+  void _internal_add_chromatic_aberration_scales(float value);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >*
+      _internal_mutable_chromatic_aberration_scales();
+  public:
+  float chromatic_aberration_scales(int index) const;
+  void set_chromatic_aberration_scales(int index, float value);
+  void add_chromatic_aberration_scales(float value);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >&
+      chromatic_aberration_scales() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >*
+      mutable_chromatic_aberration_scales();
+
   // optional string vendor = 1;
   bool has_vendor() const;
   private:
@@ -439,6 +462,7 @@ class DeviceParams final :
   mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
   ::PROTOBUF_NAMESPACE_ID::RepeatedField< float > left_eye_field_of_view_angles_;
   ::PROTOBUF_NAMESPACE_ID::RepeatedField< float > distortion_coefficients_;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< float > chromatic_aberration_scales_;
   ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr vendor_;
   ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr model_;
   float screen_to_lens_distance_;
@@ -811,6 +835,53 @@ inline void DeviceParams::set_primary_button(::cardboard::DeviceParams_ButtonTyp
   // @@protoc_insertion_point(field_set:cardboard.DeviceParams.primary_button)
 }
 
+// repeated float chromatic_aberration_scales = 13 [packed = true];
+inline int DeviceParams::_internal_chromatic_aberration_scales_size() const {
+  return chromatic_aberration_scales_.size();
+}
+inline int DeviceParams::chromatic_aberration_scales_size() const {
+  return _internal_chromatic_aberration_scales_size();
+}
+inline void DeviceParams::clear_chromatic_aberration_scales() {
+  chromatic_aberration_scales_.Clear();
+}
+inline float DeviceParams::_internal_chromatic_aberration_scales(int index) const {
+  return chromatic_aberration_scales_.Get(index);
+}
+inline float DeviceParams::chromatic_aberration_scales(int index) const {
+  // @@protoc_insertion_point(field_get:cardboard.DeviceParams.chromatic_aberration_scales)
+  return _internal_chromatic_aberration_scales(index);
+}
+inline void DeviceParams::set_chromatic_aberration_scales(int index, float value) {
+  chromatic_aberration_scales_.Set(index, value);
+  // @@protoc_insertion_point(field_set:cardboard.DeviceParams.chromatic_aberration_scales)
+}
+inline void DeviceParams::_internal_add_chromatic_aberration_scales(float value) {
+  chromatic_aberration_scales_.Add(value);
+}
+inline void DeviceParams::add_chromatic_aberration_scales(float value) {
+  _internal_add_chromatic_aberration_scales(value);
+  // @@protoc_insertion_point(field_add:cardboard.DeviceParams.chromatic_aberration_scales)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >&
+DeviceParams::_internal_chromatic_aberration_scales() const {
+  return chromatic_aberration_scales_;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >&
+DeviceParams::chromatic_aberration_scales() const {
+  // @@protoc_insertion_point(field_list:cardboard.DeviceParams.chromatic_aberration_scales)
+  return _internal_chromatic_aberration_scales();
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >*
+DeviceParams::_internal_mutable_chromatic_aberration_scales() {
+  return &chromatic_aberration_scales_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< float >*
+DeviceParams::mutable_chromatic_aberration_scales() {
+  // @@protoc_insertion_point(field_mutable_list:cardboard.DeviceParams.chromatic_aberration_scales)
+  return _internal_mutable_chromatic_aberration_scales();
+}
+
 #ifdef __GNUC__
   #pragma GCC diagnostic pop
 #endif  // __GNUC__
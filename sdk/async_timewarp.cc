@@ -0,0 +1,150 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "async_timewarp.h"
+
+#include <chrono>  // NOLINT
+
+#if defined(__ANDROID__)
+#include <sys/resource.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#endif
+
+#include "util/clock.h"
+#include "util/logging.h"
+
+namespace cardboard {
+
+namespace {
+
+#if defined(__ANDROID__)
+// Same value as ANDROID_PRIORITY_URGENT_DISPLAY, used by the system compositor.
+constexpr int kUrgentDisplayPriority = -8;
+#endif
+
+// Time to wait before retrying when the application skips a distortion pass.
+constexpr std::chrono::milliseconds kSkippedFrameWaitTime(2);
+
+// Raises the priority of the calling thread so it is scheduled ahead of the
+// application render thread.
+void RaiseCurrentThreadPriority() {
+#if defined(__ANDROID__)
+  if (setpriority(PRIO_PROCESS, gettid(), kUrgentDisplayPriority) != 0) {
+    CARDBOARD_LOGE("Failed to raise the timewarp thread priority.");
+  }
+#elif defined(__APPLE__)
+  if (pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0) != 0) {
+    CARDBOARD_LOGE("Failed to raise the timewarp thread priority.");
+  }
+#endif
+}
+
+}  // namespace
+
+AsyncTimewarp::AsyncTimewarp(HeadTracker* head_tracker,
+                             LensDistortion* lens_distortion,
+                             DistortionRenderer* renderer,
+                             const CardboardAsyncTimewarpConfig& config)
+    : head_tracker_(head_tracker),
+      lens_distortion_(lens_distortion),
+      renderer_(renderer),
+      config_(config),
+      has_frame_(false),
+      is_running_(true) {
+  thread_ = std::thread(&AsyncTimewarp::Run, this);
+}
+
+AsyncTimewarp::~AsyncTimewarp() {
+  {
+    std::lock_guard<std::mutex> lock(frame_mutex_);
+    is_running_ = false;
+  }
+  frame_condition_.notify_one();
+  thread_.join();
+}
+
+void AsyncTimewarp::SubmitFrame(
+    const CardboardEyeTextureDescription& left_eye,
+    const CardboardEyeTextureDescription& right_eye,
+    const std::array<float, 4>& render_orientation) {
+  {
+    std::lock_guard<std::mutex> lock(frame_mutex_);
+    frame_ = {left_eye, right_eye, render_orientation};
+    has_frame_ = true;
+  }
+  frame_condition_.notify_one();
+}
+
+void AsyncTimewarp::Run() {
+  RaiseCurrentThreadPriority();
+  if (config_.on_thread_start != nullptr) {
+    config_.on_thread_start(config_.user_data);
+  }
+
+  while (true) {
+    Frame frame;
+    {
+      // Nothing can be displayed until the first frame arrives.
+      std::unique_lock<std::mutex> lock(frame_mutex_);
+      frame_condition_.wait(lock,
+                            [this] { return has_frame_ || !is_running_; });
+      if (!is_running_) {
+        break;
+      }
+    }
+
+    uint64_t target = 0;
+    if (!config_.begin_frame(config_.user_data, &target)) {
+      std::this_thread::sleep_for(kSkippedFrameWaitTime);
+      continue;
+    }
+
+    // The frame is sampled as late as possible so a frame submitted while
+    // waiting in begin_frame() is not one refresh behind.
+    {
+      std::lock_guard<std::mutex> lock(frame_mutex_);
+      frame = frame_;
+    }
+    RenderFrame(frame, target);
+    config_.end_frame(config_.user_data);
+  }
+
+  if (config_.on_thread_stop != nullptr) {
+    config_.on_thread_stop(config_.user_data);
+  }
+}
+
+void AsyncTimewarp::RenderFrame(const Frame& frame, uint64_t target) {
+  std::array<float, 3> display_position;
+  std::array<float, 4> display_orientation;
+  // The viewport orientation is owned by the application, which renders the
+  // eye textures with it, so it is never changed from this thread.
+  head_tracker_->GetPose(GetBootTimeNano() + config_.prediction_time_ns,
+                         display_position, display_orientation);
+
+  for (CardboardEye eye : {kLeft, kRight}) {
+    renderer_->SetReprojection(
+        lens_distortion_->GetRotationalReprojection(
+            eye, frame.render_orientation, display_orientation),
+        eye);
+  }
+  renderer_->RenderEyeToDisplay(target, config_.x, config_.y, config_.width,
+                                config_.height, &frame.left_eye,
+                                &frame.right_eye);
+}
+
+}  // namespace cardboard
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_ASYNC_TIMEWARP_H_
+#define CARDBOARD_SDK_ASYNC_TIMEWARP_H_
+
+#include <array>
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+
+#include "distortion_renderer.h"
+#include "head_tracker.h"
+#include "include/cardboard.h"
+#include "lens_distortion.h"
+
+namespace cardboard {
+
+// @brief Runs the distortion pass on a dedicated thread. Every iteration it
+//        takes the most recently submitted eye textures and rotationally
+//        reprojects them to the latest head tracker pose. The application
+//        owns the display surface and the graphics context, and binds them to
+//        the thread through the callbacks in the configuration.
+class AsyncTimewarp {
+ public:
+  // Starts the timewarp thread. @p head_tracker, @p lens_distortion and
+  // @p renderer must outlive this object.
+  AsyncTimewarp(HeadTracker* head_tracker, LensDistortion* lens_distortion,
+                DistortionRenderer* renderer,
+                const CardboardAsyncTimewarpConfig& config);
+
+  // Stops and joins the timewarp thread.
+  ~AsyncTimewarp();
+
+  // Publishes a new pair of completed eye textures, rendered with
+  // @p render_orientation. It replaces any frame that has not been displayed
+  // yet.
+  void SubmitFrame(const CardboardEyeTextureDescription& left_eye,
+                   const CardboardEyeTextureDescription& right_eye,
+                   const std::array<float, 4>& render_orientation);
+
+ private:
+  struct Frame {
+    CardboardEyeTextureDescription left_eye;
+    CardboardEyeTextureDescription right_eye;
+    std::array<float, 4> render_orientation;
+  };
+
+  // Timewarp thread entry point.
+  void Run();
+
+  // Reprojects and renders @p frame to @p target.
+  void RenderFrame(const Frame& frame, uint64_t target);
+
+  HeadTracker* head_tracker_;
+  LensDistortion* lens_distortion_;
+  DistortionRenderer* renderer_;
+  CardboardAsyncTimewarpConfig config_;
+
+  // @{ Latest submitted frame, guarded by frame_mutex_.
+  std::mutex frame_mutex_;
+  std::condition_variable frame_condition_;
+  Frame frame_;
+  bool has_frame_;
+  bool is_running_;
+  // @}
+
+  std::thread thread_;
+};
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_ASYNC_TIMEWARP_H_
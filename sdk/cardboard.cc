@@ -15,25 +15,41 @@
  */
 #include "include/cardboard.h"
 
+#include <array>
 #include <cmath>
+#include <cstring>
+#include <memory>
+#include <utility>
 
+#include "async_timewarp.h"
 #include "distortion_renderer.h"
+#include "eye_buffer_reuse.h"
 #include "head_tracker.h"
 #include "lens_distortion.h"
 #include "qr_code.h"
 #include "qrcode/cardboard_v1/cardboard_v1.h"
+#include "qrcode/saved_device_params.h"
 #include "screen_params.h"
+#include "sensors/calibration_storage.h"
+#include "util/clock.h"
 #include "util/is_arg_null.h"
 #include "util/is_initialized.h"
 #include "util/logging.h"
+#include "util/stats.h"
+#include "util/trace.h"
 #ifdef __ANDROID__
-#include "device_params/android/device_params.h"
+#include "jni_utils/android/jni_utils.h"
 #endif
 
 // TODO(b/134142617): Revisit struct/class hierarchy.
 struct CardboardLensDistortion : cardboard::LensDistortion {};
 struct CardboardDistortionRenderer : cardboard::DistortionRenderer {};
 struct CardboardHeadTracker : cardboard::HeadTracker {};
+struct CardboardAsyncTimewarp : cardboard::AsyncTimewarp {};
+struct CardboardEyeBufferReuse : cardboard::EyeBufferReuse {};
+struct CardboardDeviceParams {
+  std::shared_ptr<const cardboard::qrcode::SavedDeviceParams> device_params;
+};
 
 namespace {
 
@@ -69,6 +85,15 @@ void GetDefaultDistortionMesh(CardboardMesh* mesh) {
   }
 }
 
+// Return default (empty) chromatic distortion mesh.
+void GetDefaultChromaticDistortionMesh(CardboardChromaticMesh* mesh) {
+  if (mesh != nullptr) {
+    GetDefaultDistortionMesh(&mesh->mesh);
+    mesh->red_uvs = nullptr;
+    mesh->blue_uvs = nullptr;
+  }
+}
+
 // Return default (empty) encoded device params.
 void GetDefaultEncodedDeviceParams(uint8_t** encoded_device_params, int* size) {
   if (encoded_device_params != nullptr) {
@@ -79,6 +104,27 @@ void GetDefaultEncodedDeviceParams(uint8_t** encoded_device_params, int* size) {
   }
 }
 
+// Return default (identity) 3x3 matrix.
+void GetDefaultReprojection(float* reprojection) {
+  if (reprojection != nullptr) {
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        reprojection[i * 3 + j] = (i == j) ? 1.0f : 0.0f;
+      }
+    }
+  }
+}
+
+// Return default (zero) texture size.
+void GetDefaultTextureSize(int* width, int* height) {
+  if (width != nullptr) {
+    *width = 0;
+  }
+  if (height != nullptr) {
+    *height = 0;
+  }
+}
+
 // Return default (zero) position.
 void GetDefaultPosition(float* position) {
   if (position != nullptr) {
@@ -107,13 +153,15 @@ void Cardboard_initializeAndroid(JavaVM* vm, jobject context) {
   if (CARDBOARD_IS_ARG_NULL(vm) || CARDBOARD_IS_ARG_NULL(context)) {
     return;
   }
+  CARDBOARD_TRACE_SCOPE("Cardboard_initializeAndroid");
   JNIEnv* env;
   vm->GetEnv((void**)&env, JNI_VERSION_1_6);
   jobject global_context = env->NewGlobalRef(context);
 
+  cardboard::jni::initializeAndroid(vm, global_context);
   cardboard::qrcode::initializeAndroid(vm, global_context);
   cardboard::screen_params::initializeAndroid(vm, global_context);
-  cardboard::DeviceParams::initializeAndroid(vm, global_context);
+  cardboard::sensors::initializeAndroid(vm, global_context);
 
   cardboard::util::SetIsInitialized();
 }
@@ -131,6 +179,17 @@ CardboardLensDistortion* CardboardLensDistortion_create(
                                     display_height));
 }
 
+CardboardLensDistortion* CardboardLensDistortion_createFromDeviceParams(
+    const CardboardDeviceParams* device_params, int display_width,
+    int display_height) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(device_params)) {
+    return nullptr;
+  }
+  return reinterpret_cast<CardboardLensDistortion*>(
+      new cardboard::LensDistortion(device_params->device_params->decoded,
+                                    display_width, display_height));
+}
+
 void CardboardLensDistortion_destroy(CardboardLensDistortion* lens_distortion) {
   if (CARDBOARD_IS_NOT_INITIALIZED() ||
       CARDBOARD_IS_ARG_NULL(lens_distortion)) {
@@ -190,6 +249,18 @@ void CardboardLensDistortion_getDistortionMesh(
               ->GetDistortionMesh(eye);
 }
 
+void CardboardLensDistortion_getChromaticDistortionMesh(
+    CardboardLensDistortion* lens_distortion, CardboardEye eye,
+    CardboardChromaticMesh* mesh) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() ||
+      CARDBOARD_IS_ARG_NULL(lens_distortion) || CARDBOARD_IS_ARG_NULL(mesh)) {
+    GetDefaultChromaticDistortionMesh(mesh);
+    return;
+  }
+  *mesh = static_cast<cardboard::LensDistortion*>(lens_distortion)
+              ->GetChromaticDistortionMesh(eye);
+}
+
 CardboardUv CardboardLensDistortion_undistortedUvForDistortedUv(
     CardboardLensDistortion* lens_distortion, const CardboardUv* distorted_uv,
     CardboardEye eye) {
@@ -230,6 +301,44 @@ CardboardUv CardboardLensDistortion_distortedUvForUndistortedUv(
   return ret;
 }
 
+void CardboardLensDistortion_getRotationalReprojection(
+    CardboardLensDistortion* lens_distortion, CardboardEye eye,
+    const float* render_orientation, const float* display_orientation,
+    float* reprojection) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() ||
+      CARDBOARD_IS_ARG_NULL(lens_distortion) ||
+      CARDBOARD_IS_ARG_NULL(render_orientation) ||
+      CARDBOARD_IS_ARG_NULL(display_orientation) ||
+      CARDBOARD_IS_ARG_NULL(reprojection)) {
+    GetDefaultReprojection(reprojection);
+    return;
+  }
+  std::array<float, 4> render;
+  std::array<float, 4> display;
+  std::memcpy(&render[0], render_orientation, 4 * sizeof(float));
+  std::memcpy(&display[0], display_orientation, 4 * sizeof(float));
+  const std::array<float, 9> out_reprojection =
+      static_cast<cardboard::LensDistortion*>(lens_distortion)
+          ->GetRotationalReprojection(eye, render, display);
+  std::memcpy(reprojection, &out_reprojection[0], 9 * sizeof(float));
+}
+
+void CardboardLensDistortion_getRecommendedEyeTextureSize(
+    CardboardLensDistortion* lens_distortion, CardboardEye eye, int* width,
+    int* height) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() ||
+      CARDBOARD_IS_ARG_NULL(lens_distortion) || CARDBOARD_IS_ARG_NULL(width) ||
+      CARDBOARD_IS_ARG_NULL(height)) {
+    GetDefaultTextureSize(width, height);
+    return;
+  }
+  const std::array<int, 2> size =
+      static_cast<cardboard::LensDistortion*>(lens_distortion)
+          ->GetRecommendedEyeTextureSize(eye);
+  *width = size[0];
+  *height = size[1];
+}
+
 void CardboardDistortionRenderer_destroy(
     CardboardDistortionRenderer* renderer) {
   if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(renderer)) {
@@ -245,9 +354,47 @@ void CardboardDistortionRenderer_setMesh(CardboardDistortionRenderer* renderer,
       CARDBOARD_IS_ARG_NULL(mesh)) {
     return;
   }
+  CARDBOARD_TRACE_SCOPE("CardboardDistortionRenderer_setMesh");
+  const CardboardChromaticMesh chromatic_mesh = {*mesh, nullptr, nullptr};
+  static_cast<cardboard::DistortionRenderer*>(renderer)->SetMesh(
+      &chromatic_mesh, eye);
+}
+
+void CardboardDistortionRenderer_setChromaticMesh(
+    CardboardDistortionRenderer* renderer, const CardboardChromaticMesh* mesh,
+    CardboardEye eye) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(renderer) ||
+      CARDBOARD_IS_ARG_NULL(mesh)) {
+    return;
+  }
+  CARDBOARD_TRACE_SCOPE("CardboardDistortionRenderer_setChromaticMesh");
   static_cast<cardboard::DistortionRenderer*>(renderer)->SetMesh(mesh, eye);
 }
 
+void CardboardDistortionRenderer_setReprojection(
+    CardboardDistortionRenderer* renderer, const float* reprojection,
+    CardboardEye eye) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(renderer) ||
+      CARDBOARD_IS_ARG_NULL(reprojection)) {
+    return;
+  }
+  std::array<float, 9> in_reprojection;
+  std::memcpy(&in_reprojection[0], reprojection, 9 * sizeof(float));
+  static_cast<cardboard::DistortionRenderer*>(renderer)->SetReprojection(
+      in_reprojection, eye);
+}
+
+void CardboardDistortionRenderer_setPassConfig(
+    CardboardDistortionRenderer* renderer,
+    const CardboardDistortionRendererPassConfig* pass_config) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(renderer) ||
+      CARDBOARD_IS_ARG_NULL(pass_config)) {
+    return;
+  }
+  static_cast<cardboard::DistortionRenderer*>(renderer)->SetPassConfig(
+      *pass_config);
+}
+
 void CardboardDistortionRenderer_renderEyeToDisplay(
     CardboardDistortionRenderer* renderer, uint64_t target, int x, int y,
     int width, int height, const CardboardEyeTextureDescription* left_eye,
@@ -256,6 +403,9 @@ void CardboardDistortionRenderer_renderEyeToDisplay(
       CARDBOARD_IS_ARG_NULL(left_eye) || CARDBOARD_IS_ARG_NULL(right_eye)) {
     return;
   }
+  CARDBOARD_TRACE_SCOPE("CardboardDistortionRenderer_renderEyeToDisplay");
+  const cardboard::util::ScopedLatency latency(
+      &cardboard::util::GetStats().distortion_pass);
   static_cast<cardboard::DistortionRenderer*>(renderer)->RenderEyeToDisplay(
       target, x, y, width, height, left_eye, right_eye);
 }
@@ -313,6 +463,152 @@ void CardboardHeadTracker_recenter(CardboardHeadTracker* head_tracker) {
   static_cast<cardboard::HeadTracker*>(head_tracker)->Recenter();
 }
 
+void CardboardHeadTracker_addVsyncTimestamp(CardboardHeadTracker* head_tracker,
+                                            int64_t vsync_timestamp_ns) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(head_tracker)) {
+    return;
+  }
+  static_cast<cardboard::HeadTracker*>(head_tracker)
+      ->AddVsyncTimestamp(vsync_timestamp_ns);
+}
+
+int64_t CardboardHeadTracker_getPredictedDisplayTime(
+    CardboardHeadTracker* head_tracker) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(head_tracker)) {
+    return 0;
+  }
+  return static_cast<cardboard::HeadTracker*>(head_tracker)
+      ->GetPredictedDisplayTime(cardboard::GetBootTimeNano());
+}
+
+int CardboardHeadTracker_getCalibration(
+    CardboardHeadTracker* head_tracker,
+    CardboardHeadTrackerCalibration* calibration) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(head_tracker) ||
+      CARDBOARD_IS_ARG_NULL(calibration)) {
+    return 0;
+  }
+  return static_cast<cardboard::HeadTracker*>(head_tracker)
+                 ->GetCalibration(calibration)
+             ? 1
+             : 0;
+}
+
+int CardboardHeadTracker_setCalibration(
+    CardboardHeadTracker* head_tracker,
+    const CardboardHeadTrackerCalibration* calibration) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(head_tracker) ||
+      CARDBOARD_IS_ARG_NULL(calibration)) {
+    return 0;
+  }
+  return static_cast<cardboard::HeadTracker*>(head_tracker)
+                 ->SetCalibration(*calibration)
+             ? 1
+             : 0;
+}
+
+CardboardAsyncTimewarp* CardboardAsyncTimewarp_create(
+    CardboardHeadTracker* head_tracker,
+    CardboardLensDistortion* lens_distortion,
+    CardboardDistortionRenderer* renderer,
+    const CardboardAsyncTimewarpConfig* config) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(head_tracker) ||
+      CARDBOARD_IS_ARG_NULL(lens_distortion) ||
+      CARDBOARD_IS_ARG_NULL(renderer) || CARDBOARD_IS_ARG_NULL(config)) {
+    return nullptr;
+  }
+  if (config->begin_frame == nullptr || config->end_frame == nullptr) {
+    CARDBOARD_LOGE(
+        "[%s : %d] Argument config is not valid. begin_frame and end_frame "
+        "callbacks must not be null.",
+        __FILE__, __LINE__);
+    return nullptr;
+  }
+  return reinterpret_cast<CardboardAsyncTimewarp*>(new cardboard::AsyncTimewarp(
+      head_tracker, lens_distortion, renderer, *config));
+}
+
+void CardboardAsyncTimewarp_destroy(CardboardAsyncTimewarp* timewarp) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(timewarp)) {
+    return;
+  }
+  delete timewarp;
+}
+
+void CardboardAsyncTimewarp_submitFrame(
+    CardboardAsyncTimewarp* timewarp,
+    const CardboardEyeTextureDescription* left_eye,
+    const CardboardEyeTextureDescription* right_eye,
+    const float* render_orientation) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(timewarp) ||
+      CARDBOARD_IS_ARG_NULL(left_eye) || CARDBOARD_IS_ARG_NULL(right_eye) ||
+      CARDBOARD_IS_ARG_NULL(render_orientation)) {
+    return;
+  }
+  std::array<float, 4> orientation;
+  std::memcpy(&orientation[0], render_orientation, 4 * sizeof(float));
+  static_cast<cardboard::AsyncTimewarp*>(timewarp)->SubmitFrame(
+      *left_eye, *right_eye, orientation);
+}
+
+CardboardEyeBufferReuse* CardboardEyeBufferReuse_create(
+    CardboardHeadTracker* head_tracker,
+    CardboardLensDistortion* lens_distortion,
+    CardboardDistortionRenderer* renderer,
+    const CardboardEyeBufferReuseConfig* config) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(head_tracker) ||
+      CARDBOARD_IS_ARG_NULL(lens_distortion) ||
+      CARDBOARD_IS_ARG_NULL(renderer) || CARDBOARD_IS_ARG_NULL(config)) {
+    return nullptr;
+  }
+  return reinterpret_cast<CardboardEyeBufferReuse*>(
+      new cardboard::EyeBufferReuse(head_tracker, lens_distortion, renderer,
+                                    *config));
+}
+
+void CardboardEyeBufferReuse_destroy(CardboardEyeBufferReuse* reuse) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(reuse)) {
+    return;
+  }
+  delete reuse;
+}
+
+void CardboardEyeBufferReuse_submitFrame(
+    CardboardEyeBufferReuse* reuse,
+    const CardboardEyeTextureDescription* left_eye,
+    const CardboardEyeTextureDescription* right_eye,
+    const float* render_orientation) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(reuse) ||
+      CARDBOARD_IS_ARG_NULL(left_eye) || CARDBOARD_IS_ARG_NULL(right_eye) ||
+      CARDBOARD_IS_ARG_NULL(render_orientation)) {
+    return;
+  }
+  std::array<float, 4> orientation;
+  std::memcpy(&orientation[0], render_orientation, 4 * sizeof(float));
+  static_cast<cardboard::EyeBufferReuse*>(reuse)->SubmitFrame(
+      *left_eye, *right_eye, orientation);
+}
+
+int CardboardEyeBufferReuse_isNewFrameNeeded(CardboardEyeBufferReuse* reuse) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(reuse)) {
+    return 1;
+  }
+  return static_cast<cardboard::EyeBufferReuse*>(reuse)->IsNewFrameNeeded()
+             ? 1
+             : 0;
+}
+
+int CardboardEyeBufferReuse_renderEyeToDisplay(CardboardEyeBufferReuse* reuse,
+                                               uint64_t target) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(reuse)) {
+    return 0;
+  }
+  return static_cast<cardboard::EyeBufferReuse*>(reuse)->RenderEyeToDisplay(
+             target)
+             ? 1
+             : 0;
+}
+
 void CardboardQrCode_getSavedDeviceParams(uint8_t** encoded_device_params,
                                           int* size) {
   if (CARDBOARD_IS_NOT_INITIALIZED() ||
@@ -321,11 +617,52 @@ void CardboardQrCode_getSavedDeviceParams(uint8_t** encoded_device_params,
     GetDefaultEncodedDeviceParams(encoded_device_params, size);
     return;
   }
-  std::vector<uint8_t> device_params =
-      cardboard::qrcode::getCurrentSavedDeviceParams();
-  *size = static_cast<int>(device_params.size());
+  // The snapshot is kept alive while copying, as the cache may be replaced
+  // concurrently.
+  const std::shared_ptr<const cardboard::qrcode::SavedDeviceParams>
+      device_params = cardboard::qrcode::getSavedDeviceParams();
+  *size = static_cast<int>(device_params->encoded.size());
   *encoded_device_params = new uint8_t[*size];
-  memcpy(*encoded_device_params, &device_params[0], *size);
+  memcpy(*encoded_device_params, device_params->encoded.data(), *size);
+}
+
+CardboardDeviceParams* CardboardQrCode_acquireSavedDeviceParams() {
+  if (CARDBOARD_IS_NOT_INITIALIZED()) {
+    return nullptr;
+  }
+  std::shared_ptr<const cardboard::qrcode::SavedDeviceParams> device_params =
+      cardboard::qrcode::getSavedDeviceParams();
+  // Lens distortions created from undecodable parameters would silently have
+  // no distortion at all.
+  if (!device_params->is_decoded) {
+    return nullptr;
+  }
+  return new CardboardDeviceParams{std::move(device_params)};
+}
+
+void CardboardDeviceParams_getEncoded(
+    const CardboardDeviceParams* device_params,
+    const uint8_t** encoded_device_params, int* size) {
+  if (CARDBOARD_IS_ARG_NULL(device_params) ||
+      CARDBOARD_IS_ARG_NULL(encoded_device_params) ||
+      CARDBOARD_IS_ARG_NULL(size)) {
+    if (encoded_device_params != nullptr) {
+      *encoded_device_params = nullptr;
+    }
+    if (size != nullptr) {
+      *size = 0;
+    }
+    return;
+  }
+  *encoded_device_params = device_params->device_params->encoded.data();
+  *size = static_cast<int>(device_params->device_params->encoded.size());
+}
+
+void CardboardDeviceParams_release(CardboardDeviceParams* device_params) {
+  if (CARDBOARD_IS_ARG_NULL(device_params)) {
+    return;
+  }
+  delete device_params;
 }
 
 void CardboardQrCode_destroy(const uint8_t* encoded_device_params) {
@@ -363,6 +700,11 @@ int CardboardQrCode_getDeviceParamsChangedCount() {
   return cardboard::qrcode::getDeviceParamsChangedCount();
 }
 
+void CardboardQrCode_setDeviceParamsChangedCallback(
+    CardboardQrCode_DeviceParamsChangedCallback callback, void* user_data) {
+  cardboard::qrcode::setDeviceParamsChangedCallback(callback, user_data);
+}
+
 void CardboardQrCode_getCardboardV1DeviceParams(uint8_t** encoded_device_params,
                                                 int* size) {
   if (CARDBOARD_IS_ARG_NULL(encoded_device_params) ||
@@ -376,4 +718,24 @@ void CardboardQrCode_getCardboardV1DeviceParams(uint8_t** encoded_device_params,
   *size = static_cast<int>(cardboard_v1_device_param.size());
 }
 
+void CardboardStats_setEnabled(int enabled) {
+  cardboard::util::Stats::SetEnabled(enabled != 0);
+}
+
+void CardboardStats_reset() { cardboard::util::GetStats().Reset(); }
+
+void CardboardStats_get(CardboardStats* stats) {
+  if (CARDBOARD_IS_ARG_NULL(stats)) {
+    return;
+  }
+  cardboard::util::GetStats().Get(stats);
+}
+
+void CardboardStats_getAndReset(CardboardStats* stats) {
+  if (CARDBOARD_IS_ARG_NULL(stats)) {
+    return;
+  }
+  cardboard::util::GetStats().GetAndReset(stats);
+}
+
 }  // extern "C"
@@ -0,0 +1,332 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "device_params/device_params.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "qrcode/cardboard_v1/cardboard_v1.h"
+#include "util/logging.h"
+
+namespace cardboard {
+namespace device_params {
+
+namespace {
+
+// Field numbers of the DeviceParams message in proto/cardboard_device.proto.
+// @{
+constexpr uint32_t kVendorField = 1;
+constexpr uint32_t kModelField = 2;
+constexpr uint32_t kScreenToLensDistanceField = 3;
+constexpr uint32_t kInterLensDistanceField = 4;
+constexpr uint32_t kLeftEyeFieldOfViewAnglesField = 5;
+constexpr uint32_t kTrayToLensDistanceField = 6;
+constexpr uint32_t kDistortionCoefficientsField = 7;
+constexpr uint32_t kVerticalAlignmentField = 11;
+constexpr uint32_t kPrimaryButtonField = 12;
+constexpr uint32_t kChromaticAberrationScalesField = 13;
+// @}
+
+// Protobuf wire types.
+// @{
+constexpr uint32_t kWireTypeVarint = 0;
+constexpr uint32_t kWireTypeFixed64 = 1;
+constexpr uint32_t kWireTypeLengthDelimited = 2;
+constexpr uint32_t kWireTypeFixed32 = 5;
+// @}
+
+// Maximum number of bytes of a 64-bit varint.
+constexpr int kMaxVarintBytes = 10;
+
+// Sequential reader over a protobuf wire format buffer. Every read is bounds
+// checked; a failed read leaves the reader in an unspecified position.
+class WireReader {
+ public:
+  WireReader(const uint8_t* data, size_t size)
+      : current_(data), end_(data + size) {}
+
+  bool AtEnd() const { return current_ == end_; }
+  const uint8_t* current() const { return current_; }
+
+  bool ReadVarint(uint64_t* value) {
+    uint64_t result = 0;
+    for (int i = 0; i < kMaxVarintBytes; ++i) {
+      if (current_ == end_) {
+        return false;
+      }
+      const uint8_t byte = *current_++;
+      result |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+      if ((byte & 0x80) == 0) {
+        *value = result;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool ReadFloat(float* value) {
+    if (Remaining() < sizeof(uint32_t)) {
+      return false;
+    }
+    // Protobuf encodes fixed32 values in little-endian byte order regardless
+    // of the host.
+    const uint32_t bits = static_cast<uint32_t>(current_[0]) |
+                          static_cast<uint32_t>(current_[1]) << 8 |
+                          static_cast<uint32_t>(current_[2]) << 16 |
+                          static_cast<uint32_t>(current_[3]) << 24;
+    std::memcpy(value, &bits, sizeof(bits));
+    current_ += sizeof(uint32_t);
+    return true;
+  }
+
+  // Reads the length prefix of a length-delimited field and returns a reader
+  // over its payload.
+  bool ReadLengthDelimited(WireReader* payload) {
+    uint64_t length;
+    if (!ReadVarint(&length) || length > Remaining()) {
+      return false;
+    }
+    *payload = WireReader(current_, static_cast<size_t>(length));
+    current_ += length;
+    return true;
+  }
+
+  bool Skip(uint32_t wire_type) {
+    switch (wire_type) {
+      case kWireTypeVarint: {
+        uint64_t unused;
+        return ReadVarint(&unused);
+      }
+      case kWireTypeFixed64:
+        return Advance(sizeof(uint64_t));
+      case kWireTypeLengthDelimited: {
+        WireReader unused(nullptr, 0);
+        return ReadLengthDelimited(&unused);
+      }
+      case kWireTypeFixed32:
+        return Advance(sizeof(uint32_t));
+      default:
+        // Groups are deprecated and are not used by DeviceParams.
+        return false;
+    }
+  }
+
+  size_t Remaining() const { return static_cast<size_t>(end_ - current_); }
+
+ private:
+  bool Advance(size_t bytes) {
+    if (Remaining() < bytes) {
+      return false;
+    }
+    current_ += bytes;
+    return true;
+  }
+
+  const uint8_t* current_;
+  const uint8_t* end_;
+};
+
+// Reads a singular float field. Values with an unexpected wire type are
+// skipped, as protobuf does with unknown fields.
+bool ReadFloatField(WireReader* reader, uint32_t wire_type, float* value) {
+  if (wire_type != kWireTypeFixed32) {
+    return reader->Skip(wire_type);
+  }
+  return reader->ReadFloat(value);
+}
+
+// Reads a repeated float field, accepting both the packed and the unpacked
+// encodings.
+bool ReadRepeatedFloatField(WireReader* reader, uint32_t wire_type,
+                            std::vector<float>* values) {
+  if (wire_type == kWireTypeFixed32) {
+    float value;
+    if (!reader->ReadFloat(&value)) {
+      return false;
+    }
+    values->push_back(value);
+    return true;
+  }
+  if (wire_type != kWireTypeLengthDelimited) {
+    return reader->Skip(wire_type);
+  }
+  WireReader packed(nullptr, 0);
+  if (!reader->ReadLengthDelimited(&packed) ||
+      packed.Remaining() % sizeof(float) != 0) {
+    return false;
+  }
+  values->reserve(values->size() + packed.Remaining() / sizeof(float));
+  while (!packed.AtEnd()) {
+    float value;
+    packed.ReadFloat(&value);
+    values->push_back(value);
+  }
+  return true;
+}
+
+bool ReadStringField(WireReader* reader, uint32_t wire_type,
+                     std::string* value) {
+  if (wire_type != kWireTypeLengthDelimited) {
+    return reader->Skip(wire_type);
+  }
+  WireReader payload(nullptr, 0);
+  if (!reader->ReadLengthDelimited(&payload)) {
+    return false;
+  }
+  const size_t length = payload.Remaining();
+  value->assign(reinterpret_cast<const char*>(payload.current()), length);
+  return true;
+}
+
+// Reads an enum field. As in proto2, values outside of [0, max_value] are
+// ignored and leave @p value untouched.
+bool ReadEnumField(WireReader* reader, uint32_t wire_type, int max_value,
+                   int* value) {
+  if (wire_type != kWireTypeVarint) {
+    return reader->Skip(wire_type);
+  }
+  uint64_t raw_value;
+  if (!reader->ReadVarint(&raw_value)) {
+    return false;
+  }
+  if (raw_value <= static_cast<uint64_t>(max_value)) {
+    *value = static_cast<int>(raw_value);
+  }
+  return true;
+}
+
+}  // anonymous namespace
+
+DeviceParams::DeviceParams() { Clear(); }
+
+void DeviceParams::Clear() {
+  vendor_.clear();
+  model_.clear();
+  screen_to_lens_distance_ = 0.0f;
+  inter_lens_distance_ = 0.0f;
+  tray_to_lens_distance_ = 0.0f;
+  vertical_alignment_ = BOTTOM;
+  primary_button_ = MAGNET;
+  distortion_coefficients_.clear();
+  left_eye_field_of_view_angles_.clear();
+  chromatic_aberration_scales_.clear();
+}
+
+bool DeviceParams::ParseFromArray(const uint8_t* encoded_device_params,
+                                  int size) {
+  Clear();
+  if (size < 0 || (encoded_device_params == nullptr && size != 0)) {
+    return false;
+  }
+
+  WireReader reader(encoded_device_params, static_cast<size_t>(size));
+  while (!reader.AtEnd()) {
+    uint64_t tag;
+    if (!reader.ReadVarint(&tag) || tag > UINT32_MAX) {
+      Clear();
+      return false;
+    }
+    const uint32_t field_number = static_cast<uint32_t>(tag) >> 3;
+    const uint32_t wire_type = static_cast<uint32_t>(tag) & 0x7;
+    if (field_number == 0) {
+      Clear();
+      return false;
+    }
+
+    bool success;
+    switch (field_number) {
+      case kVendorField:
+        success = ReadStringField(&reader, wire_type, &vendor_);
+        break;
+      case kModelField:
+        success = ReadStringField(&reader, wire_type, &model_);
+        break;
+      case kScreenToLensDistanceField:
+        success =
+            ReadFloatField(&reader, wire_type, &screen_to_lens_distance_);
+        break;
+      case kInterLensDistanceField:
+        success = ReadFloatField(&reader, wire_type, &inter_lens_distance_);
+        break;
+      case kLeftEyeFieldOfViewAnglesField:
+        success = ReadRepeatedFloatField(&reader, wire_type,
+                                         &left_eye_field_of_view_angles_);
+        break;
+      case kTrayToLensDistanceField:
+        success = ReadFloatField(&reader, wire_type, &tray_to_lens_distance_);
+        break;
+      case kDistortionCoefficientsField:
+        success = ReadRepeatedFloatField(&reader, wire_type,
+                                         &distortion_coefficients_);
+        break;
+      case kVerticalAlignmentField:
+        success =
+            ReadEnumField(&reader, wire_type, TOP, &vertical_alignment_);
+        break;
+      case kPrimaryButtonField:
+        success =
+            ReadEnumField(&reader, wire_type, INDUCTIVE, &primary_button_);
+        break;
+      case kChromaticAberrationScalesField:
+        success = ReadRepeatedFloatField(&reader, wire_type,
+                                         &chromatic_aberration_scales_);
+        break;
+      default:
+        success = reader.Skip(wire_type);
+        break;
+    }
+    if (!success) {
+      Clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+float DeviceParams::distortion_coefficients(int index) const {
+  if (index < 0 || index >= distortion_coefficients_size()) {
+    CARDBOARD_LOGE("Distortion coefficient index %d is out of range.", index);
+    return 0.0f;
+  }
+  return distortion_coefficients_[index];
+}
+
+float DeviceParams::chromatic_aberration_scales(int index) const {
+  if (index < 0 || index >= chromatic_aberration_scales_size()) {
+    CARDBOARD_LOGE("Chromatic aberration scale index %d is out of range.",
+                   index);
+    return 1.0f;
+  }
+  return chromatic_aberration_scales_[index];
+}
+
+float DeviceParams::left_eye_field_of_view_angles(int index) const {
+  if (index >= 0 && index < left_eye_field_of_view_angles_size()) {
+    return left_eye_field_of_view_angles_[index];
+  }
+  CARDBOARD_LOGE(
+      "Cannot retrieve LeftEyeFieldOfViewAngle %d from device parameters. "
+      "Using Cardboard Viewer v1 parameter.",
+      index);
+  constexpr int kFovAnglesSize = sizeof(qrcode::kCardboardV1FovHalfDegrees) /
+                                 sizeof(qrcode::kCardboardV1FovHalfDegrees[0]);
+  return index >= 0 && index < kFovAnglesSize
+             ? qrcode::kCardboardV1FovHalfDegrees[index]
+             : 0.0f;
+}
+
+}  // namespace device_params
+}  // namespace cardboard
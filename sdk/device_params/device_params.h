@@ -0,0 +1,92 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_DEVICE_PARAMS_DEVICE_PARAMS_H_
+#define CARDBOARD_SDK_DEVICE_PARAMS_DEVICE_PARAMS_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cardboard {
+namespace device_params {
+
+// Native decoder for the DeviceParams message defined in
+// proto/cardboard_device.proto. It reads the protobuf wire format directly so
+// the SDK does not depend on a protobuf runtime (nor on JNI calls on Android)
+// to read the viewer parameters. The class and method names are equivalent to
+// the ones present in protobuf generated source code, to make it transparent
+// for the user. It lives in its own namespace so it does not clash with
+// cardboard::DeviceParams from the generated code where both are linked in.
+//
+// The message is decoded once by ParseFromArray() and the getters only read
+// plain members afterwards. Fields that are not present in the buffer take the
+// default value declared in the proto file.
+class DeviceParams {
+ public:
+  enum VerticalAlignmentType { BOTTOM = 0, CENTER = 1, TOP = 2 };
+  enum ButtonType { NONE = 0, MAGNET = 1, TOUCH = 2, INDUCTIVE = 3 };
+
+  DeviceParams();
+
+  // Parses device parameters from serialized buffer.
+  //
+  // @param[in]      encoded_device_params   Device parameters byte buffer.
+  // @param[in]      size                    Buffer length in bytes.
+  // @return true when the buffer holds a well formed message. When false, all
+  //         the fields are reset to their default values.
+  bool ParseFromArray(const uint8_t* encoded_device_params, int size);
+
+  // Resets all the fields to their default values.
+  void Clear();
+
+  // Device parameters getter methods.
+  const std::string& vendor() const { return vendor_; }
+  const std::string& model() const { return model_; }
+  float screen_to_lens_distance() const { return screen_to_lens_distance_; }
+  float inter_lens_distance() const { return inter_lens_distance_; }
+  float tray_to_lens_distance() const { return tray_to_lens_distance_; }
+  int vertical_alignment() const { return vertical_alignment_; }
+  int primary_button() const { return primary_button_; }
+  float distortion_coefficients(int index) const;
+  int distortion_coefficients_size() const {
+    return static_cast<int>(distortion_coefficients_.size());
+  }
+  float left_eye_field_of_view_angles(int index) const;
+  int left_eye_field_of_view_angles_size() const {
+    return static_cast<int>(left_eye_field_of_view_angles_.size());
+  }
+  float chromatic_aberration_scales(int index) const;
+  int chromatic_aberration_scales_size() const {
+    return static_cast<int>(chromatic_aberration_scales_.size());
+  }
+
+ private:
+  std::string vendor_;
+  std::string model_;
+  float screen_to_lens_distance_;
+  float inter_lens_distance_;
+  float tray_to_lens_distance_;
+  int vertical_alignment_;
+  int primary_button_;
+  std::vector<float> distortion_coefficients_;
+  std::vector<float> left_eye_field_of_view_angles_;
+  std::vector<float> chromatic_aberration_scales_;
+};
+
+}  // namespace device_params
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_DEVICE_PARAMS_DEVICE_PARAMS_H_
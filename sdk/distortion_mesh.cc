@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "include/cardboard.h"
+#include "util/trace.h"
 
 namespace cardboard {
 
@@ -26,10 +27,18 @@ DistortionMesh::DistortionMesh(
     // Units of the following parameters are tan-angle units.
     float screen_width, float screen_height, float x_eye_offset_screen,
     float y_eye_offset_screen, float texture_width, float texture_height,
-    float x_eye_offset_texture, float y_eye_offset_texture) {
+    float x_eye_offset_texture, float y_eye_offset_texture,
+    const std::array<float, 3>& chromatic_aberration_scales) {
+  CARDBOARD_TRACE_SCOPE("DistortionMesh::DistortionMesh");
   vertex_data_.resize(kResolution * kResolution *
                       2);                           // 2 components per vertex
   uvs_data_.resize(kResolution * kResolution * 2);  // 2 components per uv
+  const bool has_chromatic_aberration =
+      chromatic_aberration_scales != std::array<float, 3>{1.0f, 1.0f, 1.0f};
+  if (has_chromatic_aberration) {
+    red_uvs_data_.resize(uvs_data_.size());
+    blue_uvs_data_.resize(uvs_data_.size());
+  }
   float u_screen, v_screen, u_texture, v_texture;
   std::array<float, 2> p_texture;
   std::array<float, 2> p_screen;
@@ -57,8 +66,23 @@ DistortionMesh::DistortionMesh(
 
       vertex_data_[index + 0] = 2 * u_screen - 1;
       vertex_data_[index + 1] = 2 * v_screen - 1;
-      uvs_data_[index + 0] = u_texture;
-      uvs_data_[index + 1] = v_texture;
+      if (!has_chromatic_aberration) {
+        uvs_data_[index + 0] = u_texture;
+        uvs_data_[index + 1] = v_texture;
+        continue;
+      }
+
+      // The lens bends each wavelength by a slightly different amount, so
+      // each channel samples the texture at its own scaled position.
+      std::vector<float>* channel_uvs[] = {&red_uvs_data_, &uvs_data_,
+                                           &blue_uvs_data_};
+      for (int channel = 0; channel < 3; ++channel) {
+        const float scale = chromatic_aberration_scales[channel];
+        (*channel_uvs[channel])[index + 0] =
+            (p_texture[0] * scale + x_eye_offset_texture) / texture_width;
+        (*channel_uvs[channel])[index + 1] =
+            (p_texture[1] * scale + y_eye_offset_texture) / texture_height;
+      }
     }
   }
 
@@ -122,4 +146,16 @@ CardboardMesh DistortionMesh::GetMesh() const {
   return mesh;
 }
 
+CardboardChromaticMesh DistortionMesh::GetChromaticMesh() const {
+  CardboardChromaticMesh mesh;
+  mesh.mesh = GetMesh();
+  mesh.red_uvs = red_uvs_data_.empty()
+                     ? nullptr
+                     : const_cast<float*>(red_uvs_data_.data());
+  mesh.blue_uvs = blue_uvs_data_.empty()
+                      ? nullptr
+                      : const_cast<float*>(blue_uvs_data_.data());
+  return mesh;
+}
+
 }  // namespace cardboard
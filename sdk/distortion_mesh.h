@@ -16,6 +16,7 @@
 #ifndef CARDBOARD_SDK_DISTORTION_MESH_H_
 #define CARDBOARD_SDK_DISTORTION_MESH_H_
 
+#include <array>
 #include <vector>
 
 #include "include/cardboard.h"
@@ -30,15 +31,26 @@ class DistortionMesh {
                  float screen_width, float screen_height,
                  float x_eye_offset_screen, float y_eye_offset_screen,
                  float texture_width, float texture_height,
-                 float x_eye_offset_texture, float y_eye_offset_texture);
+                 float x_eye_offset_texture, float y_eye_offset_texture,
+                 // Per-channel scale factors of the distorted points, in
+                 // (red, green, blue) order. See
+                 // DeviceParams::chromatic_aberration_scales.
+                 const std::array<float, 3>& chromatic_aberration_scales = {
+                     1.0f, 1.0f, 1.0f});
   virtual ~DistortionMesh() = default;
   CardboardMesh GetMesh() const;
+  // Same mesh, with the red and blue channel UV coordinates, null when all
+  // the color channels share the mesh UV coordinates.
+  CardboardChromaticMesh GetChromaticMesh() const;
 
  private:
   static constexpr int kResolution = 40;
   std::vector<int> index_data_;
   std::vector<float> vertex_data_;
   std::vector<float> uvs_data_;
+  // Empty when all the color channels share uvs_data_.
+  std::vector<float> red_uvs_data_;
+  std::vector<float> blue_uvs_data_;
 };
 
 }  // namespace cardboard
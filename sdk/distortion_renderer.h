@@ -28,7 +28,18 @@ namespace cardboard {
 class DistortionRenderer {
  public:
   virtual ~DistortionRenderer() = default;
-  virtual void SetMesh(const CardboardMesh* mesh, CardboardEye eye) = 0;
+  // The red and blue channel UV coordinates of @p mesh are null when all the
+  // color channels are sampled at the mesh UV coordinates.
+  virtual void SetMesh(const CardboardChromaticMesh* mesh,
+                       CardboardEye eye) = 0;
+  // @p reprojection is a 3x3 homogeneous transformation in column-major order
+  // applied to the eye texture coordinates before sampling.
+  virtual void SetReprojection(const std::array<float, 9>& reprojection,
+                               CardboardEye eye) = 0;
+  // Sets how subsequent RenderEyeToDisplay() calls load and store the target
+  // attachments.
+  virtual void SetPassConfig(
+      const CardboardDistortionRendererPassConfig& pass_config) = 0;
   virtual void RenderEyeToDisplay(
       uint64_t target, int x, int y, int width, int height,
       const CardboardEyeTextureDescription* left_eye,
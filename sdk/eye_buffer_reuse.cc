@@ -0,0 +1,84 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "eye_buffer_reuse.h"
+
+#include "util/clock.h"
+#include "util/reprojection.h"
+#include "util/trace.h"
+
+namespace cardboard {
+
+EyeBufferReuse::EyeBufferReuse(HeadTracker* head_tracker,
+                               LensDistortion* lens_distortion,
+                               DistortionRenderer* renderer,
+                               const CardboardEyeBufferReuseConfig& config)
+    : head_tracker_(head_tracker),
+      lens_distortion_(lens_distortion),
+      renderer_(renderer),
+      config_(config),
+      left_eye_(),
+      right_eye_(),
+      render_orientation_{0.0f, 0.0f, 0.0f, 1.0f},
+      has_frame_(false) {}
+
+void EyeBufferReuse::SubmitFrame(
+    const CardboardEyeTextureDescription& left_eye,
+    const CardboardEyeTextureDescription& right_eye,
+    const std::array<float, 4>& render_orientation) {
+  left_eye_ = left_eye;
+  right_eye_ = right_eye;
+  render_orientation_ = render_orientation;
+  has_frame_ = true;
+}
+
+bool EyeBufferReuse::IsNewFrameNeeded() {
+  if (!has_frame_) {
+    return true;
+  }
+  return ComputeReprojectionAngle(render_orientation_,
+                                  GetDisplayOrientation()) >
+         config_.max_reprojection_angle;
+}
+
+bool EyeBufferReuse::RenderEyeToDisplay(uint64_t target) {
+  if (!has_frame_) {
+    return false;
+  }
+  CARDBOARD_TRACE_SCOPE("EyeBufferReuse::RenderEyeToDisplay");
+  const std::array<float, 4> display_orientation = GetDisplayOrientation();
+  for (CardboardEye eye : {kLeft, kRight}) {
+    renderer_->SetReprojection(
+        lens_distortion_->GetRotationalReprojection(eye, render_orientation_,
+                                                    display_orientation),
+        eye);
+  }
+  renderer_->RenderEyeToDisplay(target, config_.x, config_.y, config_.width,
+                                config_.height, &left_eye_, &right_eye_);
+  return true;
+}
+
+std::array<float, 4> EyeBufferReuse::GetDisplayOrientation() {
+  std::array<float, 3> display_position;
+  std::array<float, 4> display_orientation;
+  // The viewport orientation is owned by the application, which renders the
+  // eye textures with it, so it is never changed from here.
+  head_tracker_->GetPose(
+      head_tracker_->GetPredictedDisplayTime(GetBootTimeNano()),
+      display_position, display_orientation);
+  return display_orientation;
+}
+
+}  // namespace cardboard
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_EYE_BUFFER_REUSE_H_
+#define CARDBOARD_SDK_EYE_BUFFER_REUSE_H_
+
+#include <array>
+#include <cstdint>
+
+#include "distortion_renderer.h"
+#include "head_tracker.h"
+#include "include/cardboard.h"
+#include "lens_distortion.h"
+
+namespace cardboard {
+
+// @brief Keeps the last eye textures submitted by the application and
+//        displays them again on frames it does not render, rotationally
+//        reprojected from the head orientation they were rendered with to the
+//        current predicted head orientation. Unlike AsyncTimewarp, everything
+//        runs on the caller's render thread.
+class EyeBufferReuse {
+ public:
+  // @p head_tracker, @p lens_distortion and @p renderer must outlive this
+  // object.
+  EyeBufferReuse(HeadTracker* head_tracker, LensDistortion* lens_distortion,
+                 DistortionRenderer* renderer,
+                 const CardboardEyeBufferReuseConfig& config);
+
+  // Replaces the eye textures to display, rendered with
+  // @p render_orientation.
+  void SubmitFrame(const CardboardEyeTextureDescription& left_eye,
+                   const CardboardEyeTextureDescription& right_eye,
+                   const std::array<float, 4>& render_orientation);
+
+  // Returns true when there is no submitted frame yet, or when the head has
+  // rotated by more than the configured maximum angle since the submitted
+  // frame was rendered.
+  bool IsNewFrameNeeded();
+
+  // Reprojects and renders the submitted frame to @p target. Returns false,
+  // without rendering, when there is no submitted frame.
+  bool RenderEyeToDisplay(uint64_t target);
+
+ private:
+  // Gets the head orientation predicted for a distortion pass starting now.
+  std::array<float, 4> GetDisplayOrientation();
+
+  HeadTracker* head_tracker_;
+  LensDistortion* lens_distortion_;
+  DistortionRenderer* renderer_;
+  CardboardEyeBufferReuseConfig config_;
+
+  CardboardEyeTextureDescription left_eye_;
+  CardboardEyeTextureDescription right_eye_;
+  std::array<float, 4> render_orientation_;
+  bool has_frame_;
+};
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_EYE_BUFFER_REUSE_H_
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "frame_timing.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cardboard {
+
+namespace {
+
+// Prediction time used until the estimates are locked. It matches the value
+// the SDK samples have historically used.
+constexpr int64_t kPredictionTimeWithoutVsyncNanos = 50000000;
+
+// Refresh period assumed until the first interval between vsyncs is measured.
+constexpr double kDefaultRefreshPeriodNanos = 1e9 / 60.0;
+
+// @{ Refresh period bounds, from 240 Hz to 20 Hz.
+constexpr double kMinRefreshPeriodNanos = 1e9 / 240.0;
+constexpr double kMaxRefreshPeriodNanos = 1e9 / 20.0;
+// @}
+
+// Number of vsync timestamps needed before trusting the estimates.
+constexpr int kMinSamplesToLock = 4;
+
+// When more vsyncs than this are missed in a row (e.g. the app was paused),
+// the loop restarts from the new timestamp keeping the period estimate.
+constexpr int64_t kMaxMissedVsyncs = 8;
+
+// @{ Loop gains. They give a critically damped response that settles in a
+// few tens of vsyncs while filtering out the timestamp jitter.
+constexpr double kPhaseGain = 0.2;
+constexpr double kPeriodGain = 0.01;
+// @}
+
+// Number of refresh periods between the vsync following the start of the
+// rendering and the vsync in which the frame is shown: one to finish the
+// rendering and one for the compositor.
+constexpr int64_t kDisplayLatencyRefreshPeriods = 2;
+
+}  // namespace
+
+FrameTiming::FrameTiming()
+    : phase_ns_(0), period_ns_(kDefaultRefreshPeriodNanos), num_samples_(0) {}
+
+void FrameTiming::AddVsyncTimestamp(int64_t vsync_timestamp_ns) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (num_samples_ == 0) {
+    phase_ns_ = vsync_timestamp_ns;
+    num_samples_ = 1;
+    return;
+  }
+
+  const int64_t elapsed_ns = vsync_timestamp_ns - phase_ns_;
+  // Duplicated or out-of-order timestamps carry no information.
+  if (elapsed_ns < period_ns_ / 2) {
+    return;
+  }
+
+  const int64_t cycles = std::max<int64_t>(
+      1, std::llround(static_cast<double>(elapsed_ns) / period_ns_));
+  if (cycles > kMaxMissedVsyncs) {
+    phase_ns_ = vsync_timestamp_ns;
+    num_samples_ = 1;
+    return;
+  }
+
+  if (num_samples_ == 1) {
+    // First measured interval: take it as the initial period estimate.
+    period_ns_ = std::clamp(static_cast<double>(elapsed_ns) / cycles,
+                            kMinRefreshPeriodNanos, kMaxRefreshPeriodNanos);
+    phase_ns_ = vsync_timestamp_ns;
+  } else {
+    const double predicted_ns = phase_ns_ + cycles * period_ns_;
+    const double error_ns = vsync_timestamp_ns - predicted_ns;
+    phase_ns_ = std::llround(predicted_ns + kPhaseGain * error_ns);
+    period_ns_ = std::clamp(period_ns_ + kPeriodGain * error_ns / cycles,
+                            kMinRefreshPeriodNanos, kMaxRefreshPeriodNanos);
+  }
+  ++num_samples_;
+}
+
+void FrameTiming::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  phase_ns_ = 0;
+  period_ns_ = kDefaultRefreshPeriodNanos;
+  num_samples_ = 0;
+}
+
+bool FrameTiming::IsLocked() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_samples_ >= kMinSamplesToLock;
+}
+
+int64_t FrameTiming::GetRefreshPeriod() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return std::llround(period_ns_);
+}
+
+int64_t FrameTiming::GetNextVsync(int64_t timestamp_ns) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (num_samples_ < kMinSamplesToLock) {
+    return timestamp_ns;
+  }
+  return GetNextVsyncLocked(timestamp_ns);
+}
+
+int64_t FrameTiming::GetPredictedDisplayTime(int64_t timestamp_ns) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (num_samples_ < kMinSamplesToLock) {
+    return timestamp_ns + kPredictionTimeWithoutVsyncNanos;
+  }
+  return GetNextVsyncLocked(timestamp_ns) +
+         std::llround(kDisplayLatencyRefreshPeriods * period_ns_);
+}
+
+int64_t FrameTiming::GetNextVsyncLocked(int64_t timestamp_ns) const {
+  const double cycles =
+      std::floor((timestamp_ns - phase_ns_) / period_ns_) + 1.0;
+  return phase_ns_ + std::llround(cycles * period_ns_);
+}
+
+}  // namespace cardboard
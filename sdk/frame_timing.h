@@ -0,0 +1,78 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_FRAME_TIMING_H_
+#define CARDBOARD_SDK_FRAME_TIMING_H_
+
+#include <cstdint>
+#include <mutex>  // NOLINT
+
+namespace cardboard {
+
+// @brief Estimates the display refresh period and phase from vsync timestamps
+//        and predicts when a frame will reach the display.
+//
+// It implements a second order phase-locked loop: every vsync timestamp is
+// compared against the estimated vsync closest to it, and the error corrects
+// both the phase and the period estimates. Missed and out-of-order timestamps
+// are tolerated. All timestamps are in nanoseconds and must share the clock
+// used by HeadTracker::GetPose().
+//
+// It is platform independent, so it can be driven by recorded timestamp
+// traces.
+class FrameTiming {
+ public:
+  FrameTiming();
+
+  // Adds the timestamp of a display vsync.
+  void AddVsyncTimestamp(int64_t vsync_timestamp_ns);
+
+  // Discards all the estimates, e.g. after the display has been reconfigured.
+  void Reset();
+
+  // Returns true when enough vsync timestamps have been added to trust the
+  // period and phase estimates.
+  bool IsLocked() const;
+
+  // Returns the estimated refresh period in nanoseconds.
+  int64_t GetRefreshPeriod() const;
+
+  // Returns the first estimated vsync after @p timestamp_ns. When the
+  // estimates are not locked, it returns @p timestamp_ns.
+  int64_t GetNextVsync(int64_t timestamp_ns) const;
+
+  // Returns the predicted time at which a frame whose rendering starts at
+  // @p timestamp_ns will be shown on the display. When the estimates are not
+  // locked, it falls back to a fixed prediction time.
+  int64_t GetPredictedDisplayTime(int64_t timestamp_ns) const;
+
+ private:
+  int64_t GetNextVsyncLocked(int64_t timestamp_ns) const;
+
+  mutable std::mutex mutex_;
+
+  // Estimated timestamp of the latest vsync.
+  int64_t phase_ns_;
+
+  // Estimated refresh period.
+  double period_ns_;
+
+  // Number of vsync timestamps used since the last reset.
+  int num_samples_;
+};
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_FRAME_TIMING_H_
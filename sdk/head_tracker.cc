@@ -15,10 +15,15 @@
  */
 #include "head_tracker.h"
 
+#include <cstring>
+
 #include "include/cardboard.h"
+#include "sensors/calibration_storage.h"
 #include "sensors/neck_model.h"
 #include "util/logging.h"
 #include "util/rotation.h"
+#include "util/stats.h"
+#include "util/trace.h"
 #include "util/vector.h"
 #include "util/vectorutils.h"
 
@@ -119,7 +124,8 @@ HeadTracker::HeadTracker()
       latest_gyroscope_data_({0, 0, Vector3::Zero()}),
       accel_sensor_(new SensorEventProducer<AccelerometerData>()),
       gyro_sensor_(new SensorEventProducer<GyroscopeData>()),
-      is_viewport_orientation_initialized_(false) {
+      is_viewport_orientation_initialized_(false),
+      sensor_id_(sensors::getMotionSensorId()) {
   on_accel_callback_ = [&](const AccelerometerData& event) {
     OnAccelerometerData(event);
   };
@@ -135,7 +141,7 @@ void HeadTracker::Pause() {
     return;
   }
 
-  UnregisterCallbacks();
+  PauseCallbacks();
 
   // Create a gyro event with zero velocity. This effectively stops the
   // prediction.
@@ -145,9 +151,24 @@ void HeadTracker::Pause() {
   OnGyroscopeData(event);
 
   is_tracking_ = false;
+
+  CardboardHeadTrackerCalibration calibration;
+  if (GetCalibration(&calibration)) {
+    sensors::writeCalibration(calibration);
+  }
 }
 
 void HeadTracker::Resume() {
+  CARDBOARD_TRACE_SCOPE("HeadTracker::Resume");
+  // Starts from the calibration saved by a previous session, unless this one
+  // already has its own.
+  SensorFusionEkf::Calibration current_calibration;
+  CardboardHeadTrackerCalibration saved_calibration;
+  if (!sensor_fusion_->GetCalibration(&current_calibration) &&
+      sensors::readCalibration(&saved_calibration)) {
+    SetCalibration(saved_calibration);
+  }
+
   is_tracking_ = true;
   RegisterCallbacks();
 }
@@ -156,30 +177,94 @@ void HeadTracker::GetPose(int64_t timestamp_ns,
                           CardboardViewportOrientation viewport_orientation,
                           std::array<float, 3>& out_position,
                           std::array<float, 4>& out_orientation) {
-  const Vector4 orientation =
-      GetRotation(viewport_orientation, timestamp_ns).GetQuaternion();
-
-  if (is_viewport_orientation_initialized_ &&
-      viewport_orientation != viewport_orientation_) {
-    sensor_fusion_->RotateSensorSpaceToStartSpaceTransformation(
-        ViewportChangeRotationCompensation()[viewport_orientation_]
-                                            [viewport_orientation]);
+  CARDBOARD_TRACE_SCOPE("HeadTracker::GetPose");
+  const util::ScopedLatency latency(&util::GetStats().get_pose);
+  const Rotation rotation = GetRotation(viewport_orientation, timestamp_ns);
+
+  {
+    // Poses may be queried concurrently, e.g. by the asynchronous timewarp
+    // thread and the application render thread.
+    std::lock_guard<std::mutex> lock(viewport_orientation_mutex_);
+    if (is_viewport_orientation_initialized_ &&
+        viewport_orientation != viewport_orientation_) {
+      sensor_fusion_->RotateSensorSpaceToStartSpaceTransformation(
+          ViewportChangeRotationCompensation()[viewport_orientation_]
+                                              [viewport_orientation]);
+    }
+    viewport_orientation_ = viewport_orientation;
+    is_viewport_orientation_initialized_ = true;
   }
-  viewport_orientation_ = viewport_orientation;
-  is_viewport_orientation_initialized_ = true;
 
-  out_orientation[0] = static_cast<float>(orientation[0]);
-  out_orientation[1] = static_cast<float>(orientation[1]);
-  out_orientation[2] = static_cast<float>(orientation[2]);
-  out_orientation[3] = static_cast<float>(orientation[3]);
+  RotationToPose(rotation, out_position, out_orientation);
+}
 
-  out_position = ApplyNeckModel(out_orientation, 1.0);
+void HeadTracker::GetPose(int64_t timestamp_ns,
+                          std::array<float, 3>& out_position,
+                          std::array<float, 4>& out_orientation) const {
+  CARDBOARD_TRACE_SCOPE("HeadTracker::GetPose");
+  const util::ScopedLatency latency(&util::GetStats().get_pose);
+  Rotation rotation;
+  {
+    // The lock is held while predicting so the frame of reference cannot be
+    // rotated by a concurrent viewport orientation change in between.
+    std::lock_guard<std::mutex> lock(viewport_orientation_mutex_);
+    rotation = GetRotation(is_viewport_orientation_initialized_
+                               ? viewport_orientation_
+                               : kLandscapeLeft,
+                           timestamp_ns);
+  }
+  RotationToPose(rotation, out_position, out_orientation);
 }
 
 void HeadTracker::Recenter() {
   sensor_fusion_->Reset();
 }
 
+void HeadTracker::AddVsyncTimestamp(int64_t vsync_timestamp_ns) {
+  frame_timing_.AddVsyncTimestamp(vsync_timestamp_ns);
+}
+
+int64_t HeadTracker::GetPredictedDisplayTime(int64_t timestamp_ns) const {
+  return frame_timing_.GetPredictedDisplayTime(timestamp_ns);
+}
+
+bool HeadTracker::GetCalibration(
+    CardboardHeadTrackerCalibration* calibration) const {
+  SensorFusionEkf::Calibration sensor_fusion_calibration;
+  if (!sensor_fusion_->GetCalibration(&sensor_fusion_calibration)) {
+    return false;
+  }
+  std::memset(calibration, 0, sizeof(*calibration));
+  sensor_id_.copy(calibration->sensor_id, sizeof(calibration->sensor_id) - 1);
+  for (int i = 0; i < 3; ++i) {
+    calibration->gyroscope_bias[i] =
+        static_cast<float>(sensor_fusion_calibration.gyroscope_bias[i]);
+  }
+  calibration->gyroscope_sample_interval_s =
+      static_cast<float>(sensor_fusion_calibration.gyroscope_timestep_s);
+  return true;
+}
+
+bool HeadTracker::SetCalibration(
+    const CardboardHeadTrackerCalibration& calibration) {
+  const std::string sensor_id(
+      calibration.sensor_id,
+      strnlen(calibration.sensor_id, sizeof(calibration.sensor_id)));
+  if (sensor_id != sensor_id_.substr(0, sizeof(calibration.sensor_id) - 1)) {
+    CARDBOARD_LOGI("Ignoring calibration estimated with other sensors.");
+    return false;
+  }
+  if (!(calibration.gyroscope_sample_interval_s > 0.f)) {
+    CARDBOARD_LOGE("Ignoring calibration with an invalid sample interval.");
+    return false;
+  }
+  sensor_fusion_->SetCalibration(
+      {Vector3(calibration.gyroscope_bias[0], calibration.gyroscope_bias[1],
+               calibration.gyroscope_bias[2]),
+       calibration.gyroscope_sample_interval_s});
+  return true;
+}
+
 void HeadTracker::RegisterCallbacks() {
   accel_sensor_->StartSensorPolling(&on_accel_callback_);
   gyro_sensor_->StartSensorPolling(&on_gyro_callback_);
@@ -190,6 +275,11 @@ void HeadTracker::UnregisterCallbacks() {
   gyro_sensor_->StopSensorPolling();
 }
 
+void HeadTracker::PauseCallbacks() {
+  accel_sensor_->PauseSensorPolling();
+  gyro_sensor_->PauseSensorPolling();
+}
+
 void HeadTracker::OnAccelerometerData(const AccelerometerData& event) {
   if (!is_tracking_) {
     return;
@@ -219,4 +309,16 @@ Rotation HeadTracker::GetRotation(
          EkfToHeadTrackerRotations()[viewport_orientation];
 }
 
+void HeadTracker::RotationToPose(const Rotation& rotation,
+                                 std::array<float, 3>& out_position,
+                                 std::array<float, 4>& out_orientation) {
+  const Vector4 orientation = rotation.GetQuaternion();
+  out_orientation[0] = static_cast<float>(orientation[0]);
+  out_orientation[1] = static_cast<float>(orientation[1]);
+  out_orientation[2] = static_cast<float>(orientation[2]);
+  out_orientation[3] = static_cast<float>(orientation[3]);
+
+  out_position = ApplyNeckModel(out_orientation, 1.0);
+}
+
 }  // namespace cardboard
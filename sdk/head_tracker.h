@@ -19,7 +19,9 @@
 #include <array>
 #include <memory>
 #include <mutex>  // NOLINT
+#include <string>
 
+#include "frame_timing.h"
 #include "include/cardboard.h"
 #include "sensors/accelerometer_data.h"
 #include "sensors/gyroscope_data.h"
@@ -49,9 +51,32 @@ class HeadTracker {
                std::array<float, 3>& out_position,
                std::array<float, 4>& out_orientation);
 
+  // Gets the predicted pose for a given timestamp in the viewport orientation
+  // of the latest call to the overload above, landscape left before the first
+  // one. It never changes the viewport orientation, so components other than
+  // the application (e.g. the asynchronous timewarp) can query poses without
+  // rotating the frame of reference of the application poses.
+  void GetPose(int64_t timestamp_ns, std::array<float, 3>& out_position,
+               std::array<float, 4>& out_orientation) const;
+
   // Recenters the head tracker.
   void Recenter();
 
+  // Adds the timestamp of a display vsync to the frame timing estimates.
+  void AddVsyncTimestamp(int64_t vsync_timestamp_ns);
+
+  // Gets the predicted time at which a frame whose rendering starts at
+  // @p timestamp_ns will be shown on the display.
+  int64_t GetPredictedDisplayTime(int64_t timestamp_ns) const;
+
+  // Gets the gyroscope calibration estimated so far. Returns false if the
+  // gyroscope bias has not converged yet.
+  bool GetCalibration(CardboardHeadTrackerCalibration* calibration) const;
+
+  // Seeds the sensor fusion with @p calibration. Returns false and ignores it
+  // when it was estimated with other sensors.
+  bool SetCalibration(const CardboardHeadTrackerCalibration& calibration);
+
  private:
   // Function called when receiving AccelerometerData.
   //
@@ -71,11 +96,20 @@ class HeadTracker {
   // This is useful for informing the sensors that they may be able to stop
   // polling for data.
   void UnregisterCallbacks();
+  // Disables the accel and gyro sensors while keeping their capture threads
+  // and event queues alive, so that RegisterCallbacks() re-enables them
+  // cheaply.
+  void PauseCallbacks();
 
   // Gets the predicted rotation for a given timestamp and viewport orientation.
   Rotation GetRotation(CardboardViewportOrientation viewport_orientation,
                        int64_t timestamp_ns) const;
 
+  // Converts a rotation returned by GetRotation() to a pose.
+  static void RotationToPose(const Rotation& rotation,
+                             std::array<float, 3>& out_position,
+                             std::array<float, 4>& out_orientation);
+
   std::atomic<bool> is_tracking_;
   // Sensor Fusion object that stores the internal state of the filter.
   std::unique_ptr<SensorFusionEkf> sensor_fusion_;
@@ -98,6 +132,15 @@ class HeadTracker {
   // Tells wheter the attribute viewport_orientation_ has been initialized or
   // not.
   bool is_viewport_orientation_initialized_;
+
+  // Guards viewport_orientation_ and is_viewport_orientation_initialized_.
+  mutable std::mutex viewport_orientation_mutex_;
+
+  // Display refresh period and phase estimates.
+  FrameTiming frame_timing_;
+
+  // Identifier of the device motion sensors, stored in calibrations.
+  const std::string sensor_id_;
 };
 
 }  // namespace cardboard
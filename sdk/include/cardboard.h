@@ -75,6 +75,21 @@ typedef enum CardboardSupportedOpenGlEsTextureType {
   kGlTextureExternalOes = 1,
 } CardboardSupportedOpenGlEsTextureType;
 
+/// Enum to describe how a distortion renderer initializes the color of the
+/// target rectangle before rendering the eyes.
+typedef enum CardboardDistortionRendererColorLoadOp {
+  /// The whole rectangle is cleared to opaque black.
+  kColorLoadOpClear = 0,
+  /// Only the pixels that are not covered by the distortion meshes, i.e. the
+  /// vignette, are cleared to opaque black. The previous color of the covered
+  /// pixels is not needed, so it does not have to be loaded. When the meshes
+  /// cover the whole rectangle, nothing is cleared.
+  kColorLoadOpClearVignette = 1,
+  /// The previous color of the rectangle is preserved. The vignette keeps the
+  /// previous color.
+  kColorLoadOpLoad = 2,
+} CardboardDistortionRendererColorLoadOp;
+
 /// Struct representing a 3D mesh with 3D vertices and corresponding UV
 /// coordinates.
 typedef struct CardboardMesh {
@@ -90,7 +105,26 @@ typedef struct CardboardMesh {
   int n_vertices;
 } CardboardMesh;
 
-/// Struct to hold information about an eye texture.
+/// Struct representing a distortion mesh that corrects the lateral chromatic
+/// aberration of the lenses, i.e. whose color channels are sampled at their
+/// own UV coordinates.
+typedef struct CardboardChromaticMesh {
+  /// Distortion mesh. Its UV coordinates are the ones of the green and alpha
+  /// channels.
+  CardboardMesh mesh;
+  /// UV coordinates buffer of the red channel, or null. 2 floats per uv: u,
+  /// v. It is null when the lenses of the viewer have no chromatic aberration
+  /// correction, in which case all the color channels are sampled at
+  /// @c mesh.uvs.
+  float* red_uvs;
+  /// UV coordinates buffer of the blue channel, or null. 2 floats per uv: u,
+  /// v. It is null if and only if @c red_uvs is null.
+  float* blue_uvs;
+} CardboardChromaticMesh;
+
+/// Struct to hold information about an eye texture. The texture coordinates
+/// are clamped to the rectangle given by @c left_u, @c right_u, @c top_v and
+/// @c bottom_v, also when the reprojection moves them past it.
 typedef struct CardboardEyeTextureDescription {
   /// The texture with eye pixels.
   ///
@@ -126,6 +160,9 @@ typedef struct CardboardEyeTextureDescription {
   /// CardboardDistortionRenderer_renderEyeToDisplay(..., &leftEye, ...);
   /// CFBridgingRelease(leftEye.texture);
   /// @endcode
+  ///
+  /// When using the CPU distortion renderer, this field corresponds to an
+  /// uint64_t address pointing to a @c CardboardCpuImage variable.
   uint64_t texture;
   /// u coordinate of the left side of the eye.
   float left_u;
@@ -192,6 +229,37 @@ typedef struct CardboardVulkanDistortionRendererConfig {
   uint64_t vk_swapchain;
 } CardboardVulkanDistortionRendererConfig;
 
+/// Struct to set the options of a Vulkan distortion renderer created with
+/// @c ::CardboardVulkanDistortionRenderer_createWithOptions.
+typedef struct CardboardVulkanDistortionRendererOptions {
+  /// When non-zero, the distortion pass of each swapchain image is recorded
+  /// into a secondary command buffer owned by the renderer and executed with
+  /// vkCmdExecuteCommands() into the target command buffer. The secondary
+  /// command buffer is only recorded again when the eye textures, the
+  /// rectangle, the mesh, the pass configuration or the render pass change.
+  /// The texture coordinates and the reprojection are written to a uniform
+  /// buffer of the swapchain image instead. The render pass that contains
+  /// the distortion pass must then be begun with
+  /// VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS. Image views of the eye
+  /// textures are kept as long as their VkImage handle is passed, so an eye
+  /// texture image must not be destroyed while it is in use.
+  int use_secondary_command_buffers;
+  /// Index of the queue family the command buffers are submitted to. Only
+  /// used when @c use_secondary_command_buffers is non-zero.
+  uint32_t queue_family_index;
+  /// Maximum number of command buffers recorded by
+  /// @c ::CardboardDistortionRenderer_renderEyeToDisplay that may be pending
+  /// execution. The uniform buffers, descriptor sets and secondary command
+  /// buffers of the renderer are then used in turn by the calls, and the
+  /// command buffer recorded @c max_frames_in_flight calls earlier must have
+  /// completed, e.g. by waiting on the fence of its submission, before each
+  /// call. When zero, they belong to the swapchain image, and the previous
+  /// command buffer recorded for the same swapchain image index must have
+  /// completed before each call. vkAcquireNextImageKHR() does not guarantee
+  /// it by itself.
+  uint32_t max_frames_in_flight;
+} CardboardVulkanDistortionRendererOptions;
+
 /// Struct to set Metal distortion renderer target configuration.
 typedef struct CardboardMetalDistortionRendererTargetConfig {
   /// MTLRenderCommandEncoder id.
@@ -236,6 +304,169 @@ typedef struct CardboardVulkanDistortionRendererTarget {
   uint32_t swapchain_image_index;
 } CardboardVulkanDistortionRendererTarget;
 
+/// Struct to control how a distortion renderer loads and stores the
+/// attachments of its target. Skipping loads and stores that are not needed
+/// saves memory bandwidth on tile based GPUs.
+typedef struct CardboardDistortionRendererPassConfig {
+  /// How the color of the target rectangle is initialized.
+  CardboardDistortionRendererColorLoadOp color_load_op;
+  /// When non-zero, the depth and stencil contents of the target are
+  /// discarded instead of cleared: the distortion pass does not use them, so
+  /// they are neither loaded nor stored. The target depth and stencil contents
+  /// are undefined after the pass. Depth testing is disabled while rendering
+  /// the distortion meshes.
+  int discard_depth_stencil;
+  /// Vulkan only. When it is not VK_FORMAT_UNDEFINED, the distortion renderer
+  /// owns the render pass: it begins and ends a render pass whose only
+  /// attachment is the swapchain image, loaded as set by @c color_load_op, so
+  /// no depth or stencil contents are ever loaded nor stored. The command
+  /// buffer must then be outside of a render pass when rendering and
+  /// @c vk_render_pass of the target is ignored. The swapchain image is left
+  /// in the VK_IMAGE_LAYOUT_PRESENT_SRC_KHR layout. With @c kColorLoadOpLoad,
+  /// it must be in the VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL layout before
+  /// rendering.
+  /// This field holds a [VkFormat
+  /// value](https://www.khronos.org/registry/vulkan/specs/1.2-extensions/man/html/VkFormat.html)
+  /// that must match the format of the swapchain images.
+  int vk_swapchain_image_format;
+} CardboardDistortionRendererPassConfig;
+
+/// Struct to describe an image in CPU memory, used by the CPU distortion
+/// renderer. Pixels are RGBA with 8 bits per channel.
+typedef struct CardboardCpuImage {
+  /// Pixel buffer. As in OpenGL, it points to the bottom row of the image.
+  uint8_t* pixels;
+  /// Width in pixels.
+  int width;
+  /// Height in pixels.
+  int height;
+  /// Distance in bytes from a row to the row above. It may be negative, e.g.
+  /// to describe an image stored top row first by pointing @c pixels to its
+  /// last row.
+  int stride;
+} CardboardCpuImage;
+
+/// Struct to set CPU distortion renderer configuration.
+typedef struct CardboardCpuDistortionRendererConfig {
+  /// Number of threads the distortion pass is split across. Zero uses one
+  /// thread per CPU core. The calling thread is one of them; the others are
+  /// started by CardboardCpuDistortionRenderer_create() and kept until the
+  /// renderer is destroyed.
+  int thread_count;
+} CardboardCpuDistortionRendererConfig;
+
+/// Struct to configure an asynchronous timewarp object. All callbacks are
+/// invoked from the timewarp thread.
+typedef struct CardboardAsyncTimewarpConfig {
+  /// x coordinate of the display rectangle's lower left corner in pixels.
+  int x;
+  /// y coordinate of the display rectangle's lower left corner in pixels.
+  int y;
+  /// Size in pixels of the display rectangle's width.
+  int width;
+  /// Size in pixels of the display rectangle's height.
+  int height;
+  /// Time in nanoseconds from the start of a distortion pass until it is
+  /// shown on the display. The head pose is predicted that far ahead.
+  int64_t prediction_time_ns;
+  /// Opaque pointer passed back to every callback.
+  void* user_data;
+  /// Called once when the timewarp thread starts, e.g. to make a graphics
+  /// context current on it. May be null.
+  void (*on_thread_start)(void* user_data);
+  /// Called before every distortion pass. It must set @p target as described
+  /// in CardboardDistortionRenderer_renderEyeToDisplay() and return a non-zero
+  /// value, or return zero to skip the pass (e.g. while the surface is not
+  /// available). Must not be null.
+  int (*begin_frame)(void* user_data, uint64_t* target);
+  /// Called after every distortion pass to present it, e.g. with
+  /// eglSwapBuffers(). Presenting is expected to block until the next vsync,
+  /// which is what paces the timewarp thread. Must not be null.
+  void (*end_frame)(void* user_data);
+  /// Called once right before the timewarp thread exits, e.g. to release the
+  /// graphics context. May be null.
+  void (*on_thread_stop)(void* user_data);
+} CardboardAsyncTimewarpConfig;
+
+/// Struct to configure an eye buffer reuse object.
+typedef struct CardboardEyeBufferReuseConfig {
+  /// x coordinate of the display rectangle's lower left corner in pixels.
+  int x;
+  /// y coordinate of the display rectangle's lower left corner in pixels.
+  int y;
+  /// Size in pixels of the display rectangle's width.
+  int width;
+  /// Size in pixels of the display rectangle's height.
+  int height;
+  /// Largest head rotation, in radians, between the orientation the eye
+  /// textures were rendered with and the current one for which they are still
+  /// reused. Reprojection leaves the borders of the view without content and
+  /// cannot correct parallax, so larger rotations call for a new frame.
+  float max_reprojection_angle;
+} CardboardEyeBufferReuseConfig;
+
+/// Distribution of the durations of an operation. Percentiles are estimated
+/// from a histogram with a relative error below 12.5%.
+typedef struct CardboardStatsLatency {
+  /// Number of recorded durations.
+  int64_t count;
+  /// Median duration in microseconds.
+  float p50_us;
+  /// 90th percentile duration in microseconds.
+  float p90_us;
+  /// 99th percentile duration in microseconds.
+  float p99_us;
+  /// Maximum duration in microseconds.
+  float max_us;
+} CardboardStatsLatency;
+
+/// Runtime performance statistics, collected since they were enabled or last
+/// reset.
+typedef struct CardboardStats {
+  /// Gyroscope sample rate in Hz, estimated from the median sample interval.
+  /// Zero when unknown.
+  float gyroscope_sample_rate_hz;
+  /// Difference in microseconds between the 99th percentile and the median of
+  /// the gyroscope sample intervals.
+  float gyroscope_jitter_us;
+  /// Accelerometer sample rate in Hz, estimated from the median sample
+  /// interval. Zero when unknown.
+  float accelerometer_sample_rate_hz;
+  /// Difference in microseconds between the 99th percentile and the median of
+  /// the accelerometer sample intervals.
+  float accelerometer_jitter_us;
+  /// Gyroscope sample intervals.
+  CardboardStatsLatency gyroscope_interval;
+  /// Accelerometer sample intervals.
+  CardboardStatsLatency accelerometer_interval;
+  /// Number of sensor samples discarded because they were older than the last
+  /// processed one or arrived while the head tracker was being recentered.
+  int64_t dropped_sample_count;
+  /// Number of gyroscope samples that arrived too late after the previous one.
+  /// The estimated sample interval is integrated for them instead.
+  int64_t late_gyroscope_sample_count;
+  /// Time spent waiting for the sensor fusion state to be available.
+  CardboardStatsLatency sensor_fusion_lock_wait;
+  /// CPU time spent in CardboardHeadTracker_getPose().
+  CardboardStatsLatency get_pose;
+  /// CPU time spent in CardboardDistortionRenderer_renderEyeToDisplay().
+  CardboardStatsLatency distortion_pass;
+  /// Non-zero when the gyroscope bias estimate has converged.
+  int gyroscope_bias_converged;
+} CardboardStats;
+
+/// Gyroscope calibration estimated by a head tracker. It lets later sessions
+/// start tracking without drifting while the gyroscope bias converges.
+typedef struct CardboardHeadTrackerCalibration {
+  /// Null terminated identifier of the motion sensors the calibration was
+  /// estimated with. A calibration is only applied to the same sensors.
+  char sensor_id[64];
+  /// Gyroscope bias in radians per second around the x, y and z sensor axes.
+  float gyroscope_bias[3];
+  /// Mean time between gyroscope samples in seconds.
+  float gyroscope_sample_interval_s;
+} CardboardHeadTrackerCalibration;
+
 /// An opaque Lens Distortion object.
 typedef struct CardboardLensDistortion CardboardLensDistortion;
 
@@ -245,6 +476,15 @@ typedef struct CardboardDistortionRenderer CardboardDistortionRenderer;
 /// An opaque Head Tracker object.
 typedef struct CardboardHeadTracker CardboardHeadTracker;
 
+/// An opaque Asynchronous Timewarp object.
+typedef struct CardboardAsyncTimewarp CardboardAsyncTimewarp;
+
+/// An opaque Eye Buffer Reuse object.
+typedef struct CardboardEyeBufferReuse CardboardEyeBufferReuse;
+
+/// An opaque reference to immutable device parameters.
+typedef struct CardboardDeviceParams CardboardDeviceParams;
+
 /// @}
 
 #ifdef __cplusplus
@@ -323,6 +563,24 @@ CardboardLensDistortion* CardboardLensDistortion_create(
     const uint8_t* encoded_device_params, int size, int display_width,
     int display_height);
 
+/// Creates a new lens distortion object from device parameters acquired with
+/// @c ::CardboardQrCode_acquireSavedDeviceParams.
+///
+/// @details Unlike @c ::CardboardLensDistortion_create, the device parameters
+///          are not parsed again.
+///
+/// @pre @p device_params Must not be null.
+/// When it is unmet, a call to this function results in a no-op and returns a
+/// @c nullptr.
+///
+/// @param[in]      device_params           Device parameters.
+/// @param[in]      display_width           Size in pixels of display width.
+/// @param[in]      display_height          Size in pixels of display height.
+/// @return         Lens distortion object pointer.
+CardboardLensDistortion* CardboardLensDistortion_createFromDeviceParams(
+    const CardboardDeviceParams* device_params, int display_width,
+    int display_height);
+
 /// Destroys and releases memory used by the provided lens distortion object.
 ///
 /// @pre @p lens_distortion Must not be null.
@@ -394,6 +652,27 @@ void CardboardLensDistortion_getDistortionMesh(
     CardboardLensDistortion* lens_distortion, CardboardEye eye,
     CardboardMesh* mesh);
 
+/// Gets the distortion mesh for a particular eye along with the UV coordinates
+/// of the red and blue channels, which correct the lateral chromatic
+/// aberration of the lenses. They are null when the viewer has no chromatic
+/// aberration correction. @c mesh is the one returned by
+/// @c ::CardboardLensDistortion_getDistortionMesh.
+///
+/// @pre @p lens_distortion Must not be null.
+/// @pre @p mesh Must not be null.
+/// When it is unmet, a call to this function results in a no-op and a default
+/// value is returned (empty values).
+///
+/// Important: The distorsion mesh that is returned by this function becomes
+/// invalid if CardboardLensDistortion is destroyed.
+///
+/// @param[in]      lens_distortion         Lens distortion object pointer.
+/// @param[in]      eye                     Desired eye.
+/// @param[out]     mesh                    Distortion mesh.
+void CardboardLensDistortion_getChromaticDistortionMesh(
+    CardboardLensDistortion* lens_distortion, CardboardEye eye,
+    CardboardChromaticMesh* mesh);
+
 /// Applies lens inverse distortion function to a point normalized [0,1] in
 /// pre-distortion (eye texture) space.
 ///
@@ -426,6 +705,72 @@ CardboardUv CardboardLensDistortion_undistortedUvForDistortedUv(
 CardboardUv CardboardLensDistortion_distortedUvForUndistortedUv(
     CardboardLensDistortion* lens_distortion, const CardboardUv* undistorted_uv,
     CardboardEye eye);
+
+/// Gets the rotational reprojection (a.k.a. rotational timewarp) that
+/// compensates the head rotation between the pose an eye texture was rendered
+/// with and a more recent pose queried right before distortion.
+///
+/// @details        The reprojection is a 3x3 homogeneous transformation in
+///                 column-major order that maps eye texture coordinates
+///                 (normalized [0,1] pre distort space) seen from
+///                 @p display_orientation into eye texture coordinates of the
+///                 texture rendered with @p render_orientation. It is meant to
+///                 be passed to @c ::CardboardDistortionRenderer_setReprojection.
+///
+/// @pre @p lens_distortion Must not be null.
+/// @pre @p render_orientation Must not be null.
+/// @pre @p display_orientation Must not be null.
+/// @pre @p reprojection Must not be null.
+/// When it is unmet, a call to this function results in a no-op and a default
+/// value is returned (identity matrix).
+///
+/// @param[in]      lens_distortion         Lens distortion object pointer.
+/// @param[in]      eye                     Desired eye.
+/// @param[in]      render_orientation      4 floats for the quaternion
+///                                         returned by
+///                                         @c ::CardboardHeadTracker_getPose
+///                                         used to render the eye texture.
+/// @param[in]      display_orientation     4 floats for the quaternion
+///                                         returned by
+///                                         @c ::CardboardHeadTracker_getPose
+///                                         right before distortion.
+/// @param[out]     reprojection            3x3 float reprojection matrix.
+void CardboardLensDistortion_getRotationalReprojection(
+    CardboardLensDistortion* lens_distortion, CardboardEye eye,
+    const float* render_orientation, const float* display_orientation,
+    float* reprojection);
+
+/// Gets the recommended eye texture size for the display rectangle the lens
+/// distortion object was created with.
+///
+/// @details The lens magnifies the periphery of the eye textures, so the
+///          texel density the display can actually resolve varies across the
+///          texture. It peaks in a small region around the lens center.
+///          The returned size is the smallest one whose texel density
+///          matches the display pixel density over 90% of the visible
+///          texture area, which is usually smaller than half the display
+///          rectangle. The densest tenth, around the lens center, is slightly
+///          undersampled rather than oversampling the whole texture for it.
+///          The returned size never exceeds half the display rectangle, so
+///          adopting it never renders more pixels than eye textures of half
+///          the display.
+///
+/// @pre @p lens_distortion Must not be null.
+/// @pre @p width Must not be null.
+/// @pre @p height Must not be null.
+/// When it is unmet, a call to this function results in a no-op and zero
+/// values are returned.
+///
+/// @param[in]      lens_distortion         Lens distortion object pointer.
+/// @param[in]      eye                     Desired eye.
+/// @param[out]     width                   Recommended eye texture width in
+///                                         pixels.
+/// @param[out]     height                  Recommended eye texture height in
+///                                         pixels.
+void CardboardLensDistortion_getRecommendedEyeTextureSize(
+    CardboardLensDistortion* lens_distortion, CardboardEye eye, int* width,
+    int* height);
+
 /// @}
 
 /////////////////////////////////////////////////////////////////////////////
@@ -454,6 +799,55 @@ CardboardOpenGlEs2DistortionRenderer_create(
 CardboardDistortionRenderer* CardboardOpenGlEs3DistortionRenderer_create(
     const CardboardOpenGlEsDistortionRendererConfig* config);
 
+/// Compiles ahead of time the shader programs used by the OpenGL ES 2.0
+/// distortion renderers created with @p config, so that
+/// @c ::CardboardOpenGlEs2DistortionRenderer_create and the first
+/// @c ::CardboardDistortionRenderer_setChromaticMesh call with a chromatic
+/// aberration corrected mesh do not compile them on the render thread. Must be
+/// called with an OpenGL ES context current, e.g. a context shared with the
+/// render thread one, at app startup.
+///
+/// @details        The program binaries are kept in memory for the lifetime of
+///                 the process and, if a directory was set with
+///                 @c ::CardboardOpenGlEsDistortionRenderer_setProgramCacheDirectory,
+///                 stored on disk for later launches. Binaries are keyed by
+///                 the GL vendor, renderer and version strings, so they are
+///                 rebuilt after a driver update. Without program binary
+///                 support (OpenGL ES 3.0 or GL_OES_get_program_binary) this
+///                 function does nothing. Program binaries are not used on
+///                 iOS.
+///
+/// @pre @p config Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      config                  Distortion renderer configuration.
+void CardboardOpenGlEs2DistortionRenderer_prewarm(
+    const CardboardOpenGlEsDistortionRendererConfig* config);
+
+/// Compiles ahead of time the shader programs used by the OpenGL ES 3.0
+/// distortion renderers created with @p config. See
+/// @c ::CardboardOpenGlEs2DistortionRenderer_prewarm.
+///
+/// @pre @p config Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      config                  Distortion renderer configuration.
+void CardboardOpenGlEs3DistortionRenderer_prewarm(
+    const CardboardOpenGlEsDistortionRendererConfig* config);
+
+/// Sets the directory where the OpenGL ES distortion renderers store their
+/// shader program binaries across launches, e.g. the path returned by
+/// @c Context.getCacheDir() on Android. The directory must exist. By default
+/// program binaries are only kept in memory.
+///
+/// @pre @p directory Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      directory               Writable directory path. An empty
+///                                         path disables the disk cache.
+void CardboardOpenGlEsDistortionRenderer_setProgramCacheDirectory(
+    const char* directory);
+
 /// Creates a new distortion renderer object. It uses Metal as the rendering
 /// API. Must be called from the render thread.
 ///
@@ -465,11 +859,62 @@ CardboardDistortionRenderer* CardboardMetalDistortionRenderer_create(
 /// Creates a new distortion renderer object. It uses Vulkan as the rendering
 /// API. Must be called from the render thread.
 ///
+/// @details        @c ::CardboardDistortionRenderer_renderEyeToDisplay may be
+///                 called concurrently from several threads as long as each
+///                 call uses a different swapchain image index and command
+///                 buffer. For instance, frame N + 1 may be recorded on a
+///                 worker thread while frame N is submitted. Other
+///                 distortion renderer functions must not run concurrently
+///                 with it. The previous command buffer recorded for a
+///                 swapchain image index must have completed before it is
+///                 used again.
+///
 /// @param[in]      config                  Distortion renderer configuration.
 /// @return         Distortion renderer object pointer
 CardboardDistortionRenderer* CardboardVulkanDistortionRenderer_create(
     const CardboardVulkanDistortionRendererConfig* config);
 
+/// Creates a new distortion renderer object that uses Vulkan as the rendering
+/// API, as @c ::CardboardVulkanDistortionRenderer_create does, with the given
+/// options. Must be called from the render thread.
+///
+/// @pre @p config Must not be null.
+/// @pre @p options Must not be null.
+/// When it is unmet, a call to this function results in a no-op and returns a
+/// nullptr.
+///
+/// @param[in]      config                  Distortion renderer configuration.
+/// @param[in]      options                 Distortion renderer options.
+/// @return         Distortion renderer object pointer
+CardboardDistortionRenderer*
+CardboardVulkanDistortionRenderer_createWithOptions(
+    const CardboardVulkanDistortionRendererConfig* config,
+    const CardboardVulkanDistortionRendererOptions* options);
+
+/// Creates a new distortion renderer object that runs on the CPU. It renders
+/// eye images in memory into a display image in memory, e.g. to capture
+/// distorted screenshots and videos without reading back GPU memory, and
+/// serves as a reference for the other renderers. Unlike the other renderers,
+/// it is not tied to a render thread.
+///
+/// @details        Each distortion mesh is rasterized once per display
+///                 rectangle size into a map of eye texture coordinates. Each
+///                 @c ::CardboardDistortionRenderer_renderEyeToDisplay call
+///                 then applies the reprojection to the map, clamps the
+///                 coordinates to the eye texture rectangle and samples the
+///                 eye images bilinearly, like the GPU renderers. The display
+///                 rectangle is split in bands of rows rendered concurrently.
+///                 Pixels that no mesh covers are cleared to opaque black
+///                 unless the color load operation is @c kColorLoadOpLoad.
+///
+/// @pre @p config Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      config                  Distortion renderer configuration.
+/// @return         Distortion renderer object pointer
+CardboardDistortionRenderer* CardboardCpuDistortionRenderer_create(
+    const CardboardCpuDistortionRendererConfig* config);
+
 /// Destroys and releases memory used by the provided distortion renderer
 /// object. Must be called from render thread.
 ///
@@ -493,6 +938,82 @@ void CardboardDistortionRenderer_setMesh(CardboardDistortionRenderer* renderer,
                                          const CardboardMesh* mesh,
                                          CardboardEye eye);
 
+/// Sets the distortion Mesh for a particular eye, sampling each color channel
+/// at its own UV coordinates to correct the lateral chromatic aberration of
+/// the lenses. When @p mesh has no red and blue UV coordinates, it is the same
+/// as @c ::CardboardDistortionRenderer_setMesh with @c mesh->mesh. Must be
+/// called from render thread.
+///
+/// @pre @p renderer Must not be null.
+/// @pre @p mesh Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      renderer                Distortion renderer object pointer.
+/// @param[in]      mesh                    Distortion mesh, as returned by
+///                 @c ::CardboardLensDistortion_getChromaticDistortionMesh.
+/// @param[in]      eye                     Desired eye.
+void CardboardDistortionRenderer_setChromaticMesh(
+    CardboardDistortionRenderer* renderer, const CardboardChromaticMesh* mesh,
+    CardboardEye eye);
+
+/// Sets the reprojection applied to the eye texture coordinates of a
+/// particular eye before sampling it. It is used to late-latch the head pose:
+/// see @c ::CardboardLensDistortion_getRotationalReprojection. Must be called
+/// from render thread.
+///
+/// @details        The reprojection remains in use for subsequent
+///                 @c ::CardboardDistortionRenderer_renderEyeToDisplay calls
+///                 until it is set again. By default no reprojection is
+///                 applied.
+///
+/// @pre @p renderer Must not be null.
+/// @pre @p reprojection Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      renderer                Distortion renderer object pointer.
+/// @param[in]      reprojection            3x3 float reprojection matrix in
+///                                         column-major order.
+/// @param[in]      eye                     Desired eye.
+void CardboardDistortionRenderer_setReprojection(
+    CardboardDistortionRenderer* renderer, const float* reprojection,
+    CardboardEye eye);
+
+/// Sets how the attachments of the target are loaded and stored by subsequent
+/// @c ::CardboardDistortionRenderer_renderEyeToDisplay calls. Must be called
+/// from render thread.
+///
+/// @details        By default, the whole target rectangle is cleared, as well
+///                 as the depth buffer on OpenGL ES. Backends apply the
+///                 configuration as follows:
+///
+///     * OpenGL ES 3.x: the color contents of the rectangle are invalidated
+///       with glInvalidateSubFramebuffer() before the vignette is cleared, and
+///       the depth and stencil contents are invalidated before and after the
+///       pass.
+///     * OpenGL ES 2.x: only the vignette is cleared. The depth and stencil
+///       contents are discarded with GL_EXT_discard_framebuffer when
+///       available.
+///     * Vulkan: the vignette is cleared with vkCmdClearAttachments(). When
+///       the application render pass is used, its load and store operations
+///       stay in effect: @c kColorLoadOpClear and @c kColorLoadOpLoad have no
+///       effect and @c discard_depth_stencil only disables the depth test.
+///     * Metal: the load and store actions are those of the render pass
+///       descriptor of the application encoder, so the configuration has no
+///       effect.
+///     * CPU: the covered pixels are always written, so the color load
+///       operation only decides whether the vignette is cleared. There is no
+///       depth nor stencil.
+///
+/// @pre @p renderer Must not be null.
+/// @pre @p pass_config Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      renderer                Distortion renderer object pointer.
+/// @param[in]      pass_config             Load and store configuration.
+void CardboardDistortionRenderer_setPassConfig(
+    CardboardDistortionRenderer* renderer,
+    const CardboardDistortionRendererPassConfig* pass_config);
+
 /// Renders eye textures to a rectangle in the display. Must be called from
 /// render thread.
 ///
@@ -511,6 +1032,7 @@ void CardboardDistortionRenderer_setMesh(CardboardDistortionRenderer* renderer,
 ///     * OpenGL ES 2.x or 3.x: @c GLuint.
 ///     * Metal: @c CardboardMetalDistortionRendererTargetConfig*.
 ///     * Vulkan: @c CardboardVulkanDistortionRendererTarget*.
+///     * CPU: @c CardboardCpuImage*.
 /// @param[in]      x                       x coordinate of the rectangle's
 ///                                         lower left corner in pixels.
 /// @param[in]      y                       y coordinate of the rectangle's
@@ -577,6 +1099,11 @@ void CardboardHeadTracker_destroy(CardboardHeadTracker* head_tracker);
 
 /// Pauses head tracker and underlying device sensors.
 ///
+/// @details        The sensors are disabled but, on Android, their capture
+///                 threads and event queues are kept, so
+///                 @c ::CardboardHeadTracker_resume only re-enables them. The
+///                 sensor fusion state is preserved while paused.
+///
 /// @pre @p head_tracker Must not be null.
 /// When it is unmet, a call to this function results in a no-op.
 ///
@@ -630,6 +1157,288 @@ void CardboardHeadTracker_getPose(
 /// @param[in]      head_tracker            Head tracker object pointer.
 void CardboardHeadTracker_recenter(CardboardHeadTracker* head_tracker);
 
+/// Adds the timestamp of a display vsync. The head tracker uses them to
+/// estimate the display refresh period and phase, which are needed to predict
+/// when a frame is going to be displayed.
+///
+/// @details Timestamps must be in the same clock as the ones passed to
+///          CardboardHeadTracker_getPose(). On Android, vsync timestamps
+///          reported by
+///          [Choreographer](https://developer.android.com/reference/android/view/Choreographer.FrameCallback)
+///          are in CLOCK_MONOTONIC and must be offset by the difference
+///          between CLOCK_BOOTTIME and CLOCK_MONOTONIC. On iOS,
+///          [CADisplayLink](https://developer.apple.com/documentation/quartzcore/cadisplaylink/1621257-timestamp)
+///          timestamps converted to nanoseconds can be used directly.
+///          Missed vsyncs are tolerated. This function can be called from any
+///          thread.
+///
+/// @pre @p head_tracker Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      head_tracker            Head tracker object pointer.
+/// @param[in]      vsync_timestamp_ns      The vsync timestamp in nanoseconds.
+void CardboardHeadTracker_addVsyncTimestamp(CardboardHeadTracker* head_tracker,
+                                            int64_t vsync_timestamp_ns);
+
+/// Gets the predicted time at which a frame whose rendering starts now will be
+/// shown on the display. It is meant to be passed to
+/// CardboardHeadTracker_getPose().
+///
+/// @details The prediction is aligned to the estimated display vsyncs. Until
+///          enough vsync timestamps have been added with
+///          CardboardHeadTracker_addVsyncTimestamp(), the current time plus a
+///          fixed offset is returned instead. The returned time is in the
+///          clock described in CardboardHeadTracker_getPose().
+///
+/// @pre @p head_tracker Must not be null.
+/// When it is unmet, a call to this function results in a no-op and zero is
+/// returned.
+///
+/// @param[in]      head_tracker            Head tracker object pointer.
+///
+/// @return         The predicted display time in nanoseconds.
+int64_t CardboardHeadTracker_getPredictedDisplayTime(
+    CardboardHeadTracker* head_tracker);
+
+/// Gets the gyroscope calibration estimated by the head tracker.
+///
+/// @details The gyroscope bias is estimated while the device is static. The
+///          head tracker saves its calibration when it is paused and starts
+///          from the saved one when it is resumed, so this function is only
+///          needed to store calibrations elsewhere.
+///
+/// @pre @p head_tracker Must not be null.
+/// @pre @p calibration Must not be null.
+/// When it is unmet, a call to this function results in a no-op and zero is
+/// returned.
+///
+/// @param[in]      head_tracker            Head tracker object pointer.
+/// @param[out]     calibration             Gyroscope calibration.
+///
+/// @return         Non-zero if @p calibration was filled, zero if the
+///                 gyroscope bias has not converged yet.
+int CardboardHeadTracker_getCalibration(
+    CardboardHeadTracker* head_tracker,
+    CardboardHeadTrackerCalibration* calibration);
+
+/// Seeds the head tracker with a gyroscope calibration, e.g. retrieved with
+/// CardboardHeadTracker_getCalibration() in a previous session. The head
+/// tracker keeps refining it while the device is static.
+///
+/// @pre @p head_tracker Must not be null.
+/// @pre @p calibration Must not be null.
+/// When it is unmet, a call to this function results in a no-op and zero is
+/// returned.
+///
+/// @param[in]      head_tracker            Head tracker object pointer.
+/// @param[in]      calibration             Gyroscope calibration.
+///
+/// @return         Non-zero if the calibration was applied, zero if it was
+///                 estimated with other sensors.
+int CardboardHeadTracker_setCalibration(
+    CardboardHeadTracker* head_tracker,
+    const CardboardHeadTrackerCalibration* calibration);
+
+/// @}
+
+/////////////////////////////////////////////////////////////////////////////
+// Asynchronous Timewarp
+/////////////////////////////////////////////////////////////////////////////
+/// @defgroup async-timewarp Asynchronous Timewarp
+/// @brief This module decouples the application rendering from the display
+///     refresh. A dedicated high priority thread runs the distortion pass at
+///     display rate. Each pass takes the most recently submitted eye textures
+///     and rotationally reprojects them from the head orientation they were
+///     rendered with to the latest predicted head orientation, so head motion
+///     stays smooth when the application misses a frame.
+///
+/// @details The application keeps ownership of the display surface and the
+///          graphics context, and hands them to the timewarp thread through
+///          the callbacks in CardboardAsyncTimewarpConfig. Neither the
+///          distortion renderer nor the display surface may be used from other
+///          threads while the timewarp object exists. With OpenGL ES, the eye
+///          textures and the distortion renderer must be visible to the
+///          timewarp thread context, i.e. both contexts must share objects.
+///          The timewarp thread predicts the head pose in the viewport
+///          orientation of the latest CardboardHeadTracker_getPose() call and
+///          never changes it, so it always matches the eye textures.
+/// @{
+
+/// Creates an asynchronous timewarp object and starts its thread.
+///
+/// @pre @p head_tracker Must not be null.
+/// @pre @p lens_distortion Must not be null.
+/// @pre @p renderer Must not be null.
+/// @pre @p config Must not be null.
+/// @pre @p config->begin_frame Must not be null.
+/// @pre @p config->end_frame Must not be null.
+/// When it is unmet, a call to this function results in a no-op and returns a
+/// nullptr.
+///
+/// @param[in]      head_tracker            Head tracker object pointer. It
+///                                         must outlive the timewarp object.
+/// @param[in]      lens_distortion         Lens distortion object pointer. It
+///                                         must outlive the timewarp object.
+/// @param[in]      renderer                Distortion renderer object pointer.
+///                                         It must outlive the timewarp object.
+/// @param[in]      config                  Timewarp configuration.
+///
+/// @return         Asynchronous timewarp object pointer.
+CardboardAsyncTimewarp* CardboardAsyncTimewarp_create(
+    CardboardHeadTracker* head_tracker,
+    CardboardLensDistortion* lens_distortion,
+    CardboardDistortionRenderer* renderer,
+    const CardboardAsyncTimewarpConfig* config);
+
+/// Stops the timewarp thread and releases the memory used by the provided
+/// asynchronous timewarp object.
+///
+/// @pre @p timewarp Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      timewarp                Asynchronous timewarp object pointer.
+void CardboardAsyncTimewarp_destroy(CardboardAsyncTimewarp* timewarp);
+
+/// Submits a pair of eye textures to be displayed. They are shown, and
+/// reprojected, until a newer pair is submitted.
+///
+/// @details The GPU work that renders the eye textures must be complete (e.g.
+///          by waiting on a fence) before calling this function, and the
+///          textures must not be rendered to again until a newer pair is
+///          submitted.
+///
+/// @pre @p timewarp Must not be null.
+/// @pre @p left_eye Must not be null.
+/// @pre @p right_eye Must not be null.
+/// @pre @p render_orientation Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      timewarp                Asynchronous timewarp object pointer.
+/// @param[in]      left_eye                Left eye texture description.
+/// @param[in]      right_eye               Right eye texture description.
+/// @param[in]      render_orientation      4 floats for the head orientation
+///                                         quaternion, as returned by
+///                                         CardboardHeadTracker_getPose(), the
+///                                         eye textures were rendered with.
+void CardboardAsyncTimewarp_submitFrame(
+    CardboardAsyncTimewarp* timewarp,
+    const CardboardEyeTextureDescription* left_eye,
+    const CardboardEyeTextureDescription* right_eye,
+    const float* render_orientation);
+
+/// @}
+
+/////////////////////////////////////////////////////////////////////////////
+// Eye Buffer Reuse
+/////////////////////////////////////////////////////////////////////////////
+/// @defgroup eye-buffer-reuse Eye Buffer Reuse
+/// @brief This module lets the application skip rendering the eye textures on
+///     some frames, e.g. rendering at half the display rate or only when the
+///     scene changes. The last submitted eye textures are displayed again,
+///     rotationally reprojected from the head orientation they were rendered
+///     with to the current predicted head orientation.
+///
+/// @details Everything runs on the application render thread: every display
+///          frame, the application either renders and submits new eye
+///          textures, or skips rendering them, and then calls
+///          CardboardEyeBufferReuse_renderEyeToDisplay() instead of
+///          CardboardDistortionRenderer_renderEyeToDisplay(). The eye
+///          textures must not be rendered to again until a newer pair is
+///          submitted. The reprojection set with
+///          CardboardDistortionRenderer_setReprojection() is overridden.
+///          The current head pose is predicted in the viewport orientation of
+///          the latest CardboardHeadTracker_getPose() call, which is never
+///          changed, so it always matches the eye textures.
+/// @{
+
+/// Creates an eye buffer reuse object.
+///
+/// @pre @p head_tracker Must not be null.
+/// @pre @p lens_distortion Must not be null.
+/// @pre @p renderer Must not be null.
+/// @pre @p config Must not be null.
+/// When it is unmet, a call to this function results in a no-op and returns a
+/// nullptr.
+///
+/// @param[in]      head_tracker            Head tracker object pointer. It
+///                                         must outlive the eye buffer reuse
+///                                         object.
+/// @param[in]      lens_distortion         Lens distortion object pointer. It
+///                                         must outlive the eye buffer reuse
+///                                         object.
+/// @param[in]      renderer                Distortion renderer object pointer.
+///                                         It must outlive the eye buffer
+///                                         reuse object.
+/// @param[in]      config                  Eye buffer reuse configuration.
+///
+/// @return         Eye buffer reuse object pointer.
+CardboardEyeBufferReuse* CardboardEyeBufferReuse_create(
+    CardboardHeadTracker* head_tracker,
+    CardboardLensDistortion* lens_distortion,
+    CardboardDistortionRenderer* renderer,
+    const CardboardEyeBufferReuseConfig* config);
+
+/// Releases the memory used by the provided eye buffer reuse object.
+///
+/// @pre @p reuse Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      reuse                   Eye buffer reuse object pointer.
+void CardboardEyeBufferReuse_destroy(CardboardEyeBufferReuse* reuse);
+
+/// Submits a pair of newly rendered eye textures. They are displayed until a
+/// newer pair is submitted.
+///
+/// @pre @p reuse Must not be null.
+/// @pre @p left_eye Must not be null.
+/// @pre @p right_eye Must not be null.
+/// @pre @p render_orientation Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      reuse                   Eye buffer reuse object pointer.
+/// @param[in]      left_eye                Left eye texture description.
+/// @param[in]      right_eye               Right eye texture description.
+/// @param[in]      render_orientation      4 floats for the head orientation
+///                                         quaternion, as returned by
+///                                         CardboardHeadTracker_getPose(), the
+///                                         eye textures were rendered with.
+void CardboardEyeBufferReuse_submitFrame(
+    CardboardEyeBufferReuse* reuse,
+    const CardboardEyeTextureDescription* left_eye,
+    const CardboardEyeTextureDescription* right_eye,
+    const float* render_orientation);
+
+/// Tells whether the application should render new eye textures for the
+/// current frame: either none have been submitted yet, or the head has rotated
+/// by more than CardboardEyeBufferReuseConfig::max_reprojection_angle since
+/// the submitted ones were rendered. The application may also render new eye
+/// textures at any time, e.g. when the scene changes.
+///
+/// @pre @p reuse Must not be null.
+/// When it is unmet, a call to this function results in a no-op and returns
+/// 1.
+///
+/// @param[in]      reuse                   Eye buffer reuse object pointer.
+///
+/// @return         1 if new eye textures should be rendered, 0 otherwise.
+int CardboardEyeBufferReuse_isNewFrameNeeded(CardboardEyeBufferReuse* reuse);
+
+/// Renders the submitted eye textures to the display, reprojected to the
+/// head orientation predicted for the current frame.
+///
+/// @pre @p reuse Must not be null.
+/// When it is unmet, a call to this function results in a no-op and returns
+/// 0.
+///
+/// @param[in]      reuse                   Eye buffer reuse object pointer.
+/// @param[in]      target                  Target display, as for
+///                 CardboardDistortionRenderer_renderEyeToDisplay().
+///
+/// @return         1 if the eye textures were rendered, 0 if none have been
+///                 submitted yet.
+int CardboardEyeBufferReuse_renderEyeToDisplay(CardboardEyeBufferReuse* reuse,
+                                               uint64_t target);
+
 /// @}
 
 /////////////////////////////////////////////////////////////////////////////
@@ -641,9 +1450,18 @@ void CardboardHeadTracker_recenter(CardboardHeadTracker* head_tracker);
 ///     the device parameters to and from the external storage.
 /// @{
 
+/// Callback invoked when new device parameters are saved.
+///
+/// @param[in]      user_data               The pointer provided to
+///     @c ::CardboardQrCode_setDeviceParamsChangedCallback.
+typedef void (*CardboardQrCode_DeviceParamsChangedCallback)(void* user_data);
+
 /// Gets currently saved devices parameters. This function allocates memory for
 /// the parameters, so it must be released using @c ::CardboardQrCode_destroy.
 ///
+/// @details The parameters are kept in memory and they are only read from
+///          storage again after new device parameters are saved.
+///
 /// @pre @p encoded_device_params Must not be null.
 /// @pre @p size Must not be null.
 /// When it is unmet, a call to this function results in a no-op and default
@@ -656,6 +1474,49 @@ void CardboardHeadTracker_recenter(CardboardHeadTracker* head_tracker);
 void CardboardQrCode_getSavedDeviceParams(uint8_t** encoded_device_params,
                                           int* size);
 
+/// Acquires a reference to the currently saved device parameters.
+///
+/// @details Unlike @c ::CardboardQrCode_getSavedDeviceParams, it does not copy
+///          the parameters: all the references share the same immutable
+///          object, which holds both the serialized and the decoded
+///          parameters. Saving new device parameters does not modify the
+///          object; a new one is returned by later calls. The reference must
+///          be released using @c ::CardboardDeviceParams_release.
+///
+/// @return A reference to the saved device parameters or @c nullptr when no
+///         device parameters are saved, they cannot be decoded or the SDK is
+///         not initialized.
+CardboardDeviceParams* CardboardQrCode_acquireSavedDeviceParams();
+
+/// Gets the serialized form of @p device_params.
+///
+/// @details @p encoded_device_params remains valid until @p device_params is
+///          released. It must not be freed.
+///
+/// @pre @p device_params Must not be null.
+/// @pre @p encoded_device_params Must not be null.
+/// @pre @p size Must not be null.
+/// When it is unmet, a call to this function results in a no-op and default
+/// values are returned (empty values).
+///
+/// @param[in]      device_params           Device parameters.
+/// @param[out]     encoded_device_params   Reference to the device parameters
+///     serialized using cardboard_device.proto.
+/// @param[out]     size                    Size in bytes of
+///     encoded_device_params.
+void CardboardDeviceParams_getEncoded(
+    const CardboardDeviceParams* device_params,
+    const uint8_t** encoded_device_params, int* size);
+
+/// Releases a reference acquired with
+/// @c ::CardboardQrCode_acquireSavedDeviceParams.
+///
+/// @pre @p device_params Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      device_params           Device parameters.
+void CardboardDeviceParams_release(CardboardDeviceParams* device_params);
+
 /// Releases memory used by the provided encoded_device_params array.
 ///
 /// @pre @p encoded_device_params Must not be null.
@@ -680,6 +1541,9 @@ void CardboardQrCode_destroy(const uint8_t* encoded_device_params);
 ///          This function only supports HTTPS connections. In case a URI
 ///          containing an HTTP scheme is provided, it will be replaced by an
 ///          HTTPS one.
+///          On Android, the URI is decoded and the device parameters are
+///          validated natively; only redirects go through the platform
+///          networking stack. Malformed device parameters are not saved.
 ///          Upon termination, it will increment a counter that can be queried
 ///          via @see CardboardQrCode_getDeviceParamsChangedCount() when new
 ///          device parameters were successfully saved.
@@ -701,9 +1565,29 @@ void CardboardQrCode_scanQrCodeAndSaveDeviceParams();
 
 /// Gets the count of successful device parameters read and save operations.
 ///
+/// @details It is cheap enough to be polled every frame. Alternatively, see
+///          @c ::CardboardQrCode_setDeviceParamsChangedCallback.
+///
 /// @return The count of successful device parameters read and save operations.
 int CardboardQrCode_getDeviceParamsChangedCount();
 
+/// Sets a callback to be notified when new device parameters are saved.
+///
+/// @details The callback is invoked on the thread that saved the parameters,
+///          which might be the UI thread, right after they are persisted. It
+///          must return quickly; it is safe to call
+///          @c ::CardboardQrCode_getSavedDeviceParams from it. Only one
+///          callback is kept: setting a new one replaces the previous one and
+///          passing a null @p callback removes it.
+///          Does not require a prior call to @c ::Cardboard_initializeAndroid
+///          in Android devices.
+///
+/// @param[in]      callback                Function to invoke or null.
+/// @param[in]      user_data               Opaque pointer passed to
+///                                         @p callback.
+void CardboardQrCode_setDeviceParamsChangedCallback(
+    CardboardQrCode_DeviceParamsChangedCallback callback, void* user_data);
+
 /// Gets Cardboard V1 device parameters.
 ///
 /// @details This function does not use external storage, and stores into @p
@@ -725,6 +1609,54 @@ void CardboardQrCode_getCardboardV1DeviceParams(uint8_t** encoded_device_params,
 
 /// @}
 
+/////////////////////////////////////////////////////////////////////////////
+// Runtime Statistics
+/////////////////////////////////////////////////////////////////////////////
+/// @defgroup stats Runtime Statistics
+/// @brief This module exposes runtime performance statistics of the head
+///     tracker and the distortion renderer, e.g. for production telemetry.
+///
+/// @details Statistics are collected process wide. Collection is disabled by
+///          default and has no measurable cost while disabled. When enabled,
+///          recording a value only performs lock-free atomic operations.
+///          These functions do not require a prior call to
+///          @c ::Cardboard_initializeAndroid in Android devices.
+/// @{
+
+/// Enables or disables the collection of runtime statistics. Statistics that
+/// were already collected are kept.
+///
+/// @param[in]      enabled                 Non-zero to enable the collection.
+void CardboardStats_setEnabled(int enabled);
+
+/// Clears the collected runtime statistics.
+void CardboardStats_reset();
+
+/// Gets the collected runtime statistics.
+///
+/// @pre @p stats Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[out]     stats                   Collected statistics.
+void CardboardStats_get(CardboardStats* stats);
+
+/// Gets the collected runtime statistics and clears them, so that the next
+/// call reports the values collected in between.
+///
+/// @details Periodic reports (e.g. telemetry) should use this function:
+///          percentiles accumulated over a whole session hide recent
+///          regressions. No value recorded concurrently is lost; it is
+///          reported by the next call instead. The gyroscope bias
+///          convergence state is not cleared.
+///
+/// @pre @p stats Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[out]     stats                   Collected statistics.
+void CardboardStats_getAndReset(CardboardStats* stats);
+
+/// @}
+
 #ifdef __cplusplus
 }
 #endif
@@ -16,13 +16,17 @@
 #include "jni_utils/android/jni_utils.h"
 
 #include "util/logging.h"
+#include "util/trace.h"
 
 namespace cardboard::jni {
 namespace {
 
-jclass runtime_excepton_class_;
+jclass runtime_excepton_class_ = nullptr;
 
 void LoadJNIResources(JNIEnv* env) {
+  if (runtime_excepton_class_ != nullptr) {
+    return;
+  }
   runtime_excepton_class_ =
       cardboard::jni::LoadJClass(env, "java/lang/RuntimeException");
 }
@@ -30,6 +34,7 @@ void LoadJNIResources(JNIEnv* env) {
 }  // anonymous namespace
 
 void initializeAndroid(JavaVM* vm, jobject /*context*/) {
+  CARDBOARD_TRACE_SCOPE("jni::initializeAndroid");
   JNIEnv* env;
   LoadJNIEnv(vm, &env);
   LoadJNIResources(env);
@@ -61,8 +66,52 @@ void LoadJNIEnv(JavaVM* vm, JNIEnv** env) {
 
 jclass LoadJClass(JNIEnv* env, const char* class_name) {
   jclass local = env->FindClass(class_name);
-  CheckExceptionInJava(env);
-  return static_cast<jclass>(env->NewGlobalRef(local));
+  if (CheckExceptionInJava(env) || local == nullptr) {
+    CARDBOARD_LOGE("Cannot find Java class %s.", class_name);
+    return nullptr;
+  }
+  jclass global = static_cast<jclass>(env->NewGlobalRef(local));
+  env->DeleteLocalRef(local);
+  return global;
+}
+
+jmethodID LoadJMethodID(JNIEnv* env, jclass clazz, const char* name,
+                        const char* signature) {
+  if (clazz == nullptr) {
+    return nullptr;
+  }
+  jmethodID method = env->GetMethodID(clazz, name, signature);
+  if (CheckExceptionInJava(env)) {
+    CARDBOARD_LOGE("Cannot find Java method %s%s.", name, signature);
+    return nullptr;
+  }
+  return method;
+}
+
+jmethodID LoadJStaticMethodID(JNIEnv* env, jclass clazz, const char* name,
+                              const char* signature) {
+  if (clazz == nullptr) {
+    return nullptr;
+  }
+  jmethodID method = env->GetStaticMethodID(clazz, name, signature);
+  if (CheckExceptionInJava(env)) {
+    CARDBOARD_LOGE("Cannot find static Java method %s%s.", name, signature);
+    return nullptr;
+  }
+  return method;
+}
+
+jfieldID LoadJFieldID(JNIEnv* env, jclass clazz, const char* name,
+                      const char* signature) {
+  if (clazz == nullptr) {
+    return nullptr;
+  }
+  jfieldID field = env->GetFieldID(clazz, name, signature);
+  if (CheckExceptionInJava(env)) {
+    CARDBOARD_LOGE("Cannot find Java field %s %s.", signature, name);
+    return nullptr;
+  }
+  return field;
 }
 
 void ThrowJavaRuntimeException(JNIEnv* env, const char* msg) {
@@ -21,6 +21,8 @@
 namespace cardboard::jni {
 
 /// @brief Initializes Java class refences used by this module.
+/// @details Class references are loaded once and pinned for the lifetime of
+///          the process; later calls are no-ops.
 /// @param vm The JavaVM pointer. It must not be nullptr.
 /// @param context The Andoird context. It is not used and left here just for
 ///        function prototype standarization.
@@ -40,11 +42,98 @@ bool CheckExceptionInJava(JNIEnv* env);
 void LoadJNIEnv(JavaVM* vm, JNIEnv** env);
 
 /// @brief Loads a class by its @p class_name as a global reference.
+/// @details The returned reference is meant to be pinned for the lifetime of
+///          the process: callers should load it once, typically from their
+///          initializeAndroid() function, and must not wrap it in another
+///          global reference.
 /// @param env The JNI Environment context.
 /// @param class_name A char pointer holding the Java full class name.
 /// @return A global referenced jclass pointing to the @p class_name Java class.
 jclass LoadJClass(JNIEnv* env, const char* class_name);
 
+/// @brief Resolves an instance method of @p clazz.
+/// @details Method IDs remain valid while the class is loaded, so they are
+///          expected to be resolved once alongside the pinned class reference.
+/// @param env The JNI Environment context.
+/// @param clazz The class declaring the method.
+/// @param name The method name.
+/// @param signature The JNI method signature.
+/// @return The method ID or nullptr when it cannot be found.
+jmethodID LoadJMethodID(JNIEnv* env, jclass clazz, const char* name,
+                        const char* signature);
+
+/// @brief Resolves a static method of @p clazz.
+/// @param env The JNI Environment context.
+/// @param clazz The class declaring the method.
+/// @param name The method name.
+/// @param signature The JNI method signature.
+/// @return The method ID or nullptr when it cannot be found.
+jmethodID LoadJStaticMethodID(JNIEnv* env, jclass clazz, const char* name,
+                              const char* signature);
+
+/// @brief Resolves an instance field of @p clazz.
+/// @param env The JNI Environment context.
+/// @param clazz The class declaring the field.
+/// @param name The field name.
+/// @param signature The JNI field signature.
+/// @return The field ID or nullptr when it cannot be found.
+jfieldID LoadJFieldID(JNIEnv* env, jclass clazz, const char* name,
+                      const char* signature);
+
+/// @brief Calls a static method returning an object.
+/// @return The returned object or nullptr when an exception occurred.
+template <typename... Args>
+jobject CallStaticObjectMethod(JNIEnv* env, jclass clazz, jmethodID method,
+                               Args... args) {
+  jobject result = env->CallStaticObjectMethod(clazz, method, args...);
+  return CheckExceptionInJava(env) ? nullptr : result;
+}
+
+/// @brief Calls a static method returning void.
+/// @return Whether the call completed without exceptions.
+template <typename... Args>
+bool CallStaticVoidMethod(JNIEnv* env, jclass clazz, jmethodID method,
+                          Args... args) {
+  env->CallStaticVoidMethod(clazz, method, args...);
+  return !CheckExceptionInJava(env);
+}
+
+/// @brief Calls a static method returning a boolean.
+/// @return The returned value or false when an exception occurred.
+template <typename... Args>
+bool CallStaticBooleanMethod(JNIEnv* env, jclass clazz, jmethodID method,
+                             Args... args) {
+  jboolean result = env->CallStaticBooleanMethod(clazz, method, args...);
+  return !CheckExceptionInJava(env) && result == JNI_TRUE;
+}
+
+/// @brief Calls an instance method returning an object.
+/// @return The returned object or nullptr when an exception occurred.
+template <typename... Args>
+jobject CallObjectMethod(JNIEnv* env, jobject object, jmethodID method,
+                         Args... args) {
+  jobject result = env->CallObjectMethod(object, method, args...);
+  return CheckExceptionInJava(env) ? nullptr : result;
+}
+
+/// @brief Calls an instance method returning void.
+/// @return Whether the call completed without exceptions.
+template <typename... Args>
+bool CallVoidMethod(JNIEnv* env, jobject object, jmethodID method,
+                    Args... args) {
+  env->CallVoidMethod(object, method, args...);
+  return !CheckExceptionInJava(env);
+}
+
+/// @brief Creates a new object by calling the @p constructor of @p clazz.
+/// @return The new object or nullptr when an exception occurred.
+template <typename... Args>
+jobject NewObject(JNIEnv* env, jclass clazz, jmethodID constructor,
+                  Args... args) {
+  jobject result = env->NewObject(clazz, constructor, args...);
+  return CheckExceptionInJava(env) ? nullptr : result;
+}
+
 /// @brief Throws a RuntimeException in Java with @p msg.
 /// @details The exception will be thrown as soon as the JNI execution returns.
 /// @param env The JNI Environment context. It must not be nullptr.
@@ -15,16 +15,27 @@
  */
 #include "lens_distortion.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <vector>
 
 #include "include/cardboard.h"
 #include "screen_params.h"
+#include "util/logging.h"
+#include "util/reprojection.h"
+#include "util/trace.h"
 
 namespace cardboard {
 
 constexpr float kDefaultBorderSizeMeters = 0.003f;
 
+// Number of samples per axis used to estimate the eye texture pixel density.
+constexpr int kPixelDensitySamples = 32;
+
+// Step in tanangle units used to differentiate the lens distortion.
+constexpr float kPixelDensityStep = 1e-3f;
+
 // All values in tanangle units.
 struct LensDistortion::ViewportParams {
   float width;
@@ -33,10 +44,32 @@ struct LensDistortion::ViewportParams {
   float y_eye_offset;
 };
 
-LensDistortion::LensDistortion(const uint8_t* encoded_device_params, int size,
-                               int display_width, int display_height) {
-  device_params_.ParseFromArray(encoded_device_params, size);
+namespace {
 
+device_params::DeviceParams ParseDeviceParams(
+    const uint8_t* encoded_device_params, int size) {
+  CARDBOARD_TRACE_SCOPE("LensDistortion::ParseDeviceParams");
+  device_params::DeviceParams device_params;
+  if (!device_params.ParseFromArray(encoded_device_params, size)) {
+    CARDBOARD_LOGE("Cannot parse the encoded device parameters.");
+  }
+  return device_params;
+}
+
+}  // anonymous namespace
+
+LensDistortion::LensDistortion(const uint8_t* encoded_device_params, int size,
+                               int display_width, int display_height)
+    : LensDistortion(ParseDeviceParams(encoded_device_params, size),
+                     display_width, display_height) {}
+
+LensDistortion::LensDistortion(
+    const device_params::DeviceParams& device_params, int display_width,
+    int display_height)
+    : device_params_(device_params),
+      display_width_(display_width),
+      display_height_(display_height) {
+  CARDBOARD_TRACE_SCOPE("LensDistortion::LensDistortion");
   eye_from_head_matrix_[kLeft] = cardboard::Matrix4x4::Translation(
       device_params_.inter_lens_distance() * 0.5f, 0.f, 0.f);
   eye_from_head_matrix_[kRight] = cardboard::Matrix4x4::Translation(
@@ -50,6 +83,7 @@ LensDistortion::LensDistortion(const uint8_t* encoded_device_params, int size,
 
   distortion_ = std::unique_ptr<PolynomialRadialDistortion>(
       new PolynomialRadialDistortion(distortion_coefficients));
+  chromatic_aberration_scales_ = GetChromaticAberrationScales(device_params_);
 
   screen_params::getScreenSizeInMeters(display_width, display_height,
                                        &screen_width_meters_,
@@ -79,6 +113,116 @@ CardboardMesh LensDistortion::GetDistortionMesh(CardboardEye eye) const {
   return eye == kLeft ? left_mesh_->GetMesh() : right_mesh_->GetMesh();
 }
 
+CardboardChromaticMesh LensDistortion::GetChromaticDistortionMesh(
+    CardboardEye eye) const {
+  return eye == kLeft ? left_mesh_->GetChromaticMesh()
+                      : right_mesh_->GetChromaticMesh();
+}
+
+std::array<float, 9> LensDistortion::GetRotationalReprojection(
+    CardboardEye eye, const std::array<float, 4>& render_orientation,
+    const std::array<float, 4>& display_orientation) const {
+  // Given that the eye-from-head transformation has no rotation, the same
+  // rotation applies to both eyes.
+  return ComputeRotationalReprojection(render_orientation, display_orientation,
+                                       fov_[eye]);
+}
+
+std::array<int, 2> LensDistortion::GetRecommendedEyeTextureSize(
+    CardboardEye eye, float coverage) const {
+  if (screen_width_meters_ == 0 || screen_height_meters_ == 0) {
+    return {0, 0};
+  }
+
+  ViewportParams screen_params, texture_params;
+  CalculateViewportParameters(eye, device_params_, fov_[eye],
+                              screen_width_meters_, screen_height_meters_,
+                              &screen_params, &texture_params);
+
+  // Display pixels per tanangle unit. They are constant across the screen.
+  const float screen_density_x = display_width_ / screen_params.width;
+  const float screen_density_y = display_height_ / screen_params.height;
+
+  // The lens stretches the periphery of the texture: a step on the screen maps
+  // to a longer step in the texture, so fewer texels per tanangle are needed
+  // there. Samples are evenly spread over the texture, so each one stands for
+  // the same texture area. Only texture regions that end up on this eye's half
+  // of the screen are considered.
+  std::vector<float> texture_densities_x;
+  std::vector<float> texture_densities_y;
+  texture_densities_x.reserve(kPixelDensitySamples * kPixelDensitySamples);
+  texture_densities_y.reserve(kPixelDensitySamples * kPixelDensitySamples);
+  for (int j = 0; j < kPixelDensitySamples; ++j) {
+    for (int i = 0; i < kPixelDensitySamples; ++i) {
+      const std::array<float, 2> texture_tanangle = {
+          (i + 0.5f) / kPixelDensitySamples * texture_params.width -
+              texture_params.x_eye_offset,
+          (j + 0.5f) / kPixelDensitySamples * texture_params.height -
+              texture_params.y_eye_offset};
+      const std::array<float, 2> screen_tanangle =
+          distortion_->DistortInverse(texture_tanangle);
+
+      const float screen_u =
+          (screen_tanangle[0] + screen_params.x_eye_offset) /
+          screen_params.width;
+      const float screen_v =
+          (screen_tanangle[1] + screen_params.y_eye_offset) /
+          screen_params.height;
+      const bool is_on_eye_half =
+          eye == kLeft ? screen_u >= 0.0f && screen_u <= 0.5f
+                       : screen_u >= 0.5f && screen_u <= 1.0f;
+      if (!is_on_eye_half || screen_v < 0.0f || screen_v > 1.0f) {
+        continue;
+      }
+
+      const std::array<float, 2> distorted =
+          distortion_->Distort(screen_tanangle);
+      const std::array<float, 2> distorted_dx = distortion_->Distort(
+          {screen_tanangle[0] + kPixelDensityStep, screen_tanangle[1]});
+      const std::array<float, 2> distorted_dy = distortion_->Distort(
+          {screen_tanangle[0], screen_tanangle[1] + kPixelDensityStep});
+      const float stretch_x =
+          std::abs(distorted_dx[0] - distorted[0]) / kPixelDensityStep;
+      const float stretch_y =
+          std::abs(distorted_dy[1] - distorted[1]) / kPixelDensityStep;
+      if (stretch_x > 0.0f) {
+        texture_densities_x.push_back(screen_density_x / stretch_x);
+      }
+      if (stretch_y > 0.0f) {
+        texture_densities_y.push_back(screen_density_y / stretch_y);
+      }
+    }
+  }
+
+  // The densest region, usually the lens center, is small: sizing the texture
+  // for it oversamples the rest. The texture is instead sized so that
+  // @p coverage of its visible area gets at least the display pixel density.
+  const float texture_density_x =
+      GetDensityPercentile(&texture_densities_x, coverage);
+  const float texture_density_y =
+      GetDensityPercentile(&texture_densities_y, coverage);
+  // Never more than the eye's half of the display, the size used before the
+  // lens pixel density was taken into account, so no display renders more.
+  const int width =
+      static_cast<int>(std::ceil(texture_density_x * texture_params.width));
+  const int height =
+      static_cast<int>(std::ceil(texture_density_y * texture_params.height));
+  return {std::min(width, display_width_ / 2),
+          std::min(height, display_height_)};
+}
+
+float LensDistortion::GetDensityPercentile(std::vector<float>* densities,
+                                          float coverage) {
+  if (densities->empty()) {
+    return 0.0f;
+  }
+  const size_t index = static_cast<size_t>(std::round(
+      std::clamp(coverage, 0.0f, 1.0f) * (densities->size() - 1)));
+  std::nth_element(densities->begin(), densities->begin() + index,
+                   densities->end());
+  return (*densities)[index];
+}
+
 void LensDistortion::UpdateParams() {
   fov_[kLeft] = CalculateFov(device_params_, *distortion_, screen_width_meters_,
                              screen_height_meters_);
@@ -87,12 +231,12 @@ void LensDistortion::UpdateParams() {
   fov_[kRight][0] = fov_[kLeft][1];
   fov_[kRight][1] = fov_[kLeft][0];
 
-  left_mesh_ = std::unique_ptr<DistortionMesh>(
-      CreateDistortionMesh(kLeft, device_params_, *distortion_, fov_[kLeft],
-                           screen_width_meters_, screen_height_meters_));
-  right_mesh_ = std::unique_ptr<DistortionMesh>(
-      CreateDistortionMesh(kRight, device_params_, *distortion_, fov_[kRight],
-                           screen_width_meters_, screen_height_meters_));
+  left_mesh_ = std::unique_ptr<DistortionMesh>(CreateDistortionMesh(
+      kLeft, device_params_, *distortion_, fov_[kLeft], screen_width_meters_,
+      screen_height_meters_, chromatic_aberration_scales_));
+  right_mesh_ = std::unique_ptr<DistortionMesh>(CreateDistortionMesh(
+      kRight, device_params_, *distortion_, fov_[kRight], screen_width_meters_,
+      screen_height_meters_, chromatic_aberration_scales_));
 }
 
 std::array<float, 2> LensDistortion::DistortedUvForUndistortedUv(
@@ -153,7 +297,7 @@ std::array<float, 2> LensDistortion::UndistortedUvForDistortedUv(
 }
 
 std::array<float, 4> LensDistortion::CalculateFov(
-    const DeviceParams& device_params,
+    const device_params::DeviceParams& device_params,
     const PolynomialRadialDistortion& distortion, float screen_width_meters,
     float screen_height_meters) {
   // FOV angles in device parameters are in degrees so they are converted
@@ -190,25 +334,55 @@ std::array<float, 4> LensDistortion::CalculateFov(
   };
 }
 
-float LensDistortion::GetYEyeOffsetMeters(const DeviceParams& device_params,
-                                          float screen_height_meters) {
+float LensDistortion::GetYEyeOffsetMeters(
+    const device_params::DeviceParams& device_params,
+    float screen_height_meters) {
   switch (device_params.vertical_alignment()) {
-    case DeviceParams::CENTER:
+    case device_params::DeviceParams::CENTER:
     default:
       return screen_height_meters / 2.0f;
-    case DeviceParams::BOTTOM:
+    case device_params::DeviceParams::BOTTOM:
       return device_params.tray_to_lens_distance() - kDefaultBorderSizeMeters;
-    case DeviceParams::TOP:
+    case device_params::DeviceParams::TOP:
       return screen_height_meters - device_params.tray_to_lens_distance() -
              kDefaultBorderSizeMeters;
   }
 }
 
+std::array<float, 3> LensDistortion::GetChromaticAberrationScales(
+    const device_params::DeviceParams& device_params) {
+  constexpr std::array<float, 3> kNoChromaticAberration = {1.0f, 1.0f, 1.0f};
+  const int size = device_params.chromatic_aberration_scales_size();
+  if (size == 0) {
+    return kNoChromaticAberration;
+  }
+  if (size != 3) {
+    CARDBOARD_LOGE(
+        "Expected 3 chromatic aberration scales, got %d. Chromatic aberration "
+        "correction is disabled.",
+        size);
+    return kNoChromaticAberration;
+  }
+  std::array<float, 3> scales;
+  for (int i = 0; i < 3; ++i) {
+    scales[i] = device_params.chromatic_aberration_scales(i);
+    // Also rejects NaN.
+    if (!(scales[i] > 0.0f)) {
+      CARDBOARD_LOGE(
+          "Chromatic aberration scales must be positive. Chromatic aberration "
+          "correction is disabled.");
+      return kNoChromaticAberration;
+    }
+  }
+  return scales;
+}
+
 DistortionMesh* LensDistortion::CreateDistortionMesh(
-    CardboardEye eye, const DeviceParams& device_params,
+    CardboardEye eye, const device_params::DeviceParams& device_params,
     const PolynomialRadialDistortion& distortion,
     const std::array<float, 4>& fov, float screen_width_meters,
-    float screen_height_meters) {
+    float screen_height_meters,
+    const std::array<float, 3>& chromatic_aberration_scales) {
   ViewportParams screen_params, texture_params;
 
   CalculateViewportParameters(eye, device_params, fov, screen_width_meters,
@@ -219,11 +393,12 @@ DistortionMesh* LensDistortion::CreateDistortionMesh(
                             screen_params.height, screen_params.x_eye_offset,
                             screen_params.y_eye_offset, texture_params.width,
                             texture_params.height, texture_params.x_eye_offset,
-                            texture_params.y_eye_offset);
+                            texture_params.y_eye_offset,
+                            chromatic_aberration_scales);
 }
 
 void LensDistortion::CalculateViewportParameters(
-    CardboardEye eye, const DeviceParams& device_params,
+    CardboardEye eye, const device_params::DeviceParams& device_params,
     const std::array<float, 4>& fov, float screen_width_meters,
     float screen_height_meters, ViewportParams* screen_params,
     ViewportParams* texture_params) {
@@ -18,13 +18,9 @@
 
 #include <array>
 #include <memory>
+#include <vector>
 
-#ifdef __ANDROID__
-#include "device_params/android/device_params.h"
-#else
-#include "cardboard_device.pb.h"
-#endif
-
+#include "device_params/device_params.h"
 #include "distortion_mesh.h"
 #include "include/cardboard.h"
 #include "polynomial_radial_distortion.h"
@@ -36,6 +32,9 @@ class LensDistortion {
  public:
   LensDistortion(const uint8_t* encoded_device_params, int size,
                  int display_width, int display_height);
+  // Uses already decoded device parameters, avoiding parsing them again.
+  LensDistortion(const device_params::DeviceParams& device_params,
+                 int display_width, int display_height);
   virtual ~LensDistortion();
   // Tan angle units. "DistortedUvForUndistoredUv" goes through the forward
   // distort function. I.e. the lens. UndistortedUvForDistortedUv uses the
@@ -50,36 +49,65 @@ class LensDistortion {
                               float* projection_matrix) const;
   void GetEyeFieldOfView(CardboardEye eye, float* field_of_view) const;
   CardboardMesh GetDistortionMesh(CardboardEye eye) const;
+  CardboardChromaticMesh GetChromaticDistortionMesh(CardboardEye eye) const;
+  // Orientations are quaternions as returned by HeadTracker::GetPose(). The
+  // returned 3x3 matrix is in column-major order.
+  std::array<float, 9> GetRotationalReprojection(
+      CardboardEye eye, const std::array<float, 4>& render_orientation,
+      const std::array<float, 4>& display_orientation) const;
+  // Smallest eye texture size, in pixels, whose texel density matches the
+  // display pixel density, after the lens distortion is applied, over
+  // @p coverage (in [0, 1]) of the visible texture area. A coverage of 1 sizes
+  // the texture for its densest region. It is capped at half the display,
+  // the eye texture size without this recommendation. Returned as
+  // [width, height].
+  std::array<int, 2> GetRecommendedEyeTextureSize(
+      CardboardEye eye,
+      float coverage = kRecommendedEyeTextureCoverage) const;
+
+  // Default coverage of GetRecommendedEyeTextureSize().
+  static constexpr float kRecommendedEyeTextureCoverage = 0.9f;
+
  private:
   struct ViewportParams;
 
   void UpdateParams();
-  static float GetYEyeOffsetMeters(const DeviceParams& device_params,
-                                   float screen_height_meters);
+  // Returns the value of @p densities that @p coverage of them do not exceed.
+  // @p densities is reordered.
+  static float GetDensityPercentile(std::vector<float>* densities,
+                                    float coverage);
+  static float GetYEyeOffsetMeters(
+      const device_params::DeviceParams& device_params,
+      float screen_height_meters);
+  static std::array<float, 3> GetChromaticAberrationScales(
+      const device_params::DeviceParams& device_params);
   static DistortionMesh* CreateDistortionMesh(
-      CardboardEye eye, const cardboard::DeviceParams& device_params,
+      CardboardEye eye,
+      const cardboard::device_params::DeviceParams& device_params,
       const cardboard::PolynomialRadialDistortion& distortion,
       const std::array<float, 4>& fov, float screen_width_meters,
-      float screen_height_meters);
+      float screen_height_meters,
+      const std::array<float, 3>& chromatic_aberration_scales);
   static std::array<float, 4> CalculateFov(
-      const cardboard::DeviceParams& device_params,
+      const cardboard::device_params::DeviceParams& device_params,
       const cardboard::PolynomialRadialDistortion& distortion,
       float screen_width_meters, float screen_height_meters);
-  static void CalculateViewportParameters(CardboardEye eye,
-                                          const DeviceParams& device_params,
-                                          const std::array<float, 4>& fov,
-                                          float screen_width_meters,
-                                          float screen_height_meters,
-                                          ViewportParams* screen_params,
-                                          ViewportParams* texture_params);
+  static void CalculateViewportParameters(
+      CardboardEye eye, const device_params::DeviceParams& device_params,
+      const std::array<float, 4>& fov, float screen_width_meters,
+      float screen_height_meters, ViewportParams* screen_params,
+      ViewportParams* texture_params);
   static constexpr float DegreesToRadians(float angle);
 
-  DeviceParams device_params_;
+  device_params::DeviceParams device_params_;
 
+  int display_width_;
+  int display_height_;
   float screen_width_meters_;
   float screen_height_meters_;
   std::array<std::array<float, 4>, 2> fov_;  // L, R, B, T
   std::array<Matrix4x4, 2> eye_from_head_matrix_;
+  std::array<float, 3> chromatic_aberration_scales_;  // R, G, B
   std::unique_ptr<DistortionMesh> left_mesh_;
   std::unique_ptr<DistortionMesh> right_mesh_;
   std::unique_ptr<PolynomialRadialDistortion> distortion_;
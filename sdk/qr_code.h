@@ -30,7 +30,6 @@ void initializeAndroid(JavaVM* vm, jobject context);
 std::vector<uint8_t> getCurrentSavedDeviceParams();
 void scanQrCodeAndSaveDeviceParams();
 void saveDeviceParams(const uint8_t* uri, int size);
-int getDeviceParamsChangedCount();
 }  // namespace cardboard::qrcode
 
 #endif  // CARDBOARD_SDK_QR_CODE_H_
@@ -266,13 +266,10 @@ public class QrCodeCaptureActivity extends AppCompatActivity
     if (status) {
       Log.d(TAG, "Device parameters saved in external storage.");
       cameraSourcePreview.stop();
-      nativeIncrementDeviceParamsChangedCount();
       finish();
     } else {
       Log.e(TAG, "Device parameters not saved in external storage.");
     }
     qrCodeSaved = false;
   }
-
-  private native void nativeIncrementDeviceParamsChangedCount();
 }
@@ -19,7 +19,6 @@ import android.content.Context;
 import android.net.Uri;
 import android.os.Build;
 import android.os.Environment;
-import android.util.Base64;
 import android.util.Log;
 import androidx.annotation.ChecksSdkIntAtLeast;
 import androidx.annotation.Nullable;
@@ -34,49 +33,27 @@ import java.net.HttpURLConnection;
 import java.net.ProtocolException;
 import java.nio.ByteBuffer;
 
-/** Utility methods for managing configuration parameters. */
+/**
+ * Utility methods for managing configuration parameters.
+ *
+ * <p>QR code contents are decoded natively. This class only provides the platform pieces the
+ * native decoder relies on: following a single HTTPS redirect and persisting device parameters.
+ */
 public abstract class CardboardParamsUtils {
   private static final String TAG = CardboardParamsUtils.class.getSimpleName();
 
-  /** URL key used to encode Cardboard device parameters. */
-  private static final String URI_KEY_PARAMS = "p";
-
   /** Name of the folder where Cardboard configuration files are stored. */
   private static final String CARDBOARD_CONFIG_FOLDER = "Cardboard";
 
   /** Name of the file containing device parameters of the currently paired Cardboard device. */
   private static final String CARDBOARD_DEVICE_PARAMS_FILE = "current_device_params";
 
+  /** Suffix of the file device parameters are written to before replacing the current ones. */
+  private static final String TEMPORARY_FILE_SUFFIX = ".tmp";
+
   /** Sentinel value for including device params in a stream. */
   private static final int CARDBOARD_DEVICE_PARAMS_STREAM_SENTINEL = 0x35587a2b;
 
-  private static final String HTTPS_SCHEME = "https";
-  private static final String HTTP_SCHEME = "http";
-
-  /** URI short host of Google. */
-  private static final String URI_HOST_GOOGLE_SHORT = "g.co";
-
-  /** URI host of Google. */
-  private static final String URI_HOST_GOOGLE = "google.com";
-
-  /** URI path of Cardboard home page. */
-  private static final String URI_PATH_CARDBOARD_HOME = "cardboard";
-
-  /** URI path used in viewer param NFC and QR codes. */
-  private static final String URI_PATH_CARDBOARD_CONFIG = "cardboard/cfg";
-
-  /** Flags to encode and decode in Base64 device parameters in the Uri. */
-  private static final int URI_CODING_PARAMS = Base64.URL_SAFE | Base64.NO_WRAP | Base64.NO_PADDING;
-
-  /** URI of original cardboard QR code. */
-  private static final Uri URI_ORIGINAL_CARDBOARD_QR_CODE =
-      new Uri.Builder()
-          .scheme(HTTPS_SCHEME)
-          .authority(URI_HOST_GOOGLE_SHORT)
-          .appendEncodedPath(URI_PATH_CARDBOARD_HOME)
-          .build();
-
-  private static final int MAX_REDIRECTS = 5;
   private static final String HTTP_SCHEME_PREFIX = "http://";
   private static final String HTTPS_SCHEME_PREFIX = "https://";
   private static final int HTTPS_TIMEOUT_MS = 5 * 1000;
@@ -87,52 +64,6 @@ public abstract class CardboardParamsUtils {
     EXTERNAL_STORAGE
   };
 
-  /** Holds status for conversion from a URI to Cardboard device params. */
-  public static class UriToParamsStatus {
-    public static final int STATUS_OK = 0;
-    public static final int STATUS_UNEXPECTED_FORMAT = 1;
-    public static final int STATUS_CONNECTION_ERROR = 2;
-
-    public final int statusCode;
-    /** Only not null when statusCode is STATUS_OK. */
-    @Nullable public final byte[] params;
-
-    public static UriToParamsStatus success(byte[] params) {
-      return new UriToParamsStatus(STATUS_OK, params);
-    }
-
-    public static UriToParamsStatus error(int statusCode) {
-      return new UriToParamsStatus(statusCode, null);
-    }
-
-    private UriToParamsStatus(int statusCode, @Nullable byte[] params) {
-      this.statusCode = statusCode;
-      this.params = params;
-    }
-  }
-
-  /**
-   * Obtains the Cardboard device parameters from a Uri string and saves them.
-   *
-   * <p>Obtains the Cardboard device parameters from a Uri string (passed as a bytes array) and
-   * saves them into a predefined storage location.
-   *
-   * @param uriAsBytes URI string (as a bytes array) used to get the device parameters.
-   * @param context The current Context. It is or wraps an Activity or an Application instance.
-   */
-  @UsedByNative
-  public static void saveParamsFromUri(byte[] uriAsBytes, Context context) {
-    String uriAsString = new String(uriAsBytes);
-    UriToParamsStatus uriToParamsStatus = getParamsFromUriString(uriAsString, new UrlFactory());
-    if (uriToParamsStatus.statusCode != UriToParamsStatus.STATUS_OK) {
-      Log.e(TAG, "Error when trying to get the Cardboard device params from URI: " + uriAsString);
-      return;
-    }
-
-    boolean status = writeDeviceParams(uriToParamsStatus.params, context);
-    Log.d(TAG, "Could " + (!status ? "not " : "") + "save Cardboard device parameters.");
-  }
-
   /**
    * Saves the Cardboard V1 device parameters into a predefined storage location.
    *
@@ -144,58 +75,6 @@ public abstract class CardboardParamsUtils {
     Log.d(TAG, "Could " + (!status ? "not " : "") + "save Cardboard V1 device parameters.");
   }
 
-  /**
-   * Obtains the Cardboard device parameters from a URI string.
-   *
-   * <p>Analyses the URI obtained from a string in order to get the device parameters. If the
-   * obtained string matches a Cardboard V1 string format, the parameters are taken directly from
-   * the code. If the obtained string matches a Cardboard V2 string format, the parameters are taken
-   * from the URI query string (up to 5 redirections supported). This function only supports HTTPS
-   * connections. In case a URI containing an HTTP scheme is provided, it will be replaced by an
-   * HTTPS one.
-   *
-   * @param uriAsString URI string used to get the device parameters.
-   * @param urlFactory Factory for creating URL instance for HTTPS connection.
-   * @return A UriToParamsStatus instance containing the obtained result.
-   */
-  public static UriToParamsStatus getParamsFromUriString(
-      String uriAsString, UrlFactory urlFactory) {
-    Uri uri = Uri.parse(uriAsString);
-    if (uri == null) {
-      Log.e(TAG, "Error when parsing URI: " + uri);
-      return UriToParamsStatus.error(UriToParamsStatus.STATUS_UNEXPECTED_FORMAT);
-    }
-
-    // If needed, prefix free text results with a https prefix.
-    if (uri.getScheme() == null) {
-      uri = Uri.parse(HTTPS_SCHEME_PREFIX + uri);
-    } else if ((uri.getScheme()).equals(HTTP_SCHEME)) {
-      // If the prefix is http, replace it with https.
-      uri = Uri.parse(uri.toString().replaceFirst(HTTP_SCHEME_PREFIX, HTTPS_SCHEME_PREFIX));
-    }
-
-    // Follow redirects to support URL shortening.
-    try {
-      Log.d(TAG, "Following redirects for original URI: " + uri);
-      uri = followCardboardParamRedirect(uri, MAX_REDIRECTS, urlFactory);
-    } catch (IOException e) {
-      Log.w(TAG, "Error while following URL redirect " + e);
-      return UriToParamsStatus.error(UriToParamsStatus.STATUS_CONNECTION_ERROR);
-    }
-
-    if (uri == null) {
-      Log.e(TAG, "Error when following URI redirects");
-      return UriToParamsStatus.error(UriToParamsStatus.STATUS_UNEXPECTED_FORMAT);
-    }
-
-    byte[] params = CardboardParamsUtils.createFromUri(uri);
-    if (params == null) {
-      Log.e(TAG, "Error when parsing device parameters from URI query string: " + uri);
-      return UriToParamsStatus.error(UriToParamsStatus.STATUS_UNEXPECTED_FORMAT);
-    }
-    return UriToParamsStatus.success(params);
-  }
-
   /**
    * Reads the device parameters from a predefined storage location by forwarding a call to {@code
    * readDeviceParamsFromStorage()}.
@@ -241,9 +120,12 @@ public abstract class CardboardParamsUtils {
    * <p>Based on the API level, different behaviours are expected. When the API level is below
    * Android Q´s API level external storage is used. Otherwise, scoped storage is used.
    *
+   * <p>The native SDK is notified upon success so it refreshes its cached device parameters.
+   *
    * @param context The current Context. It is or wraps an Activity or an Application instance.
    * @return true when the write operation is successful.
    */
+  @UsedByNative
   public static boolean writeDeviceParams(byte[] deviceParams, Context context) {
     StorageSource storageSource;
     if (isAtLeastQ()) {
@@ -253,84 +135,28 @@ public abstract class CardboardParamsUtils {
       storageSource = StorageSource.EXTERNAL_STORAGE;
       Log.d(TAG, "Writing device parameters to external storage.");
     }
-    return writeDeviceParamsToStorage(deviceParams, storageSource, context);
-  }
-
-  /**
-   * Obtains the physical parameters of a Cardboard headset from a Uri (as bytes).
-   *
-   * @param uri Uri to read the parameters from.
-   * @return A bytes buffer with the Cardboard headset parameters or null in case of error.
-   */
-  private static byte[] createFromUri(Uri uri) {
-    if (uri == null) {
-      return null;
-    }
-
-    byte[] deviceParams;
-    if (isOriginalCardboardDeviceUri(uri)) {
-      deviceParams = CardboardV1DeviceParams.build().toByteArray();
-    } else if (isCardboardDeviceUri(uri)) {
-      deviceParams = readDeviceParamsFromUri(uri);
-    } else {
-      Log.w(TAG, String.format("URI \"%s\" not recognized as Cardboard viewer.", uri));
-      deviceParams = null;
+    if (!writeDeviceParamsToStorage(deviceParams, storageSource, context)) {
+      return false;
     }
-
-    return deviceParams;
+    nativeOnDeviceParamsSaved();
+    return true;
   }
 
   /**
-   * Analyzes if the given URI identifies a Cardboard viewer.
+   * Resolves a single HTTPS redirect of a URI without following it.
    *
-   * @param uri Uri to analyze.
-   * @return true if the given URI identifies a Cardboard viewer.
+   * @param uri The URI to resolve.
+   * @return The redirect location, an empty string when {@code uri} is not redirected or null when
+   *     the connection fails.
    */
-  private static boolean isCardboardUri(Uri uri) {
-    return isOriginalCardboardDeviceUri(uri) || isCardboardDeviceUri(uri);
-  }
-
-  /**
-   * Analyzes if the given URI identifies an original Cardboard viewer (or equivalent).
-   *
-   * @param uri Uri to analyze.
-   * @return true if the given URI identifies an original Cardboard viewer (or equivalent).
-   */
-  private static boolean isOriginalCardboardDeviceUri(Uri uri) {
-    // Note for "cardboard:" scheme case we're lax about path, parameters, etc. since
-    // some viewers compatible with original Cardboard are known to take liberties.
-    return URI_ORIGINAL_CARDBOARD_QR_CODE.equals(uri);
-  }
-
-  /**
-   * Analyzes if the given URI identifies a Cardboard device using current scheme.
-   *
-   * @param uri Uri to analyze.
-   * @return true if the given URI identifies a Cardboard device using current scheme.
-   */
-  private static boolean isCardboardDeviceUri(Uri uri) {
-    return HTTPS_SCHEME.equals(uri.getScheme())
-        && URI_HOST_GOOGLE.equals(uri.getAuthority())
-        && ("/" + URI_PATH_CARDBOARD_CONFIG).equals(uri.getPath());
-  }
-
-  /**
-   * Decodes device parameters in URI from Base64 to bytes.
-   *
-   * @param uri Uri to get the parameters from.
-   * @return device parameters in bytes, or null in case of error.
-   */
-  private static byte[] readDeviceParamsFromUri(Uri uri) {
-    String paramsEncoded = uri.getQueryParameter(URI_KEY_PARAMS);
-    if (paramsEncoded == null) {
-      Log.w(TAG, "No Cardboard parameters in URI.");
-      return null;
-    }
-
+  @UsedByNative
+  @Nullable
+  public static String resolveRedirect(String uri) {
     try {
-      return Base64.decode(paramsEncoded, URI_CODING_PARAMS);
-    } catch (Exception e) {
-      Log.w(TAG, "Parsing Cardboard parameters from URI failed: " + e);
+      Uri redirectUri = resolveHttpsRedirect(Uri.parse(uri), new UrlFactory());
+      return redirectUri == null ? "" : redirectUri.toString();
+    } catch (IOException e) {
+      Log.w(TAG, "Error while resolving redirect: " + e);
       return null;
     }
   }
@@ -410,6 +236,9 @@ public abstract class CardboardParamsUtils {
   /**
    * Writes device parameters to external storage.
    *
+   * <p>Parameters are first written to a temporary file which then replaces the current one, so a
+   * failed write never leaves a truncated parameters file behind.
+   *
    * @param paramBytes The parameters to be written.
    * @param storageSource When {@code StorageSource.SCOPED_STORAGE}, the path is in the scoped
    *     storage. Otherwise, the SD card is used.
@@ -420,24 +249,40 @@ public abstract class CardboardParamsUtils {
    */
   private static boolean writeDeviceParamsToStorage(
       byte[] paramBytes, StorageSource storageSource, Context context) {
+    File file;
+    try {
+      file = getDeviceParamsFile(storageSource, context);
+    } catch (IllegalStateException e) {
+      Log.w(TAG, "Error writing parameters: " + e);
+      return false;
+    }
+    File temporaryFile = new File(file.getPath() + TEMPORARY_FILE_SUFFIX);
+
     boolean success = false;
     OutputStream stream = null;
     try {
-      stream = OutputStreamProvider.get(getDeviceParamsFile(storageSource, context));
+      stream = OutputStreamProvider.get(temporaryFile);
       success = writeDeviceParamsToOutputStream(paramBytes, stream);
     } catch (FileNotFoundException e) {
       Log.e(TAG, "Parameters file not found for writing: " + e);
-    } catch (IllegalStateException e) {
-      Log.w(TAG, "Error writing parameters: " + e);
     } finally {
       if (stream != null) {
         try {
           stream.close();
         } catch (IOException e) {
-          // Pass
+          Log.w(TAG, "Error closing parameters file: " + e);
+          success = false;
         }
       }
     }
+
+    if (success && !temporaryFile.renameTo(file)) {
+      Log.e(TAG, "Error replacing parameters file.");
+      success = false;
+    }
+    if (!success) {
+      temporaryFile.delete();
+    }
     return success;
   }
 
@@ -458,6 +303,7 @@ public abstract class CardboardParamsUtils {
       header.putInt(paramBytes.length);
       outputStream.write(header.array());
       outputStream.write(paramBytes);
+      outputStream.flush();
       return true;
     } catch (IOException e) {
       Log.w(TAG, "Error writing parameters: " + e);
@@ -503,32 +349,6 @@ public abstract class CardboardParamsUtils {
     return new File(configFolder, CARDBOARD_DEVICE_PARAMS_FILE);
   }
 
-  /**
-   * Follow HTTPS redirect until we reach a valid Cardboard device URI.
-   *
-   * <p>Network access is only used if the given URI is not already a cardboard device. Only HTTPS
-   * headers are transmitted, and the final URI is not accessed.
-   *
-   * @param uri The initial URI.
-   * @param maxRedirects Maximum number of redirects to follow.
-   * @param urlFactory Factory for creating URL instance for HTTPS connection.
-   * @return Cardboard device URI, or null if there is an error.
-   */
-  @Nullable
-  private static Uri followCardboardParamRedirect(
-      Uri uri, int maxRedirects, final UrlFactory urlFactory) throws IOException {
-    int numRedirects = 0;
-    while (uri != null && !isCardboardUri(uri)) {
-      if (numRedirects >= maxRedirects) {
-        Log.d(TAG, "Exceeding the number of maximum redirects: " + maxRedirects);
-        return null;
-      }
-      uri = resolveHttpsRedirect(uri, urlFactory);
-      numRedirects++;
-    }
-    return uri;
-  }
-
   /**
    * Dereference an HTTPS redirect without reading resource body.
    *
@@ -594,4 +414,7 @@ public abstract class CardboardParamsUtils {
   private static boolean isAtLeastQ() {
     return Build.VERSION.SDK_INT >= Build.VERSION_CODES.Q;
   }
+
+  /** Notifies the native SDK that new device parameters were saved. */
+  private static native void nativeOnDeviceParamsSaved();
 }
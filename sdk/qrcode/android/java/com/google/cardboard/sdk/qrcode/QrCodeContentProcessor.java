@@ -20,15 +20,26 @@ import android.util.Log;
 import android.widget.Toast;
 import com.google.android.gms.vision.barcode.Barcode;
 import com.google.cardboard.sdk.R;
+import java.nio.charset.StandardCharsets;
 
 /**
  * Class for processing QR code data. The QR code content should be a URI which has a parameter
  * named 'p' in the query string. This parameter contains the Cardboard Viewer Parameters encoded in
- * Base64. If needed, the URI can be redirected up to MAX_REDIRECTS times.
+ * Base64. If needed, the URI can be redirected a few times (e.g. when it is a short URL).
+ *
+ * <p>The QR code content is decoded, validated and saved by the native SDK. Only redirects and
+ * storage access go through {@link CardboardParamsUtils}.
  */
 public class QrCodeContentProcessor {
   private static final String TAG = QrCodeContentProcessor.class.getSimpleName();
 
+  /** Status codes returned by {@code nativeSaveDeviceParams()}. */
+  private static final int STATUS_OK = 0;
+
+  private static final int STATUS_UNEXPECTED_FORMAT = 1;
+  private static final int STATUS_CONNECTION_ERROR = 2;
+  private static final int STATUS_WRITE_ERROR = 3;
+
   private final Listener listener;
 
   public QrCodeContentProcessor(Listener listener) {
@@ -58,8 +69,7 @@ public class QrCodeContentProcessor {
    * Asynchronous Task to process QR code. Once it is processed, obtained parameters are saved in
    * external storage.
    */
-  public class ProcessAndSaveQrCodeTask
-      extends AsyncTask<Barcode, CardboardParamsUtils.UriToParamsStatus> {
+  public class ProcessAndSaveQrCodeTask extends AsyncTask<Barcode, Integer> {
     private final Context context;
 
     /**
@@ -74,23 +84,24 @@ public class QrCodeContentProcessor {
     }
 
     @Override
-    protected CardboardParamsUtils.UriToParamsStatus doInBackground(Barcode qrCode) {
-      UrlFactory urlFactory = new UrlFactory();
-      return getParamsFromQrCode(qrCode, urlFactory);
+    protected Integer doInBackground(Barcode qrCode) {
+      if (qrCode.valueFormat != Barcode.TEXT && qrCode.valueFormat != Barcode.URL) {
+        Log.e(TAG, "Invalid QR code format: " + qrCode.valueFormat);
+        return STATUS_UNEXPECTED_FORMAT;
+      }
+      return nativeSaveDeviceParams(qrCode.rawValue.getBytes(StandardCharsets.UTF_8), context);
     }
 
     @Override
-    protected void onPostExecute(CardboardParamsUtils.UriToParamsStatus result) {
-      boolean status = false;
-      if (result.statusCode == CardboardParamsUtils.UriToParamsStatus.STATUS_UNEXPECTED_FORMAT) {
+    protected void onPostExecute(Integer result) {
+      boolean status = result == STATUS_OK;
+      if (result == STATUS_UNEXPECTED_FORMAT) {
         Log.d(TAG, String.valueOf(R.string.invalid_qr_code));
         Toast.makeText(context, R.string.invalid_qr_code, Toast.LENGTH_LONG).show();
-      } else if (result.statusCode
-          == CardboardParamsUtils.UriToParamsStatus.STATUS_CONNECTION_ERROR) {
+      } else if (result == STATUS_CONNECTION_ERROR) {
         Log.d(TAG, String.valueOf(R.string.connection_error));
         Toast.makeText(context, R.string.connection_error, Toast.LENGTH_LONG).show();
-      } else if (result.params != null) {
-        status = CardboardParamsUtils.writeDeviceParams(result.params, context);
+      } else {
         Log.d(TAG, "Could " + (!status ? "not " : "") + "write Cardboard parameters to storage.");
       }
 
@@ -99,23 +110,11 @@ public class QrCodeContentProcessor {
   }
 
   /**
-   * Attempts to convert a QR code detection result into device parameters (as a protobuf).
+   * Decodes the device parameters from a QR code content and saves them.
    *
-   * <p>This function analyses the obtained string from a QR code in order to get the device
-   * parameters by calling {@code CardboardParamsUtils.getParamsFromUriString}.
-   *
-   * @param barcode The detected QR code.
-   * @param urlFactory Factory for creating URL instance for HTTPS connection.
-   * @return Cardboard device parameters, or null if there is an error.
+   * @param uri UTF-8 encoded QR code content.
+   * @param context The current Context, used to write the device parameters.
+   * @return One of the {@code STATUS_*} codes.
    */
-  private static CardboardParamsUtils.UriToParamsStatus getParamsFromQrCode(
-      Barcode barcode, UrlFactory urlFactory) {
-    if (barcode.valueFormat != Barcode.TEXT && barcode.valueFormat != Barcode.URL) {
-      Log.e(TAG, "Invalid QR code format: " + barcode.valueFormat);
-      return CardboardParamsUtils.UriToParamsStatus.error(
-          CardboardParamsUtils.UriToParamsStatus.STATUS_UNEXPECTED_FORMAT);
-    }
-
-    return CardboardParamsUtils.getParamsFromUriString(barcode.rawValue, urlFactory);
-  }
+  private static native int nativeSaveDeviceParams(byte[] uri, Context context);
 }
@@ -17,9 +17,14 @@
 
 #include <jni.h>
 
-#include <atomic>
+#include <string>
+#include <vector>
 
 #include "jni_utils/android/jni_utils.h"
+#include "qrcode/device_params_uri.h"
+#include "qrcode/saved_device_params.h"
+#include "util/logging.h"
+#include "util/trace.h"
 
 #define JNI_METHOD(return_type, clazz, method_name) \
   JNIEXPORT return_type JNICALL                     \
@@ -30,29 +35,113 @@ namespace cardboard::qrcode {
 namespace {
 JavaVM* vm_;
 jobject context_;
-jclass cardboard_params_utils_class_;
+jclass cardboard_params_utils_class_ = nullptr;
 jclass intent_class_;
 jclass component_name_class_;
-std::atomic<int> device_params_changed_count_(0);
-
-// TODO(b/180938531): Release these global references.
+jclass context_class_;
+jmethodID read_device_params_method_;
+jmethodID write_device_params_method_;
+jmethodID resolve_redirect_method_;
+jmethodID intent_constructor_;
+jmethodID intent_set_component_method_;
+jmethodID component_name_constructor_;
+jmethodID start_activity_method_;
+
+// Classes and methods are resolved once and pinned for the lifetime of the
+// process.
 void LoadJNIResources(JNIEnv* env) {
-  cardboard_params_utils_class_ =
-      reinterpret_cast<jclass>(env->NewGlobalRef(cardboard::jni::LoadJClass(
-          env, "com/google/cardboard/sdk/qrcode/CardboardParamsUtils")));
-  intent_class_ = reinterpret_cast<jclass>(env->NewGlobalRef(
-      cardboard::jni::LoadJClass(env, "android/content/Intent")));
-  component_name_class_ = reinterpret_cast<jclass>(env->NewGlobalRef(
-      cardboard::jni::LoadJClass(env, "android/content/ComponentName")));
+  if (cardboard_params_utils_class_ != nullptr) {
+    return;
+  }
+  cardboard_params_utils_class_ = cardboard::jni::LoadJClass(
+      env, "com/google/cardboard/sdk/qrcode/CardboardParamsUtils");
+  read_device_params_method_ = cardboard::jni::LoadJStaticMethodID(
+      env, cardboard_params_utils_class_, "readDeviceParams",
+      "(Landroid/content/Context;)[B");
+  write_device_params_method_ = cardboard::jni::LoadJStaticMethodID(
+      env, cardboard_params_utils_class_, "writeDeviceParams",
+      "([BLandroid/content/Context;)Z");
+  resolve_redirect_method_ = cardboard::jni::LoadJStaticMethodID(
+      env, cardboard_params_utils_class_, "resolveRedirect",
+      "(Ljava/lang/String;)Ljava/lang/String;");
+
+  intent_class_ = cardboard::jni::LoadJClass(env, "android/content/Intent");
+  intent_constructor_ =
+      cardboard::jni::LoadJMethodID(env, intent_class_, "<init>", "()V");
+  intent_set_component_method_ = cardboard::jni::LoadJMethodID(
+      env, intent_class_, "setComponent",
+      "(Landroid/content/ComponentName;)Landroid/content/Intent;");
+
+  component_name_class_ =
+      cardboard::jni::LoadJClass(env, "android/content/ComponentName");
+  component_name_constructor_ = cardboard::jni::LoadJMethodID(
+      env, component_name_class_, "<init>",
+      "(Landroid/content/Context;Ljava/lang/String;)V");
+
+  context_class_ = cardboard::jni::LoadJClass(env, "android/content/Context");
+  start_activity_method_ = cardboard::jni::LoadJMethodID(
+      env, context_class_, "startActivity", "(Landroid/content/Intent;)V");
+}
+
+// Status returned to Java when the decoded device parameters cannot be
+// written. It extends the DeviceParamsUriStatus values.
+constexpr int kWriteErrorStatus = 3;
+
+// Resolves a single redirect hop through the Java networking stack.
+DeviceParamsUriStatus ResolveRedirect(const std::string& url,
+                                      std::string* location) {
+  JNIEnv* env;
+  cardboard::jni::LoadJNIEnv(vm_, &env);
+
+  jstring url_string = env->NewStringUTF(url.c_str());
+  jstring location_string =
+      static_cast<jstring>(cardboard::jni::CallStaticObjectMethod(
+          env, cardboard_params_utils_class_, resolve_redirect_method_,
+          url_string));
+  env->DeleteLocalRef(url_string);
+  if (location_string == nullptr) {
+    return DeviceParamsUriStatus::kConnectionError;
+  }
+
+  const char* location_chars = env->GetStringUTFChars(location_string, nullptr);
+  *location = location_chars;
+  env->ReleaseStringUTFChars(location_string, location_chars);
+  env->DeleteLocalRef(location_string);
+  return DeviceParamsUriStatus::kOk;
 }
 
-void IncrementDeviceParamsChangedCount() {
-  device_params_changed_count_++;
+// Decodes the device parameters in @p uri and writes them using @p context.
+// The Java writer notifies the saved device parameters cache on success.
+int SaveDeviceParams(JNIEnv* env, const uint8_t* uri, int size,
+                     jobject context) {
+  std::vector<uint8_t> encoded_device_params;
+  const DeviceParamsUriStatus status = getDeviceParamsFromUri(
+      std::string(reinterpret_cast<const char*>(uri), size), ResolveRedirect,
+      &encoded_device_params);
+  if (status != DeviceParamsUriStatus::kOk) {
+    return static_cast<int>(status);
+  }
+
+  const jsize length = static_cast<jsize>(encoded_device_params.size());
+  jbyteArray device_params_array = env->NewByteArray(length);
+  env->SetByteArrayRegion(
+      device_params_array, 0, length,
+      reinterpret_cast<const jbyte*>(encoded_device_params.data()));
+  const bool written = cardboard::jni::CallStaticBooleanMethod(
+      env, cardboard_params_utils_class_, write_device_params_method_,
+      device_params_array, context);
+  env->DeleteLocalRef(device_params_array);
+  if (!written) {
+    CARDBOARD_LOGE("Cannot write the decoded device parameters.");
+    return kWriteErrorStatus;
+  }
+  return static_cast<int>(DeviceParamsUriStatus::kOk);
 }
 
 }  // anonymous namespace
 
 void initializeAndroid(JavaVM* vm, jobject context) {
+  CARDBOARD_TRACE_SCOPE("qrcode::initializeAndroid");
   vm_ = vm;
   context_ = context;
 
@@ -62,14 +151,14 @@ void initializeAndroid(JavaVM* vm, jobject context) {
 }
 
 std::vector<uint8_t> getCurrentSavedDeviceParams() {
+  CARDBOARD_TRACE_SCOPE("qrcode::getCurrentSavedDeviceParams");
   JNIEnv* env;
   cardboard::jni::LoadJNIEnv(vm_, &env);
 
-  jmethodID readDeviceParams =
-      env->GetStaticMethodID(cardboard_params_utils_class_, "readDeviceParams",
-                             "(Landroid/content/Context;)[B");
-  jbyteArray byteArray = static_cast<jbyteArray>(env->CallStaticObjectMethod(
-      cardboard_params_utils_class_, readDeviceParams, context_));
+  jbyteArray byteArray =
+      static_cast<jbyteArray>(cardboard::jni::CallStaticObjectMethod(
+          env, cardboard_params_utils_class_, read_device_params_method_,
+          context_));
   if (byteArray == nullptr) {
     return {};
   }
@@ -80,6 +169,7 @@ std::vector<uint8_t> getCurrentSavedDeviceParams() {
   buffer.resize(length);
   env->GetByteArrayRegion(byteArray, 0, length,
                           reinterpret_cast<jbyte*>(&buffer[0]));
+  env->DeleteLocalRef(byteArray);
   return buffer;
 }
 
@@ -89,69 +179,53 @@ void scanQrCodeAndSaveDeviceParams() {
   cardboard::jni::LoadJNIEnv(vm_, &env);
 
   // Get instance of Intent
-  jmethodID newIntent = env->GetMethodID(intent_class_, "<init>", "()V");
-  jobject intentObject = env->NewObject(intent_class_, newIntent);
+  jobject intentObject =
+      cardboard::jni::NewObject(env, intent_class_, intent_constructor_);
 
   // Get instance of ComponentName
-  jmethodID newComponentName =
-      env->GetMethodID(component_name_class_, "<init>",
-                       "(Landroid/content/Context;Ljava/lang/String;)V");
   jstring className =
       env->NewStringUTF("com.google.cardboard.sdk.QrCodeCaptureActivity");
-  jobject componentNameObject = env->NewObject(
-      component_name_class_, newComponentName, context_, className);
+  jobject componentNameObject = cardboard::jni::NewObject(
+      env, component_name_class_, component_name_constructor_, context_,
+      className);
 
   // Set component in intent
-  jmethodID setComponent = env->GetMethodID(
-      intent_class_, "setComponent",
-      "(Landroid/content/ComponentName;)Landroid/content/Intent;");
-  env->CallObjectMethod(intentObject, setComponent, componentNameObject);
+  jobject result = cardboard::jni::CallObjectMethod(
+      env, intentObject, intent_set_component_method_, componentNameObject);
 
   // Start activity using intent
-  jclass activityClass = env->GetObjectClass(context_);
-  jmethodID startActivity = env->GetMethodID(activityClass, "startActivity",
-                                             "(Landroid/content/Intent;)V");
-  env->CallVoidMethod(context_, startActivity, intentObject);
+  cardboard::jni::CallVoidMethod(env, context_, start_activity_method_,
+                                 intentObject);
+
+  env->DeleteLocalRef(result);
+  env->DeleteLocalRef(componentNameObject);
+  env->DeleteLocalRef(className);
+  env->DeleteLocalRef(intentObject);
 }
 
 void saveDeviceParams(const uint8_t* uri, int size) {
-  // Get JNI environment pointer
   JNIEnv* env;
   cardboard::jni::LoadJNIEnv(vm_, &env);
-
-  // Allocate memory for uri_jbyte_array
-  jbyteArray uri_jbyte_array = env->NewByteArray(size);
-
-  // Copy the uint8_t* to a jbyteArray
-  jbyte* java_data_ptr = env->GetByteArrayElements(uri_jbyte_array, 0);
-  memcpy(java_data_ptr, uri, size);
-  env->SetByteArrayRegion(uri_jbyte_array, 0, size, java_data_ptr);
-
-  // Get the Java class method to be called
-  jmethodID save_params_from_uri_method =
-      env->GetStaticMethodID(cardboard_params_utils_class_, "saveParamsFromUri",
-                             "([BLandroid/content/Context;)V");
-
-  // Call the Java class method
-  env->CallStaticVoidMethod(cardboard_params_utils_class_,
-                            save_params_from_uri_method, uri_jbyte_array,
-                            context_);
-
-  // Release memory allocated by uri_jbyte_array
-  env->ReleaseByteArrayElements(uri_jbyte_array, java_data_ptr, 0);
-
-  IncrementDeviceParamsChangedCount();
+  SaveDeviceParams(env, uri, size, context_);
 }
 
-int getDeviceParamsChangedCount() { return device_params_changed_count_; }
-
 }  // namespace cardboard::qrcode
 
 extern "C" {
 
-JNI_METHOD(void, QrCodeCaptureActivity, nativeIncrementDeviceParamsChangedCount)
-(JNIEnv* /*env*/, jobject /*obj*/) {
-  cardboard::qrcode::IncrementDeviceParamsChangedCount();
+JNI_METHOD(jint, qrcode_QrCodeContentProcessor, nativeSaveDeviceParams)
+(JNIEnv* env, jclass /*clazz*/, jbyteArray uri, jobject context) {
+  const jsize size = env->GetArrayLength(uri);
+  std::vector<uint8_t> uri_bytes(size);
+  env->GetByteArrayRegion(uri, 0, size,
+                          reinterpret_cast<jbyte*>(uri_bytes.data()));
+  return cardboard::qrcode::SaveDeviceParams(env, uri_bytes.data(), size,
+                                             context);
+}
+
+JNI_METHOD(void, qrcode_CardboardParamsUtils, nativeOnDeviceParamsSaved)
+(JNIEnv* /*env*/, jclass /*clazz*/) {
+  cardboard::qrcode::notifyDeviceParamsChanged();
 }
 
 }  // extern "C"
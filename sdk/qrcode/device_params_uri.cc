@@ -0,0 +1,298 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "qrcode/device_params_uri.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "device_params/device_params.h"
+#include "qrcode/cardboard_v1/cardboard_v1.h"
+#include "util/logging.h"
+
+namespace cardboard::qrcode {
+
+namespace {
+
+constexpr char kHttpsScheme[] = "https";
+constexpr char kHttpScheme[] = "http";
+constexpr char kOriginalCardboardUri[] = "https://g.co/cardboard";
+constexpr char kCardboardConfigHost[] = "google.com";
+constexpr char kCardboardConfigPath[] = "/cardboard/cfg";
+constexpr char kParamsQueryKey[] = "p";
+
+// Number of left eye field of view angles: left, right, bottom and top.
+constexpr int kFieldOfViewAnglesSize = 4;
+
+struct UriParts {
+  std::string scheme;
+  std::string authority;
+  std::string path;
+  std::string query;
+};
+
+bool IsSchemeChar(char c, bool first) {
+  const bool is_alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+  if (first) {
+    return is_alpha;
+  }
+  return is_alpha || (c >= '0' && c <= '9') || c == '+' || c == '-' ||
+         c == '.';
+}
+
+// Returns the length of the scheme of @p uri, or 0 when it has none.
+size_t SchemeLength(const std::string& uri) {
+  for (size_t i = 0; i < uri.size(); ++i) {
+    if (uri[i] == ':') {
+      return i;
+    }
+    if (!IsSchemeChar(uri[i], i == 0)) {
+      return 0;
+    }
+  }
+  return 0;
+}
+
+UriParts SplitUri(const std::string& uri) {
+  UriParts parts;
+  const size_t scheme_length = SchemeLength(uri);
+  size_t position = 0;
+  if (scheme_length > 0) {
+    parts.scheme = uri.substr(0, scheme_length);
+    position = scheme_length + 1;
+  }
+
+  // The fragment is never used.
+  const size_t end = std::min(uri.find('#', position), uri.size());
+
+  if (uri.compare(position, 2, "//") == 0) {
+    position += 2;
+    const size_t authority_end =
+        std::min(uri.find_first_of("/?", position), end);
+    parts.authority = uri.substr(position, authority_end - position);
+    position = authority_end;
+  }
+
+  const size_t path_end = std::min(uri.find('?', position), end);
+  parts.path = uri.substr(position, path_end - position);
+  if (path_end < end) {
+    parts.query = uri.substr(path_end + 1, end - path_end - 1);
+  }
+  return parts;
+}
+
+int HexValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+std::string PercentDecode(const std::string& encoded) {
+  std::string decoded;
+  decoded.reserve(encoded.size());
+  for (size_t i = 0; i < encoded.size(); ++i) {
+    if (encoded[i] == '%' && i + 2 < encoded.size() &&
+        HexValue(encoded[i + 1]) >= 0 && HexValue(encoded[i + 2]) >= 0) {
+      decoded.push_back(static_cast<char>(HexValue(encoded[i + 1]) * 16 +
+                                          HexValue(encoded[i + 2])));
+      i += 2;
+    } else {
+      decoded.push_back(encoded[i]);
+    }
+  }
+  return decoded;
+}
+
+// Gets the first value of @p key in @p query.
+bool GetQueryParameter(const std::string& query, const std::string& key,
+                       std::string* value) {
+  size_t position = 0;
+  while (position <= query.size()) {
+    const size_t end = std::min(query.find('&', position), query.size());
+    const std::string pair = query.substr(position, end - position);
+    const size_t separator = pair.find('=');
+    if (PercentDecode(pair.substr(0, separator)) == key) {
+      *value = separator == std::string::npos
+                   ? std::string()
+                   : PercentDecode(pair.substr(separator + 1));
+      return true;
+    }
+    position = end + 1;
+  }
+  return false;
+}
+
+bool IsOriginalCardboardDeviceUri(const std::string& uri) {
+  return uri == kOriginalCardboardUri;
+}
+
+bool IsCardboardDeviceUri(const std::string& uri) {
+  const UriParts parts = SplitUri(uri);
+  return parts.scheme == kHttpsScheme &&
+         parts.authority == kCardboardConfigHost &&
+         parts.path == kCardboardConfigPath;
+}
+
+bool IsCardboardUri(const std::string& uri) {
+  return IsOriginalCardboardDeviceUri(uri) || IsCardboardDeviceUri(uri);
+}
+
+int Base64UrlValue(char c) {
+  if (c >= 'A' && c <= 'Z') {
+    return c - 'A';
+  }
+  if (c >= 'a' && c <= 'z') {
+    return c - 'a' + 26;
+  }
+  if (c >= '0' && c <= '9') {
+    return c - '0' + 52;
+  }
+  if (c == '-') {
+    return 62;
+  }
+  if (c == '_') {
+    return 63;
+  }
+  return -1;
+}
+
+}  // anonymous namespace
+
+std::string normalizeUri(const std::string& uri) {
+  const size_t scheme_length = SchemeLength(uri);
+  if (scheme_length == 0) {
+    return std::string(kHttpsScheme) + "://" + uri;
+  }
+  if (uri.compare(0, scheme_length, kHttpScheme) == 0 &&
+      scheme_length == sizeof(kHttpScheme) - 1) {
+    return kHttpsScheme + uri.substr(scheme_length);
+  }
+  return uri;
+}
+
+bool decodeBase64Url(const std::string& encoded,
+                     std::vector<uint8_t>* decoded) {
+  size_t length = encoded.size();
+  while (length > 0 && encoded[length - 1] == '=') {
+    length--;
+  }
+  // A single character cannot encode a whole byte.
+  if (length % 4 == 1) {
+    return false;
+  }
+
+  decoded->clear();
+  decoded->reserve(length * 3 / 4);
+  uint32_t buffer = 0;
+  int buffered_bits = 0;
+  for (size_t i = 0; i < length; ++i) {
+    const int value = Base64UrlValue(encoded[i]);
+    if (value < 0) {
+      return false;
+    }
+    buffer = (buffer << 6) | static_cast<uint32_t>(value);
+    buffered_bits += 6;
+    if (buffered_bits >= 8) {
+      buffered_bits -= 8;
+      decoded->push_back(static_cast<uint8_t>(buffer >> buffered_bits));
+      buffer &= (1u << buffered_bits) - 1;
+    }
+  }
+  return true;
+}
+
+bool validateDeviceParams(const std::vector<uint8_t>& encoded_device_params) {
+  device_params::DeviceParams device_params;
+  if (encoded_device_params.empty() ||
+      !device_params.ParseFromArray(
+          encoded_device_params.data(),
+          static_cast<int>(encoded_device_params.size()))) {
+    CARDBOARD_LOGE("Malformed device parameters.");
+    return false;
+  }
+  if (device_params.left_eye_field_of_view_angles_size() !=
+      kFieldOfViewAnglesSize) {
+    CARDBOARD_LOGE("Device parameters have %d field of view angles.",
+                   device_params.left_eye_field_of_view_angles_size());
+    return false;
+  }
+
+  bool all_finite = std::isfinite(device_params.screen_to_lens_distance()) &&
+                    std::isfinite(device_params.inter_lens_distance()) &&
+                    std::isfinite(device_params.tray_to_lens_distance());
+  for (int i = 0; i < kFieldOfViewAnglesSize; ++i) {
+    all_finite &= std::isfinite(device_params.left_eye_field_of_view_angles(i));
+  }
+  for (int i = 0; i < device_params.distortion_coefficients_size(); ++i) {
+    all_finite &= std::isfinite(device_params.distortion_coefficients(i));
+  }
+  if (!all_finite) {
+    CARDBOARD_LOGE("Device parameters hold non finite values.");
+    return false;
+  }
+  return true;
+}
+
+DeviceParamsUriStatus getDeviceParamsFromUri(
+    const std::string& uri, const RedirectFetcher& fetcher,
+    std::vector<uint8_t>* encoded_device_params) {
+  std::string current_uri = normalizeUri(uri);
+
+  // Follows redirects to support URL shortening. Cardboard URIs are never
+  // fetched.
+  for (int redirects = 0; !IsCardboardUri(current_uri); ++redirects) {
+    if (redirects >= kMaxRedirects || !fetcher) {
+      CARDBOARD_LOGE("Cannot resolve a Cardboard URI from the QR code.");
+      return DeviceParamsUriStatus::kUnexpectedFormat;
+    }
+    std::string location;
+    const DeviceParamsUriStatus status = fetcher(current_uri, &location);
+    if (status != DeviceParamsUriStatus::kOk) {
+      return status;
+    }
+    if (location.empty() || normalizeUri(location) == current_uri) {
+      CARDBOARD_LOGE("URI is not redirected to a Cardboard URI.");
+      return DeviceParamsUriStatus::kUnexpectedFormat;
+    }
+    current_uri = normalizeUri(location);
+  }
+
+  if (IsOriginalCardboardDeviceUri(current_uri)) {
+    *encoded_device_params = getCardboardV1DeviceParams();
+    return DeviceParamsUriStatus::kOk;
+  }
+
+  std::string params;
+  std::vector<uint8_t> decoded_params;
+  if (!GetQueryParameter(SplitUri(current_uri).query, kParamsQueryKey,
+                         &params) ||
+      !decodeBase64Url(params, &decoded_params) ||
+      !validateDeviceParams(decoded_params)) {
+    CARDBOARD_LOGE("Cannot decode device parameters from the Cardboard URI.");
+    return DeviceParamsUriStatus::kUnexpectedFormat;
+  }
+  *encoded_device_params = std::move(decoded_params);
+  return DeviceParamsUriStatus::kOk;
+}
+
+}  // namespace cardboard::qrcode
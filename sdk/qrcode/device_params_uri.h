@@ -0,0 +1,83 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_QRCODE_DEVICE_PARAMS_URI_H_
+#define CARDBOARD_SDK_QRCODE_DEVICE_PARAMS_URI_H_
+
+#include <stdint.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace cardboard::qrcode {
+
+/// Result of resolving a URI into device parameters.
+enum class DeviceParamsUriStatus {
+  kOk = 0,
+  kUnexpectedFormat = 1,
+  kConnectionError = 2,
+};
+
+/// Resolves a single redirect hop of @p url without following it.
+///
+/// @param[in]      url                     HTTPS URL to query.
+/// @param[out]     location                Redirect target. Empty when @p url
+///                                         is not redirected.
+/// @return kOk when the server answered, kConnectionError otherwise.
+using RedirectFetcher = std::function<DeviceParamsUriStatus(
+    const std::string& url, std::string* location)>;
+
+/// Maximum number of redirects followed before reaching a Cardboard URI.
+constexpr int kMaxRedirects = 5;
+
+/// Gets the device parameters encoded in a QR code URI.
+///
+/// @details The URI is first normalized to HTTPS. Cardboard Viewer v1 URIs
+///          (https://g.co/cardboard) map to the Cardboard Viewer v1
+///          parameters. Cardboard URIs (https://google.com/cardboard/cfg?p=)
+///          are decoded locally from the base64url @c p query parameter. Any
+///          other URI is assumed to be a short URL and @p fetcher is used to
+///          follow up to @c kMaxRedirects redirects until a Cardboard URI is
+///          reached. The decoded parameters are validated before returning.
+///
+/// @param[in]      uri                     QR code content.
+/// @param[in]      fetcher                 Redirect resolver. It is only called
+///                                         for non Cardboard URIs.
+/// @param[out]     encoded_device_params   Device parameters serialized using
+///                                         cardboard_device.proto. Only set
+///                                         when kOk is returned.
+/// @return The status of the operation.
+DeviceParamsUriStatus getDeviceParamsFromUri(
+    const std::string& uri, const RedirectFetcher& fetcher,
+    std::vector<uint8_t>* encoded_device_params);
+
+/// Prefixes @p uri with an HTTPS scheme when it has none and replaces an HTTP
+/// scheme by HTTPS.
+std::string normalizeUri(const std::string& uri);
+
+/// Decodes base64url data without padding nor line wraps. Trailing padding is
+/// tolerated.
+///
+/// @return false when @p encoded is not valid base64url.
+bool decodeBase64Url(const std::string& encoded, std::vector<uint8_t>* decoded);
+
+/// Checks that @p encoded_device_params hold well formed device parameters
+/// that a LensDistortion can be built from.
+bool validateDeviceParams(const std::vector<uint8_t>& encoded_device_params);
+
+}  // namespace cardboard::qrcode
+
+#endif  // CARDBOARD_SDK_QRCODE_DEVICE_PARAMS_URI_H_
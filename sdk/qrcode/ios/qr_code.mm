@@ -18,20 +18,15 @@
 #import <AVFoundation/AVFoundation.h>
 #import <UIKit/UIKit.h>
 
-#import <atomic>
-
 #import "qrcode/ios/device_params_helper.h"
 #import "qrcode/ios/qr_scan_view_controller.h"
+#import "qrcode/saved_device_params.h"
 #import "util/logging.h"
 
 namespace cardboard {
 namespace qrcode {
 namespace {
 
-std::atomic<int32_t> deviceParamsChangedCount = {0};
-
-void incrementDeviceParamsChangedCount() { std::atomic_fetch_add(&deviceParamsChangedCount, 1); }
-
 void showQRScanViewController() {
   UIViewController *presentingViewController = nil;
   presentingViewController = [UIApplication sharedApplication].keyWindow.rootViewController;
@@ -44,7 +39,7 @@ void showQRScanViewController() {
 
   __block CardboardQRScanViewController *qrViewController =
       [[CardboardQRScanViewController alloc] initWithCompletion:^(BOOL /*succeeded*/) {
-        incrementDeviceParamsChangedCount();
+        notifyDeviceParamsChanged();
         [qrViewController dismissViewControllerAnimated:YES completion:nil];
       }];
 
@@ -118,6 +113,7 @@ void saveDeviceParams(const uint8_t *uri, int /*size*/) {
                             withCompletion:^(BOOL success, NSError *error) {
                               if (success) {
                                 CARDBOARD_LOGI("Successfully saved device parameters to storage");
+                                notifyDeviceParamsChanged();
                               } else {
                                 if (error) {
                                   CARDBOARD_LOGE(
@@ -130,7 +126,5 @@ void saveDeviceParams(const uint8_t *uri, int /*size*/) {
                             }];
 }
 
-int getDeviceParamsChangedCount() { return deviceParamsChangedCount; }
-
 }  // namespace qrcode
 }  // namespace cardboard
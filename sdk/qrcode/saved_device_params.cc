@@ -0,0 +1,120 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "qrcode/saved_device_params.h"
+
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+#include "qr_code.h"
+#include "util/logging.h"
+#include "util/trace.h"
+
+namespace cardboard::qrcode {
+
+namespace {
+
+std::atomic<int> device_params_changed_count_(0);
+
+// Guards the cached device parameters.
+std::mutex cache_mutex_;
+std::shared_ptr<const SavedDeviceParams> cached_device_params_;
+// Value of device_params_changed_count_ when cached_device_params_ was read. -1
+// means that the cache has never been filled.
+int cached_device_params_count_ = -1;
+
+// Guards the change callback.
+std::mutex callback_mutex_;
+void (*device_params_changed_callback_)(void*) = nullptr;
+void* device_params_changed_user_data_ = nullptr;
+
+// Reads and decodes the saved device parameters from storage.
+std::shared_ptr<const SavedDeviceParams> ReadSavedDeviceParams() {
+  CARDBOARD_TRACE_SCOPE("qrcode::ReadSavedDeviceParams");
+  auto device_params = std::make_shared<SavedDeviceParams>();
+  device_params->encoded = getCurrentSavedDeviceParams();
+  if (device_params->encoded.empty()) {
+    return device_params;
+  }
+  device_params->is_decoded = device_params->decoded.ParseFromArray(
+      device_params->encoded.data(),
+      static_cast<int>(device_params->encoded.size()));
+  if (!device_params->is_decoded) {
+    CARDBOARD_LOGE("Cannot parse the saved device parameters.");
+  }
+  return device_params;
+}
+
+}  // anonymous namespace
+
+std::shared_ptr<const SavedDeviceParams> getSavedDeviceParams() {
+  // The count is loaded before reading the storage so a change that races
+  // with the read makes the next call read it again.
+  const int changed_count = device_params_changed_count_;
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    if (cached_device_params_count_ == changed_count) {
+      return cached_device_params_;
+    }
+  }
+
+  // The storage is read without holding the lock, so callers that find the
+  // cache up to date are not blocked behind a slow read (a JNI call on
+  // Android).
+  std::shared_ptr<const SavedDeviceParams> device_params =
+      ReadSavedDeviceParams();
+
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  // Another caller may have cached newer parameters while the storage was
+  // read, in which case they are kept.
+  if (cached_device_params_count_ < changed_count) {
+    // Readers holding the previous snapshot keep it alive until they release
+    // it.
+    cached_device_params_ = std::move(device_params);
+    cached_device_params_count_ = changed_count;
+  }
+  return cached_device_params_;
+}
+
+void notifyDeviceParamsChanged() {
+  device_params_changed_count_++;
+  CARDBOARD_TRACE_COUNTER("DeviceParamsChangedCount",
+                          device_params_changed_count_.load());
+
+  void (*callback)(void*);
+  void* user_data;
+  {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    callback = device_params_changed_callback_;
+    user_data = device_params_changed_user_data_;
+  }
+  // The callback is invoked without holding the lock so it can query the new
+  // device parameters or replace itself.
+  if (callback != nullptr) {
+    callback(user_data);
+  }
+}
+
+int getDeviceParamsChangedCount() { return device_params_changed_count_; }
+
+void setDeviceParamsChangedCallback(void (*callback)(void* user_data),
+                                    void* user_data) {
+  std::lock_guard<std::mutex> lock(callback_mutex_);
+  device_params_changed_callback_ = callback;
+  device_params_changed_user_data_ = user_data;
+}
+
+}  // namespace cardboard::qrcode
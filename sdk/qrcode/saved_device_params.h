@@ -0,0 +1,68 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_QRCODE_SAVED_DEVICE_PARAMS_H_
+#define CARDBOARD_SDK_QRCODE_SAVED_DEVICE_PARAMS_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "device_params/device_params.h"
+
+namespace cardboard::qrcode {
+
+/// Immutable snapshot of the saved device parameters, in both serialized and
+/// decoded forms. It is shared by every reader until the parameters change.
+struct SavedDeviceParams {
+  std::vector<uint8_t> encoded;
+  device_params::DeviceParams decoded;
+  // Whether @c decoded holds the parameters of @c encoded. It is false when
+  // no device parameters are saved or they cannot be parsed.
+  bool is_decoded = false;
+};
+
+/// Platform independent cache of the saved device parameters.
+///
+/// The platform specific code calls notifyDeviceParamsChanged() whenever new
+/// device parameters are saved. The cache then reloads them from storage,
+/// through getCurrentSavedDeviceParams(), the first time they are requested
+/// after the change. Reading the change count is a single atomic load.
+
+/// Gets the saved device parameters, reading and decoding them from storage
+/// only when they changed since the last call. The storage is read without
+/// holding any lock: callers racing on a change may each read it, and the
+/// snapshot of the latest change is kept. Callers share the returned object,
+/// so no copy is made. Its encoded buffer is empty when no device parameters
+/// are saved.
+std::shared_ptr<const SavedDeviceParams> getSavedDeviceParams();
+
+/// Marks the saved device parameters as changed and invokes the registered
+/// callback, if any, on the calling thread.
+void notifyDeviceParamsChanged();
+
+/// Gets the number of times notifyDeviceParamsChanged() has been called.
+int getDeviceParamsChangedCount();
+
+/// Registers @p callback to be invoked with @p user_data every time the saved
+/// device parameters change. It replaces any previously registered callback.
+/// Passing nullptr removes it.
+void setDeviceParamsChangedCallback(void (*callback)(void* user_data),
+                                    void* user_data);
+
+}  // namespace cardboard::qrcode
+
+#endif  // CARDBOARD_SDK_QRCODE_SAVED_DEVICE_PARAMS_H_
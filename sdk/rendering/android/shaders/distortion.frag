@@ -19,12 +19,15 @@
 precision mediump float;
 
 layout (binding = 0) uniform sampler2D u_Texture;
-layout (location = 0) in vec2 v_TexCoords;
+layout (location = 0) in vec3 v_TexCoords;
 layout (location = 1) in vec2 u_Start;
 layout (location = 2) in vec2 u_End;
 layout (location = 0) out vec4 o_FragColor;
 
 void main() {
-   vec2 coords = u_Start + v_TexCoords * (u_End - u_Start);
+   // Clamped to the eye texture rectangle, so that the texels around the
+   // rendered area are never sampled.
+   vec2 coords = clamp(v_TexCoords.xy / v_TexCoords.z, 0.0, 1.0);
+   coords = u_Start + coords * (u_End - u_Start);
    o_FragColor = texture(u_Texture, coords);
 }
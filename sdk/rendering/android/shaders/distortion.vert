@@ -20,21 +20,22 @@ precision mediump float;
 
 layout (location = 0) in vec2 a_Position;
 layout (location = 1) in vec2 a_TexCoords;
-layout (location = 0) out vec2 v_TexCoords;
+layout (location = 0) out vec3 v_TexCoords;
 layout (location = 1) out vec2 u_Start;
 layout (location = 2) out vec2 u_End;
 
-layout( push_constant ) uniform constants
+layout (binding = 1) uniform UniformBufferObject
 {
     float left_u;
     float right_u;
     float top_v;
     float bottom_v;
-} push_constants;
+    mat3 reprojection;
+} ubo;
 
 void main() {
    gl_Position = vec4(a_Position, 0, 1);
-   v_TexCoords = a_TexCoords;
-   u_Start = vec2(push_constants.left_u, push_constants.bottom_v);
-   u_End = vec2(push_constants.right_u, push_constants.top_v);
+   v_TexCoords = ubo.reprojection * vec3(a_TexCoords, 1);
+   u_Start = vec2(ubo.left_u, ubo.bottom_v);
+   u_End = vec2(ubo.right_u, ubo.top_v);
 }
@@ -0,0 +1,41 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#version 330
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+precision mediump float;
+
+layout (binding = 0) uniform sampler2D u_Texture;
+layout (location = 0) in vec3 v_TexCoords;
+layout (location = 1) in vec2 u_Start;
+layout (location = 2) in vec2 u_End;
+layout (location = 3) in vec3 v_TexCoordsRed;
+layout (location = 4) in vec3 v_TexCoordsBlue;
+layout (location = 0) out vec4 o_FragColor;
+
+vec2 GetCoords(vec3 coords) {
+   // Clamped to the eye texture rectangle, as in distortion.frag.
+   return u_Start + clamp(coords.xy / coords.z, 0.0, 1.0) * (u_End - u_Start);
+}
+
+// Variant of distortion.frag for meshes with chromatic aberration correction:
+// the red, green and blue channels are sampled at their own coordinates.
+void main() {
+   vec4 color = texture(u_Texture, GetCoords(v_TexCoords));
+   color.r = texture(u_Texture, GetCoords(v_TexCoordsRed)).r;
+   color.b = texture(u_Texture, GetCoords(v_TexCoordsBlue)).b;
+   o_FragColor = color;
+}
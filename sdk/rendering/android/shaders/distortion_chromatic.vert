@@ -0,0 +1,49 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#version 330
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+precision mediump float;
+
+layout (location = 0) in vec2 a_Position;
+layout (location = 1) in vec2 a_TexCoords;
+layout (location = 2) in vec2 a_TexCoordsRed;
+layout (location = 3) in vec2 a_TexCoordsBlue;
+layout (location = 0) out vec3 v_TexCoords;
+layout (location = 1) out vec2 u_Start;
+layout (location = 2) out vec2 u_End;
+layout (location = 3) out vec3 v_TexCoordsRed;
+layout (location = 4) out vec3 v_TexCoordsBlue;
+
+layout (binding = 1) uniform UniformBufferObject
+{
+    float left_u;
+    float right_u;
+    float top_v;
+    float bottom_v;
+    mat3 reprojection;
+} ubo;
+
+// Variant of distortion.vert for meshes with chromatic aberration correction,
+// which have texture coordinates per color channel.
+void main() {
+   gl_Position = vec4(a_Position, 0, 1);
+   v_TexCoords = ubo.reprojection * vec3(a_TexCoords, 1);
+   v_TexCoordsRed = ubo.reprojection * vec3(a_TexCoordsRed, 1);
+   v_TexCoordsBlue = ubo.reprojection * vec3(a_TexCoordsBlue, 1);
+   u_Start = vec2(ubo.left_u, ubo.bottom_v);
+   u_End = vec2(ubo.right_u, ubo.top_v);
+}
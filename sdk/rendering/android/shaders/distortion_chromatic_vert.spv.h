@@ -0,0 +1,101 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// 1011.5.0
+#pragma once
+const uint32_t distortion_chromatic_vert[] = {
+		0x07230203,0x00010000,0x0008000a,0x0000004b,0x00000000,0x00020011,0x00000001,0x0006000b,
+		0x00000001,0x4c534c47,0x6474732e,0x3035342e,0x00000000,0x0003000e,0x00000000,0x00000001,
+		0x000f000f,0x00000000,0x00000002,0x6e69616d,0x00000000,0x00000003,0x00000004,0x00000005,
+		0x00000006,0x00000007,0x00000008,0x00000009,0x0000000a,0x0000000b,0x0000000c,0x00030003,
+		0x00000002,0x0000014a,0x00090004,0x415f4c47,0x735f4252,0x72617065,0x5f657461,0x64616873,
+		0x6f5f7265,0x63656a62,0x00007374,0x00090004,0x415f4c47,0x735f4252,0x69646168,0x6c5f676e,
+		0x75676e61,0x5f656761,0x70303234,0x006b6361,0x00040005,0x00000002,0x6e69616d,0x00000000,
+		0x00060005,0x0000000d,0x505f6c67,0x65567265,0x78657472,0x00000000,0x00060006,0x0000000d,
+		0x00000000,0x505f6c67,0x7469736f,0x006e6f69,0x00070006,0x0000000d,0x00000001,0x505f6c67,
+		0x746e696f,0x657a6953,0x00000000,0x00070006,0x0000000d,0x00000002,0x435f6c67,0x4470696c,
+		0x61747369,0x0065636e,0x00030005,0x00000003,0x00000000,0x00050005,0x00000004,0x6f505f61,
+		0x69746973,0x00006e6f,0x00050005,0x00000005,0x65545f76,0x6f6f4378,0x00736472,0x00070005,
+		0x0000000e,0x66696e55,0x426d726f,0x65666675,0x6a624f72,0x00746365,0x00050006,0x0000000e,
+		0x00000000,0x7466656c,0x0000755f,0x00050006,0x0000000e,0x00000001,0x68676972,0x00755f74,
+		0x00050006,0x0000000e,0x00000002,0x5f706f74,0x00000076,0x00060006,0x0000000e,0x00000003,
+		0x74746f62,0x765f6d6f,0x00000000,0x00070006,0x0000000e,0x00000004,0x72706572,0x63656a6f,
+		0x6e6f6974,0x00000000,0x00030005,0x0000000f,0x006f6275,0x00050005,0x00000006,0x65545f61,
+		0x6f6f4378,0x00736472,0x00040005,0x00000007,0x74535f75,0x00747261,0x00040005,0x00000008,
+		0x6e455f75,0x00000064,0x00060005,0x00000009,0x65545f76,0x6f6f4378,0x52736472,0x00006465,
+		0x00060005,0x0000000a,0x65545f61,0x6f6f4378,0x52736472,0x00006465,0x00060005,0x0000000b,
+		0x65545f76,0x6f6f4378,0x42736472,0x0065756c,0x00060005,0x0000000c,0x65545f61,0x6f6f4378,
+		0x42736472,0x0065756c,0x00050048,0x0000000d,0x00000000,0x0000000b,0x00000000,0x00050048,
+		0x0000000d,0x00000001,0x0000000b,0x00000001,0x00050048,0x0000000d,0x00000002,0x0000000b,
+		0x00000003,0x00030047,0x0000000d,0x00000002,0x00030047,0x00000004,0x00000000,0x00040047,
+		0x00000004,0x0000001e,0x00000000,0x00030047,0x00000005,0x00000000,0x00040047,0x00000005,
+		0x0000001e,0x00000000,0x00040048,0x0000000e,0x00000000,0x00000000,0x00050048,0x0000000e,
+		0x00000000,0x00000023,0x00000000,0x00040048,0x0000000e,0x00000001,0x00000000,0x00050048,
+		0x0000000e,0x00000001,0x00000023,0x00000004,0x00040048,0x0000000e,0x00000002,0x00000000,
+		0x00050048,0x0000000e,0x00000002,0x00000023,0x00000008,0x00040048,0x0000000e,0x00000003,
+		0x00000000,0x00050048,0x0000000e,0x00000003,0x00000023,0x0000000c,0x00040048,0x0000000e,
+		0x00000004,0x00000000,0x00040048,0x0000000e,0x00000004,0x00000005,0x00050048,0x0000000e,
+		0x00000004,0x00000023,0x00000010,0x00050048,0x0000000e,0x00000004,0x00000007,0x00000010,
+		0x00030047,0x0000000e,0x00000002,0x00040047,0x0000000f,0x00000022,0x00000000,0x00040047,
+		0x0000000f,0x00000021,0x00000001,0x00030047,0x00000006,0x00000000,0x00040047,0x00000006,
+		0x0000001e,0x00000001,0x00030047,0x00000007,0x00000000,0x00040047,0x00000007,0x0000001e,
+		0x00000001,0x00030047,0x00000008,0x00000000,0x00040047,0x00000008,0x0000001e,0x00000002,
+		0x00030047,0x00000009,0x00000000,0x00040047,0x00000009,0x0000001e,0x00000003,0x00030047,
+		0x0000000a,0x00000000,0x00040047,0x0000000a,0x0000001e,0x00000002,0x00030047,0x0000000b,
+		0x00000000,0x00040047,0x0000000b,0x0000001e,0x00000004,0x00030047,0x0000000c,0x00000000,
+		0x00040047,0x0000000c,0x0000001e,0x00000003,0x00020013,0x00000010,0x00030021,0x00000011,
+		0x00000010,0x00030016,0x00000012,0x00000020,0x00040017,0x00000013,0x00000012,0x00000004,
+		0x00040015,0x00000014,0x00000020,0x00000000,0x0004002b,0x00000014,0x00000015,0x00000001,
+		0x0004001c,0x00000016,0x00000012,0x00000015,0x0005001e,0x0000000d,0x00000013,0x00000012,
+		0x00000016,0x00040020,0x00000017,0x00000003,0x0000000d,0x0004003b,0x00000017,0x00000003,
+		0x00000003,0x00040015,0x00000018,0x00000020,0x00000001,0x0004002b,0x00000018,0x00000019,
+		0x00000000,0x00040017,0x0000001a,0x00000012,0x00000002,0x00040020,0x0000001b,0x00000001,
+		0x0000001a,0x0004003b,0x0000001b,0x00000004,0x00000001,0x0004002b,0x00000012,0x0000001c,
+		0x00000000,0x0004002b,0x00000012,0x0000001d,0x3f800000,0x00040020,0x0000001e,0x00000003,
+		0x00000013,0x00040017,0x0000001f,0x00000012,0x00000003,0x00040020,0x00000020,0x00000003,
+		0x0000001f,0x0004003b,0x00000020,0x00000005,0x00000003,0x00040018,0x00000021,0x0000001f,
+		0x00000003,0x0007001e,0x0000000e,0x00000012,0x00000012,0x00000012,0x00000012,0x00000021,
+		0x00040020,0x00000022,0x00000002,0x0000000e,0x0004003b,0x00000022,0x0000000f,0x00000002,
+		0x0004002b,0x00000018,0x00000023,0x00000004,0x00040020,0x00000024,0x00000002,0x00000021,
+		0x0004003b,0x0000001b,0x00000006,0x00000001,0x00040020,0x00000025,0x00000003,0x0000001a,
+		0x0004003b,0x00000025,0x00000007,0x00000003,0x00040020,0x00000026,0x00000002,0x00000012,
+		0x0004002b,0x00000018,0x00000027,0x00000003,0x0004003b,0x00000025,0x00000008,0x00000003,
+		0x0004002b,0x00000018,0x00000028,0x00000001,0x0004002b,0x00000018,0x00000029,0x00000002,
+		0x0004003b,0x00000020,0x00000009,0x00000003,0x0004003b,0x0000001b,0x0000000a,0x00000001,
+		0x0004003b,0x00000020,0x0000000b,0x00000003,0x0004003b,0x0000001b,0x0000000c,0x00000001,
+		0x00050036,0x00000010,0x00000002,0x00000000,0x00000011,0x000200f8,0x0000002a,0x0004003d,
+		0x0000001a,0x0000002b,0x00000004,0x00050051,0x00000012,0x0000002c,0x0000002b,0x00000000,
+		0x00050051,0x00000012,0x0000002d,0x0000002b,0x00000001,0x00070050,0x00000013,0x0000002e,
+		0x0000002c,0x0000002d,0x0000001c,0x0000001d,0x00050041,0x0000001e,0x0000002f,0x00000003,
+		0x00000019,0x0003003e,0x0000002f,0x0000002e,0x00050041,0x00000024,0x00000030,0x0000000f,
+		0x00000023,0x0004003d,0x00000021,0x00000031,0x00000030,0x0004003d,0x0000001a,0x00000032,
+		0x00000006,0x00050051,0x00000012,0x00000033,0x00000032,0x00000000,0x00050051,0x00000012,
+		0x00000034,0x00000032,0x00000001,0x00060050,0x0000001f,0x00000035,0x00000033,0x00000034,
+		0x0000001d,0x00050091,0x0000001f,0x00000036,0x00000031,0x00000035,0x0003003e,0x00000005,
+		0x00000036,0x0004003d,0x0000001a,0x00000037,0x0000000a,0x00050051,0x00000012,0x00000038,
+		0x00000037,0x00000000,0x00050051,0x00000012,0x00000039,0x00000037,0x00000001,0x00060050,
+		0x0000001f,0x0000003a,0x00000038,0x00000039,0x0000001d,0x00050091,0x0000001f,0x0000003b,
+		0x00000031,0x0000003a,0x0003003e,0x00000009,0x0000003b,0x0004003d,0x0000001a,0x0000003c,
+		0x0000000c,0x00050051,0x00000012,0x0000003d,0x0000003c,0x00000000,0x00050051,0x00000012,
+		0x0000003e,0x0000003c,0x00000001,0x00060050,0x0000001f,0x0000003f,0x0000003d,0x0000003e,
+		0x0000001d,0x00050091,0x0000001f,0x00000040,0x00000031,0x0000003f,0x0003003e,0x0000000b,
+		0x00000040,0x00050041,0x00000026,0x00000041,0x0000000f,0x00000019,0x0004003d,0x00000012,
+		0x00000042,0x00000041,0x00050041,0x00000026,0x00000043,0x0000000f,0x00000027,0x0004003d,
+		0x00000012,0x00000044,0x00000043,0x00050050,0x0000001a,0x00000045,0x00000042,0x00000044,
+		0x0003003e,0x00000007,0x00000045,0x00050041,0x00000026,0x00000046,0x0000000f,0x00000028,
+		0x0004003d,0x00000012,0x00000047,0x00000046,0x00050041,0x00000026,0x00000048,0x0000000f,
+		0x00000029,0x0004003d,0x00000012,0x00000049,0x00000048,0x00050050,0x0000001a,0x0000004a,
+		0x00000047,0x00000049,0x0003003e,0x00000008,0x0000004a,0x000100fd,0x00010038
+};
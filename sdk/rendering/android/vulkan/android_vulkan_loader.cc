@@ -21,6 +21,11 @@ namespace cardboard::rendering {
 
 bool LoadVulkan() {
   void* libvulkan = dlopen("libvulkan.so", RTLD_NOW | RTLD_LOCAL);
+  if (!libvulkan) {
+    // Desktop Linux loaders, e.g. with lavapipe, only ship the versioned name
+    // unless the development package is installed.
+    libvulkan = dlopen("libvulkan.so.1", RTLD_NOW | RTLD_LOCAL);
+  }
   if (!libvulkan) {
     return false;
   }
@@ -16,17 +16,24 @@
 #include <sys/types.h>
 
 #include <array>
+#include <atomic>
 #include <cstdint>
+#include <mutex>
 #include <vector>
 
 #include "distortion_renderer.h"
 #include "include/cardboard.h"
+#include "rendering/android/shaders/distortion_chromatic_frag.spv.h"
+#include "rendering/android/shaders/distortion_chromatic_vert.spv.h"
 #include "rendering/android/shaders/distortion_frag.spv.h"
 #include "rendering/android/shaders/distortion_vert.spv.h"
 #include "rendering/android/vulkan/android_vulkan_loader.h"
 #include "util/is_arg_null.h"
 #include "util/is_initialized.h"
 #include "util/logging.h"
+#include "util/reprojection.h"
+#include "util/trace.h"
+#include "util/vignette.h"
 
 // Vulkan call wrapper
 #define CALL_VK(func)                                                    \
@@ -40,24 +47,28 @@
 
 namespace cardboard::rendering {
 
-struct PushConstantsObject {
+// Per frame inputs of the vertex shader, in its std140 uniform block layout.
+struct UniformBufferObject {
   float left_u;
   float right_u;
   float top_v;
   float bottom_v;
+  // Column-major 3x3 reprojection. Each column is padded to 4 floats, as
+  // the columns of a mat3 are 16 bytes apart in a std140 uniform block.
+  std::array<float, 12> reprojection;
 };
 
-struct Vertex {
-  float pos_x;
-  float pos_y;
-  float tex_u;
-  float tex_v;
-};
+// Number of floats of a vertex: its position and texture coordinates, then,
+// with chromatic aberration correction, the texture coordinates of the red and
+// blue channels.
+constexpr int kVertexFloatCount = 4;
+constexpr int kChromaticVertexFloatCount = 8;
 
 class VulkanDistortionRenderer : public DistortionRenderer {
  public:
-  explicit VulkanDistortionRenderer(
-      const CardboardVulkanDistortionRendererConfig* config) {
+  VulkanDistortionRenderer(
+      const CardboardVulkanDistortionRendererConfig* config,
+      const CardboardVulkanDistortionRendererOptions& options) {
     if (!LoadVulkan()) {
       CARDBOARD_LOGE("Failed to load vulkan lib in cardboard!");
       return;
@@ -70,17 +81,27 @@ class VulkanDistortionRenderer : public DistortionRenderer {
     CALL_VK(vkGetSwapchainImagesKHR(logical_device_, swapchain_,
                                     &swapchain_image_count_,
                                     nullptr /* pSwapchainImages */));
+    max_frames_in_flight_ = options.max_frames_in_flight;
+    frame_count_ = max_frames_in_flight_ != 0 ? max_frames_in_flight_
+                                              : swapchain_image_count_;
 
     CreateSharedVulkanObjects();
     CreatePerEyeVulkanObjects(kLeft);
     CreatePerEyeVulkanObjects(kRight);
+    if (options.use_secondary_command_buffers != 0) {
+      CreateSecondaryCommandBuffers(options.queue_family_index);
+    }
   }
 
   ~VulkanDistortionRenderer() {
-    for (uint32_t i = 0; i < swapchain_image_count_; i++) {
+    for (uint32_t i = 0; i < frame_count_; i++) {
       CleanTextureImageView(kLeft, i);
       CleanTextureImageView(kRight, i);
     }
+    CleanOwnedRenderPass();
+    for (VkCommandPool command_pool : secondary_command_pools_) {
+      vkDestroyCommandPool(logical_device_, command_pool, nullptr);
+    }
 
     vkDestroySampler(logical_device_, texture_sampler_, nullptr);
     vkDestroyPipelineLayout(logical_device_, pipeline_layout_, nullptr);
@@ -89,30 +110,45 @@ class VulkanDistortionRenderer : public DistortionRenderer {
 
     vkDestroyDescriptorPool(logical_device_, descriptor_pool_[kLeft], nullptr);
     vkDestroyDescriptorPool(logical_device_, descriptor_pool_[kRight], nullptr);
+    CleanUniformBuffers(kLeft);
+    CleanUniformBuffers(kRight);
 
     CleanPipeline(kLeft);
     CleanPipeline(kRight);
 
-    vkDestroyBuffer(logical_device_, index_buffers_[kLeft], nullptr);
-    vkFreeMemory(logical_device_, index_buffers_memory_[kLeft], nullptr);
-    vkDestroyBuffer(logical_device_, index_buffers_[kRight], nullptr);
-    vkFreeMemory(logical_device_, index_buffers_memory_[kRight], nullptr);
-
-    vkDestroyBuffer(logical_device_, vertex_buffers_[kLeft], nullptr);
-    vkFreeMemory(logical_device_, vertex_buffers_memory_[kLeft], nullptr);
-    vkDestroyBuffer(logical_device_, vertex_buffers_[kRight], nullptr);
-    vkFreeMemory(logical_device_, vertex_buffers_memory_[kRight], nullptr);
+    CleanMeshBuffers(kLeft);
+    CleanMeshBuffers(kRight);
   }
 
-  void SetMesh(const CardboardMesh* mesh, CardboardEye eye) override {
-    // Create Vertex buffer
-    std::vector<Vertex> vertices;
-    vertices.resize(mesh->n_vertices);
+  void SetMesh(const CardboardChromaticMesh* chromatic_mesh,
+               CardboardEye eye) override {
+    const CardboardMesh* mesh = &chromatic_mesh->mesh;
+    const float* red_uvs = chromatic_mesh->red_uvs;
+    const float* blue_uvs = chromatic_mesh->blue_uvs;
+    // The buffers of the previous mesh may still be used by pending command
+    // buffers.
+    if (vertex_buffers_[eye] != VK_NULL_HANDLE) {
+      CALL_VK(vkDeviceWaitIdle(logical_device_));
+      CleanMeshBuffers(eye);
+    }
+
+    // Create Vertex buffer. With chromatic aberration correction, each vertex
+    // holds the texture coordinates of all the color channels, so the mesh is
+    // drawn once.
+    const bool has_chromatic_aberration =
+        red_uvs != nullptr && blue_uvs != nullptr;
+    std::vector<float> vertices;
+    vertices.reserve(mesh->n_vertices * (has_chromatic_aberration
+                                             ? kChromaticVertexFloatCount
+                                             : kVertexFloatCount));
     for (int i = 0; i < mesh->n_vertices; i++) {
-      vertices[i].pos_x = mesh->vertices[2 * i];
-      vertices[i].pos_y = mesh->vertices[2 * i + 1];
-      vertices[i].tex_u = mesh->uvs[2 * i];
-      vertices[i].tex_v = mesh->uvs[2 * i + 1];
+      vertices.insert(vertices.end(),
+                      {mesh->vertices[2 * i], mesh->vertices[2 * i + 1],
+                       mesh->uvs[2 * i], mesh->uvs[2 * i + 1]});
+      if (has_chromatic_aberration) {
+        vertices.insert(vertices.end(), {red_uvs[2 * i], red_uvs[2 * i + 1],
+                                         blue_uvs[2 * i], blue_uvs[2 * i + 1]});
+      }
     }
 
     VkDeviceSize vertex_buffer_size = sizeof(vertices[0]) * vertices.size();
@@ -147,6 +183,20 @@ class VulkanDistortionRenderer : public DistortionRenderer {
     vkUnmapMemory(logical_device_, index_buffers_memory_[eye]);
 
     indices_count_ = mesh->n_indices;
+    has_chromatic_aberration_[eye] = has_chromatic_aberration;
+    covered_bounds_[eye] = GetMeshCoveredBounds(*mesh);
+    ++generation_;
+  }
+
+  void SetReprojection(const std::array<float, 9>& reprojection,
+                       CardboardEye eye) override {
+    reprojection_[eye] = reprojection;
+  }
+
+  void SetPassConfig(
+      const CardboardDistortionRendererPassConfig& pass_config) override {
+    pass_config_ = pass_config;
+    ++generation_;
   }
 
   void RenderEyeToDisplay(
@@ -157,8 +207,6 @@ class VulkanDistortionRenderer : public DistortionRenderer {
         reinterpret_cast<CardboardVulkanDistortionRendererTarget*>(target);
     VkCommandBuffer command_buffer =
         *reinterpret_cast<VkCommandBuffer*>(render_target->vk_command_buffer);
-    VkRenderPass render_pass =
-        *reinterpret_cast<VkRenderPass*>(render_target->vk_render_pass);
     uint32_t image_index = render_target->swapchain_image_index;
 
     if (image_index >= swapchain_image_count_) {
@@ -166,20 +214,127 @@ class VulkanDistortionRenderer : public DistortionRenderer {
           "Input swapchain image index is above the swapchain length");
       return;
     }
+    const uint32_t frame = GetFrame(image_index);
+
+    // Render passes, pipelines and pass configuration are shared by all the
+    // swapchain images, which may be recorded concurrently.
+    const bool owns_render_pass =
+        pass_config_.vk_swapchain_image_format != VK_FORMAT_UNDEFINED;
+    RecordState state{};
+    {
+      std::lock_guard<std::mutex> lock(shared_objects_mutex_);
+      VkRenderPass render_pass =
+          owns_render_pass ? GetOwnedRenderPass()
+                           : *reinterpret_cast<VkRenderPass*>(
+                                 render_target->vk_render_pass);
+      if (render_pass == VK_NULL_HANDLE) {
+        return;
+      }
+      // The owned render pass has no depth attachment.
+      const bool disable_depth_test =
+          owns_render_pass || pass_config_.discard_depth_stencil != 0;
+
+      if (render_pass != current_render_pass_ ||
+          disable_depth_test != is_depth_test_disabled_ ||
+          IsPipelineOutdated(kLeft) || IsPipelineOutdated(kRight)) {
+        current_render_pass_ = render_pass;
+        is_depth_test_disabled_ = disable_depth_test;
+        CreateGraphicsPipelines(kLeft);
+        CreateGraphicsPipelines(kRight);
+        ++generation_;
+      }
+      state.generation = generation_;
+      state.render_pass = render_pass;
+    }
+    state.x = x;
+    state.y = y;
+    state.width = width;
+    state.height = height;
+    state.textures = {reinterpret_cast<VkImage>(left_eye->texture),
+                      reinterpret_cast<VkImage>(right_eye->texture)};
+
+    // The caller waited for the previous submission that used this frame, so
+    // its uniform buffers may be overwritten. They are host coherent.
+    const UniformBufferObject left_uniforms = GetUniforms(left_eye, kLeft);
+    const UniformBufferObject right_uniforms = GetUniforms(right_eye, kRight);
+    memcpy(uniform_buffers_mapped_[kLeft][frame], &left_uniforms,
+           sizeof(UniformBufferObject));
+    memcpy(uniform_buffers_mapped_[kRight][frame], &right_uniforms,
+           sizeof(UniformBufferObject));
+
+    const bool use_secondary_command_buffers =
+        !secondary_command_buffers_.empty();
+    const VkSubpassContents contents =
+        use_secondary_command_buffers
+            ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+            : VK_SUBPASS_CONTENTS_INLINE;
+    if (owns_render_pass &&
+        !BeginOwnedRenderPass(command_buffer, image_index, x, y, width, height,
+                              contents)) {
+      return;
+    }
 
-    if (render_pass != current_render_pass_) {
-      current_render_pass_ = render_pass;
-      CreateGraphicsPipeline(kLeft);
-      CreateGraphicsPipeline(kRight);
+    if (use_secondary_command_buffers) {
+      if (!(recorded_states_[frame] == state)) {
+        RecordSecondaryCommandBuffer(frame, state);
+      }
+      vkCmdExecuteCommands(command_buffer, 1,
+                           &secondary_command_buffers_[frame]);
+    } else {
+      // Image views are created again every frame since the eye textures may
+      // have been recreated with the same handle.
+      UpdateEyeTexture(kLeft, frame, state.textures[kLeft],
+                       /*reuse_image_view=*/false);
+      UpdateEyeTexture(kRight, frame, state.textures[kRight],
+                       /*reuse_image_view=*/false);
+      RecordDistortionPass(command_buffer, frame, state);
     }
 
-    RenderDistortionMesh(left_eye, kLeft, command_buffer, image_index, x, y,
-                         width, height);
-    RenderDistortionMesh(right_eye, kRight, command_buffer, image_index, x, y,
-                         width, height);
+    if (owns_render_pass) {
+      vkCmdEndRenderPass(command_buffer);
+    }
   }
 
  private:
+  /**
+   * Returns the index of the per frame resources, the uniform buffers,
+   * descriptor sets, eye texture image views and secondary command buffers,
+   * used by a frame. Without a maximum number of frames in flight, they are
+   * the resources of the swapchain image.
+   *
+   * @param image_index index of current image in the swapchain.
+   */
+  uint32_t GetFrame(uint32_t image_index) {
+    if (max_frames_in_flight_ == 0) {
+      return image_index;
+    }
+    return static_cast<uint32_t>(next_frame_.fetch_add(1) %
+                                 max_frames_in_flight_);
+  }
+
+  // Inputs of the distortion pass of a frame baked into its commands.
+  // Secondary command buffers are recorded again when they change.
+  // Per frame inputs, the texture rectangles and the reprojections, are read
+  // from uniform buffers instead.
+  struct RecordState {
+    // Incremented when the meshes, the pass configuration or the pipelines
+    // change.
+    uint64_t generation;
+    VkRenderPass render_pass;
+    int x;
+    int y;
+    int width;
+    int height;
+    std::array<VkImage, 2> textures;
+
+    bool operator==(const RecordState& other) const {
+      return generation == other.generation &&
+             render_pass == other.render_pass && x == other.x &&
+             y == other.y && width == other.width && height == other.height &&
+             textures == other.textures;
+    }
+  };
+
   void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
                     VkMemoryPropertyFlags properties, VkBuffer& buffer,
                     VkDeviceMemory& buffer_memory) {
@@ -211,7 +366,7 @@ class VulkanDistortionRenderer : public DistortionRenderer {
    */
   void CreateSharedVulkanObjects() {
     // Create DescriptorSet Layout
-    VkDescriptorSetLayoutBinding bindings[1];
+    VkDescriptorSetLayoutBinding bindings[2];
 
     VkDescriptorSetLayoutBinding sampler_layout_binding{
         .binding = 0,
@@ -222,29 +377,31 @@ class VulkanDistortionRenderer : public DistortionRenderer {
     };
     bindings[0] = sampler_layout_binding;
 
+    VkDescriptorSetLayoutBinding uniform_buffer_layout_binding{
+        .binding = 1,
+        .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+        .descriptorCount = 1,
+        .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+        .pImmutableSamplers = nullptr,
+    };
+    bindings[1] = uniform_buffer_layout_binding;
+
     VkDescriptorSetLayoutCreateInfo layout_info = {
         .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-        .bindingCount = 1,
+        .bindingCount = 2,
         .pBindings = bindings,
     };
     CALL_VK(vkCreateDescriptorSetLayout(logical_device_, &layout_info, nullptr,
                                         &descriptor_set_layout_));
 
-    // Setup push constants.
-    VkPushConstantRange push_constant_range = {
-      .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
-      .offset = 0,
-      .size = sizeof(PushConstantsObject),
-    };
-
     // Create Pipeline Layout
     VkPipelineLayoutCreateInfo pipeline_layout_create_info{
         .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
         .pNext = nullptr,
         .setLayoutCount = 1,
         .pSetLayouts = &descriptor_set_layout_,
-        .pushConstantRangeCount = 1,
-        .pPushConstantRanges = &push_constant_range,
+        .pushConstantRangeCount = 0,
+        .pPushConstantRanges = nullptr,
     };
     CALL_VK(vkCreatePipelineLayout(logical_device_,
                                    &pipeline_layout_create_info, nullptr,
@@ -254,15 +411,17 @@ class VulkanDistortionRenderer : public DistortionRenderer {
     VkPhysicalDeviceProperties properties{};
     vkGetPhysicalDeviceProperties(physical_device_, &properties);
 
+    // Reprojected texture coordinates may leave the texture. They are clamped
+    // to its edge, as in the CPU renderer.
     VkSamplerCreateInfo sampler = {
         .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
         .pNext = nullptr,
         .magFilter = VK_FILTER_NEAREST,
         .minFilter = VK_FILTER_NEAREST,
         .mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
-        .addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-        .addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-        .addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        .addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+        .addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+        .addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
         .mipLodBias = 0.0f,
         .maxAnisotropy = properties.limits.maxSamplerAnisotropy,
         .compareOp = VK_COMPARE_OP_NEVER,
@@ -283,53 +442,120 @@ class VulkanDistortionRenderer : public DistortionRenderer {
    */
   void CreatePerEyeVulkanObjects(CardboardEye eye) {
     // Create Descriptor Pool
-    VkDescriptorPoolSize pool_sizes[1];
+    VkDescriptorPoolSize pool_sizes[2];
     pool_sizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    pool_sizes[0].descriptorCount =
-        static_cast<uint32_t>(swapchain_image_count_);
+    pool_sizes[0].descriptorCount = frame_count_;
+    pool_sizes[1].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    pool_sizes[1].descriptorCount = frame_count_;
 
     VkDescriptorPoolCreateInfo pool_info{};
     pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    pool_info.poolSizeCount = 1;
+    pool_info.poolSizeCount = 2;
     pool_info.pPoolSizes = pool_sizes;
-    pool_info.maxSets = static_cast<uint32_t>(swapchain_image_count_);
+    pool_info.maxSets = frame_count_;
 
     CALL_VK(vkCreateDescriptorPool(logical_device_, &pool_info, nullptr,
                                    &descriptor_pool_[eye]));
 
     // Create Descriptor Sets
-    std::vector<VkDescriptorSetLayout> layouts(swapchain_image_count_,
+    std::vector<VkDescriptorSetLayout> layouts(frame_count_,
                                                descriptor_set_layout_);
     VkDescriptorSetAllocateInfo alloc_info{};
     alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
     alloc_info.descriptorPool = descriptor_pool_[eye];
-    alloc_info.descriptorSetCount =
-        static_cast<uint32_t>(swapchain_image_count_);
+    alloc_info.descriptorSetCount = frame_count_;
     alloc_info.pSetLayouts = layouts.data();
 
-    descriptor_sets_[eye].resize(swapchain_image_count_);
+    descriptor_sets_[eye].resize(frame_count_);
     CALL_VK(vkAllocateDescriptorSets(logical_device_, &alloc_info,
                                      descriptor_sets_[eye].data()));
 
-    // Set the size of image view array to the swapchain length.
-    image_views_[eye].resize(swapchain_image_count_);
+    // Set the size of image view array to the number of frames.
+    image_views_[eye].resize(frame_count_);
+    image_view_images_[eye].resize(frame_count_);
+
+    // Create one persistently mapped uniform buffer per frame. Its
+    // descriptor never changes, so it is written once.
+    uniform_buffers_[eye].resize(frame_count_);
+    uniform_buffers_memory_[eye].resize(frame_count_);
+    uniform_buffers_mapped_[eye].resize(frame_count_);
+    for (uint32_t i = 0; i < frame_count_; i++) {
+      CreateBuffer(sizeof(UniformBufferObject),
+                   VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                       VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                   uniform_buffers_[eye][i], uniform_buffers_memory_[eye][i]);
+      CALL_VK(vkMapMemory(logical_device_, uniform_buffers_memory_[eye][i], 0,
+                          sizeof(UniformBufferObject), 0,
+                          &uniform_buffers_mapped_[eye][i]));
+
+      const VkDescriptorBufferInfo buffer_info = {
+          .buffer = uniform_buffers_[eye][i],
+          .offset = 0,
+          .range = sizeof(UniformBufferObject),
+      };
+      const VkWriteDescriptorSet descriptor_write = {
+          .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+          .pNext = nullptr,
+          .dstSet = descriptor_sets_[eye][i],
+          .dstBinding = 1,
+          .dstArrayElement = 0,
+          .descriptorCount = 1,
+          .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+          .pImageInfo = nullptr,
+          .pBufferInfo = &buffer_info,
+          .pTexelBufferView = nullptr,
+      };
+      vkUpdateDescriptorSets(logical_device_, 1, &descriptor_write, 0,
+                             nullptr);
+    }
   }
 
   /**
-   * Create the graphics pipeline for the given eye.
+   * Create the graphics pipeline for the given eye, with the shaders matching
+   * the vertices of its mesh.
    * It cleans the previous pipeline if it exists.
    *
    * @param eye CardboardEye input.
-   *
-   * @return VkPipeline the graphics pipeline output.
    */
-  void CreateGraphicsPipeline(CardboardEye eye) {
+  void CreateGraphicsPipelines(CardboardEye eye) {
     CleanPipeline(eye);
+    graphics_pipeline_[eye] =
+        CreateGraphicsPipeline(has_chromatic_aberration_[eye]);
+    pipeline_has_chromatic_aberration_[eye] = has_chromatic_aberration_[eye];
+  }
+
+  /**
+   * Returns whether the pipeline of the given eye was created for a mesh
+   * with or without chromatic aberration correction, unlike its current one.
+   *
+   * @param eye CardboardEye input.
+   */
+  bool IsPipelineOutdated(CardboardEye eye) const {
+    return pipeline_has_chromatic_aberration_[eye] !=
+           has_chromatic_aberration_[eye];
+  }
 
+  /**
+   * Create a graphics pipeline.
+   *
+   * @param chromatic_aberration whether the pipeline draws meshes with
+   *        chromatic aberration correction, whose vertices hold the texture
+   *        coordinates of each color channel.
+   *
+   * @return VkPipeline the graphics pipeline output.
+   */
+  VkPipeline CreateGraphicsPipeline(bool chromatic_aberration) {
     VkShaderModule vertex_shader =
-        LoadShader(distortion_vert, sizeof(distortion_vert));
+        chromatic_aberration
+            ? LoadShader(distortion_chromatic_vert,
+                         sizeof(distortion_chromatic_vert))
+            : LoadShader(distortion_vert, sizeof(distortion_vert));
     VkShaderModule fragment_shader =
-        LoadShader(distortion_frag, sizeof(distortion_frag));
+        chromatic_aberration
+            ? LoadShader(distortion_chromatic_frag,
+                         sizeof(distortion_chromatic_frag))
+            : LoadShader(distortion_frag, sizeof(distortion_frag));
 
     // Specify vertex and fragment shader stages
     VkPipelineShaderStageCreateInfo vertex_shader_state = {
@@ -415,30 +641,31 @@ class VulkanDistortionRenderer : public DistortionRenderer {
     // Specify vertex input state
     VkVertexInputBindingDescription vertex_input_bindings = {
         .binding = 0,
-        .stride = 4 * sizeof(float),
+        .stride = (chromatic_aberration ? kChromaticVertexFloatCount
+                                        : kVertexFloatCount) *
+                  sizeof(float),
         .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
     };
 
-    VkVertexInputAttributeDescription vertex_input_attributes[2] = {
-        {
-            .location = 0,
-            .binding = 0,
-            .format = VK_FORMAT_R32G32_SFLOAT,
-            .offset = 0,
-        },
-        {
-            .location = 1,
-            .binding = 0,
-            .format = VK_FORMAT_R32G32_SFLOAT,
-            .offset = sizeof(float) * 2,
-        }};
+    // Position, texture coordinates, then, with chromatic aberration
+    // correction, texture coordinates of the red and blue channels.
+    VkVertexInputAttributeDescription vertex_input_attributes[4];
+    const uint32_t vertex_input_attribute_count = chromatic_aberration ? 4 : 2;
+    for (uint32_t i = 0; i < vertex_input_attribute_count; i++) {
+      vertex_input_attributes[i] = {
+          .location = i,
+          .binding = 0,
+          .format = VK_FORMAT_R32G32_SFLOAT,
+          .offset = static_cast<uint32_t>(sizeof(float) * 2 * i),
+      };
+    }
 
     VkPipelineVertexInputStateCreateInfo vertex_input_info = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
         .pNext = nullptr,
         .vertexBindingDescriptionCount = 1,
         .pVertexBindingDescriptions = &vertex_input_bindings,
-        .vertexAttributeDescriptionCount = 2,
+        .vertexAttributeDescriptionCount = vertex_input_attribute_count,
         .pVertexAttributeDescriptions = vertex_input_attributes,
     };
 
@@ -453,10 +680,14 @@ class VulkanDistortionRenderer : public DistortionRenderer {
         .dynamicStateCount = 2,
         .pDynamicStates = dynamic_state_enables};
 
+    // When the depth contents are discarded, the pass must not read nor write
+    // them.
+    const VkBool32 depth_enable =
+        is_depth_test_disabled_ ? VK_FALSE : VK_TRUE;
     VkPipelineDepthStencilStateCreateInfo depth_stencil = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
-        .depthTestEnable = VK_TRUE,
-        .depthWriteEnable = VK_TRUE,
+        .depthTestEnable = depth_enable,
+        .depthWriteEnable = depth_enable,
         .depthCompareOp = VK_COMPARE_OP_LESS,
         .depthBoundsTestEnable = VK_FALSE,
         .stencilTestEnable = VK_FALSE};
@@ -485,12 +716,14 @@ class VulkanDistortionRenderer : public DistortionRenderer {
         .basePipelineHandle = VK_NULL_HANDLE,
         .basePipelineIndex = 0,
     };
+    VkPipeline pipeline = VK_NULL_HANDLE;
     CALL_VK(vkCreateGraphicsPipelines(logical_device_, VK_NULL_HANDLE, 1,
                                       &pipeline_create_info, nullptr,
-                                      &graphics_pipeline_[eye]));
+                                      &pipeline));
 
     vkDestroyShaderModule(logical_device_, vertex_shader, nullptr);
     vkDestroyShaderModule(logical_device_, fragment_shader, nullptr);
+    return pipeline;
   }
 
   VkShaderModule LoadShader(const uint32_t* const content, size_t size) const {
@@ -534,38 +767,149 @@ class VulkanDistortionRenderer : public DistortionRenderer {
   }
 
   /**
-   * Set up render distortion mesh and bind them to the command buffer.
+   * Create a command pool and a secondary command buffer per frame. Each frame
+   * has its own pool so that they can be recorded from different threads.
+   *
+   * @param queue_family_index Queue family of the primary command buffers.
+   */
+  void CreateSecondaryCommandBuffers(uint32_t queue_family_index) {
+    secondary_command_pools_.resize(frame_count_);
+    secondary_command_buffers_.resize(frame_count_);
+    // Value initialized states have a null render pass, so they never match.
+    recorded_states_.resize(frame_count_);
+    for (uint32_t i = 0; i < frame_count_; i++) {
+      const VkCommandPoolCreateInfo pool_info = {
+          .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+          .pNext = nullptr,
+          .flags = 0,
+          .queueFamilyIndex = queue_family_index,
+      };
+      CALL_VK(vkCreateCommandPool(logical_device_, &pool_info, nullptr,
+                                  &secondary_command_pools_[i]));
+
+      const VkCommandBufferAllocateInfo allocate_info = {
+          .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+          .pNext = nullptr,
+          .commandPool = secondary_command_pools_[i],
+          .level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+          .commandBufferCount = 1,
+      };
+      CALL_VK(vkAllocateCommandBuffers(logical_device_, &allocate_info,
+                                       &secondary_command_buffers_[i]));
+    }
+  }
+
+  /**
+   * Record the distortion pass of a frame into its secondary command buffer.
+   * The previous submission of that command buffer must have completed.
+   *
+   * @param frame index of the per frame resources, see GetFrame().
+   * @param state inputs of the distortion pass.
+   */
+  void RecordSecondaryCommandBuffer(uint32_t frame, const RecordState& state) {
+    CARDBOARD_TRACE_SCOPE("VulkanDistortionRenderer::RecordSecondary");
+    // Descriptor sets may only be updated while no command buffer that binds
+    // them is recorded, so it happens before recording.
+    UpdateEyeTexture(kLeft, frame, state.textures[kLeft],
+                     /*reuse_image_view=*/true);
+    UpdateEyeTexture(kRight, frame, state.textures[kRight],
+                     /*reuse_image_view=*/true);
+
+    CALL_VK(vkResetCommandPool(logical_device_,
+                               secondary_command_pools_[frame], 0));
+    VkCommandBuffer command_buffer = secondary_command_buffers_[frame];
+    const VkCommandBufferInheritanceInfo inheritance_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        .pNext = nullptr,
+        .renderPass = state.render_pass,
+        .subpass = 0,
+        .framebuffer = VK_NULL_HANDLE,
+        .occlusionQueryEnable = VK_FALSE,
+        .queryFlags = 0,
+        .pipelineStatistics = 0,
+    };
+    const VkCommandBufferBeginInfo begin_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .pNext = nullptr,
+        .flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+        .pInheritanceInfo = &inheritance_info,
+    };
+    CALL_VK(vkBeginCommandBuffer(command_buffer, &begin_info));
+    RecordDistortionPass(command_buffer, frame, state);
+    CALL_VK(vkEndCommandBuffer(command_buffer));
+
+    recorded_states_[frame] = state;
+  }
+
+  /**
+   * Record the vignette clear and the distortion meshes of both eyes.
+   *
+   * @param command_buffer VkCommandBuffer to record to.
+   * @param frame index of the per frame resources, see GetFrame().
+   * @param state inputs of the distortion pass.
+   */
+  void RecordDistortionPass(VkCommandBuffer command_buffer, uint32_t frame,
+                            const RecordState& state) {
+    if (pass_config_.color_load_op == kColorLoadOpClearVignette) {
+      ClearVignette(command_buffer, state.x, state.y, state.width,
+                    state.height);
+    }
+    RenderDistortionMesh(kLeft, command_buffer, frame, state.x, state.y,
+                         state.width, state.height);
+    RenderDistortionMesh(kRight, command_buffer, frame, state.x, state.y,
+                         state.width, state.height);
+  }
+
+  /**
+   * Compute the uniforms of an eye.
    *
    * @param eye_description Texture for the eye.
    * @param eye CardboardEye input.
-   * @param command_buffer VkCommandBuffer to be bond.
-   * @param image_index index of current image in the swapchain.
-   * @param x x of the rendering area.
-   * @param y y of the rendering area.
-   * @param width width of the rendering area.
-   * @param height height of the rendering area.
+   *
+   * @return UniformBufferObject the texture rectangle to sample and the
+   *         reprojection of the eye.
    */
-  void RenderDistortionMesh(
-      const CardboardEyeTextureDescription* eye_description, CardboardEye eye,
-      VkCommandBuffer command_buffer, uint32_t image_index, int x, int y,
-      int width, int height) {
-    // Update Push constants.
-    PushConstantsObject push_constants {
+  UniformBufferObject GetUniforms(
+      const CardboardEyeTextureDescription* eye_description,
+      CardboardEye eye) const {
+    UniformBufferObject uniforms{
         .left_u = eye_description->left_u,
         .right_u = eye_description->right_u,
         .top_v = eye_description->top_v,
         .bottom_v = eye_description->bottom_v,
+        .reprojection = {},
     };
-    vkCmdPushConstants(command_buffer, pipeline_layout_, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstantsObject), &push_constants);
+    for (int column = 0; column < 3; column++) {
+      for (int row = 0; row < 3; row++) {
+        uniforms.reprojection[4 * column + row] =
+            reprojection_[eye][3 * column + row];
+      }
+    }
+    return uniforms;
+  }
+
+  /**
+   * Point the descriptor set of an eye and frame to an eye texture.
+   *
+   * @param eye CardboardEye input.
+   * @param frame index of the per frame resources, see GetFrame().
+   * @param image eye texture.
+   * @param reuse_image_view whether the image view is kept when @p image is
+   *        the image of the previous call.
+   */
+  void UpdateEyeTexture(CardboardEye eye, uint32_t frame, VkImage image,
+                        bool reuse_image_view) {
+    if (reuse_image_view && image_views_[eye][frame] != VK_NULL_HANDLE &&
+        image_view_images_[eye][frame] == image) {
+      return;
+    }
 
-    // Update image and view
-    VkImage current_image = reinterpret_cast<VkImage>(eye_description->texture);
-    CleanTextureImageView(eye, image_index);
+    CleanTextureImageView(eye, frame);
     const VkImageViewCreateInfo view_create_info = {
         .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
         .pNext = nullptr,
         .flags = 0,
-        .image = current_image,
+        .image = image,
         .viewType = VK_IMAGE_VIEW_TYPE_2D,
         .format = VK_FORMAT_R8G8B8A8_SRGB,
         .components =
@@ -586,19 +930,20 @@ class VulkanDistortionRenderer : public DistortionRenderer {
     };
     CALL_VK(vkCreateImageView(logical_device_, &view_create_info,
                               nullptr /* pAllocator */,
-                              &image_views_[eye][image_index]));
+                              &image_views_[eye][frame]));
+    image_view_images_[eye][frame] = image;
 
     // Update Descriptor Sets
     VkDescriptorImageInfo image_info{
         .sampler = texture_sampler_,
-        .imageView = image_views_[eye][image_index],
+        .imageView = image_views_[eye][frame],
         .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
     };
 
     VkWriteDescriptorSet descriptor_writes[1];
 
     descriptor_writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    descriptor_writes[0].dstSet = descriptor_sets_[eye][image_index];
+    descriptor_writes[0].dstSet = descriptor_sets_[eye][frame];
     descriptor_writes[0].dstBinding = 0;
     descriptor_writes[0].dstArrayElement = 0;
     descriptor_writes[0].descriptorType =
@@ -608,7 +953,22 @@ class VulkanDistortionRenderer : public DistortionRenderer {
     descriptor_writes[0].pNext = nullptr;
 
     vkUpdateDescriptorSets(logical_device_, 1, descriptor_writes, 0, nullptr);
+  }
 
+  /**
+   * Bind the distortion mesh of an eye to the command buffer and draw it.
+   *
+   * @param eye CardboardEye input.
+   * @param command_buffer VkCommandBuffer to be bond.
+   * @param frame index of the per frame resources, see GetFrame().
+   * @param x x of the rendering area.
+   * @param y y of the rendering area.
+   * @param width width of the rendering area.
+   * @param height height of the rendering area.
+   */
+  void RenderDistortionMesh(CardboardEye eye, VkCommandBuffer command_buffer,
+                            uint32_t frame, int x, int y, int width,
+                            int height) const {
     // Update Viewport and scissor
     VkViewport viewport = {.x = static_cast<float>(x),
                            .y = static_cast<float>(y),
@@ -628,27 +988,279 @@ class VulkanDistortionRenderer : public DistortionRenderer {
     }
 
     // Bind to the command buffer.
-    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                      graphics_pipeline_[eye]);
     vkCmdSetViewport(command_buffer, 0, 1, &viewport);
     vkCmdSetScissor(command_buffer, 0, 1, &scissor);
 
-    VkDeviceSize offset = 0;
-    vkCmdBindVertexBuffers(command_buffer, 0, 1, &vertex_buffers_[eye],
-                           &offset);
-
     vkCmdBindIndexBuffer(command_buffer, index_buffers_[eye], 0,
                          VK_INDEX_TYPE_UINT16);
 
     vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
                             pipeline_layout_, 0, 1,
-                            &descriptor_sets_[eye][image_index], 0, nullptr);
+                            &descriptor_sets_[eye][frame], 0, nullptr);
+
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                      graphics_pipeline_[eye]);
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(command_buffer, 0, 1, &vertex_buffers_[eye],
+                           &offset);
     vkCmdDrawIndexed(command_buffer, static_cast<uint32_t>(indices_count_), 1,
                      0, 0, 0);
   }
 
   /**
-   * Clean the graphics pipeline of the given eye.
+   * Returns the load operation of the owned render pass.
+   */
+  VkAttachmentLoadOp GetOwnedRenderPassLoadOp() const {
+    switch (pass_config_.color_load_op) {
+      case kColorLoadOpClearVignette:
+        // The vignette is cleared with vkCmdClearAttachments().
+        return VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+      case kColorLoadOpLoad:
+        return VK_ATTACHMENT_LOAD_OP_LOAD;
+      case kColorLoadOpClear:
+      default:
+        return VK_ATTACHMENT_LOAD_OP_CLEAR;
+    }
+  }
+
+  /**
+   * Get the render pass owned by the distortion renderer. It is created again
+   * when the swapchain image format or the load operation changes.
+   *
+   * @return VkRenderPass the owned render pass or VK_NULL_HANDLE on failure.
+   */
+  VkRenderPass GetOwnedRenderPass() {
+    const VkFormat format =
+        static_cast<VkFormat>(pass_config_.vk_swapchain_image_format);
+    const VkAttachmentLoadOp load_op = GetOwnedRenderPassLoadOp();
+    if (owned_render_pass_ != VK_NULL_HANDLE &&
+        owned_render_pass_format_ == format &&
+        owned_render_pass_load_op_ == load_op) {
+      return owned_render_pass_;
+    }
+    CleanOwnedRenderPass();
+
+    // The color is always stored since it is presented. There is no depth
+    // attachment, so nothing else is loaded nor stored.
+    const VkAttachmentDescription color_attachment = {
+        .format = format,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .loadOp = load_op,
+        .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+        .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+        .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+        .initialLayout = load_op == VK_ATTACHMENT_LOAD_OP_LOAD
+                             ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+                             : VK_IMAGE_LAYOUT_UNDEFINED,
+        .finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+    };
+    const VkAttachmentReference color_reference = {
+        .attachment = 0,
+        .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+    };
+    const VkSubpassDescription subpass = {
+        .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+        .colorAttachmentCount = 1,
+        .pColorAttachments = &color_reference,
+    };
+    // Waits for the presentation engine to release the swapchain image.
+    const VkSubpassDependency dependency = {
+        .srcSubpass = VK_SUBPASS_EXTERNAL,
+        .dstSubpass = 0,
+        .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        .dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        .srcAccessMask = 0,
+        .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+                         VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+    };
+    const VkRenderPassCreateInfo render_pass_info = {
+        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+        .attachmentCount = 1,
+        .pAttachments = &color_attachment,
+        .subpassCount = 1,
+        .pSubpasses = &subpass,
+        .dependencyCount = 1,
+        .pDependencies = &dependency,
+    };
+    if (vkCreateRenderPass(logical_device_, &render_pass_info, nullptr,
+                           &owned_render_pass_) != VK_SUCCESS) {
+      CARDBOARD_LOGE("Failed to create the distortion render pass.");
+      owned_render_pass_ = VK_NULL_HANDLE;
+      return VK_NULL_HANDLE;
+    }
+    owned_render_pass_format_ = format;
+    owned_render_pass_load_op_ = load_op;
+    ++generation_;
+
+    // Image views and framebuffers are created on first use.
+    swapchain_images_.resize(swapchain_image_count_);
+    CALL_VK(vkGetSwapchainImagesKHR(logical_device_, swapchain_,
+                                    &swapchain_image_count_,
+                                    swapchain_images_.data()));
+    swapchain_image_views_.assign(swapchain_image_count_, VK_NULL_HANDLE);
+    framebuffers_.assign(swapchain_image_count_, VK_NULL_HANDLE);
+    framebuffer_extents_.assign(swapchain_image_count_, VkExtent2D{0, 0});
+    return owned_render_pass_;
+  }
+
+  /**
+   * Begin the owned render pass on the given swapchain image.
+   *
+   * @param command_buffer VkCommandBuffer to record to.
+   * @param image_index index of current image in the swapchain.
+   * @param x x of the rendering area.
+   * @param y y of the rendering area.
+   * @param width width of the rendering area.
+   * @param height height of the rendering area.
+   * @param contents how the commands of the render pass are provided.
+   *
+   * @return true if the render pass was begun.
+   */
+  bool BeginOwnedRenderPass(VkCommandBuffer command_buffer,
+                            uint32_t image_index, int x, int y, int width,
+                            int height, VkSubpassContents contents) {
+    // The framebuffer only needs to contain the rendering area.
+    const VkExtent2D extent = {static_cast<uint32_t>(x + width),
+                               static_cast<uint32_t>(y + height)};
+    if (framebuffers_[image_index] == VK_NULL_HANDLE ||
+        framebuffer_extents_[image_index].width != extent.width ||
+        framebuffer_extents_[image_index].height != extent.height) {
+      CleanOwnedFramebuffer(image_index);
+
+      const VkImageViewCreateInfo view_create_info = {
+          .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+          .image = swapchain_images_[image_index],
+          .viewType = VK_IMAGE_VIEW_TYPE_2D,
+          .format = owned_render_pass_format_,
+          .components =
+              {
+                  .r = VK_COMPONENT_SWIZZLE_IDENTITY,
+                  .g = VK_COMPONENT_SWIZZLE_IDENTITY,
+                  .b = VK_COMPONENT_SWIZZLE_IDENTITY,
+                  .a = VK_COMPONENT_SWIZZLE_IDENTITY,
+              },
+          .subresourceRange =
+              {
+                  .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                  .baseMipLevel = 0,
+                  .levelCount = 1,
+                  .baseArrayLayer = 0,
+                  .layerCount = 1,
+              },
+      };
+      CALL_VK(vkCreateImageView(logical_device_, &view_create_info, nullptr,
+                                &swapchain_image_views_[image_index]));
+
+      const VkFramebufferCreateInfo framebuffer_info = {
+          .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+          .renderPass = owned_render_pass_,
+          .attachmentCount = 1,
+          .pAttachments = &swapchain_image_views_[image_index],
+          .width = extent.width,
+          .height = extent.height,
+          .layers = 1,
+      };
+      if (vkCreateFramebuffer(logical_device_, &framebuffer_info, nullptr,
+                              &framebuffers_[image_index]) != VK_SUCCESS) {
+        CARDBOARD_LOGE("Failed to create the distortion framebuffer.");
+        framebuffers_[image_index] = VK_NULL_HANDLE;
+        CleanOwnedFramebuffer(image_index);
+        return false;
+      }
+      framebuffer_extents_[image_index] = extent;
+    }
+
+    const VkClearValue clear_value = {
+        .color = {.float32 = {0.0f, 0.0f, 0.0f, 1.0f}}};
+    const VkRenderPassBeginInfo begin_info = {
+        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+        .renderPass = owned_render_pass_,
+        .framebuffer = framebuffers_[image_index],
+        .renderArea = {.offset = {.x = x, .y = y},
+                       .extent = {.width = static_cast<uint32_t>(width),
+                                  .height = static_cast<uint32_t>(height)}},
+        .clearValueCount = 1,
+        .pClearValues = &clear_value,
+    };
+    vkCmdBeginRenderPass(command_buffer, &begin_info, contents);
+    return true;
+  }
+
+  /**
+   * Clear the pixels of the rendering area that are not covered by the
+   * distortion meshes. Must be recorded inside a render pass.
+   *
+   * @param command_buffer VkCommandBuffer to record to.
+   * @param x x of the rendering area.
+   * @param y y of the rendering area.
+   * @param width width of the rendering area.
+   * @param height height of the rendering area.
+   */
+  void ClearVignette(VkCommandBuffer command_buffer, int x, int y, int width,
+                     int height) const {
+    std::array<PixelRect, kMaxVignetteRectCount> vignette_rects;
+    const int vignette_rect_count = GetVignetteRects(
+        covered_bounds_, {x, y, width, height}, &vignette_rects);
+    if (vignette_rect_count == 0) {
+      return;
+    }
+
+    std::array<VkClearRect, kMaxVignetteRectCount> clear_rects;
+    for (int i = 0; i < vignette_rect_count; i++) {
+      clear_rects[i] = {
+          .rect = {.offset = {.x = vignette_rects[i].x,
+                              .y = vignette_rects[i].y},
+                   .extent = {.width = static_cast<uint32_t>(
+                                  vignette_rects[i].width),
+                              .height = static_cast<uint32_t>(
+                                  vignette_rects[i].height)}},
+          .baseArrayLayer = 0,
+          .layerCount = 1,
+      };
+    }
+    const VkClearAttachment clear_attachment = {
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .colorAttachment = 0,
+        .clearValue = {.color = {.float32 = {0.0f, 0.0f, 0.0f, 1.0f}}},
+    };
+    vkCmdClearAttachments(command_buffer, 1, &clear_attachment,
+                          static_cast<uint32_t>(vignette_rect_count),
+                          clear_rects.data());
+  }
+
+  /**
+   * Clean the framebuffer and image view of the owned render pass for the
+   * given swapchain image index.
+   *
+   * @param index The index of the image in the swapchain.
+   */
+  void CleanOwnedFramebuffer(uint32_t index) {
+    if (framebuffers_[index] != VK_NULL_HANDLE) {
+      vkDestroyFramebuffer(logical_device_, framebuffers_[index], nullptr);
+      framebuffers_[index] = VK_NULL_HANDLE;
+    }
+    if (swapchain_image_views_[index] != VK_NULL_HANDLE) {
+      vkDestroyImageView(logical_device_, swapchain_image_views_[index],
+                         nullptr);
+      swapchain_image_views_[index] = VK_NULL_HANDLE;
+    }
+  }
+
+  /**
+   * Clean the owned render pass and its framebuffers.
+   */
+  void CleanOwnedRenderPass() {
+    for (uint32_t i = 0; i < framebuffers_.size(); i++) {
+      CleanOwnedFramebuffer(i);
+    }
+    if (owned_render_pass_ != VK_NULL_HANDLE) {
+      vkDestroyRenderPass(logical_device_, owned_render_pass_, nullptr);
+      owned_render_pass_ = VK_NULL_HANDLE;
+    }
+  }
+
+  /**
+   * Clean the graphics pipelines of the given eye.
    *
    * @param eye CardboardEye input.
    */
@@ -660,10 +1272,43 @@ class VulkanDistortionRenderer : public DistortionRenderer {
   }
 
   /**
-   * Clean the image view of the given eye and swapchain image index.
+   * Clean the vertex and index buffers of the given eye.
    *
    * @param eye CardboardEye input.
-   * @param index The index of the image in the swapchain.
+   */
+  void CleanMeshBuffers(CardboardEye eye) {
+    vkDestroyBuffer(logical_device_, index_buffers_[eye], nullptr);
+    vkFreeMemory(logical_device_, index_buffers_memory_[eye], nullptr);
+    index_buffers_[eye] = VK_NULL_HANDLE;
+    index_buffers_memory_[eye] = VK_NULL_HANDLE;
+
+    vkDestroyBuffer(logical_device_, vertex_buffers_[eye], nullptr);
+    vkFreeMemory(logical_device_, vertex_buffers_memory_[eye], nullptr);
+    vertex_buffers_[eye] = VK_NULL_HANDLE;
+    vertex_buffers_memory_[eye] = VK_NULL_HANDLE;
+  }
+
+  /**
+   * Clean the uniform buffers of the given eye.
+   *
+   * @param eye CardboardEye input.
+   */
+  void CleanUniformBuffers(CardboardEye eye) {
+    for (size_t i = 0; i < uniform_buffers_[eye].size(); i++) {
+      vkUnmapMemory(logical_device_, uniform_buffers_memory_[eye][i]);
+      vkDestroyBuffer(logical_device_, uniform_buffers_[eye][i], nullptr);
+      vkFreeMemory(logical_device_, uniform_buffers_memory_[eye][i], nullptr);
+    }
+    uniform_buffers_[eye].clear();
+    uniform_buffers_memory_[eye].clear();
+    uniform_buffers_mapped_[eye].clear();
+  }
+
+  /**
+   * Clean the image view of the given eye and frame.
+   *
+   * @param eye CardboardEye input.
+   * @param index index of the per frame resources, see GetFrame().
    */
   void CleanTextureImageView(CardboardEye eye, int index) {
     if (image_views_[eye][index] != VK_NULL_HANDLE) {
@@ -679,20 +1324,61 @@ class VulkanDistortionRenderer : public DistortionRenderer {
   VkSwapchainKHR swapchain_;
   VkRenderPass current_render_pass_;
   int indices_count_;
+  CardboardDistortionRendererPassConfig pass_config_{kColorLoadOpClear, 0, 0};
 
   // Variables created and maintained by the distortion renderer.
   uint32_t swapchain_image_count_;
+  // See CardboardVulkanDistortionRendererOptions::max_frames_in_flight.
+  uint32_t max_frames_in_flight_;
+  // Number of per frame resources, see GetFrame().
+  uint32_t frame_count_;
+  std::atomic<uint64_t> next_frame_{0};
   VkSampler texture_sampler_;
   VkDescriptorSetLayout descriptor_set_layout_;
   VkPipelineLayout pipeline_layout_;
   VkPipeline graphics_pipeline_[2] = {VK_NULL_HANDLE, VK_NULL_HANDLE};
-  VkBuffer vertex_buffers_[2];
-  VkDeviceMemory vertex_buffers_memory_[2];
-  VkBuffer index_buffers_[2];
-  VkDeviceMemory index_buffers_memory_[2];
+  VkBuffer vertex_buffers_[2] = {VK_NULL_HANDLE, VK_NULL_HANDLE};
+  VkDeviceMemory vertex_buffers_memory_[2] = {VK_NULL_HANDLE, VK_NULL_HANDLE};
+  VkBuffer index_buffers_[2] = {VK_NULL_HANDLE, VK_NULL_HANDLE};
+  VkDeviceMemory index_buffers_memory_[2] = {VK_NULL_HANDLE, VK_NULL_HANDLE};
   VkDescriptorPool descriptor_pool_[2];
   std::vector<VkDescriptorSet> descriptor_sets_[2];
   std::vector<VkImageView> image_views_[2];
+  // Eye texture of each image view.
+  std::vector<VkImage> image_view_images_[2];
+  // Uniform buffers of each eye and frame, and their mapping.
+  std::vector<VkBuffer> uniform_buffers_[2];
+  std::vector<VkDeviceMemory> uniform_buffers_memory_[2];
+  std::vector<void*> uniform_buffers_mapped_[2];
+  std::array<std::array<float, 9>, 2> reprojection_{IdentityReprojection(),
+                                                    IdentityReprojection()};
+  // Bounds of the area covered by each mesh. See GetMeshCoveredBounds().
+  std::array<std::array<float, 4>, 2> covered_bounds_{};
+  std::array<bool, 2> has_chromatic_aberration_{false, false};
+  // Whether each pipeline was created for a mesh with chromatic aberration
+  // correction.
+  std::array<bool, 2> pipeline_has_chromatic_aberration_{false, false};
+  bool is_depth_test_disabled_ = false;
+
+  // Render pass owned by the distortion renderer, see
+  // CardboardDistortionRendererPassConfig::vk_swapchain_image_format.
+  VkRenderPass owned_render_pass_ = VK_NULL_HANDLE;
+  VkFormat owned_render_pass_format_ = VK_FORMAT_UNDEFINED;
+  VkAttachmentLoadOp owned_render_pass_load_op_ =
+      VK_ATTACHMENT_LOAD_OP_CLEAR;
+  std::vector<VkImage> swapchain_images_;
+  std::vector<VkImageView> swapchain_image_views_;
+  std::vector<VkFramebuffer> framebuffers_;
+  std::vector<VkExtent2D> framebuffer_extents_;
+
+  // Guards the render passes and pipelines shared by all the swapchain images.
+  std::mutex shared_objects_mutex_;
+  uint64_t generation_ = 0;
+
+  // One per frame. Empty unless secondary command buffers are used.
+  std::vector<VkCommandPool> secondary_command_pools_;
+  std::vector<VkCommandBuffer> secondary_command_buffers_;
+  std::vector<RecordState> recorded_states_;
 };
 
 }  // namespace cardboard::rendering
@@ -704,9 +1390,25 @@ CardboardDistortionRenderer* CardboardVulkanDistortionRenderer_create(
   if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(config)) {
     return nullptr;
   }
+  CARDBOARD_TRACE_SCOPE("CardboardVulkanDistortionRenderer_create");
+
+  return reinterpret_cast<CardboardDistortionRenderer*>(
+      new cardboard::rendering::VulkanDistortionRenderer(
+          config, CardboardVulkanDistortionRendererOptions{}));
+}
+
+CardboardDistortionRenderer*
+CardboardVulkanDistortionRenderer_createWithOptions(
+    const CardboardVulkanDistortionRendererConfig* config,
+    const CardboardVulkanDistortionRendererOptions* options) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(config) ||
+      CARDBOARD_IS_ARG_NULL(options)) {
+    return nullptr;
+  }
+  CARDBOARD_TRACE_SCOPE("CardboardVulkanDistortionRenderer_createWithOptions");
 
   return reinterpret_cast<CardboardDistortionRenderer*>(
-      new cardboard::rendering::VulkanDistortionRenderer(config));
+      new cardboard::rendering::VulkanDistortionRenderer(config, *options));
 }
 
 }  // extern "C"
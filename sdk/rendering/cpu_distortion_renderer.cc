@@ -0,0 +1,588 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>  // NOLINT
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "distortion_renderer.h"
+#include "include/cardboard.h"
+#include "util/is_arg_null.h"
+#include "util/is_initialized.h"
+#include "util/logging.h"
+#include "util/reprojection.h"
+#include "util/trace.h"
+#include "util/worker_pool.h"
+
+namespace {
+
+constexpr int kBytesPerPixel = 4;
+
+// Bilinear weights have 8 bits of precision, as in common GPU texture units.
+constexpr int kSubTexelBits = 8;
+constexpr int kSubTexelCount = 1 << kSubTexelBits;
+
+constexpr std::array<uint8_t, kBytesPerPixel> kOpaqueBlack = {0, 0, 0, 255};
+
+// Number of rows of the display rectangle that a thread renders at a time.
+constexpr int kTileHeight = 16;
+
+// Tolerance on the barycentric coordinates of a pixel center, so that pixels
+// on an edge shared by two triangles are never missed because of rounding.
+constexpr float kBarycentricEpsilon = 1e-5f;
+
+// Eye texture coordinates, before the reprojection, of the center of each
+// pixel of an eye viewport. Rows are stored bottom row first.
+struct UvMap {
+  int width = 0;
+  int height = 0;
+  std::vector<float> u;
+  std::vector<float> v;
+  // Coordinates of the red and blue channels when the mesh has chromatic
+  // aberration correction, empty otherwise. u and v then hold the coordinates
+  // of the green and alpha channels.
+  std::vector<float> red_u;
+  std::vector<float> red_v;
+  std::vector<float> blue_u;
+  std::vector<float> blue_v;
+  // Non-zero where the pixel center is covered by the distortion mesh.
+  std::vector<uint8_t> covered;
+};
+
+// Eye image and its mapping from eye texture coordinates to texels.
+struct EyeSampler {
+  const uint8_t* pixels;
+  int width;
+  int height;
+  ptrdiff_t stride;
+  // Texel coordinates of the texture coordinate (0, 0) and size in texels of
+  // the eye rectangle.
+  float start_x;
+  float start_y;
+  float size_x;
+  float size_y;
+  // Column-major 3x3.
+  std::array<float, 9> reprojection;
+};
+
+// Fills @p map with the interpolated texture coordinates of the triangle
+// strip of a distortion mesh. As in the GPU renderers, the mesh positions are
+// in normalized device coordinates of the whole display rectangle of
+// @p display_width x @p display_height pixels and only the pixels of the eye
+// viewport, which starts at column @p x_offset, are kept. @p red_uvs and
+// @p blue_uvs are empty when the mesh has no chromatic aberration correction.
+void RasterizeMesh(const std::vector<int>& indices,
+                   const std::vector<float>& vertices,
+                   const std::vector<float>& uvs,
+                   const std::vector<float>& red_uvs,
+                   const std::vector<float>& blue_uvs, int display_width,
+                   int display_height, int x_offset, UvMap* map) {
+  const bool has_chromatic_aberration = !red_uvs.empty();
+  const size_t pixel_count = map->u.size();
+  map->red_u.assign(has_chromatic_aberration ? pixel_count : 0, 0.f);
+  map->red_v.assign(has_chromatic_aberration ? pixel_count : 0, 0.f);
+  map->blue_u.assign(has_chromatic_aberration ? pixel_count : 0, 0.f);
+  map->blue_v.assign(has_chromatic_aberration ? pixel_count : 0, 0.f);
+  std::fill(map->u.begin(), map->u.end(), 0.f);
+  std::fill(map->v.begin(), map->v.end(), 0.f);
+  std::fill(map->covered.begin(), map->covered.end(), 0);
+  const int vertex_count = static_cast<int>(vertices.size() / 2);
+
+  for (size_t i = 0; i + 2 < indices.size(); ++i) {
+    const std::array<int, 3> triangle = {indices[i], indices[i + 1],
+                                         indices[i + 2]};
+    if (std::any_of(triangle.begin(), triangle.end(), [&](int index) {
+          return index < 0 || index >= vertex_count;
+        })) {
+      continue;
+    }
+    std::array<float, 3> x;
+    std::array<float, 3> y;
+    for (int k = 0; k < 3; ++k) {
+      x[k] = (vertices[2 * triangle[k]] + 1.f) * 0.5f * display_width -
+             x_offset;
+      y[k] = (vertices[2 * triangle[k] + 1] + 1.f) * 0.5f * display_height;
+    }
+    const float area =
+        (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+    // Degenerate triangles join the rows of the strip.
+    if (std::abs(area) < 1e-6f) {
+      continue;
+    }
+
+    // Pixels whose center lies in the bounding box of the triangle.
+    const auto [min_x, max_x] = std::minmax({x[0], x[1], x[2]});
+    const auto [min_y, max_y] = std::minmax({y[0], y[1], y[2]});
+    const int first_column =
+        std::max(0, static_cast<int>(std::ceil(min_x - 0.5f)));
+    const int last_column = std::min(
+        map->width - 1, static_cast<int>(std::floor(max_x - 0.5f)));
+    const int first_row =
+        std::max(0, static_cast<int>(std::ceil(min_y - 0.5f)));
+    const int last_row = std::min(map->height - 1,
+                                  static_cast<int>(std::floor(max_y - 0.5f)));
+
+    const float inverse_area = 1.f / area;
+    for (int row = first_row; row <= last_row; ++row) {
+      const float center_y = row + 0.5f;
+      for (int column = first_column; column <= last_column; ++column) {
+        const float center_x = column + 0.5f;
+        const float w0 = ((x[2] - x[1]) * (center_y - y[1]) -
+                          (y[2] - y[1]) * (center_x - x[1])) *
+                         inverse_area;
+        const float w1 = ((x[0] - x[2]) * (center_y - y[2]) -
+                          (y[0] - y[2]) * (center_x - x[2])) *
+                         inverse_area;
+        const float w2 = 1.f - w0 - w1;
+        if (w0 < -kBarycentricEpsilon || w1 < -kBarycentricEpsilon ||
+            w2 < -kBarycentricEpsilon) {
+          continue;
+        }
+        const auto interpolate = [&](const std::vector<float>& values,
+                                     int component) {
+          return w0 * values[2 * triangle[0] + component] +
+                 w1 * values[2 * triangle[1] + component] +
+                 w2 * values[2 * triangle[2] + component];
+        };
+        const int pixel = row * map->width + column;
+        map->u[pixel] = interpolate(uvs, 0);
+        map->v[pixel] = interpolate(uvs, 1);
+        if (has_chromatic_aberration) {
+          map->red_u[pixel] = interpolate(red_uvs, 0);
+          map->red_v[pixel] = interpolate(red_uvs, 1);
+          map->blue_u[pixel] = interpolate(blue_uvs, 0);
+          map->blue_v[pixel] = interpolate(blue_uvs, 1);
+        }
+        map->covered[pixel] = 1;
+      }
+    }
+  }
+}
+
+inline uint32_t LoadPixel(const uint8_t* row, int column) {
+  uint32_t pixel;
+  memcpy(&pixel, row + column * kBytesPerPixel, sizeof(pixel));
+  return pixel;
+}
+
+// Each variant of BlendTexels() below rounds the 16-bit sums
+// a * (kSubTexelCount - weight) + b * weight of each channel to the nearest
+// 8-bit value, so they all produce the same images. Gathering the four texels
+// of each sample is left to scalar loads: SSE2 and NEON have no gather and the
+// sample positions are arbitrary, so the vector units only do the arithmetic,
+// one pixel at a time.
+#if defined(__SSE2__)
+
+// Interpolates the RGBA texels in the low and high 64 bits of @p texels, as
+// 16-bit channels, with the weights in @p weights. The result is in the low
+// 64 bits.
+inline __m128i LerpTexels(__m128i texels, __m128i weights) {
+  const __m128i products = _mm_mullo_epi16(texels, weights);
+  const __m128i sums = _mm_add_epi16(products, _mm_srli_si128(products, 8));
+  return _mm_srli_epi16(
+      _mm_add_epi16(sums, _mm_set1_epi16(kSubTexelCount / 2)), kSubTexelBits);
+}
+
+inline __m128i GetLerpWeights(uint32_t weight) {
+  return _mm_unpacklo_epi64(
+      _mm_set1_epi16(static_cast<int16_t>(kSubTexelCount - weight)),
+      _mm_set1_epi16(static_cast<int16_t>(weight)));
+}
+
+inline __m128i UnpackTexels(uint32_t a, uint32_t b) {
+  return _mm_unpacklo_epi8(
+      _mm_unpacklo_epi32(_mm_cvtsi32_si128(static_cast<int>(a)),
+                         _mm_cvtsi32_si128(static_cast<int>(b))),
+      _mm_setzero_si128());
+}
+
+// Interpolates four RGBA texels with weights of @p weight_x / kSubTexelCount
+// for the right texels and @p weight_y / kSubTexelCount for the top texels.
+inline uint32_t BlendTexels(uint32_t bottom_left, uint32_t bottom_right,
+                            uint32_t top_left, uint32_t top_right,
+                            uint32_t weight_x, uint32_t weight_y) {
+  const __m128i weights_x = GetLerpWeights(weight_x);
+  const __m128i rows = _mm_unpacklo_epi64(
+      LerpTexels(UnpackTexels(bottom_left, bottom_right), weights_x),
+      LerpTexels(UnpackTexels(top_left, top_right), weights_x));
+  const __m128i result = LerpTexels(rows, GetLerpWeights(weight_y));
+  return static_cast<uint32_t>(
+      _mm_cvtsi128_si32(_mm_packus_epi16(result, result)));
+}
+
+#elif defined(__ARM_NEON)
+
+// Interpolates the RGBA texels in the low and high halves of @p texels, as
+// 16-bit channels, with a weight of @p weight / kSubTexelCount for the high
+// half.
+inline uint16x4_t LerpTexels(uint16x8_t texels, uint32_t weight) {
+  const uint16x8_t weights =
+      vcombine_u16(vdup_n_u16(static_cast<uint16_t>(kSubTexelCount - weight)),
+                   vdup_n_u16(static_cast<uint16_t>(weight)));
+  const uint16x8_t products = vmulq_u16(texels, weights);
+  return vrshr_n_u16(vadd_u16(vget_low_u16(products), vget_high_u16(products)),
+                     kSubTexelBits);
+}
+
+inline uint16x8_t UnpackTexels(uint32_t a, uint32_t b) {
+  return vmovl_u8(vreinterpret_u8_u32(vset_lane_u32(b, vdup_n_u32(a), 1)));
+}
+
+// Interpolates four RGBA texels with weights of @p weight_x / kSubTexelCount
+// for the right texels and @p weight_y / kSubTexelCount for the top texels.
+inline uint32_t BlendTexels(uint32_t bottom_left, uint32_t bottom_right,
+                            uint32_t top_left, uint32_t top_right,
+                            uint32_t weight_x, uint32_t weight_y) {
+  const uint16x4_t bottom =
+      LerpTexels(UnpackTexels(bottom_left, bottom_right), weight_x);
+  const uint16x4_t top =
+      LerpTexels(UnpackTexels(top_left, top_right), weight_x);
+  const uint16x4_t result = LerpTexels(vcombine_u16(bottom, top), weight_y);
+  return vget_lane_u32(
+      vreinterpret_u32_u8(vmovn_u16(vcombine_u16(result, result))), 0);
+}
+
+#else
+
+// Interpolates each 8-bit channel of two RGBA pixels with a weight of
+// @p weight / kSubTexelCount for @p b. Two channels are processed at a time in
+// each 32-bit word.
+inline uint32_t LerpPixel(uint32_t a, uint32_t b, uint32_t weight) {
+  constexpr uint32_t kEvenChannels = 0x00ff00ff;
+  constexpr uint32_t kRounding = 0x00800080;
+  const uint32_t complement = kSubTexelCount - weight;
+  const uint32_t even = (((a & kEvenChannels) * complement +
+                          (b & kEvenChannels) * weight + kRounding) >>
+                         kSubTexelBits) &
+                        kEvenChannels;
+  const uint32_t odd = (((a >> 8) & kEvenChannels) * complement +
+                        ((b >> 8) & kEvenChannels) * weight + kRounding) &
+                       ~kEvenChannels;
+  return even | odd;
+}
+
+// Interpolates four RGBA texels with weights of @p weight_x / kSubTexelCount
+// for the right texels and @p weight_y / kSubTexelCount for the top texels.
+inline uint32_t BlendTexels(uint32_t bottom_left, uint32_t bottom_right,
+                            uint32_t top_left, uint32_t top_right,
+                            uint32_t weight_x, uint32_t weight_y) {
+  return LerpPixel(LerpPixel(bottom_left, bottom_right, weight_x),
+                   LerpPixel(top_left, top_right, weight_x), weight_y);
+}
+
+#endif
+
+// Samples the eye image with bilinear filtering and clamp to edge addressing.
+// @p fixed_x and @p fixed_y are fixed point texel coordinates, offset by one
+// texel so that they are never negative, where integer coordinates are texel
+// centers.
+inline void SampleBilinear(const EyeSampler& eye, int32_t fixed_x,
+                           int32_t fixed_y, uint8_t* pixel) {
+  const int column = (fixed_x >> kSubTexelBits) - 1;
+  const int row = (fixed_y >> kSubTexelBits) - 1;
+  const int left = std::clamp(column, 0, eye.width - 1);
+  const int right = std::clamp(column + 1, 0, eye.width - 1);
+  const uint8_t* bottom_row =
+      eye.pixels + std::clamp(row, 0, eye.height - 1) * eye.stride;
+  const uint8_t* top_row =
+      eye.pixels + std::clamp(row + 1, 0, eye.height - 1) * eye.stride;
+
+  const uint32_t weight_x = fixed_x & (kSubTexelCount - 1);
+  const uint32_t weight_y = fixed_y & (kSubTexelCount - 1);
+  const uint32_t result =
+      BlendTexels(LoadPixel(bottom_row, left), LoadPixel(bottom_row, right),
+                  LoadPixel(top_row, left), LoadPixel(top_row, right),
+                  weight_x, weight_y);
+  memcpy(pixel, &result, sizeof(result));
+}
+
+// Computes the fixed point texel coordinates, as expected by
+// SampleBilinear(), of @p count texture coordinates.
+void GetTexelCoordinates(const float* u, const float* v, int count,
+                         const EyeSampler& eye, int32_t* fixed_x,
+                         int32_t* fixed_y) {
+  const std::array<float, 9>& m = eye.reprojection;
+  const float max_x = static_cast<float>(eye.width);
+  const float max_y = static_cast<float>(eye.height);
+
+  // The texel coordinates are computed for the whole row without branches,
+  // so that compilers vectorize this loop. As in the GPU renderers, the
+  // reprojected coordinates are clamped to the eye rectangle. Coordinates
+  // past the edges of the image are clamped too so that the conversion cannot
+  // overflow. std::max() returns its first argument when the comparison
+  // fails, which also maps NaN to 0.
+  for (int i = 0; i < count; ++i) {
+    const float x = m[0] * u[i] + m[3] * v[i] + m[6];
+    const float y = m[1] * u[i] + m[4] * v[i] + m[7];
+    const float inverse_z = 1.f / (m[2] * u[i] + m[5] * v[i] + m[8]);
+    const float clamped_x = std::min(std::max(0.f, x * inverse_z), 1.f);
+    const float clamped_y = std::min(std::max(0.f, y * inverse_z), 1.f);
+    const float texel_x = std::min(
+        std::max(-1.f, eye.start_x + clamped_x * eye.size_x - 0.5f), max_x);
+    const float texel_y = std::min(
+        std::max(-1.f, eye.start_y + clamped_y * eye.size_y - 0.5f), max_y);
+    fixed_x[i] = static_cast<int32_t>((texel_x + 1.f) * kSubTexelCount);
+    fixed_y[i] = static_cast<int32_t>((texel_y + 1.f) * kSubTexelCount);
+  }
+}
+
+// Renders a row of an eye viewport to @p output. @p fixed_x and @p fixed_y
+// are scratch buffers of at least map.width elements, or 3 * map.width
+// elements when the map has chromatic aberration correction.
+void RenderEyeRow(const UvMap& map, int row, const EyeSampler& eye,
+                  bool clear_vignette, int32_t* fixed_x, int32_t* fixed_y,
+                  uint8_t* output) {
+  const int offset = row * map.width;
+  const uint8_t* covered = map.covered.data() + offset;
+  GetTexelCoordinates(map.u.data() + offset, map.v.data() + offset,
+                      map.width, eye, fixed_x, fixed_y);
+  const bool has_chromatic_aberration = !map.red_u.empty();
+  if (has_chromatic_aberration) {
+    GetTexelCoordinates(map.red_u.data() + offset, map.red_v.data() + offset,
+                        map.width, eye, fixed_x + map.width,
+                        fixed_y + map.width);
+    GetTexelCoordinates(map.blue_u.data() + offset,
+                        map.blue_v.data() + offset, map.width, eye,
+                        fixed_x + 2 * map.width, fixed_y + 2 * map.width);
+  }
+
+  for (int i = 0; i < map.width; ++i) {
+    uint8_t* pixel = output + i * kBytesPerPixel;
+    if (covered[i] != 0) {
+      SampleBilinear(eye, fixed_x[i], fixed_y[i], pixel);
+      if (has_chromatic_aberration) {
+        std::array<uint8_t, kBytesPerPixel> red;
+        std::array<uint8_t, kBytesPerPixel> blue;
+        SampleBilinear(eye, fixed_x[map.width + i], fixed_y[map.width + i],
+                       red.data());
+        SampleBilinear(eye, fixed_x[2 * map.width + i],
+                       fixed_y[2 * map.width + i], blue.data());
+        pixel[0] = red[0];
+        pixel[2] = blue[2];
+      }
+    } else if (clear_vignette) {
+      memcpy(pixel, kOpaqueBlack.data(), kBytesPerPixel);
+    }
+  }
+}
+
+// Returns whether @p image describes a non empty image.
+bool IsValidImage(const CardboardCpuImage* image) {
+  return image != nullptr && image->pixels != nullptr && image->width > 0 &&
+         image->height > 0;
+}
+
+}  // namespace
+
+namespace cardboard::rendering {
+
+// @brief CPU concrete implementation of DistortionRenderer.
+class CpuDistortionRenderer : public DistortionRenderer {
+ public:
+  CpuDistortionRenderer(const CardboardCpuDistortionRendererConfig* config)
+      : worker_pool_{config->thread_count > 0
+                         ? config->thread_count
+                         : static_cast<int>(
+                               std::thread::hardware_concurrency())},
+        scratch_buffers_(worker_pool_.worker_count()),
+        reprojection_{IdentityReprojection(), IdentityReprojection()},
+        pass_config_{kColorLoadOpClear, 0, 0},
+        is_uv_map_dirty_{true, true} {}
+
+  void SetMesh(const CardboardChromaticMesh* chromatic_mesh,
+               CardboardEye eye) override {
+    const CardboardMesh* mesh = &chromatic_mesh->mesh;
+    const float* red_uvs = chromatic_mesh->red_uvs;
+    const float* blue_uvs = chromatic_mesh->blue_uvs;
+    indices_[eye].assign(mesh->indices, mesh->indices + mesh->n_indices);
+    vertices_[eye].assign(mesh->vertices,
+                          mesh->vertices + mesh->n_vertices * 2);
+    uvs_[eye].assign(mesh->uvs, mesh->uvs + mesh->n_vertices * 2);
+    if (red_uvs != nullptr && blue_uvs != nullptr) {
+      red_uvs_[eye].assign(red_uvs, red_uvs + mesh->n_vertices * 2);
+      blue_uvs_[eye].assign(blue_uvs, blue_uvs + mesh->n_vertices * 2);
+    } else {
+      red_uvs_[eye].clear();
+      blue_uvs_[eye].clear();
+    }
+    is_uv_map_dirty_[eye] = true;
+  }
+
+  void SetReprojection(const std::array<float, 9>& reprojection,
+                       CardboardEye eye) override {
+    reprojection_[eye] = reprojection;
+  }
+
+  void SetPassConfig(
+      const CardboardDistortionRendererPassConfig& pass_config) override {
+    pass_config_ = pass_config;
+  }
+
+  void RenderEyeToDisplay(
+      uint64_t target, int x, int y, int width, int height,
+      const CardboardEyeTextureDescription* left_eye,
+      const CardboardEyeTextureDescription* right_eye) override {
+    if (indices_[0].empty() || indices_[1].empty()) {
+      CARDBOARD_LOGE(
+          "Distortion mesh is empty. CpuDistortionRenderer::SetMesh was not "
+          "called yet.");
+      return;
+    }
+    const auto* image = reinterpret_cast<const CardboardCpuImage*>(target);
+    if (!IsValidImage(image) || x < 0 || y < 0 || width < 2 || height <= 0 ||
+        x + width > image->width || y + height > image->height) {
+      CARDBOARD_LOGE(
+          "The target image is empty or does not contain the display "
+          "rectangle.");
+      return;
+    }
+    const std::array<const CardboardEyeTextureDescription*, 2> descriptions =
+        {left_eye, right_eye};
+    std::array<EyeSampler, 2> eyes;
+    for (int eye = 0; eye < 2; ++eye) {
+      const auto* eye_image = reinterpret_cast<const CardboardCpuImage*>(
+          descriptions[eye]->texture);
+      if (!IsValidImage(eye_image)) {
+        CARDBOARD_LOGE("Eye image is empty.");
+        return;
+      }
+      eyes[eye] = GetEyeSampler(*eye_image, *descriptions[eye], eye);
+    }
+
+    UpdateUvMaps(width, height);
+
+    const int eye_width = width / 2;
+    const bool clear_vignette =
+        pass_config_.color_load_op != kColorLoadOpLoad;
+    // Room for the coordinates of the three color channels.
+    for (ScratchBuffer& scratch : scratch_buffers_) {
+      scratch.fixed_x.resize(3 * eye_width);
+      scratch.fixed_y.resize(3 * eye_width);
+    }
+    const int tile_count = (height + kTileHeight - 1) / kTileHeight;
+    worker_pool_.Run(tile_count, [&](int tile, int worker) {
+      ScratchBuffer& scratch = scratch_buffers_[worker];
+      const int last_row = std::min((tile + 1) * kTileHeight, height);
+      for (int row = tile * kTileHeight; row < last_row; ++row) {
+        uint8_t* output = image->pixels +
+                          static_cast<ptrdiff_t>(y + row) * image->stride +
+                          x * kBytesPerPixel;
+        for (int eye = 0; eye < 2; ++eye) {
+          RenderEyeRow(uv_maps_[eye], row, eyes[eye], clear_vignette,
+                       scratch.fixed_x.data(), scratch.fixed_y.data(),
+                       output + eye * eye_width * kBytesPerPixel);
+        }
+        // The last column of an odd width rectangle is not part of any eye
+        // viewport.
+        if (clear_vignette && width % 2 != 0) {
+          memcpy(output + 2 * eye_width * kBytesPerPixel,
+                 kOpaqueBlack.data(), kBytesPerPixel);
+        }
+      }
+    });
+  }
+
+ private:
+  EyeSampler GetEyeSampler(const CardboardCpuImage& image,
+                           const CardboardEyeTextureDescription& description,
+                           int eye) const {
+    return {image.pixels,
+            image.width,
+            image.height,
+            image.stride,
+            description.left_u * image.width,
+            description.bottom_v * image.height,
+            (description.right_u - description.left_u) * image.width,
+            (description.top_v - description.bottom_v) * image.height,
+            reprojection_[eye]};
+  }
+
+  // Rasterizes the distortion meshes again when they or the size of the
+  // display rectangle changed.
+  void UpdateUvMaps(int width, int height) {
+    const int eye_width = width / 2;
+    std::array<int, 2> dirty_eyes;
+    int dirty_eye_count = 0;
+    for (int eye = 0; eye < 2; ++eye) {
+      UvMap& map = uv_maps_[eye];
+      if (!is_uv_map_dirty_[eye] && map.width == eye_width &&
+          map.height == height) {
+        continue;
+      }
+      map.width = eye_width;
+      map.height = height;
+      map.u.resize(eye_width * height);
+      map.v.resize(eye_width * height);
+      map.covered.resize(eye_width * height);
+      is_uv_map_dirty_[eye] = false;
+      dirty_eyes[dirty_eye_count++] = eye;
+    }
+    if (dirty_eye_count == 0) {
+      return;
+    }
+    CARDBOARD_TRACE_SCOPE("CpuDistortionRenderer::UpdateUvMaps");
+    worker_pool_.Run(dirty_eye_count, [&](int index, int /*worker*/) {
+      const int eye = dirty_eyes[index];
+      RasterizeMesh(indices_[eye], vertices_[eye], uvs_[eye], red_uvs_[eye],
+                    blue_uvs_[eye], width, height, eye * eye_width,
+                    &uv_maps_[eye]);
+    });
+  }
+
+  // Texel coordinates of the rows a worker renders.
+  struct ScratchBuffer {
+    std::vector<int32_t> fixed_x;
+    std::vector<int32_t> fixed_y;
+  };
+
+  util::WorkerPool worker_pool_;
+  std::vector<ScratchBuffer> scratch_buffers_;  // One per worker.
+  std::array<std::vector<int>, 2> indices_;  // One per eye.
+  std::array<std::vector<float>, 2> vertices_;
+  std::array<std::vector<float>, 2> uvs_;
+  // Empty for meshes without chromatic aberration correction.
+  std::array<std::vector<float>, 2> red_uvs_;
+  std::array<std::vector<float>, 2> blue_uvs_;
+  std::array<std::array<float, 9>, 2> reprojection_;  // Column-major 3x3.
+  CardboardDistortionRendererPassConfig pass_config_;
+  std::array<UvMap, 2> uv_maps_;
+  std::array<bool, 2> is_uv_map_dirty_;
+};
+
+}  // namespace cardboard::rendering
+
+extern "C" {
+
+CardboardDistortionRenderer* CardboardCpuDistortionRenderer_create(
+    const CardboardCpuDistortionRendererConfig* config) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(config)) {
+    return nullptr;
+  }
+  return reinterpret_cast<CardboardDistortionRenderer*>(
+      new cardboard::rendering::CpuDistortionRenderer(config));
+}
+
+}  // extern "C"
@@ -28,6 +28,9 @@ namespace {
 typedef enum VertexInputIndex {
   VertexInputIndexPosition = 0,
   VertexInputIndexTexCoords,
+  VertexInputIndexReprojection,
+  VertexInputIndexRedTexCoords,
+  VertexInputIndexBlueTexCoords,
 } VertexInputIndex;
 
 /// @note This enum must be kept in sync with the shader counterpart.
@@ -53,6 +56,9 @@ constexpr const char* kMetalShaders =
     typedef enum VertexInputIndex {
       VertexInputIndexPosition = 0,
       VertexInputIndexTexCoords,
+      VertexInputIndexReprojection,
+      VertexInputIndexRedTexCoords,
+      VertexInputIndexBlueTexCoords,
     } VertexInputIndex;
 
     typedef enum FragmentInputIndex {
@@ -68,16 +74,16 @@ constexpr const char* kMetalShaders =
 
     struct VertexOut {
       float4 position [[position]];
-      float2 tex_coords;
+      float3 tex_coords;
     };
 
     vertex VertexOut vertexShader(uint vertexID [[vertex_id]],
                                   constant vector_float2 *position [[buffer(VertexInputIndexPosition)]],
-                                  constant vector_float2 *tex_coords [[buffer(VertexInputIndexTexCoords)]]) {
+                                  constant vector_float2 *tex_coords [[buffer(VertexInputIndexTexCoords)]],
+                                  constant float3x3 *reprojection [[buffer(VertexInputIndexReprojection)]]) {
       VertexOut out;
       out.position = vector_float4(position[vertexID], 0.0, 1.0);
-      // The v coordinate of the distortion mesh is reversed compared to what Metal expects, so we invert it.
-      out.tex_coords = vector_float2(tex_coords[vertexID].x, 1.0 - tex_coords[vertexID].y);
+      out.tex_coords = *reprojection * float3(tex_coords[vertexID], 1.0);
       return out;
     }
 
@@ -86,8 +92,53 @@ constexpr const char* kMetalShaders =
                                    constant vector_float2 *start [[buffer(FragmentInputIndexStart)]],
                                    constant vector_float2 *end [[buffer(FragmentInputIndexEnd)]]) {
       constexpr sampler textureSampler(mag_filter::linear, min_filter::linear);
-      float2 coords = *start + in.tex_coords * (*end - *start);
+      // The reprojected texture coordinates are clamped to the eye texture rectangle.
+      float2 tex_coords = saturate(in.tex_coords.xy / in.tex_coords.z);
+      // The v coordinate of the distortion mesh is reversed compared to what Metal expects, so we invert it.
+      tex_coords.y = 1.0 - tex_coords.y;
+      float2 coords = *start + tex_coords * (*end - *start);
       return float4(colorTexture.sample(textureSampler, coords));
+    }
+
+    // Variant for meshes with chromatic aberration correction: the red, green and blue channels
+    // are sampled at their own texture coordinates.
+    struct ChromaticVertexOut {
+      float4 position [[position]];
+      float3 tex_coords;
+      float3 red_tex_coords;
+      float3 blue_tex_coords;
+    };
+
+    vertex ChromaticVertexOut chromaticVertexShader(uint vertexID [[vertex_id]],
+                                  constant vector_float2 *position [[buffer(VertexInputIndexPosition)]],
+                                  constant vector_float2 *tex_coords [[buffer(VertexInputIndexTexCoords)]],
+                                  constant float3x3 *reprojection [[buffer(VertexInputIndexReprojection)]],
+                                  constant vector_float2 *red_tex_coords [[buffer(VertexInputIndexRedTexCoords)]],
+                                  constant vector_float2 *blue_tex_coords [[buffer(VertexInputIndexBlueTexCoords)]]) {
+      ChromaticVertexOut out;
+      out.position = vector_float4(position[vertexID], 0.0, 1.0);
+      out.tex_coords = *reprojection * float3(tex_coords[vertexID], 1.0);
+      out.red_tex_coords = *reprojection * float3(red_tex_coords[vertexID], 1.0);
+      out.blue_tex_coords = *reprojection * float3(blue_tex_coords[vertexID], 1.0);
+      return out;
+    }
+
+    float2 GetCoords(float3 tex_coords, float2 start, float2 end) {
+      float2 coords = saturate(tex_coords.xy / tex_coords.z);
+      // The v coordinate of the distortion mesh is reversed compared to what Metal expects, so we invert it.
+      coords.y = 1.0 - coords.y;
+      return start + coords * (end - start);
+    }
+
+    fragment float4 chromaticFragmentShader(ChromaticVertexOut in [[stage_in]],
+                                   texture2d<half> colorTexture [[texture(FragmentInputIndexTexture)]],
+                                   constant vector_float2 *start [[buffer(FragmentInputIndexStart)]],
+                                   constant vector_float2 *end [[buffer(FragmentInputIndexEnd)]]) {
+      constexpr sampler textureSampler(mag_filter::linear, min_filter::linear);
+      half4 color = colorTexture.sample(textureSampler, GetCoords(in.tex_coords, *start, *end));
+      color.r = colorTexture.sample(textureSampler, GetCoords(in.red_tex_coords, *start, *end)).r;
+      color.b = colorTexture.sample(textureSampler, GetCoords(in.blue_tex_coords, *start, *end)).b;
+      return float4(color);
     })msl";
 
 }  // namespace
@@ -115,24 +166,13 @@ class MetalDistortionRenderer : public DistortionRenderer {
       return;
     }
 
-    id<MTLFunction> vertex_function = [mtl_library newFunctionWithName:@"vertexShader"];
-    id<MTLFunction> fragment_function = [mtl_library newFunctionWithName:@"fragmentShader"];
-
-    // Create pipeline.
+    // Create pipelines.
     MTLRenderPipelineDescriptorClass = NSClassFromString(@"MTLRenderPipelineDescriptor");
-    MTLRenderPipelineDescriptor* mtl_render_pipeline_descriptor =
-        [[MTLRenderPipelineDescriptorClass alloc] init];
-    mtl_render_pipeline_descriptor.vertexFunction = vertex_function;
-    mtl_render_pipeline_descriptor.fragmentFunction = fragment_function;
-    mtl_render_pipeline_descriptor.colorAttachments[0].pixelFormat =
-        static_cast<MTLPixelFormat>(config->color_attachment_pixel_format);
-    mtl_render_pipeline_descriptor.depthAttachmentPixelFormat =
-        static_cast<MTLPixelFormat>(config->depth_attachment_pixel_format);
-    mtl_render_pipeline_descriptor.stencilAttachmentPixelFormat =
-        static_cast<MTLPixelFormat>(config->stencil_attachment_pixel_format);
     mtl_render_pipeline_state_ =
-        [mtl_device_ newRenderPipelineStateWithDescriptor:mtl_render_pipeline_descriptor error:nil];
-    if (mtl_render_pipeline_state_ == nil) {
+        CreateRenderPipelineState(mtl_library, @"vertexShader", @"fragmentShader", config);
+    chromatic_mtl_render_pipeline_state_ = CreateRenderPipelineState(
+        mtl_library, @"chromaticVertexShader", @"chromaticFragmentShader", config);
+    if (mtl_render_pipeline_state_ == nil || chromatic_mtl_render_pipeline_state_ == nil) {
       CARDBOARD_LOGE("Failed to create Metal render pipeline.");
       return;
     }
@@ -142,7 +182,11 @@ class MetalDistortionRenderer : public DistortionRenderer {
 
   ~MetalDistortionRenderer() {}
 
-  void SetMesh(const CardboardMesh* mesh, CardboardEye eye) override {
+  void SetMesh(const CardboardChromaticMesh* chromatic_mesh,
+               CardboardEye eye) override {
+    const CardboardMesh* mesh = &chromatic_mesh->mesh;
+    const float* red_uvs = chromatic_mesh->red_uvs;
+    const float* blue_uvs = chromatic_mesh->blue_uvs;
     vertices_buffer_[eye] = [mtl_device_
         newBufferWithBytes:mesh->vertices
                     length:(mesh->n_vertices * sizeof(float) * 2)  // Two components per vertex
@@ -151,12 +195,35 @@ class MetalDistortionRenderer : public DistortionRenderer {
         newBufferWithBytes:mesh->uvs
                     length:(mesh->n_vertices * sizeof(float) * 2)  // Two components per uv
                    options:MTLResourceStorageModeShared];
+    has_chromatic_aberration_[eye] = red_uvs != nullptr && blue_uvs != nullptr;
+    if (has_chromatic_aberration_[eye]) {
+      red_uvs_buffer_[eye] = [mtl_device_ newBufferWithBytes:red_uvs
+                                                      length:(mesh->n_vertices * sizeof(float) * 2)
+                                                     options:MTLResourceStorageModeShared];
+      blue_uvs_buffer_[eye] = [mtl_device_ newBufferWithBytes:blue_uvs
+                                                       length:(mesh->n_vertices * sizeof(float) * 2)
+                                                      options:MTLResourceStorageModeShared];
+    } else {
+      red_uvs_buffer_[eye] = nil;
+      blue_uvs_buffer_[eye] = nil;
+    }
     indices_buffer_[eye] = [mtl_device_ newBufferWithBytes:mesh->indices
                                                     length:(mesh->n_indices * sizeof(int))
                                                    options:MTLResourceStorageModeShared];
     indices_count_[eye] = mesh->n_indices;
   }
 
+  void SetReprojection(const std::array<float, 9>& reprojection, CardboardEye eye) override {
+    reprojection_[eye] = simd_matrix(
+        simd_make_float3(reprojection[0], reprojection[1], reprojection[2]),
+        simd_make_float3(reprojection[3], reprojection[4], reprojection[5]),
+        simd_make_float3(reprojection[6], reprojection[7], reprojection[8]));
+  }
+
+  // The load and store actions are set by the application on the render pass descriptor of the
+  // encoder it provides.
+  void SetPassConfig(const CardboardDistortionRendererPassConfig& /*pass_config*/) override {}
+
   void RenderEyeToDisplay(uint64_t target, int x, int y, int width, int height,
                           const CardboardEyeTextureDescription* left_eye,
                           const CardboardEyeTextureDescription* right_eye) override {
@@ -181,8 +248,6 @@ class MetalDistortionRenderer : public DistortionRenderer {
         (__bridge id<MTLRenderCommandEncoder>)reinterpret_cast<CFTypeRef>(
             target_config->render_command_encoder);
 
-    [mtl_render_command_encoder setRenderPipelineState:mtl_render_pipeline_state_];
-
     // Translate y coordinate of the rectangle since in Metal the (0,0) coordinate is
     // located on the top-left corner instead of the bottom-left corner.
     const int mtl_viewport_y = target_config->screen_height - height - y;
@@ -197,9 +262,33 @@ class MetalDistortionRenderer : public DistortionRenderer {
   }
 
  private:
+  id<MTLRenderPipelineState> CreateRenderPipelineState(
+      id<MTLLibrary> mtl_library, NSString* vertex_function_name, NSString* fragment_function_name,
+      const CardboardMetalDistortionRendererConfig* config) const {
+    MTLRenderPipelineDescriptor* mtl_render_pipeline_descriptor =
+        [[MTLRenderPipelineDescriptorClass alloc] init];
+    mtl_render_pipeline_descriptor.vertexFunction =
+        [mtl_library newFunctionWithName:vertex_function_name];
+    mtl_render_pipeline_descriptor.fragmentFunction =
+        [mtl_library newFunctionWithName:fragment_function_name];
+    mtl_render_pipeline_descriptor.colorAttachments[0].pixelFormat =
+        static_cast<MTLPixelFormat>(config->color_attachment_pixel_format);
+    mtl_render_pipeline_descriptor.depthAttachmentPixelFormat =
+        static_cast<MTLPixelFormat>(config->depth_attachment_pixel_format);
+    mtl_render_pipeline_descriptor.stencilAttachmentPixelFormat =
+        static_cast<MTLPixelFormat>(config->stencil_attachment_pixel_format);
+    return [mtl_device_ newRenderPipelineStateWithDescriptor:mtl_render_pipeline_descriptor
+                                                       error:nil];
+  }
+
   void RenderDistortionMesh(id<MTLRenderCommandEncoder> mtl_render_command_encoder,
                             const CardboardEyeTextureDescription* eye_description,
                             CardboardEye eye) const {
+    id<MTLRenderPipelineState> mtl_render_pipeline_state =
+        has_chromatic_aberration_[eye] ? chromatic_mtl_render_pipeline_state_
+                                       : mtl_render_pipeline_state_;
+    [mtl_render_command_encoder setRenderPipelineState:mtl_render_pipeline_state];
+
     [mtl_render_command_encoder setVertexBuffer:vertices_buffer_[eye]
                                          offset:0
                                         atIndex:VertexInputIndexPosition];
@@ -208,6 +297,19 @@ class MetalDistortionRenderer : public DistortionRenderer {
                                          offset:0
                                         atIndex:VertexInputIndexTexCoords];
 
+    [mtl_render_command_encoder setVertexBytes:&reprojection_[eye]
+                                        length:sizeof(reprojection_[eye])
+                                       atIndex:VertexInputIndexReprojection];
+
+    if (has_chromatic_aberration_[eye]) {
+      [mtl_render_command_encoder setVertexBuffer:red_uvs_buffer_[eye]
+                                           offset:0
+                                          atIndex:VertexInputIndexRedTexCoords];
+      [mtl_render_command_encoder setVertexBuffer:blue_uvs_buffer_[eye]
+                                           offset:0
+                                          atIndex:VertexInputIndexBlueTexCoords];
+    }
+
     [mtl_render_command_encoder
         setFragmentTexture:(__bridge id<MTLTexture>)reinterpret_cast<CFTypeRef>(
                                eye_description->texture)
@@ -232,13 +334,22 @@ class MetalDistortionRenderer : public DistortionRenderer {
 
   id<MTLDevice> mtl_device_;
   id<MTLRenderPipelineState> mtl_render_pipeline_state_;
+  // Used for meshes with chromatic aberration correction.
+  id<MTLRenderPipelineState> chromatic_mtl_render_pipeline_state_;
 
   // Mesh buffers. One per eye.
   std::array<id<MTLBuffer>, 2> vertices_buffer_;
   std::array<id<MTLBuffer>, 2> uvs_buffer_;
+  // Nil for meshes without chromatic aberration correction.
+  std::array<id<MTLBuffer>, 2> red_uvs_buffer_;
+  std::array<id<MTLBuffer>, 2> blue_uvs_buffer_;
+  std::array<bool, 2> has_chromatic_aberration_{false, false};
   std::array<id<MTLBuffer>, 2> indices_buffer_;
   std::array<int, 2> indices_count_{0, 0};
 
+  // Eye texture coordinates reprojection. One per eye.
+  std::array<simd_float3x3, 2> reprojection_{matrix_identity_float3x3, matrix_identity_float3x3};
+
   bool is_initialized_{false};
 };
 
@@ -13,23 +13,30 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#ifndef __APPLE__
+#include <dlfcn.h>
+#endif
+
 #include <array>
+#include <cstring>
 #include <vector>
 
-#ifdef __ANDROID__
-#include <GLES2/gl2.h>
-#endif
 #ifdef __APPLE__
 #include <OpenGLES/ES2/gl.h>
-#endif
-#ifdef __ANDROID__
+#include <OpenGLES/ES2/glext.h>
+#else
+#include <GLES2/gl2.h>
 #include <GLES2/gl2ext.h>
 #endif
 #include "distortion_renderer.h"
 #include "include/cardboard.h"
+#include "rendering/opengl_program_cache.h"
 #include "util/is_arg_null.h"
 #include "util/is_initialized.h"
 #include "util/logging.h"
+#include "util/reprojection.h"
+#include "util/trace.h"
+#include "util/vignette.h"
 
 namespace {
 
@@ -37,13 +44,36 @@ constexpr const char* kDistortionVertexShader =
     R"glsl(
     attribute vec2 a_Position;
     attribute vec2 a_TexCoords;
-    varying vec2 v_TexCoords;
+    uniform mat3 u_Reprojection;
+    varying vec3 v_TexCoords;
 
     void main() {
       gl_Position = vec4(a_Position, 0, 1);
-      v_TexCoords = a_TexCoords;
+      v_TexCoords = u_Reprojection * vec3(a_TexCoords, 1);
     })glsl";
 
+// Variant for meshes with chromatic aberration correction: the red, green and
+// blue channels are sampled at their own texture coordinates.
+constexpr const char* kChromaticDistortionVertexShader =
+    R"glsl(
+    attribute vec2 a_Position;
+    attribute vec2 a_TexCoords;
+    attribute vec2 a_TexCoordsRed;
+    attribute vec2 a_TexCoordsBlue;
+    uniform mat3 u_Reprojection;
+    varying vec3 v_TexCoords;
+    varying vec3 v_TexCoordsRed;
+    varying vec3 v_TexCoordsBlue;
+
+    void main() {
+      gl_Position = vec4(a_Position, 0, 1);
+      v_TexCoords = u_Reprojection * vec3(a_TexCoords, 1);
+      v_TexCoordsRed = u_Reprojection * vec3(a_TexCoordsRed, 1);
+      v_TexCoordsBlue = u_Reprojection * vec3(a_TexCoordsBlue, 1);
+    })glsl";
+
+// The reprojected texture coordinates are clamped to the eye texture
+// rectangle, so that the texels around the rendered area are never sampled.
 constexpr const char* kDistortionFragmentShaderTexture2D =
     R"glsl(
     precision mediump float;
@@ -51,13 +81,37 @@ constexpr const char* kDistortionFragmentShaderTexture2D =
     uniform sampler2D u_Texture;
     uniform vec2 u_Start;
     uniform vec2 u_End;
-    varying vec2 v_TexCoords;
+    varying vec3 v_TexCoords;
 
     void main() {
-      vec2 coords = u_Start + v_TexCoords * (u_End - u_Start);
+      vec2 coords = u_Start + clamp(v_TexCoords.xy / v_TexCoords.z, 0.0, 1.0) *
+                                  (u_End - u_Start);
       gl_FragColor = texture2D(u_Texture, coords);
     })glsl";
 
+constexpr const char* kChromaticDistortionFragmentShaderTexture2D =
+    R"glsl(
+    precision mediump float;
+
+    uniform sampler2D u_Texture;
+    uniform vec2 u_Start;
+    uniform vec2 u_End;
+    varying vec3 v_TexCoords;
+    varying vec3 v_TexCoordsRed;
+    varying vec3 v_TexCoordsBlue;
+
+    vec2 GetCoords(vec3 tex_coords) {
+      return u_Start +
+             clamp(tex_coords.xy / tex_coords.z, 0.0, 1.0) * (u_End - u_Start);
+    }
+
+    void main() {
+      vec4 color = texture2D(u_Texture, GetCoords(v_TexCoords));
+      color.r = texture2D(u_Texture, GetCoords(v_TexCoordsRed)).r;
+      color.b = texture2D(u_Texture, GetCoords(v_TexCoordsBlue)).b;
+      gl_FragColor = color;
+    })glsl";
+
 #ifdef __ANDROID__
 constexpr const char* kDistortionFragmentShaderTextureExternalOes =
     R"glsl(
@@ -67,12 +121,37 @@ constexpr const char* kDistortionFragmentShaderTextureExternalOes =
     uniform samplerExternalOES u_Texture;
     uniform vec2 u_Start;
     uniform vec2 u_End;
-    varying vec2 v_TexCoords;
+    varying vec3 v_TexCoords;
 
     void main() {
-      vec2 coords = u_Start + v_TexCoords * (u_End - u_Start);
+      vec2 coords = u_Start + clamp(v_TexCoords.xy / v_TexCoords.z, 0.0, 1.0) *
+                                  (u_End - u_Start);
       gl_FragColor = texture2D(u_Texture, coords);
     })glsl";
+
+constexpr const char* kChromaticDistortionFragmentShaderTextureExternalOes =
+    R"glsl(
+    #extension GL_OES_EGL_image_external : require
+    precision mediump float;
+
+    uniform samplerExternalOES u_Texture;
+    uniform vec2 u_Start;
+    uniform vec2 u_End;
+    varying vec3 v_TexCoords;
+    varying vec3 v_TexCoordsRed;
+    varying vec3 v_TexCoordsBlue;
+
+    vec2 GetCoords(vec3 tex_coords) {
+      return u_Start +
+             clamp(tex_coords.xy / tex_coords.z, 0.0, 1.0) * (u_End - u_Start);
+    }
+
+    void main() {
+      vec4 color = texture2D(u_Texture, GetCoords(v_TexCoords));
+      color.r = texture2D(u_Texture, GetCoords(v_TexCoordsRed)).r;
+      color.b = texture2D(u_Texture, GetCoords(v_TexCoordsBlue)).b;
+      gl_FragColor = color;
+    })glsl";
 #endif
 
 void CheckGlError(const char* label) {
@@ -150,6 +229,94 @@ GLuint CreateProgram(const char* vertex, const char* fragment) {
   return program;
 }
 
+const char* GetVertexShader(bool chromatic_aberration) {
+  return chromatic_aberration ? kChromaticDistortionVertexShader
+                              : kDistortionVertexShader;
+}
+
+// Returns the fragment shader sampling eye textures of @p texture_type and sets
+// @p eye_texture_type to the matching texture target.
+const char* GetFragmentShader(
+    CardboardSupportedOpenGlEsTextureType texture_type,
+    bool chromatic_aberration, GLenum* eye_texture_type) {
+  switch (texture_type) {
+    case kGlTexture2D:
+      *eye_texture_type = GL_TEXTURE_2D;
+      return chromatic_aberration ? kChromaticDistortionFragmentShaderTexture2D
+                                  : kDistortionFragmentShaderTexture2D;
+#ifdef __ANDROID__
+    case kGlTextureExternalOes:
+      *eye_texture_type = GL_TEXTURE_EXTERNAL_OES;
+      return chromatic_aberration
+                 ? kChromaticDistortionFragmentShaderTextureExternalOes
+                 : kDistortionFragmentShaderTextureExternalOes;
+#endif
+    default:
+      CARDBOARD_LOGE(
+          "The Cardboard SDK does not support the selected texture type on "
+          "this platform. Setting GL_TEXTURE_2D as default.");
+
+      *eye_texture_type = GL_TEXTURE_2D;
+      return chromatic_aberration ? kChromaticDistortionFragmentShaderTexture2D
+                                  : kDistortionFragmentShaderTexture2D;
+  }
+}
+
+// Distortion program and the locations of its inputs.
+struct DistortionProgram {
+  GLuint program;
+  GLuint attrib_pos;
+  GLuint attrib_tex;
+  // Only used by the chromatic aberration correction variant.
+  GLuint attrib_tex_red;
+  GLuint attrib_tex_blue;
+  GLuint uniform_start;
+  GLuint uniform_end;
+  GLuint uniform_reprojection;
+};
+
+DistortionProgram CreateDistortionProgram(
+    CardboardSupportedOpenGlEsTextureType texture_type,
+    bool chromatic_aberration, GLenum* eye_texture_type) {
+  DistortionProgram program;
+  program.program = cardboard::rendering::CreateCachedProgram(
+      GetVertexShader(chromatic_aberration),
+      GetFragmentShader(texture_type, chromatic_aberration, eye_texture_type),
+      CreateProgram);
+  program.attrib_pos = glGetAttribLocation(program.program, "a_Position");
+  program.attrib_tex = glGetAttribLocation(program.program, "a_TexCoords");
+  program.attrib_tex_red =
+      glGetAttribLocation(program.program, "a_TexCoordsRed");
+  program.attrib_tex_blue =
+      glGetAttribLocation(program.program, "a_TexCoordsBlue");
+  program.uniform_start = glGetUniformLocation(program.program, "u_Start");
+  program.uniform_end = glGetUniformLocation(program.program, "u_End");
+  program.uniform_reprojection =
+      glGetUniformLocation(program.program, "u_Reprojection");
+  return program;
+}
+
+using DiscardFramebufferFunction = void (*)(GLenum target,
+                                           GLsizei num_attachments,
+                                           const GLenum* attachments);
+
+// Looks up glDiscardFramebufferEXT() for the current context. Returns null when
+// GL_EXT_discard_framebuffer is not supported.
+DiscardFramebufferFunction GetDiscardFramebufferFunction() {
+  const char* extensions =
+      reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+  if (extensions == nullptr ||
+      strstr(extensions, "GL_EXT_discard_framebuffer") == nullptr) {
+    return nullptr;
+  }
+#ifdef __APPLE__
+  return glDiscardFramebufferEXT;
+#else
+  return reinterpret_cast<DiscardFramebufferFunction>(
+      dlsym(RTLD_DEFAULT, "glDiscardFramebufferEXT"));
+#endif
+}
+
 }  // namespace
 
 namespace cardboard::rendering {
@@ -161,48 +328,38 @@ class OpenGlEs2DistortionRenderer : public DistortionRenderer {
       const CardboardOpenGlEsDistortionRendererConfig* config)
       : vertices_vbo_{0, 0},
         uvs_vbo_{0, 0},
+        red_uvs_vbo_{0, 0},
+        blue_uvs_vbo_{0, 0},
         elements_vbo_{0, 0},
         elements_count_{0, 0},
-        eye_texture_type_{GL_TEXTURE_2D} {
-    const char* fragment_shader;
-
-    switch (config->texture_type) {
-      case kGlTexture2D:
-        fragment_shader = kDistortionFragmentShaderTexture2D;
-        eye_texture_type_ = GL_TEXTURE_2D;
-        break;
-#ifdef __ANDROID__
-      case kGlTextureExternalOes:
-        fragment_shader = kDistortionFragmentShaderTextureExternalOes;
-        eye_texture_type_ = GL_TEXTURE_EXTERNAL_OES;
-        break;
-#endif
-      default:
-        CARDBOARD_LOGE(
-            "The Cardboard SDK does not support the selected texture type on "
-            "this platform. Setting GL_TEXTURE_2D as default.");
-
-        fragment_shader = kDistortionFragmentShaderTexture2D;
-        eye_texture_type_ = GL_TEXTURE_2D;
-        break;
-    }
-
-    program_ = CreateProgram(kDistortionVertexShader, fragment_shader);
-    attrib_pos_ = glGetAttribLocation(program_, "a_Position");
-    attrib_tex_ = glGetAttribLocation(program_, "a_TexCoords");
-    uniform_start_ = glGetUniformLocation(program_, "u_Start");
-    uniform_end_ = glGetUniformLocation(program_, "u_End");
+        reprojection_{IdentityReprojection(), IdentityReprojection()},
+        covered_bounds_{},
+        has_chromatic_aberration_{false, false},
+        pass_config_{kColorLoadOpClear, 0, 0},
+        discard_framebuffer_{GetDiscardFramebufferFunction()},
+        texture_type_{config->texture_type},
+        program_{CreateDistortionProgram(texture_type_,
+                                         /*chromatic_aberration=*/false,
+                                         &eye_texture_type_)},
+        chromatic_program_{} {
 
     // Gen buffers, one per eye.
     glGenBuffers(2, &vertices_vbo_[0]);
     glGenBuffers(2, &uvs_vbo_[0]);
+    glGenBuffers(2, &red_uvs_vbo_[0]);
+    glGenBuffers(2, &blue_uvs_vbo_[0]);
     glGenBuffers(2, &elements_vbo_[0]);
     CheckGlError("OpenGlEs2DistortionRendererSetUp");
   }
 
   ~OpenGlEs2DistortionRenderer() {
+    glDeleteProgram(program_.program);
+    // Deleting the program name 0 is silently ignored.
+    glDeleteProgram(chromatic_program_.program);
     glDeleteBuffers(2, &vertices_vbo_[0]);
     glDeleteBuffers(2, &uvs_vbo_[0]);
+    glDeleteBuffers(2, &red_uvs_vbo_[0]);
+    glDeleteBuffers(2, &blue_uvs_vbo_[0]);
     glDeleteBuffers(2, &elements_vbo_[0]);
     CheckGlError("~OpenGlEs2DistortionRenderer");
   }
@@ -212,7 +369,11 @@ class OpenGlEs2DistortionRenderer : public DistortionRenderer {
    *   - glGet(GL_ARRAY_BUFFER_BINDING)
    *   - glGet(GL_ELEMENT_ARRAY_BUFFER_BINDING)
    */
-  void SetMesh(const CardboardMesh* mesh, CardboardEye eye) override {
+  void SetMesh(const CardboardChromaticMesh* chromatic_mesh,
+               CardboardEye eye) override {
+    const CardboardMesh* mesh = &chromatic_mesh->mesh;
+    const float* red_uvs = chromatic_mesh->red_uvs;
+    const float* blue_uvs = chromatic_mesh->blue_uvs;
     glBindBuffer(GL_ARRAY_BUFFER, vertices_vbo_[eye]);
     glBufferData(
         GL_ARRAY_BUFFER,
@@ -222,6 +383,24 @@ class OpenGlEs2DistortionRenderer : public DistortionRenderer {
     glBufferData(GL_ARRAY_BUFFER,
                  mesh->n_vertices * sizeof(float) * 2,  // Two components per uv
                  mesh->uvs, GL_STATIC_DRAW);
+    has_chromatic_aberration_[eye] = red_uvs != nullptr && blue_uvs != nullptr;
+    if (has_chromatic_aberration_[eye]) {
+      glBindBuffer(GL_ARRAY_BUFFER, red_uvs_vbo_[eye]);
+      glBufferData(GL_ARRAY_BUFFER, mesh->n_vertices * sizeof(float) * 2,
+                   red_uvs, GL_STATIC_DRAW);
+      glBindBuffer(GL_ARRAY_BUFFER, blue_uvs_vbo_[eye]);
+      glBufferData(GL_ARRAY_BUFFER, mesh->n_vertices * sizeof(float) * 2,
+                   blue_uvs, GL_STATIC_DRAW);
+      // Only viewers with chromatic aberration correction pay for the
+      // compilation of the variant.
+      if (chromatic_program_.program == 0) {
+        GLenum eye_texture_type;
+        chromatic_program_ =
+            CreateDistortionProgram(texture_type_,
+                                    /*chromatic_aberration=*/true,
+                                    &eye_texture_type);
+      }
+    }
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elements_vbo_[eye]);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh->n_indices * sizeof(int),
                  mesh->indices, GL_STATIC_DRAW);
@@ -229,6 +408,17 @@ class OpenGlEs2DistortionRenderer : public DistortionRenderer {
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     CheckGlError("OpenGlEs2DistortionRenderer::SetMesh");
     elements_count_[eye] = mesh->n_indices;
+    covered_bounds_[eye] = GetMeshCoveredBounds(*mesh);
+  }
+
+  void SetReprojection(const std::array<float, 9>& reprojection,
+                       CardboardEye eye) override {
+    reprojection_[eye] = reprojection;
+  }
+
+  void SetPassConfig(
+      const CardboardDistortionRendererPassConfig& pass_config) override {
+    pass_config_ = pass_config;
   }
 
   /*
@@ -237,6 +427,7 @@ class OpenGlEs2DistortionRenderer : public DistortionRenderer {
    *   - glGet(GL_FRAMEBUFFER_BINDING)
    *   - glIsEnabled(GL_SCISSOR_TEST)
    *   - glIsEnabled(GL_CULL_FACE)
+   *   - glIsEnabled(GL_DEPTH_TEST)
    *   - glGet(GL_CLEAR_COLOR_VALUE)
    *   - glGet(GL_CURRENT_PROGRAM)
    *   - glGet(GL_SCISSOR_BOX)
@@ -259,10 +450,8 @@ class OpenGlEs2DistortionRenderer : public DistortionRenderer {
     glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(target));
     glDisable(GL_SCISSOR_TEST);
     glDisable(GL_CULL_FACE);
-    glClearColor(.0f, .0f, .0f, 1.0f);
-    glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
-
-    glUseProgram(program_);
+    const bool is_default_framebuffer = target == 0;
+    LoadAttachments(is_default_framebuffer, x, y, width, height);
 
     glEnable(GL_SCISSOR_TEST);
     glScissor(x, y, width / 2, height);
@@ -282,10 +471,78 @@ class OpenGlEs2DistortionRenderer : public DistortionRenderer {
 
     // Disable scissor test.
     glDisable(GL_SCISSOR_TEST);
+
+    // The depth and stencil contents are not stored back to memory.
+    if (pass_config_.discard_depth_stencil != 0 &&
+        discard_framebuffer_ != nullptr) {
+      DiscardDepthStencil(is_default_framebuffer);
+    }
     CheckGlError("OpenGlEs2DistortionRenderer::RenderEyeToDisplay");
   }
 
  private:
+  /*
+   * Initializes the attachments of the bound framebuffer according to the pass
+   * configuration. Modifies the OpenGL global state. In particular:
+   *   - glIsEnabled(GL_SCISSOR_TEST)
+   *   - glIsEnabled(GL_DEPTH_TEST)
+   *   - glGet(GL_CLEAR_COLOR_VALUE)
+   *   - glGet(GL_SCISSOR_BOX)
+   */
+  void LoadAttachments(bool is_default_framebuffer, int x, int y, int width,
+                       int height) const {
+    GLbitfield clear_mask = GL_DEPTH_BUFFER_BIT;
+    if (pass_config_.discard_depth_stencil != 0) {
+      // Without GL_EXT_discard_framebuffer, clearing the depth buffer is still
+      // cheaper than loading it. Depth testing against undefined contents
+      // would drop fragments.
+      if (discard_framebuffer_ != nullptr) {
+        DiscardDepthStencil(is_default_framebuffer);
+        clear_mask = 0;
+      }
+      glDisable(GL_DEPTH_TEST);
+    }
+
+    glClearColor(.0f, .0f, .0f, 1.0f);
+    switch (pass_config_.color_load_op) {
+      case kColorLoadOpClearVignette: {
+        // OpenGL ES 2.0 cannot invalidate part of an attachment, so the
+        // covered pixels are simply left untouched.
+        std::array<PixelRect, kMaxVignetteRectCount> vignette_rects;
+        const int vignette_rect_count = GetVignetteRects(
+            covered_bounds_, {x, y, width, height}, &vignette_rects);
+        glEnable(GL_SCISSOR_TEST);
+        for (int i = 0; i < vignette_rect_count; ++i) {
+          glScissor(vignette_rects[i].x, vignette_rects[i].y,
+                    vignette_rects[i].width, vignette_rects[i].height);
+          glClear(GL_COLOR_BUFFER_BIT);
+        }
+        glDisable(GL_SCISSOR_TEST);
+        break;
+      }
+      case kColorLoadOpLoad:
+        break;
+      case kColorLoadOpClear:
+      default:
+        clear_mask |= GL_COLOR_BUFFER_BIT;
+        break;
+    }
+    if (clear_mask != 0) {
+      glClear(clear_mask);
+    }
+  }
+
+  // Tells the driver that the depth and stencil contents of the bound
+  // framebuffer are not needed. Requires GL_EXT_discard_framebuffer.
+  void DiscardDepthStencil(bool is_default_framebuffer) const {
+    const std::array<GLenum, 2> attachments =
+        is_default_framebuffer
+            ? std::array<GLenum, 2>{GL_DEPTH_EXT, GL_STENCIL_EXT}
+            : std::array<GLenum, 2>{GL_DEPTH_ATTACHMENT, GL_STENCIL_ATTACHMENT};
+    discard_framebuffer_(GL_FRAMEBUFFER, attachments.size(),
+                         attachments.data());
+  }
+
   /*
    * Modifies the OpenGL global state. In particular:
    *   - glGet(GL_ARRAY_BUFFER_BINDING)
@@ -301,28 +558,44 @@ class OpenGlEs2DistortionRenderer : public DistortionRenderer {
   void RenderDistortionMesh(
       const CardboardEyeTextureDescription* eye_description,
       CardboardEye eye) const {
+    const DistortionProgram& program =
+        has_chromatic_aberration_[eye] ? chromatic_program_ : program_;
+    glUseProgram(program.program);
+
     glBindBuffer(GL_ARRAY_BUFFER, vertices_vbo_[eye]);
     glVertexAttribPointer(
-        attrib_pos_,
+        program.attrib_pos,
         2,  // 2 components per vertex
         GL_FLOAT, false,
         0,  // Stride and offset 0, as we are using different vbos.
         0);
-    glEnableVertexAttribArray(attrib_pos_);
+    glEnableVertexAttribArray(program.attrib_pos);
 
     glBindBuffer(GL_ARRAY_BUFFER, uvs_vbo_[eye]);
-    glVertexAttribPointer(attrib_tex_,
+    glVertexAttribPointer(program.attrib_tex,
                           2,  // 2 components per uv
                           GL_FLOAT, false, 0, 0);
-    glEnableVertexAttribArray(attrib_tex_);
+    glEnableVertexAttribArray(program.attrib_tex);
+
+    if (has_chromatic_aberration_[eye]) {
+      glBindBuffer(GL_ARRAY_BUFFER, red_uvs_vbo_[eye]);
+      glVertexAttribPointer(program.attrib_tex_red, 2, GL_FLOAT, false, 0, 0);
+      glEnableVertexAttribArray(program.attrib_tex_red);
+      glBindBuffer(GL_ARRAY_BUFFER, blue_uvs_vbo_[eye]);
+      glVertexAttribPointer(program.attrib_tex_blue, 2, GL_FLOAT, false, 0, 0);
+      glEnableVertexAttribArray(program.attrib_tex_blue);
+    }
 
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(eye_texture_type_,
                   static_cast<GLuint>(eye_description->texture));
 
-    glUniform2f(uniform_start_, eye_description->left_u,
+    glUniform2f(program.uniform_start, eye_description->left_u,
                 eye_description->bottom_v);
-    glUniform2f(uniform_end_, eye_description->right_u, eye_description->top_v);
+    glUniform2f(program.uniform_end, eye_description->right_u,
+                eye_description->top_v);
+    glUniformMatrix3fv(program.uniform_reprojection, 1, GL_FALSE,
+                       reprojection_[eye].data());
 
     // Draw with indices
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elements_vbo_[eye]);
@@ -332,16 +605,24 @@ class OpenGlEs2DistortionRenderer : public DistortionRenderer {
 
   std::array<GLuint, 2> vertices_vbo_;  // One per eye.
   std::array<GLuint, 2> uvs_vbo_;
+  // Only filled for meshes with chromatic aberration correction.
+  std::array<GLuint, 2> red_uvs_vbo_;
+  std::array<GLuint, 2> blue_uvs_vbo_;
   std::array<GLuint, 2> elements_vbo_;
   std::array<int, 2> elements_count_;
-
-  GLuint program_;
-  GLuint attrib_pos_;
-  GLuint attrib_tex_;
-  GLuint uniform_start_;
-  GLuint uniform_end_;
+  std::array<std::array<float, 9>, 2> reprojection_;  // Column-major 3x3.
+  // Bounds of the area covered by each mesh. See GetMeshCoveredBounds().
+  std::array<std::array<float, 4>, 2> covered_bounds_;
+  std::array<bool, 2> has_chromatic_aberration_;
+  CardboardDistortionRendererPassConfig pass_config_;
+  // Null when GL_EXT_discard_framebuffer is not supported.
+  DiscardFramebufferFunction discard_framebuffer_;
 
   GLenum eye_texture_type_;
+  CardboardSupportedOpenGlEsTextureType texture_type_;
+  DistortionProgram program_;
+  // Created by the first SetMesh() call with chromatic aberration correction.
+  DistortionProgram chromatic_program_;
 };
 
 }  // namespace cardboard::rendering
@@ -353,8 +634,25 @@ CardboardDistortionRenderer* CardboardOpenGlEs2DistortionRenderer_create(
   if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(config)) {
     return nullptr;
   }
+  CARDBOARD_TRACE_SCOPE("CardboardOpenGlEs2DistortionRenderer_create");
   return reinterpret_cast<CardboardDistortionRenderer*>(
       new cardboard::rendering::OpenGlEs2DistortionRenderer(config));
 }
 
+void CardboardOpenGlEs2DistortionRenderer_prewarm(
+    const CardboardOpenGlEsDistortionRendererConfig* config) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(config)) {
+    return;
+  }
+  CARDBOARD_TRACE_SCOPE("CardboardOpenGlEs2DistortionRenderer_prewarm");
+  GLenum eye_texture_type;
+  for (bool chromatic_aberration : {false, true}) {
+    cardboard::rendering::PrewarmCachedProgram(
+        GetVertexShader(chromatic_aberration),
+        GetFragmentShader(config->texture_type, chromatic_aberration,
+                          &eye_texture_type),
+        CreateProgram);
+  }
+}
+
 }  // extern "C"
@@ -0,0 +1,342 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "rendering/opengl_program_cache.h"
+
+#ifndef __APPLE__
+#include <dlfcn.h>
+#endif
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "include/cardboard.h"
+#include "util/is_arg_null.h"
+#include "util/logging.h"
+#include "util/trace.h"
+
+namespace cardboard::rendering {
+
+namespace {
+
+// Same values for OpenGL ES 3.0 and GL_OES_get_program_binary.
+constexpr GLenum kProgramBinaryLength = 0x8741;
+constexpr GLenum kNumProgramBinaryFormats = 0x87FE;
+
+constexpr uint32_t kProgramBinaryFileMagic = 0x43504231;  // "CPB1"
+
+using GetProgramBinaryFunction = void (*)(GLuint program, GLsizei buffer_size,
+                                          GLsizei* length,
+                                          GLenum* binary_format, void* binary);
+using ProgramBinaryFunction = void (*)(GLuint program, GLenum binary_format,
+                                       const void* binary, GLsizei length);
+
+struct ProgramBinaryFunctions {
+  GetProgramBinaryFunction get_program_binary;
+  ProgramBinaryFunction program_binary;
+};
+
+struct ProgramBinary {
+  GLenum format;
+  std::vector<uint8_t> data;
+};
+
+struct ProgramBinaryFileHeader {
+  uint32_t magic;
+  uint32_t format;
+  uint32_t size;
+};
+
+std::mutex cache_mutex;
+std::string cache_directory;
+std::unordered_map<uint64_t, ProgramBinary> memory_cache;
+
+// Returns whether the space separated @p extensions list contains
+// @p extension. A substring match is not enough: an extension name may prefix
+// another one.
+bool HasExtension(const char* extensions, const char* extension) {
+  if (extensions == nullptr) {
+    return false;
+  }
+  const size_t length = strlen(extension);
+  for (const char* name = strstr(extensions, extension); name != nullptr;
+       name = strstr(name + length, extension)) {
+    const bool starts_token = name == extensions || name[-1] == ' ';
+    const bool ends_token = name[length] == ' ' || name[length] == '\0';
+    if (starts_token && ends_token) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns the major version of the current OpenGL ES context, or 0 if it is
+// not an OpenGL ES context. The version string is "OpenGL ES N.M <vendor>".
+int GetOpenGlEsMajorVersion() {
+  const char* version =
+      reinterpret_cast<const char*>(glGetString(GL_VERSION));
+  int major = 0;
+  if (version == nullptr || sscanf(version, "OpenGL ES %d.", &major) != 1) {
+    return 0;
+  }
+  return major;
+}
+
+// Looks up the program binary entry points for the current context. They are
+// core in OpenGL ES 3.0 and exposed by GL_OES_get_program_binary on OpenGL ES
+// 2.0. Support is decided from the version and extension strings before any
+// program binary enum is queried, so that no GL error is raised on contexts
+// without it. The entry points are resolved at runtime so that OpenGL ES 2.0
+// only builds do not need to link libGLESv3.
+ProgramBinaryFunctions GetProgramBinaryFunctions() {
+  ProgramBinaryFunctions functions = {nullptr, nullptr};
+#ifndef __APPLE__
+  if (GetOpenGlEsMajorVersion() >= 3) {
+    functions.get_program_binary = reinterpret_cast<GetProgramBinaryFunction>(
+        dlsym(RTLD_DEFAULT, "glGetProgramBinary"));
+    functions.program_binary = reinterpret_cast<ProgramBinaryFunction>(
+        dlsym(RTLD_DEFAULT, "glProgramBinary"));
+  } else if (HasExtension(
+                 reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS)),
+                 "GL_OES_get_program_binary")) {
+    functions.get_program_binary = reinterpret_cast<GetProgramBinaryFunction>(
+        dlsym(RTLD_DEFAULT, "glGetProgramBinaryOES"));
+    functions.program_binary = reinterpret_cast<ProgramBinaryFunction>(
+        dlsym(RTLD_DEFAULT, "glProgramBinaryOES"));
+  }
+  if (functions.get_program_binary == nullptr ||
+      functions.program_binary == nullptr) {
+    return {nullptr, nullptr};
+  }
+
+  // Supporting program binaries does not mean supporting any format: drivers
+  // may report none, in which case glGetProgramBinary() always fails.
+  GLint format_count = 0;
+  glGetIntegerv(kNumProgramBinaryFormats, &format_count);
+  if (format_count <= 0) {
+    functions = {nullptr, nullptr};
+  }
+#endif
+  return functions;
+}
+
+// 64-bit FNV-1a.
+uint64_t HashString(const char* string, uint64_t hash) {
+  constexpr uint64_t kFnvPrime = 0x100000001b3;
+  for (const char* c = string; *c != '\0'; ++c) {
+    hash = (hash ^ static_cast<uint8_t>(*c)) * kFnvPrime;
+  }
+  // Hashes the terminator so that consecutive strings cannot be confused.
+  return hash * kFnvPrime;
+}
+
+// Returns the cache key of a program: binaries are only valid for the driver
+// that produced them.
+uint64_t GetProgramKey(const char* vertex, const char* fragment) {
+  uint64_t hash = 0xcbf29ce484222325;
+  for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+    const char* value = reinterpret_cast<const char*>(glGetString(name));
+    hash = HashString(value != nullptr ? value : "", hash);
+  }
+  hash = HashString(vertex, hash);
+  return HashString(fragment, hash);
+}
+
+std::string GetProgramBinaryPath(const std::string& directory, uint64_t key) {
+  char file_name[64];
+  snprintf(file_name, sizeof(file_name), "/cardboard_program_%016llx.bin",
+           static_cast<unsigned long long>(key));
+  return directory + file_name;
+}
+
+bool ReadProgramBinary(const std::string& path, ProgramBinary* binary) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  ProgramBinaryFileHeader header;
+  bool success = fread(&header, sizeof(header), 1, file) == 1 &&
+                 header.magic == kProgramBinaryFileMagic && header.size > 0;
+  if (success) {
+    binary->format = header.format;
+    binary->data.resize(header.size);
+    success =
+        fread(binary->data.data(), 1, header.size, file) == header.size;
+  }
+  fclose(file);
+  return success;
+}
+
+// Writes to a temporary file first so that a concurrent reader or a crash
+// never leaves a truncated binary behind.
+void WriteProgramBinary(const std::string& path, const ProgramBinary& binary) {
+  const std::string temporary_path = path + ".tmp";
+  FILE* file = fopen(temporary_path.c_str(), "wb");
+  if (file == nullptr) {
+    CARDBOARD_LOGE("Cannot open program binary file %s.",
+                   temporary_path.c_str());
+    return;
+  }
+  const ProgramBinaryFileHeader header = {
+      kProgramBinaryFileMagic, static_cast<uint32_t>(binary.format),
+      static_cast<uint32_t>(binary.data.size())};
+  bool success =
+      fwrite(&header, sizeof(header), 1, file) == 1 &&
+      fwrite(binary.data.data(), 1, binary.data.size(), file) ==
+          binary.data.size();
+  success = fclose(file) == 0 && success;
+  if (!success || rename(temporary_path.c_str(), path.c_str()) != 0) {
+    CARDBOARD_LOGE("Cannot write program binary file %s.", path.c_str());
+    remove(temporary_path.c_str());
+  }
+}
+
+// Returns whether the memory cache holds the binary of a program.
+bool HasProgramBinaryInMemory(uint64_t key) {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  return memory_cache.find(key) != memory_cache.end();
+}
+
+// Returns the cached binary of a program, loading it from disk if needed.
+bool FindProgramBinary(uint64_t key, ProgramBinary* binary) {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  auto it = memory_cache.find(key);
+  if (it != memory_cache.end()) {
+    *binary = it->second;
+    return true;
+  }
+  if (cache_directory.empty() ||
+      !ReadProgramBinary(GetProgramBinaryPath(cache_directory, key), binary)) {
+    return false;
+  }
+  memory_cache[key] = *binary;
+  return true;
+}
+
+void StoreProgramBinary(uint64_t key, const ProgramBinary& binary) {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  memory_cache[key] = binary;
+  if (!cache_directory.empty()) {
+    WriteProgramBinary(GetProgramBinaryPath(cache_directory, key), binary);
+  }
+}
+
+void EraseProgramBinary(uint64_t key) {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  memory_cache.erase(key);
+  if (!cache_directory.empty()) {
+    remove(GetProgramBinaryPath(cache_directory, key).c_str());
+  }
+}
+
+GLuint LoadProgramBinary(const ProgramBinaryFunctions& functions,
+                         const ProgramBinary& binary) {
+  GLuint program = glCreateProgram();
+  functions.program_binary(program, binary.format, binary.data.data(),
+                           static_cast<GLsizei>(binary.data.size()));
+  GLint result = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &result);
+  if (result == GL_FALSE) {
+    // Binaries are rejected after a driver update. Not an error: the program
+    // is compiled again.
+    glDeleteProgram(program);
+    glGetError();
+    return 0;
+  }
+  return program;
+}
+
+bool GetProgramBinary(const ProgramBinaryFunctions& functions, GLuint program,
+                      ProgramBinary* binary) {
+  GLint length = 0;
+  glGetProgramiv(program, kProgramBinaryLength, &length);
+  if (length <= 0) {
+    return false;
+  }
+  binary->data.resize(length);
+  GLsizei written = 0;
+  functions.get_program_binary(program, length, &written, &binary->format,
+                               binary->data.data());
+  if (glGetError() != GL_NO_ERROR || written <= 0) {
+    return false;
+  }
+  binary->data.resize(written);
+  return true;
+}
+
+}  // anonymous namespace
+
+void SetProgramCacheDirectory(const std::string& directory) {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  cache_directory = directory;
+  while (cache_directory.size() > 1 && cache_directory.back() == '/') {
+    cache_directory.pop_back();
+  }
+}
+
+GLuint CreateCachedProgram(const char* vertex, const char* fragment,
+                           CompileProgramFunction compile) {
+  CARDBOARD_TRACE_SCOPE("CreateCachedProgram");
+  const ProgramBinaryFunctions functions = GetProgramBinaryFunctions();
+  if (functions.program_binary == nullptr) {
+    return compile(vertex, fragment);
+  }
+
+  const uint64_t key = GetProgramKey(vertex, fragment);
+  ProgramBinary binary;
+  if (FindProgramBinary(key, &binary)) {
+    const GLuint program = LoadProgramBinary(functions, binary);
+    if (program != 0) {
+      return program;
+    }
+    CARDBOARD_LOGI("Cached program binary was rejected. Compiling it again.");
+    EraseProgramBinary(key);
+  }
+
+  const GLuint program = compile(vertex, fragment);
+  if (program != 0 && GetProgramBinary(functions, program, &binary)) {
+    StoreProgramBinary(key, binary);
+  }
+  return program;
+}
+
+void PrewarmCachedProgram(const char* vertex, const char* fragment,
+                          CompileProgramFunction compile) {
+  CARDBOARD_TRACE_SCOPE("PrewarmCachedProgram");
+  if (GetProgramBinaryFunctions().program_binary == nullptr ||
+      HasProgramBinaryInMemory(GetProgramKey(vertex, fragment))) {
+    return;
+  }
+  // Also validates a binary found on disk, which avoids a rejection later.
+  glDeleteProgram(CreateCachedProgram(vertex, fragment, compile));
+}
+
+}  // namespace cardboard::rendering
+
+extern "C" {
+
+void CardboardOpenGlEsDistortionRenderer_setProgramCacheDirectory(
+    const char* directory) {
+  if (CARDBOARD_IS_ARG_NULL(directory)) {
+    return;
+  }
+  cardboard::rendering::SetProgramCacheDirectory(directory);
+}
+
+}  // extern "C"
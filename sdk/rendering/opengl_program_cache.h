@@ -0,0 +1,60 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_RENDERING_OPENGL_PROGRAM_CACHE_H_
+#define CARDBOARD_SDK_RENDERING_OPENGL_PROGRAM_CACHE_H_
+
+#include <string>
+
+#ifdef __APPLE__
+#include <OpenGLES/ES2/gl.h>
+#else
+#include <GLES2/gl2.h>
+#endif
+
+namespace cardboard::rendering {
+
+// Compiles and links a program from its vertex and fragment shader sources.
+// Returns 0 on failure.
+using CompileProgramFunction = GLuint (*)(const char* vertex,
+                                          const char* fragment);
+
+// Sets the directory where program binaries are stored across launches. An
+// empty directory keeps them in memory only, which is the default.
+void SetProgramCacheDirectory(const std::string& directory);
+
+// Creates a program from its shader sources on the current context.
+//
+// Linked programs are retrieved with glGetProgramBinary() and kept in a
+// process wide cache keyed by the GL vendor, renderer and version strings and
+// by a hash of the sources. Later calls restore the program with
+// glProgramBinary() instead of compiling it. Program binaries are not tied to
+// a context, so a program created once, e.g. on a shared context at startup,
+// speeds up the creation on any other context of the same driver. When
+// program binaries are not supported or the cached binary is rejected, the
+// program is built with @p compile.
+GLuint CreateCachedProgram(const char* vertex, const char* fragment,
+                           CompileProgramFunction compile);
+
+// Makes a later CreateCachedProgram() call with the same sources restore the
+// program from its binary, on any context of the current driver. It does
+// nothing when the binary is already in memory or when program binaries are
+// not supported, given that the program could not be kept anyway.
+void PrewarmCachedProgram(const char* vertex, const char* fragment,
+                          CompileProgramFunction compile);
+
+}  // namespace cardboard::rendering
+
+#endif  // CARDBOARD_SDK_RENDERING_OPENGL_PROGRAM_CACHE_H_
@@ -18,6 +18,8 @@
 #include <jni.h>
 
 #include "jni_utils/android/jni_utils.h"
+#include "util/logging.h"
+#include "util/trace.h"
 
 namespace cardboard::screen_params {
 
@@ -25,48 +27,66 @@ namespace {
 JavaVM* vm_;
 jobject context_;
 
+// Android's DisplayMetrics.DENSITY_DEFAULT, used when the screen density
+// cannot be retrieved.
+constexpr float kDefaultDpi = 160.0f;
+
+jclass screen_params_utils_class_ = nullptr;
 jclass screen_pixel_density_class_;
-jclass screen_params_utils_class_;
+jmethodID get_screen_pixel_density_method_;
+jfieldID xdpi_field_;
+jfieldID ydpi_field_;
 
 struct DisplayMetrics {
   float xdpi;
   float ydpi;
 };
 
-// TODO(b/180938531): Release these global references.
+// Classes, methods and fields are resolved once and pinned for the lifetime of
+// the process.
 void LoadJNIResources(JNIEnv* env) {
-  screen_params_utils_class_ =
-      reinterpret_cast<jclass>(env->NewGlobalRef(cardboard::jni::LoadJClass(
-          env, "com/google/cardboard/sdk/screenparams/ScreenParamsUtils")));
-  screen_pixel_density_class_ = reinterpret_cast<jclass>(env->NewGlobalRef(
+  if (screen_params_utils_class_ != nullptr) {
+    return;
+  }
+  screen_params_utils_class_ = cardboard::jni::LoadJClass(
+      env, "com/google/cardboard/sdk/screenparams/ScreenParamsUtils");
+  get_screen_pixel_density_method_ = cardboard::jni::LoadJStaticMethodID(
+      env, screen_params_utils_class_, "getScreenPixelDensity",
+      "(Landroid/content/Context;)Lcom/google/cardboard/sdk/screenparams/"
+      "ScreenParamsUtils$ScreenPixelDensity;");
+
+  screen_pixel_density_class_ =
       cardboard::jni::LoadJClass(env,
                                  "com/google/cardboard/sdk/screenparams/"
-                                 "ScreenParamsUtils$ScreenPixelDensity")));
+                                 "ScreenParamsUtils$ScreenPixelDensity");
+  xdpi_field_ = cardboard::jni::LoadJFieldID(env, screen_pixel_density_class_,
+                                             "xdpi", "F");
+  ydpi_field_ = cardboard::jni::LoadJFieldID(env, screen_pixel_density_class_,
+                                             "ydpi", "F");
 }
 
 DisplayMetrics getDisplayMetrics() {
   JNIEnv* env;
   cardboard::jni::LoadJNIEnv(vm_, &env);
 
-  const jmethodID get_screen_pixel_density_method = env->GetStaticMethodID(
-      screen_params_utils_class_, "getScreenPixelDensity",
-      "(Landroid/content/Context;)Lcom/google/cardboard/sdk/screenparams/"
-      "ScreenParamsUtils$ScreenPixelDensity;");
-  const jobject screen_pixel_density = env->CallStaticObjectMethod(
-      screen_params_utils_class_, get_screen_pixel_density_method, context_);
-  const jfieldID xdpi_id =
-      env->GetFieldID(screen_pixel_density_class_, "xdpi", "F");
-  const jfieldID ydpi_id =
-      env->GetFieldID(screen_pixel_density_class_, "ydpi", "F");
-
-  const float xdpi = env->GetFloatField(screen_pixel_density, xdpi_id);
-  const float ydpi = env->GetFloatField(screen_pixel_density, ydpi_id);
+  const jobject screen_pixel_density = cardboard::jni::CallStaticObjectMethod(
+      env, screen_params_utils_class_, get_screen_pixel_density_method_,
+      context_);
+  if (screen_pixel_density == nullptr) {
+    CARDBOARD_LOGE("Cannot retrieve the screen pixel density.");
+    return {kDefaultDpi, kDefaultDpi};
+  }
+
+  const float xdpi = env->GetFloatField(screen_pixel_density, xdpi_field_);
+  const float ydpi = env->GetFloatField(screen_pixel_density, ydpi_field_);
+  env->DeleteLocalRef(screen_pixel_density);
   return {xdpi, ydpi};
 }
 
 }  // anonymous namespace
 
 void initializeAndroid(JavaVM* vm, jobject context) {
+  CARDBOARD_TRACE_SCOPE("screen_params::initializeAndroid");
   vm_ = vm;
   context_ = context;
 
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sensors/calibration_storage.h"
+
+#include <android/sensor.h>
+#include <jni.h>
+#include <sys/stat.h>
+
+#include <cstdint>
+#include <cstdio>
+
+#include "jni_utils/android/jni_utils.h"
+#include "util/logging.h"
+#include "util/trace.h"
+
+namespace cardboard::sensors {
+
+namespace {
+
+// Not defined in the native public sensors API. See
+// device_gyroscope_sensor.cc.
+constexpr int kSensorTypeGyroscopeUncalibrated = 16;
+
+// Folder shared with the saved device parameters.
+constexpr const char* kCalibrationFolder = "/Cardboard";
+constexpr const char* kCalibrationFile = "/head_tracker_calibration";
+
+constexpr uint32_t kCalibrationFileMagic = 0x43484331;  // "CHC1"
+
+std::string calibration_folder_;
+
+// Returns the absolute path of Context.getFilesDir().
+std::string GetFilesDir(JNIEnv* env, jobject context) {
+  const jclass context_class =
+      cardboard::jni::LoadJClass(env, "android/content/Context");
+  const jmethodID get_files_dir_method = cardboard::jni::LoadJMethodID(
+      env, context_class, "getFilesDir", "()Ljava/io/File;");
+  const jclass file_class = cardboard::jni::LoadJClass(env, "java/io/File");
+  const jmethodID get_absolute_path_method = cardboard::jni::LoadJMethodID(
+      env, file_class, "getAbsolutePath", "()Ljava/lang/String;");
+
+  std::string files_dir;
+  const jobject files_dir_file =
+      cardboard::jni::CallObjectMethod(env, context, get_files_dir_method);
+  if (files_dir_file != nullptr) {
+    const auto path = static_cast<jstring>(cardboard::jni::CallObjectMethod(
+        env, files_dir_file, get_absolute_path_method));
+    if (path != nullptr) {
+      const char* chars = env->GetStringUTFChars(path, nullptr);
+      files_dir = chars;
+      env->ReleaseStringUTFChars(path, chars);
+      env->DeleteLocalRef(path);
+    }
+    env->DeleteLocalRef(files_dir_file);
+  }
+  env->DeleteGlobalRef(file_class);
+  env->DeleteGlobalRef(context_class);
+  return files_dir;
+}
+
+std::string GetCalibrationPath() {
+  return calibration_folder_ + kCalibrationFile;
+}
+
+}  // anonymous namespace
+
+void initializeAndroid(JavaVM* vm, jobject context) {
+  CARDBOARD_TRACE_SCOPE("sensors::initializeAndroid");
+  JNIEnv* env;
+  cardboard::jni::LoadJNIEnv(vm, &env);
+  const std::string files_dir = GetFilesDir(env, context);
+  if (files_dir.empty()) {
+    CARDBOARD_LOGE("Cannot retrieve the files directory.");
+    return;
+  }
+  calibration_folder_ = files_dir + kCalibrationFolder;
+}
+
+std::string getMotionSensorId() {
+  ASensorManager* sensor_manager = ASensorManager_getInstance();
+  const ASensor* gyroscope = ASensorManager_getDefaultSensor(
+      sensor_manager, kSensorTypeGyroscopeUncalibrated);
+  if (gyroscope == nullptr) {
+    gyroscope =
+        ASensorManager_getDefaultSensor(sensor_manager, ASENSOR_TYPE_GYROSCOPE);
+  }
+  if (gyroscope == nullptr) {
+    return "";
+  }
+  return std::string(ASensor_getVendor(gyroscope)) + " " +
+         ASensor_getName(gyroscope);
+}
+
+bool readCalibration(CardboardHeadTrackerCalibration* calibration) {
+  if (calibration_folder_.empty()) {
+    return false;
+  }
+  FILE* file = fopen(GetCalibrationPath().c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  uint32_t magic = 0;
+  const bool success = fread(&magic, sizeof(magic), 1, file) == 1 &&
+                       magic == kCalibrationFileMagic &&
+                       fread(calibration, sizeof(*calibration), 1, file) == 1;
+  fclose(file);
+  return success;
+}
+
+void writeCalibration(const CardboardHeadTrackerCalibration& calibration) {
+  if (calibration_folder_.empty()) {
+    return;
+  }
+  mkdir(calibration_folder_.c_str(), 0700);
+
+  // Writes to a temporary file first so that an interrupted write never
+  // leaves a truncated calibration behind.
+  const std::string path = GetCalibrationPath();
+  const std::string temporary_path = path + ".tmp";
+  FILE* file = fopen(temporary_path.c_str(), "wb");
+  if (file == nullptr) {
+    CARDBOARD_LOGE("Cannot open head tracker calibration file.");
+    return;
+  }
+  bool success =
+      fwrite(&kCalibrationFileMagic, sizeof(kCalibrationFileMagic), 1,
+             file) == 1 &&
+      fwrite(&calibration, sizeof(calibration), 1, file) == 1;
+  success = fclose(file) == 0 && success;
+  if (!success || rename(temporary_path.c_str(), path.c_str()) != 0) {
+    CARDBOARD_LOGE("Cannot write head tracker calibration file.");
+    remove(temporary_path.c_str());
+  }
+}
+
+}  // namespace cardboard::sensors
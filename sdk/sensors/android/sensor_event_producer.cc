@@ -16,6 +16,7 @@
 #include "sensors/sensor_event_producer.h"
 
 #include <atomic>
+#include <condition_variable>  // NOLINT
 #include <memory>
 #include <mutex>   // NOLINT
 #include <thread>  // NOLINT
@@ -30,13 +31,44 @@ namespace cardboard {
 
 template <typename DataType>
 struct SensorEventProducer<DataType>::EventProducer {
-  EventProducer() : run_thread(false) {}
+  EventProducer() : run_thread(false), is_paused(false) {}
+
+  // Parks the calling capture thread with @p sensor disabled while polling is
+  // paused. Events queued before the sensor was disabled are dropped.
+  //
+  // @return false if polling was stopped while parked.
+  template <typename DeviceSensor>
+  bool ParkWhilePaused(DeviceSensor* sensor, std::vector<DataType>* events) {
+    std::unique_lock<std::mutex> lock(pause_mutex);
+    if (!is_paused) {
+      return true;
+    }
+    sensor->Stop();
+    sensor->PollForSensorData(0, events);
+    pause_condition.wait(lock, [this] { return !is_paused || !run_thread; });
+    return run_thread && sensor->Start();
+  }
+
+  // Wakes up the capture thread if it is parked.
+  void WakeUp() {
+    { std::lock_guard<std::mutex> lock(pause_mutex); }
+    pause_condition.notify_all();
+  }
+
   // Capture thread. This will be created when polling is started, and
   // destroyed when polling is stopped.
   std::unique_ptr<std::thread> thread;
   std::mutex mutex;
   // Flag indicating if the capture thread should run.
   std::atomic<bool> run_thread;
+
+  // Guards is_paused. It is distinct from mutex, which is held while joining
+  // the capture thread.
+  std::mutex pause_mutex;
+  std::condition_variable pause_condition;
+  // Flag indicating if the capture thread should park with its sensor
+  // disabled.
+  bool is_paused;
 };
 
 template <typename DataType>
@@ -52,6 +84,11 @@ template <typename DataType>
 void SensorEventProducer<DataType>::StartSensorPolling(
     const std::function<void(DataType)>* on_event_callback) {
   on_event_callback_ = on_event_callback;
+  {
+    std::lock_guard<std::mutex> lock(event_producer_->pause_mutex);
+    event_producer_->is_paused = false;
+  }
+  event_producer_->pause_condition.notify_all();
   std::unique_lock<std::mutex> lock(event_producer_->mutex);
   StartSensorPollingLocked();
 }
@@ -63,6 +100,12 @@ void SensorEventProducer<DataType>::StopSensorPolling() {
   on_event_callback_ = nullptr;
 }
 
+template <typename DataType>
+void SensorEventProducer<DataType>::PauseSensorPolling() {
+  std::lock_guard<std::mutex> lock(event_producer_->pause_mutex);
+  event_producer_->is_paused = true;
+}
+
 template <typename DataType>
 void SensorEventProducer<DataType>::StartSensorPollingLocked() {
   // If the thread is started already there is nothing left to do.
@@ -79,6 +122,7 @@ void SensorEventProducer<DataType>::StopSensorPollingLocked() {
   if (!event_producer_->run_thread.exchange(false)) {
     return;
   }
+  event_producer_->WakeUp();
 
   if (!event_producer_->thread || !event_producer_->thread->joinable()) {
     return;
@@ -101,6 +145,9 @@ void SensorEventProducer<AccelerometerData>::WorkFn() {
   // TODO(b/135468657): Investigate clock conversion. Old cardboard doesn't have
   // this.
   while (event_producer_->run_thread) {
+    if (!event_producer_->ParkWhilePaused(&sensor, &sensor_events_vec)) {
+      break;
+    }
     sensor.PollForSensorData(kMaxWaitMilliseconds, &sensor_events_vec);
     for (AccelerometerData& event : sensor_events_vec) {
       event.system_timestamp = event.sensor_timestamp_ns;
@@ -126,6 +173,9 @@ void SensorEventProducer<GyroscopeData>::WorkFn() {
   // TODO(b/135468657): Investigate clock conversion. Old cardboard doesn't have
   // this.
   while (event_producer_->run_thread) {
+    if (!event_producer_->ParkWhilePaused(&sensor, &sensor_events_vec)) {
+      break;
+    }
     sensor.PollForSensorData(kMaxWaitMilliseconds, &sensor_events_vec);
     for (GyroscopeData& event : sensor_events_vec) {
       event.system_timestamp = event.sensor_timestamp_ns;
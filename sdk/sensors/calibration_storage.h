@@ -0,0 +1,46 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_SENSORS_CALIBRATION_STORAGE_H_
+#define CARDBOARD_SDK_SENSORS_CALIBRATION_STORAGE_H_
+
+#ifdef __ANDROID__
+#include <jni.h>
+#endif
+
+#include <string>
+
+#include "include/cardboard.h"
+
+namespace cardboard::sensors {
+#ifdef __ANDROID__
+void initializeAndroid(JavaVM* vm, jobject context);
+#endif
+
+// Returns an identifier of the device motion sensors. Calibrations are only
+// applied to the sensors they were estimated with.
+std::string getMotionSensorId();
+
+// Reads the calibration saved by writeCalibration().
+//
+// @param calibration Output calibration.
+// @return false if no calibration was saved or it cannot be read.
+bool readCalibration(CardboardHeadTrackerCalibration* calibration);
+
+// Saves @p calibration for later sessions, replacing the previous one.
+void writeCalibration(const CardboardHeadTrackerCalibration& calibration);
+}  // namespace cardboard::sensors
+
+#endif  // CARDBOARD_SDK_SENSORS_CALIBRATION_STORAGE_H_
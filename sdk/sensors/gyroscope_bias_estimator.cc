@@ -131,6 +131,11 @@ void GyroscopeBiasEstimator::Reset() {
   gyroscope_static_counter_->Reset();
 }
 
+void GyroscopeBiasEstimator::Reset(const Vector3& gyroscope_bias) {
+  Reset();
+  gyroscope_bias_lowpass_filter_.Reset(gyroscope_bias);
+}
+
 void GyroscopeBiasEstimator::ProcessGyroscope(const Vector3& gyroscope_sample,
                                               uint64_t timestamp_ns) {
   // Update gyroscope and gyroscope delta low-pass filters.
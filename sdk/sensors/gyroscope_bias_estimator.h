@@ -89,6 +89,12 @@ class GyroscopeBiasEstimator {
   // Resets the estimator state.
   void Reset();
 
+  // Resets the estimator state and seeds the bias estimate with
+  // @p gyroscope_bias, e.g. estimated in a previous session. The seed is
+  // returned by GetGyroscopeBias until it gets refined while the device is
+  // static.
+  void Reset(const Vector3& gyroscope_bias);
+
   // Returns true if the current estimate returned by GetGyroscopeBias is
   // correct. The device (measured using the sensors) has to be static for this
   // function to return true.
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#import "sensors/calibration_storage.h"
+
+#import <Foundation/Foundation.h>
+
+#import <sys/sysctl.h>
+#import <vector>
+
+namespace cardboard::sensors {
+
+namespace {
+
+NSString* const kCalibrationKey = @"com.google.cardboard.sdk.HeadTrackerCalibration";
+
+}  // anonymous namespace
+
+std::string getMotionSensorId() {
+  // Core Motion does not expose the sensors, so they are identified by the
+  // hardware model, e.g. "iPhone12,1".
+  size_t size = 0;
+  if (sysctlbyname("hw.machine", nullptr, &size, nullptr, 0) != 0 || size == 0) {
+    return "";
+  }
+  std::vector<char> machine(size);
+  if (sysctlbyname("hw.machine", machine.data(), &size, nullptr, 0) != 0) {
+    return "";
+  }
+  return std::string(machine.data());
+}
+
+bool readCalibration(CardboardHeadTrackerCalibration* calibration) {
+  NSData* data = [[NSUserDefaults standardUserDefaults] dataForKey:kCalibrationKey];
+  if (data == nil || data.length != sizeof(*calibration)) {
+    return false;
+  }
+  [data getBytes:calibration length:sizeof(*calibration)];
+  return true;
+}
+
+void writeCalibration(const CardboardHeadTrackerCalibration& calibration) {
+  NSData* data = [NSData dataWithBytes:&calibration length:sizeof(calibration)];
+  [[NSUserDefaults standardUserDefaults] setObject:data forKey:kCalibrationKey];
+}
+
+}  // namespace cardboard::sensors
@@ -135,6 +135,13 @@ void SensorEventProducer<GyroscopeData>::StopSensorPolling() {
                                           callback:event_producer_->workfn_block];
 }
 
+template <typename DataType>
+void SensorEventProducer<DataType>::PauseSensorPolling() {
+  // Sensor updates are delivered on the shared sensor helper thread, so there
+  // is no capture thread to park.
+  StopSensorPolling();
+}
+
 template <typename DataType>
 void SensorEventProducer<DataType>::WorkFn() {
   event_producer_->sensor.value->PollForSensorData(kMaxWaitMilliseconds,
@@ -80,4 +80,12 @@ void LowpassFilter::Reset() {
   filtered_data_ = {0, 0, 0};
 }
 
+void LowpassFilter::Reset(const Vector3& filtered_data) {
+  initialized_ = true;
+  // Sensor timestamps are far from zero, so the time step to the next sample
+  // is always out of range.
+  timestamp_most_recent_update_ns_ = 0;
+  filtered_data_ = filtered_data;
+}
+
 }  // namespace cardboard
@@ -65,6 +65,10 @@ class LowpassFilter {
   // Resets filter state.
   void Reset();
 
+  // Resets the filter state to @p filtered_data, e.g. a value estimated in a
+  // previous session. The next sample only sets the most recent timestamp.
+  void Reset(const Vector3& filtered_data);
+
  private:
   const double cutoff_time_constant_;
   uint64_t timestamp_most_recent_update_ns_;
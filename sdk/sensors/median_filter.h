@@ -16,6 +16,7 @@
 #ifndef CARDBOARD_SDK_SENSORS_MEDIAN_FILTER_H_
 #define CARDBOARD_SDK_SENSORS_MEDIAN_FILTER_H_
 
+#include <cstddef>
 #include <deque>
 
 #include "util/vector.h"
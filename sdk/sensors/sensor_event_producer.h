@@ -47,6 +47,12 @@ class SensorEventProducer {
   // running. This method blocks until the sensor capture thread is finished.
   void StopSensorPolling();
 
+  // Disables the sensor while keeping its capture thread and event queue
+  // alive, so that the next StartSensorPolling() call only re-enables it.
+  // Events may still be delivered for a short while after this call. This
+  // method does not block.
+  void PauseSensorPolling();
+
  private:
   // Internal function to start sensor polling with the assumption that the lock
   // has already been obtained. Not implemented for iOS.
@@ -20,8 +20,11 @@
 
 #include "sensors/accelerometer_data.h"
 #include "sensors/gyroscope_data.h"
+#include "util/clock.h"
 #include "util/logging.h"
 #include "util/matrixutils.h"
+#include "util/stats.h"
+#include "util/trace.h"
 
 namespace cardboard {
 
@@ -94,6 +97,32 @@ Rotation GetRotationFromGyroscope(const Vector3& gyroscope_value,
                                     -timestep_s * velocity);
 }
 
+// Locks @p mutex, recording the time spent waiting for it when statistics are
+// enabled. Uncontended locks are recorded as a zero wait without reading the
+// clock.
+std::unique_lock<std::mutex> AcquireLock(std::mutex& mutex) {
+  if (!util::Stats::IsEnabled()) {
+    return std::unique_lock<std::mutex>(mutex);
+  }
+  std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+  if (lock.owns_lock()) {
+    util::GetStats().sensor_fusion_lock_wait.Record(0);
+    return lock;
+  }
+  const int64_t start_ns = GetBootTimeNano();
+  lock.lock();
+  util::GetStats().sensor_fusion_lock_wait.Record(GetBootTimeNano() - start_ns);
+  return lock;
+}
+
+// Counts a sensor sample discarded by the sensor fusion.
+void RecordDroppedSample() {
+  if (util::Stats::IsEnabled()) {
+    util::GetStats().dropped_sample_count.fetch_add(1,
+                                                    std::memory_order_relaxed);
+  }
+}
+
 // Returns the difference of @p timestamp_ns_a and @p timestamp_ns_b in
 // nanoseconds, and returns a floating point result in seconds.
 constexpr double ComputeTimeDifferenceInSeconds(int64_t timestamp_ns_a,
@@ -105,7 +134,9 @@ constexpr double ComputeTimeDifferenceInSeconds(int64_t timestamp_ns_a,
 
 SensorFusionEkf::SensorFusionEkf()
     : execute_reset_with_next_accelerometer_sample_(false),
-      gyroscope_bias_estimate_({0, 0, 0}) {
+      gyroscope_bias_estimate_({0, 0, 0}),
+      calibration_{Vector3::Zero(), kDefaultGyroscopeTimestep_s},
+      has_calibration_(false) {
   ResetState();
 }
 
@@ -148,18 +179,52 @@ void SensorFusionEkf::ResetState() {
   // Reset biases.
   gyroscope_bias_estimator_.Reset();
   gyroscope_bias_estimate_ = {0, 0, 0};
+
+  // The calibration does not depend on the rotation, so it is kept.
+  if (has_calibration_) {
+    ApplyCalibration();
+  }
+}
+
+void SensorFusionEkf::ApplyCalibration() {
+  gyroscope_bias_estimator_.Reset(calibration_.gyroscope_bias);
+  gyroscope_bias_estimate_ = calibration_.gyroscope_bias;
+
+  filtered_gyroscope_timestep_s_ = calibration_.gyroscope_timestep_s;
+  num_gyroscope_timestep_samples_ = kTimestepFilterMinSamples + 1;
+  is_timestep_filter_initialized_ = true;
+  is_gyroscope_filter_valid_ = true;
+}
+
+bool SensorFusionEkf::GetCalibration(Calibration* calibration) const {
+  std::unique_lock<std::mutex> lock = AcquireLock(mutex_);
+  if (!has_calibration_) {
+    return false;
+  }
+  calibration->gyroscope_bias = calibration_.gyroscope_bias;
+  calibration->gyroscope_timestep_s = is_gyroscope_filter_valid_
+                                          ? filtered_gyroscope_timestep_s_
+                                          : calibration_.gyroscope_timestep_s;
+  return true;
+}
+
+void SensorFusionEkf::SetCalibration(const Calibration& calibration) {
+  std::unique_lock<std::mutex> lock = AcquireLock(mutex_);
+  calibration_ = calibration;
+  has_calibration_ = true;
+  ApplyCalibration();
 }
 
 // Here I am doing something wrong relative to time stamps. The state timestamps
 // always correspond to the gyrostamps because it would require additional
 // extrapolation if I wanted to do otherwise.
 RotationState SensorFusionEkf::GetLatestRotationState() const {
-  std::unique_lock<std::mutex> lock(mutex_);
+  std::unique_lock<std::mutex> lock = AcquireLock(mutex_);
   return current_state_;
 }
 
 Rotation SensorFusionEkf::PredictRotation(int64_t requested_timestamp) const {
-  std::unique_lock<std::mutex> lock(mutex_);
+  std::unique_lock<std::mutex> lock = AcquireLock(mutex_);
   // If the required timestamp is equal to zero, return the current pose.
   if (requested_timestamp == 0) {
     return current_state_.sensor_from_start_rotation;
@@ -175,26 +240,38 @@ Rotation SensorFusionEkf::PredictRotation(int64_t requested_timestamp) const {
 }
 
 void SensorFusionEkf::ProcessGyroscopeSample(const GyroscopeData& sample) {
-  std::unique_lock<std::mutex> lock(mutex_);
+  CARDBOARD_TRACE_SCOPE("SensorFusionEkf::ProcessGyroscopeSample");
+  std::unique_lock<std::mutex> lock = AcquireLock(mutex_);
 
   // Don't accept gyroscope sample when waiting for a reset.
   if (execute_reset_with_next_accelerometer_sample_) {
+    RecordDroppedSample();
     return;
   }
 
   // Discard outdated samples.
   if (current_gyroscope_sensor_timestamp_ns_ >= sample.sensor_timestamp_ns) {
+    RecordDroppedSample();
     return;
   }
 
   // Checks that we received at least one gyroscope sample in the past.
   if (current_gyroscope_sensor_timestamp_ns_ != 0) {
+    const bool is_stats_enabled = util::Stats::IsEnabled();
+    if (is_stats_enabled) {
+      util::GetStats().gyroscope_interval.Record(
+          sample.sensor_timestamp_ns - current_gyroscope_sensor_timestamp_ns_);
+    }
     double current_timestep_s =
         std::chrono::duration_cast<std::chrono::duration<double>>(
             std::chrono::nanoseconds(sample.sensor_timestamp_ns -
                                      current_gyroscope_sensor_timestamp_ns_))
             .count();
     if (current_timestep_s > kMaximumGyroscopeSampleDelay_s) {
+      if (is_stats_enabled) {
+        util::GetStats().late_gyroscope_sample_count.fetch_add(
+            1, std::memory_order_relaxed);
+      }
       if (is_gyroscope_filter_valid_) {
         // Replaces the delta timestamp by the filtered estimates of the delta
         // time.
@@ -210,10 +287,18 @@ void SensorFusionEkf::ProcessGyroscopeSample(const GyroscopeData& sample) {
     gyroscope_bias_estimator_.ProcessGyroscope(sample.data,
                                                sample.sensor_timestamp_ns);
 
-    if (gyroscope_bias_estimator_.IsCurrentEstimateValid()) {
+    const bool is_bias_estimate_valid =
+        gyroscope_bias_estimator_.IsCurrentEstimateValid();
+    if (is_bias_estimate_valid) {
       // As soon as the device is considered to be static, the bias estimator
       // should have a precise estimate of the gyroscope bias.
       gyroscope_bias_estimate_ = gyroscope_bias_estimator_.GetGyroscopeBias();
+      calibration_.gyroscope_bias = gyroscope_bias_estimate_;
+      has_calibration_ = true;
+    }
+    if (is_stats_enabled) {
+      util::GetStats().gyroscope_bias_converged.store(
+          is_bias_estimate_valid, std::memory_order_relaxed);
     }
     // }
 
@@ -273,14 +358,23 @@ void SensorFusionEkf::ComputeMeasurementJacobian() {
 
 void SensorFusionEkf::ProcessAccelerometerSample(
     const AccelerometerData& sample) {
-  std::unique_lock<std::mutex> lock(mutex_);
+  CARDBOARD_TRACE_SCOPE("SensorFusionEkf::ProcessAccelerometerSample");
+  std::unique_lock<std::mutex> lock = AcquireLock(mutex_);
 
   // Discard outdated samples.
   if (current_accelerometer_sensor_timestamp_ns_ >=
       sample.sensor_timestamp_ns) {
+    RecordDroppedSample();
     return;
   }
 
+  if (current_accelerometer_sensor_timestamp_ns_ != 0 &&
+      util::Stats::IsEnabled()) {
+    util::GetStats().accelerometer_interval.Record(
+        sample.sensor_timestamp_ns -
+        current_accelerometer_sensor_timestamp_ns_);
+  }
+
   // Call reset state if required.
   if (execute_reset_with_next_accelerometer_sample_.exchange(false)) {
     ResetState();
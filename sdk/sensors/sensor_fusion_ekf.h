@@ -40,6 +40,15 @@ namespace cardboard {
 // good introduction: https://en.wikipedia.org/wiki/Kalman_filter
 class SensorFusionEkf {
  public:
+  // Gyroscope calibration. Unlike the rotation state, it remains valid across
+  // sessions.
+  struct Calibration {
+    // Gyroscope bias in radians per second.
+    Vector3 gyroscope_bias;
+    // Mean time between gyroscope samples in seconds.
+    double gyroscope_timestep_s;
+  };
+
   SensorFusionEkf();
 
   // Resets the state of the sensor fusion. It sets the velocity for
@@ -88,6 +97,20 @@ class SensorFusionEkf {
   //                 frame to Start Space.
   void RotateSensorSpaceToStartSpaceTransformation(const Rotation& rotation);
 
+  // Gets the latest gyroscope calibration, either estimated while the device
+  // was static or set with SetCalibration().
+  //
+  // @param calibration Output calibration.
+  // @return false if the gyroscope bias has neither converged nor been set.
+  bool GetCalibration(Calibration* calibration) const;
+
+  // Seeds the gyroscope bias and timestep estimates, e.g. with a calibration
+  // from a previous session, so that the rotation does not drift while they
+  // converge. The calibration is kept by Reset().
+  //
+  // @param calibration Calibration to start from.
+  void SetCalibration(const Calibration& calibration);
+
  private:
   // Estimates the average timestep between gyroscope event.
   void FilterGyroscopeTimestep(double gyroscope_timestep);
@@ -116,6 +139,10 @@ class SensorFusionEkf {
   // outside of it. This function is called in ProcessAccelerometerSample.
   void ResetState();
 
+  // Seeds the bias estimator and the timestep filter with calibration_. This
+  // is not thread safe. Lock should be acquired outside of it.
+  void ApplyCalibration();
+
   // Current transformation from Sensor Space to Start Space.
   // x_sensor = sensor_from_start_rotation_ * x_start;
   RotationState current_state_;
@@ -180,6 +207,10 @@ class SensorFusionEkf {
   // Current bias estimate_;
   Vector3 gyroscope_bias_estimate_;
 
+  // Latest gyroscope calibration and whether it has been estimated or set.
+  Calibration calibration_;
+  bool has_calibration_;
+
   SensorFusionEkf(const SensorFusionEkf&) = delete;
   SensorFusionEkf& operator=(const SensorFusionEkf&) = delete;
 };
@@ -0,0 +1,269 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "async_timewarp.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "distortion_renderer.h"
+#include "gtest/gtest.h"
+#include "head_tracker.h"
+#include "include/cardboard.h"
+#include "lens_distortion.h"
+#include "qrcode/cardboard_v1/cardboard_v1.h"
+#include "util/clock.h"
+#include "util/reprojection.h"
+
+namespace cardboard {
+namespace {
+
+constexpr int kDisplayWidth = 1920;
+constexpr int kDisplayHeight = 1080;
+constexpr std::chrono::seconds kWaitTimeout(5);
+constexpr float kReprojectionTolerance = 1e-4f;
+
+// Distortion renderer recording the passes the timewarp thread renders.
+class RecordingDistortionRenderer : public DistortionRenderer {
+ public:
+  struct Pass {
+    uint64_t left_texture;
+    uint64_t right_texture;
+    std::array<std::array<float, 9>, 2> reprojections;
+  };
+
+  void SetMesh(const CardboardChromaticMesh* /*mesh*/,
+               CardboardEye /*eye*/) override {}
+
+  void SetReprojection(const std::array<float, 9>& reprojection,
+                       CardboardEye eye) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reprojections_[eye] = reprojection;
+  }
+
+  void SetPassConfig(
+      const CardboardDistortionRendererPassConfig& /*pass_config*/) override {}
+
+  void RenderEyeToDisplay(
+      uint64_t /*target*/, int /*x*/, int /*y*/, int /*width*/,
+      int /*height*/, const CardboardEyeTextureDescription* left_eye,
+      const CardboardEyeTextureDescription* right_eye) override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      passes_.push_back(
+          {left_eye->texture, right_eye->texture, reprojections_});
+    }
+    condition_.notify_all();
+  }
+
+  // Waits until a pass renders @p left_texture and returns it.
+  //
+  // @return false on timeout.
+  bool WaitForPass(uint64_t left_texture, Pass* pass) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return condition_.wait_for(lock, kWaitTimeout, [&] {
+      for (const Pass& candidate : passes_) {
+        if (candidate.left_texture == left_texture) {
+          *pass = candidate;
+          return true;
+        }
+      }
+      return false;
+    });
+  }
+
+  int pass_count() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int>(passes_.size());
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::array<std::array<float, 9>, 2> reprojections_{IdentityReprojection(),
+                                                     IdentityReprojection()};
+  std::vector<Pass> passes_;
+};
+
+// Application side of the timewarp callbacks.
+struct FakeDisplay {
+  std::atomic<int> thread_start_count{0};
+  std::atomic<int> thread_stop_count{0};
+  std::atomic<int> begin_frame_count{0};
+  std::atomic<int> end_frame_count{0};
+  // Number of begin_frame() calls that skip the pass.
+  std::atomic<int> skipped_frame_count{0};
+
+  CardboardAsyncTimewarpConfig GetConfig() {
+    CardboardAsyncTimewarpConfig config{};
+    config.width = kDisplayWidth;
+    config.height = kDisplayHeight;
+    config.prediction_time_ns = 0;
+    config.user_data = this;
+    config.on_thread_start = [](void* user_data) {
+      static_cast<FakeDisplay*>(user_data)->thread_start_count++;
+    };
+    config.begin_frame = [](void* user_data, uint64_t* target) {
+      FakeDisplay* display = static_cast<FakeDisplay*>(user_data);
+      *target = 1;
+      return display->begin_frame_count++ < display->skipped_frame_count ? 0
+                                                                         : 1;
+    };
+    // Presenting blocks until the next vsync, which paces the thread.
+    config.end_frame = [](void* user_data) {
+      static_cast<FakeDisplay*>(user_data)->end_frame_count++;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    };
+    config.on_thread_stop = [](void* user_data) {
+      static_cast<FakeDisplay*>(user_data)->thread_stop_count++;
+    };
+    return config;
+  }
+};
+
+CardboardEyeTextureDescription EyeTexture(uint64_t texture) {
+  return {texture, 0.0f, 1.0f, 1.0f, 0.0f};
+}
+
+void ExpectIdentity(const std::array<float, 9>& reprojection) {
+  const std::array<float, 9> identity = IdentityReprojection();
+  for (int i = 0; i < 9; i++) {
+    EXPECT_NEAR(reprojection[i], identity[i], kReprojectionTolerance)
+        << "at index " << i;
+  }
+}
+
+class AsyncTimewarpTest : public ::testing::Test {
+ protected:
+  AsyncTimewarpTest()
+      : lens_distortion_(qrcode::getCardboardV1DeviceParams().data(),
+                         static_cast<int>(
+                             qrcode::getCardboardV1DeviceParams().size()),
+                         kDisplayWidth, kDisplayHeight) {}
+
+  std::unique_ptr<AsyncTimewarp> CreateTimewarp() {
+    return std::make_unique<AsyncTimewarp>(&head_tracker_, &lens_distortion_,
+                                           &renderer_, display_.GetConfig());
+  }
+
+  std::array<float, 4> GetApplicationOrientation(
+      CardboardViewportOrientation viewport_orientation) {
+    std::array<float, 3> position;
+    std::array<float, 4> orientation;
+    head_tracker_.GetPose(GetBootTimeNano(), viewport_orientation, position,
+                          orientation);
+    return orientation;
+  }
+
+  HeadTracker head_tracker_;
+  LensDistortion lens_distortion_;
+  RecordingDistortionRenderer renderer_;
+  FakeDisplay display_;
+};
+
+TEST_F(AsyncTimewarpTest, RendersLatestSubmittedFrame) {
+  std::unique_ptr<AsyncTimewarp> timewarp = CreateTimewarp();
+  const std::array<float, 4> orientation =
+      GetApplicationOrientation(kLandscapeLeft);
+
+  timewarp->SubmitFrame(EyeTexture(1), EyeTexture(2), orientation);
+  RecordingDistortionRenderer::Pass pass;
+  ASSERT_TRUE(renderer_.WaitForPass(1, &pass));
+  EXPECT_EQ(pass.right_texture, 2u);
+
+  timewarp->SubmitFrame(EyeTexture(3), EyeTexture(4), orientation);
+  ASSERT_TRUE(renderer_.WaitForPass(3, &pass));
+  EXPECT_EQ(pass.right_texture, 4u);
+}
+
+TEST_F(AsyncTimewarpTest, RetriesSkippedPasses) {
+  display_.skipped_frame_count = 3;
+  std::unique_ptr<AsyncTimewarp> timewarp = CreateTimewarp();
+  timewarp->SubmitFrame(EyeTexture(1), EyeTexture(2),
+                        GetApplicationOrientation(kLandscapeLeft));
+
+  RecordingDistortionRenderer::Pass pass;
+  ASSERT_TRUE(renderer_.WaitForPass(1, &pass));
+  timewarp.reset();
+  EXPECT_GE(display_.begin_frame_count, 4);
+  // Skipped passes are neither rendered nor presented.
+  EXPECT_EQ(display_.end_frame_count, renderer_.pass_count());
+}
+
+TEST_F(AsyncTimewarpTest, RunsThreadCallbacksOnce) {
+  std::unique_ptr<AsyncTimewarp> timewarp = CreateTimewarp();
+  timewarp->SubmitFrame(EyeTexture(1), EyeTexture(2),
+                        GetApplicationOrientation(kLandscapeLeft));
+  RecordingDistortionRenderer::Pass pass;
+  ASSERT_TRUE(renderer_.WaitForPass(1, &pass));
+  timewarp.reset();
+
+  EXPECT_EQ(display_.thread_start_count, 1);
+  EXPECT_EQ(display_.thread_stop_count, 1);
+}
+
+// Parameter: viewport orientation of the application.
+class AsyncTimewarpOrientationTest
+    : public AsyncTimewarpTest,
+      public ::testing::WithParamInterface<CardboardViewportOrientation> {};
+
+// The head does not move, so the timewarp thread must see the orientation the
+// application rendered with, whatever its viewport orientation, and leave the
+// application poses untouched.
+TEST_P(AsyncTimewarpOrientationTest, FollowsApplicationViewportOrientation) {
+  const std::array<float, 4> render_orientation =
+      GetApplicationOrientation(GetParam());
+  std::unique_ptr<AsyncTimewarp> timewarp = CreateTimewarp();
+  timewarp->SubmitFrame(EyeTexture(1), EyeTexture(2), render_orientation);
+
+  RecordingDistortionRenderer::Pass pass;
+  ASSERT_TRUE(renderer_.WaitForPass(1, &pass));
+  ExpectIdentity(pass.reprojections[kLeft]);
+  ExpectIdentity(pass.reprojections[kRight]);
+
+  const std::array<float, 4> orientation =
+      GetApplicationOrientation(GetParam());
+  for (int i = 0; i < 4; i++) {
+    EXPECT_NEAR(orientation[i], render_orientation[i], kReprojectionTolerance);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AllViewportOrientations, AsyncTimewarpOrientationTest,
+    ::testing::Values(kLandscapeLeft, kLandscapeRight, kPortrait,
+                      kPortraitUpsideDown),
+    [](const ::testing::TestParamInfo<CardboardViewportOrientation>& info) {
+      switch (info.param) {
+        case kLandscapeLeft:
+          return "LandscapeLeft";
+        case kLandscapeRight:
+          return "LandscapeRight";
+        case kPortrait:
+          return "Portrait";
+        case kPortraitUpsideDown:
+        default:
+          return "PortraitUpsideDown";
+      }
+    });
+
+}  // namespace
+}  // namespace cardboard
@@ -0,0 +1,40 @@
+# Copyright 2023 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Regenerates the C++ sources of PROTO_DIR/cardboard_device.proto with PROTOC
+# into OUTPUT_DIR and fails when they differ from the checked in ones, which
+# must only ever be changed by regenerating them:
+#
+#   cmake -DPROTOC=protoc -DPROTO_DIR=proto -DOUTPUT_DIR=/tmp/proto \
+#       -P sdk/tests/check_generated_proto.cmake
+
+file(MAKE_DIRECTORY ${OUTPUT_DIR})
+execute_process(
+    COMMAND ${PROTOC} --proto_path=${PROTO_DIR} --cpp_out=${OUTPUT_DIR}
+        cardboard_device.proto
+    RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "${PROTOC} failed: ${result}")
+endif()
+
+foreach(generated cardboard_device.pb.h cardboard_device.pb.cc)
+  execute_process(
+      COMMAND ${CMAKE_COMMAND} -E compare_files
+          ${PROTO_DIR}/${generated} ${OUTPUT_DIR}/${generated}
+      RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "proto/${generated} differs from the output of "
+        "${PROTOC}: edit cardboard_device.proto and regenerate it instead.")
+  endif()
+endforeach()
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "include/cardboard.h"
+#include "tests/distortion_test_scene.h"
+
+namespace cardboard::testing {
+namespace {
+
+constexpr int kDisplayWidth = 640;
+constexpr int kDisplayHeight = 360;
+// Number of frames rendered by each renderer, so that the worker threads run
+// several jobs.
+constexpr int kFrameCount = 3;
+
+// Renders kFrameCount frames of @p scene with @p thread_count threads and
+// returns them.
+std::vector<std::vector<uint8_t>> RenderFrames(const DistortionTestScene& scene,
+                                               int thread_count) {
+  const CardboardCpuDistortionRendererConfig config = {thread_count};
+  CardboardDistortionRenderer* renderer =
+      CardboardCpuDistortionRenderer_create(&config);
+  CardboardDistortionRendererPassConfig pass_config = {};
+  pass_config.color_load_op = kColorLoadOpClear;
+  scene.Configure(renderer, pass_config);
+
+  std::array<CardboardCpuImage, 2> eye_images;
+  std::array<CardboardEyeTextureDescription, 2> descriptions;
+  for (CardboardEye eye : {kLeft, kRight}) {
+    eye_images[eye] = {const_cast<uint8_t*>(scene.eye_pixels(eye).data()),
+                       scene.eye_width(), scene.eye_height(),
+                       scene.eye_width() * 4};
+    descriptions[eye] = scene.GetEyeDescription(
+        eye, reinterpret_cast<uint64_t>(&eye_images[eye]));
+  }
+  std::vector<std::vector<uint8_t>> frames;
+  for (int frame = 0; frame < kFrameCount; ++frame) {
+    std::vector<uint8_t> pixels(static_cast<size_t>(scene.display_width()) *
+                                scene.display_height() * 4);
+    CardboardCpuImage target = {pixels.data(), scene.display_width(),
+                                scene.display_height(),
+                                scene.display_width() * 4};
+    CardboardDistortionRenderer_renderEyeToDisplay(
+        renderer, reinterpret_cast<uint64_t>(&target), 0, 0,
+        scene.display_width(), scene.display_height(), &descriptions[kLeft],
+        &descriptions[kRight]);
+    frames.push_back(std::move(pixels));
+  }
+  CardboardDistortionRenderer_destroy(renderer);
+  return frames;
+}
+
+// Parameter: whether the viewer corrects the chromatic aberration.
+class CpuDistortionRendererTest : public ::testing::TestWithParam<bool> {};
+
+// The rows are split across the worker threads, whose count must not change
+// the image, and the threads are reused from frame to frame.
+TEST_P(CpuDistortionRendererTest, RendersSameImageWithAnyThreadCount) {
+  const DistortionTestScene scene(kDisplayWidth, kDisplayHeight, GetParam());
+  const std::vector<std::vector<uint8_t>> reference = RenderFrames(scene, 1);
+  for (const std::vector<uint8_t>& frame : reference) {
+    EXPECT_EQ(frame, reference[0]);
+  }
+  for (int thread_count : {2, 3, 8}) {
+    for (const std::vector<uint8_t>& frame :
+         RenderFrames(scene, thread_count)) {
+      EXPECT_EQ(frame, reference[0]) << thread_count << " threads";
+    }
+  }
+}
+
+// A reprojection that moves the texture coordinates past the eye texture
+// rectangle samples its edge, not the texels around it.
+TEST_P(CpuDistortionRendererTest, ClampsToEyeTextureRectangle) {
+  const DistortionTestScene scene(kDisplayWidth, kDisplayHeight, GetParam());
+  const CardboardCpuDistortionRendererConfig config = {/*thread_count=*/1};
+  CardboardDistortionRenderer* renderer =
+      CardboardCpuDistortionRenderer_create(&config);
+  CardboardDistortionRendererPassConfig pass_config = {};
+  pass_config.color_load_op = kColorLoadOpClear;
+  scene.Configure(renderer, pass_config);
+  // Moves the texture coordinates by half the texture on both axes.
+  const std::array<float, 9> shift = {1, 0, 0, 0, 1, 0, 0.5f, 0.5f, 1};
+  for (CardboardEye eye : {kLeft, kRight}) {
+    CardboardDistortionRenderer_setReprojection(renderer, shift.data(), eye);
+  }
+
+  // Green inside the eye texture rectangle, red around it.
+  CardboardEyeTextureDescription description =
+      scene.GetEyeDescription(kLeft, 0);
+  std::vector<uint8_t> eye_pixels(
+      static_cast<size_t>(scene.eye_width()) * scene.eye_height() * 4);
+  for (int y = 0; y < scene.eye_height(); ++y) {
+    for (int x = 0; x < scene.eye_width(); ++x) {
+      const float u = (x + 0.5f) / scene.eye_width();
+      const float v = (y + 0.5f) / scene.eye_height();
+      const bool inside = u > description.left_u && u < description.right_u &&
+                          v > description.bottom_v && v < description.top_v;
+      uint8_t* pixel =
+          &eye_pixels[(static_cast<size_t>(y) * scene.eye_width() + x) * 4];
+      pixel[0] = inside ? 0 : 255;
+      pixel[1] = inside ? 255 : 0;
+      pixel[2] = 0;
+      pixel[3] = 255;
+    }
+  }
+  CardboardCpuImage eye_image = {eye_pixels.data(), scene.eye_width(),
+                                 scene.eye_height(), scene.eye_width() * 4};
+  description.texture = reinterpret_cast<uint64_t>(&eye_image);
+
+  std::vector<uint8_t> pixels(static_cast<size_t>(kDisplayWidth) *
+                              kDisplayHeight * 4);
+  CardboardCpuImage target = {pixels.data(), kDisplayWidth, kDisplayHeight,
+                              kDisplayWidth * 4};
+  CardboardDistortionRenderer_renderEyeToDisplay(
+      renderer, reinterpret_cast<uint64_t>(&target), 0, 0, kDisplayWidth,
+      kDisplayHeight, &description, &description);
+  CardboardDistortionRenderer_destroy(renderer);
+
+  // Bilinear filtering at the corners of the rectangle blends in three of
+  // the texels around it at most.
+  int outside_pixels = 0;
+  int covered_pixels = 0;
+  for (size_t i = 0; i < pixels.size(); i += 4) {
+    outside_pixels += pixels[i] > 192 ? 1 : 0;
+    covered_pixels += pixels[i + 1] != 0 ? 1 : 0;
+  }
+  EXPECT_EQ(outside_pixels, 0);
+  EXPECT_GT(covered_pixels, 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(ChromaticAberration, CpuDistortionRendererTest,
+                         ::testing::Bool(),
+                         [](const ::testing::TestParamInfo<bool>& info) {
+                           return info.param ? "Chromatic" : "Achromatic";
+                         });
+
+}  // namespace
+}  // namespace cardboard::testing
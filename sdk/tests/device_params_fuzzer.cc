@@ -0,0 +1,128 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// libFuzzer target of the native DeviceParams wire format decoder. It is built
+// as a fuzzer with CARDBOARD_BUILD_FUZZERS and Clang, and replayed over a fixed
+// set of mutated messages by device_params_test otherwise.
+//
+// Besides memory errors, which need a sanitizer build to be caught, it aborts
+// when the decoder breaks the protobuf parsing contract:
+// - a failed parse leaves every field at its default value;
+// - parsing is deterministic;
+// - a well formed message concatenated with itself is well formed, with the
+//   same singular fields and twice the repeated ones. Protobuf merges
+//   concatenated messages that way.
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "device_params/device_params.h"
+
+namespace cardboard::device_params {
+namespace {
+
+// Aborts when @p condition does not hold, in every build type.
+void Check(bool condition) {
+  if (!condition) {
+    std::abort();
+  }
+}
+
+// Whether @p a and @p b are bitwise equal, so that NaNs compare equal.
+bool SameFloat(float a, float b) {
+  return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+// Compares the singular fields of two messages.
+bool SameSingularFields(const DeviceParams& a, const DeviceParams& b) {
+  return a.vendor() == b.vendor() && a.model() == b.model() &&
+         SameFloat(a.screen_to_lens_distance(), b.screen_to_lens_distance()) &&
+         SameFloat(a.inter_lens_distance(), b.inter_lens_distance()) &&
+         SameFloat(a.tray_to_lens_distance(), b.tray_to_lens_distance()) &&
+         a.vertical_alignment() == b.vertical_alignment() &&
+         a.primary_button() == b.primary_button();
+}
+
+// Compares the repeated fields of two messages, @p b holding each field of
+// @p a repeated @p repetitions times.
+bool SameRepeatedFields(const DeviceParams& a, const DeviceParams& b,
+                        int repetitions) {
+  using Getter = float (DeviceParams::*)(int) const;
+  using SizeGetter = int (DeviceParams::*)() const;
+  const struct {
+    Getter get;
+    SizeGetter size;
+  } kRepeatedFields[] = {
+      {&DeviceParams::left_eye_field_of_view_angles,
+       &DeviceParams::left_eye_field_of_view_angles_size},
+      {&DeviceParams::distortion_coefficients,
+       &DeviceParams::distortion_coefficients_size},
+      {&DeviceParams::chromatic_aberration_scales,
+       &DeviceParams::chromatic_aberration_scales_size},
+  };
+  for (const auto& field : kRepeatedFields) {
+    const int size = (a.*field.size)();
+    if ((b.*field.size)() != size * repetitions) {
+      return false;
+    }
+    for (int i = 0; i < size * repetitions; ++i) {
+      if (!SameFloat((a.*field.get)(i % size), (b.*field.get)(i))) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+}  // namespace cardboard::device_params
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  using cardboard::device_params::Check;
+  using cardboard::device_params::DeviceParams;
+  using cardboard::device_params::SameRepeatedFields;
+  using cardboard::device_params::SameSingularFields;
+  // Sizes are passed as int to the decoder. Inputs that large say nothing
+  // about it.
+  if (size > 1 << 20) {
+    return 0;
+  }
+
+  DeviceParams params;
+  const bool is_parsed = params.ParseFromArray(data, static_cast<int>(size));
+  if (!is_parsed) {
+    const DeviceParams defaults;
+    Check(SameSingularFields(params, defaults));
+    Check(SameRepeatedFields(defaults, params, 1));
+  }
+
+  DeviceParams reparsed;
+  Check(reparsed.ParseFromArray(data, static_cast<int>(size)) == is_parsed);
+  Check(SameSingularFields(params, reparsed));
+  Check(SameRepeatedFields(params, reparsed, 1));
+
+  if (is_parsed) {
+    std::vector<uint8_t> concatenated(data, data + size);
+    concatenated.insert(concatenated.end(), data, data + size);
+    DeviceParams merged;
+    Check(merged.ParseFromArray(concatenated.data(),
+                                static_cast<int>(concatenated.size())));
+    Check(SameSingularFields(params, merged));
+    Check(SameRepeatedFields(params, merged, 2));
+  }
+  return 0;
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "device_params/device_params.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "qrcode/cardboard_v1/cardboard_v1.h"
+
+// Fuzz target defined in device_params_fuzzer.cc. It aborts on failure.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace cardboard::device_params {
+namespace {
+
+// Number of random mutations replayed through the fuzz target.
+constexpr int kMutationCount = 20000;
+
+// Packed chromatic aberration scales {0.994, 1.0, 1.008}.
+const std::vector<uint8_t> kChromaticAberrationScales = {
+    0x6a, 0x0c, 0xc9, 0x76, 0x7e, 0x3f, 0x00, 0x00,
+    0x80, 0x3f, 0x25, 0x06, 0x81, 0x3f};
+
+void RunFuzzTarget(const std::vector<uint8_t>& data) {
+  LLVMFuzzerTestOneInput(data.data(), data.size());
+}
+
+// Well formed messages the mutations start from.
+std::vector<std::vector<uint8_t>> SeedCorpus() {
+  std::vector<uint8_t> cardboard_v1 = qrcode::getCardboardV1DeviceParams();
+  std::vector<uint8_t> chromatic = cardboard_v1;
+  chromatic.insert(chromatic.end(), kChromaticAberrationScales.begin(),
+                   kChromaticAberrationScales.end());
+  return {
+      {},
+      cardboard_v1,
+      chromatic,
+      // Unpacked field of view angle, enums, a fixed64 and an unknown field.
+      {0x2d, 0x00, 0x00, 0x20, 0x42, 0x58, 0x02, 0x60, 0x03, 0x71, 0x01,
+       0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0xa2, 0x06, 0x01, 0x7f},
+  };
+}
+
+TEST(DeviceParamsTest, ParsesCardboardV1) {
+  const std::vector<uint8_t> encoded = qrcode::getCardboardV1DeviceParams();
+  DeviceParams params;
+  ASSERT_TRUE(
+      params.ParseFromArray(encoded.data(), static_cast<int>(encoded.size())));
+  EXPECT_EQ(params.vendor(), qrcode::kCardboardV1Vendor);
+  EXPECT_EQ(params.model(), qrcode::kCardboardV1Model);
+  EXPECT_EQ(params.screen_to_lens_distance(),
+            qrcode::kCardboardV1ScreenToLensDistance);
+  EXPECT_EQ(params.inter_lens_distance(),
+            qrcode::kCardboardV1InterLensDistance);
+  EXPECT_EQ(params.tray_to_lens_distance(),
+            qrcode::kCardboardV1TrayToLensDistance);
+  EXPECT_EQ(params.vertical_alignment(),
+            qrcode::kCardboardV1VerticalAlignmentType);
+  ASSERT_EQ(params.left_eye_field_of_view_angles_size(), 4);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(params.left_eye_field_of_view_angles(i),
+              qrcode::kCardboardV1FovHalfDegrees[i]);
+  }
+  ASSERT_EQ(params.distortion_coefficients_size(),
+            qrcode::kCardboardV1DistortionCoeffsSize);
+  for (int i = 0; i < qrcode::kCardboardV1DistortionCoeffsSize; ++i) {
+    EXPECT_EQ(params.distortion_coefficients(i),
+              qrcode::kCardboardV1DistortionCoeffs[i]);
+  }
+  EXPECT_EQ(params.chromatic_aberration_scales_size(), 0);
+}
+
+TEST(DeviceParamsTest, ParsesPackedChromaticAberrationScales) {
+  DeviceParams params;
+  ASSERT_TRUE(params.ParseFromArray(
+      kChromaticAberrationScales.data(),
+      static_cast<int>(kChromaticAberrationScales.size())));
+  ASSERT_EQ(params.chromatic_aberration_scales_size(), 3);
+  EXPECT_EQ(params.chromatic_aberration_scales(0), 0.994f);
+  EXPECT_EQ(params.chromatic_aberration_scales(1), 1.0f);
+  EXPECT_EQ(params.chromatic_aberration_scales(2), 1.008f);
+}
+
+TEST(DeviceParamsTest, RejectsMalformedTags) {
+  const std::vector<std::vector<uint8_t>> malformed = {
+      // Field number 0.
+      {0x05, 0x00, 0x00, 0x00, 0x00},
+      // Wire types 6 and 7.
+      {0x1e, 0x00},
+      {0x1f, 0x00},
+      // Tag larger than 32 bits.
+      {0x80, 0x80, 0x80, 0x80, 0x80, 0x01},
+      // Unterminated varint.
+      {0x58, 0x80},
+      // Length beyond the end of the buffer.
+      {0x0a, 0x05, 0x41},
+      // Packed floats whose length is not a multiple of 4.
+      {0x3a, 0x03, 0x00, 0x00, 0x00},
+  };
+  for (const std::vector<uint8_t>& encoded : malformed) {
+    DeviceParams params;
+    EXPECT_FALSE(params.ParseFromArray(encoded.data(),
+                                       static_cast<int>(encoded.size())));
+    RunFuzzTarget(encoded);
+  }
+}
+
+TEST(DeviceParamsTest, RejectsNegativeSize) {
+  const uint8_t encoded[] = {0x00};
+  DeviceParams params;
+  EXPECT_FALSE(params.ParseFromArray(encoded, -1));
+}
+
+// Every prefix of a well formed message, which cuts fields at every byte.
+TEST(DeviceParamsFuzzTest, Truncations) {
+  for (const std::vector<uint8_t>& seed : SeedCorpus()) {
+    for (size_t size = 0; size <= seed.size(); ++size) {
+      RunFuzzTarget(std::vector<uint8_t>(seed.begin(), seed.begin() + size));
+    }
+  }
+}
+
+// Every byte of the seeds replaced by the values that matter to varints,
+// tags and lengths.
+TEST(DeviceParamsFuzzTest, ByteReplacements) {
+  for (const std::vector<uint8_t>& seed : SeedCorpus()) {
+    for (size_t i = 0; i < seed.size(); ++i) {
+      for (uint8_t value : {0x00, 0x01, 0x07, 0x7f, 0x80, 0xff}) {
+        std::vector<uint8_t> mutated = seed;
+        mutated[i] = value;
+        RunFuzzTarget(mutated);
+      }
+    }
+  }
+}
+
+// Random bit flips, insertions, deletions and splices of the seeds, with a
+// fixed seed so that failures reproduce.
+TEST(DeviceParamsFuzzTest, RandomMutations) {
+  const std::vector<std::vector<uint8_t>> corpus = SeedCorpus();
+  std::mt19937 random(20230101);
+  const auto uniform = [&random](size_t bound) {
+    return std::uniform_int_distribution<size_t>(0, bound)(random);
+  };
+  for (int i = 0; i < kMutationCount; ++i) {
+    std::vector<uint8_t> data = corpus[uniform(corpus.size() - 1)];
+    const int edit_count = 1 + static_cast<int>(uniform(3));
+    for (int edit = 0; edit < edit_count; ++edit) {
+      const size_t position = uniform(data.size());
+      switch (uniform(3)) {
+        case 0:
+          if (position < data.size()) {
+            data[position] ^= static_cast<uint8_t>(1 << uniform(7));
+          }
+          break;
+        case 1:
+          data.insert(data.begin() + position,
+                      static_cast<uint8_t>(uniform(255)));
+          break;
+        case 2:
+          if (position < data.size()) {
+            data.erase(data.begin() + position);
+          }
+          break;
+        default: {
+          const std::vector<uint8_t>& other =
+              corpus[uniform(corpus.size() - 1)];
+          const size_t start = uniform(other.size());
+          data.insert(data.begin() + position, other.begin() + start,
+                      other.begin() + start + uniform(other.size() - start));
+          break;
+        }
+      }
+    }
+    RunFuzzTarget(data);
+  }
+}
+
+}  // namespace
+}  // namespace cardboard::device_params
@@ -0,0 +1,296 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "qrcode/device_params_uri.h"
+
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "qrcode/cardboard_v1/cardboard_v1.h"
+
+namespace cardboard::qrcode {
+namespace {
+
+constexpr char kCardboardConfigUri[] = "https://google.com/cardboard/cfg?p=";
+
+// Encodes @p data as base64url without padding.
+std::string EncodeBase64Url(const std::vector<uint8_t>& data) {
+  constexpr char kAlphabet[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+  std::string encoded;
+  uint32_t buffer = 0;
+  int buffered_bits = 0;
+  for (uint8_t byte : data) {
+    buffer = (buffer << 8) | byte;
+    buffered_bits += 8;
+    while (buffered_bits >= 6) {
+      buffered_bits -= 6;
+      encoded.push_back(kAlphabet[(buffer >> buffered_bits) & 0x3f]);
+    }
+  }
+  if (buffered_bits > 0) {
+    encoded.push_back(kAlphabet[(buffer << (6 - buffered_bits)) & 0x3f]);
+  }
+  return encoded;
+}
+
+// Cardboard v1 parameters with a distinct inter lens distance, so that they
+// cannot be mistaken for the ones of the Cardboard v1 URI.
+std::vector<uint8_t> CustomDeviceParams() {
+  std::vector<uint8_t> encoded = getCardboardV1DeviceParams();
+  // inter_lens_distance = 0.0625.
+  const std::vector<uint8_t> inter_lens_distance = {0x25, 0x00, 0x00, 0x80,
+                                                    0x3d};
+  encoded.insert(encoded.end(), inter_lens_distance.begin(),
+                 inter_lens_distance.end());
+  return encoded;
+}
+
+std::string CustomDeviceParamsUri() {
+  return kCardboardConfigUri + EncodeBase64Url(CustomDeviceParams());
+}
+
+// Redirect resolver answering from a fixed table of redirects and recording
+// the URLs it is queried with.
+class StubFetcher {
+ public:
+  void AddRedirect(const std::string& url, const std::string& location) {
+    redirects_[url] = location;
+  }
+
+  void set_status(DeviceParamsUriStatus status) { status_ = status; }
+
+  const std::vector<std::string>& queried_urls() const {
+    return queried_urls_;
+  }
+
+  RedirectFetcher AsFetcher() {
+    return [this](const std::string& url, std::string* location) {
+      queried_urls_.push_back(url);
+      if (status_ != DeviceParamsUriStatus::kOk) {
+        return status_;
+      }
+      const auto redirect = redirects_.find(url);
+      *location = redirect == redirects_.end() ? "" : redirect->second;
+      return DeviceParamsUriStatus::kOk;
+    };
+  }
+
+ private:
+  std::map<std::string, std::string> redirects_;
+  std::vector<std::string> queried_urls_;
+  DeviceParamsUriStatus status_ = DeviceParamsUriStatus::kOk;
+};
+
+// Adds a chain of @p hops redirects from https://short.link/0 to @p target.
+//
+// @return The first URL of the chain.
+std::string AddRedirectChain(StubFetcher* fetcher, int hops,
+                             const std::string& target) {
+  for (int i = 0; i < hops; ++i) {
+    fetcher->AddRedirect(
+        "https://short.link/" + std::to_string(i),
+        i + 1 < hops ? "https://short.link/" + std::to_string(i + 1) : target);
+  }
+  return "https://short.link/0";
+}
+
+TEST(DeviceParamsUriTest, NormalizeUri) {
+  EXPECT_EQ(normalizeUri("g.co/cardboard"), "https://g.co/cardboard");
+  EXPECT_EQ(normalizeUri("http://g.co/cardboard"), "https://g.co/cardboard");
+  EXPECT_EQ(normalizeUri("https://g.co/cardboard"), "https://g.co/cardboard");
+  EXPECT_EQ(normalizeUri("httpx://g.co/cardboard"), "httpx://g.co/cardboard");
+  EXPECT_EQ(normalizeUri(""), "https://");
+}
+
+TEST(DeviceParamsUriTest, DecodeBase64Url) {
+  std::vector<uint8_t> decoded;
+  ASSERT_TRUE(decodeBase64Url("TWFu", &decoded));
+  EXPECT_EQ(decoded, std::vector<uint8_t>({'M', 'a', 'n'}));
+  ASSERT_TRUE(decodeBase64Url("TWE", &decoded));
+  EXPECT_EQ(decoded, std::vector<uint8_t>({'M', 'a'}));
+  ASSERT_TRUE(decodeBase64Url("TQ==", &decoded));
+  EXPECT_EQ(decoded, std::vector<uint8_t>({'M'}));
+  // The two characters that differ from standard base64.
+  ASSERT_TRUE(decodeBase64Url("-_8", &decoded));
+  EXPECT_EQ(decoded, std::vector<uint8_t>({0xfb, 0xff}));
+  ASSERT_TRUE(decodeBase64Url("", &decoded));
+  EXPECT_TRUE(decoded.empty());
+
+  const std::vector<uint8_t> device_params = CustomDeviceParams();
+  ASSERT_TRUE(decodeBase64Url(EncodeBase64Url(device_params), &decoded));
+  EXPECT_EQ(decoded, device_params);
+}
+
+TEST(DeviceParamsUriTest, DecodeBase64UrlRejectsInvalidInput) {
+  std::vector<uint8_t> decoded;
+  EXPECT_FALSE(decodeBase64Url("TWF+", &decoded));
+  EXPECT_FALSE(decodeBase64Url("TWF/", &decoded));
+  EXPECT_FALSE(decodeBase64Url("TW Fu", &decoded));
+  EXPECT_FALSE(decodeBase64Url("TWFuT", &decoded));
+}
+
+TEST(DeviceParamsUriTest, ValidateDeviceParams) {
+  EXPECT_TRUE(validateDeviceParams(getCardboardV1DeviceParams()));
+  EXPECT_TRUE(validateDeviceParams(CustomDeviceParams()));
+  EXPECT_FALSE(validateDeviceParams({}));
+  // Truncated message.
+  std::vector<uint8_t> truncated = getCardboardV1DeviceParams();
+  truncated.pop_back();
+  EXPECT_FALSE(validateDeviceParams(truncated));
+  // A fifth field of view angle.
+  std::vector<uint8_t> extra_angle = getCardboardV1DeviceParams();
+  extra_angle.insert(extra_angle.end(), {0x2d, 0x00, 0x00, 0x20, 0x42});
+  EXPECT_FALSE(validateDeviceParams(extra_angle));
+  // A NaN screen to lens distance.
+  std::vector<uint8_t> nan_distance = getCardboardV1DeviceParams();
+  nan_distance.insert(nan_distance.end(), {0x1d, 0x00, 0x00, 0xc0, 0x7f});
+  EXPECT_FALSE(validateDeviceParams(nan_distance));
+}
+
+TEST(DeviceParamsUriTest, ResolvesCardboardV1UriLocally) {
+  StubFetcher fetcher;
+  for (const char* uri :
+       {"g.co/cardboard", "http://g.co/cardboard", "https://g.co/cardboard"}) {
+    std::vector<uint8_t> device_params;
+    ASSERT_EQ(getDeviceParamsFromUri(uri, fetcher.AsFetcher(), &device_params),
+              DeviceParamsUriStatus::kOk)
+        << uri;
+    EXPECT_EQ(device_params, getCardboardV1DeviceParams());
+  }
+  EXPECT_TRUE(fetcher.queried_urls().empty());
+}
+
+TEST(DeviceParamsUriTest, DecodesCardboardUriLocally) {
+  StubFetcher fetcher;
+  std::vector<uint8_t> device_params;
+  ASSERT_EQ(getDeviceParamsFromUri(CustomDeviceParamsUri(),
+                                   fetcher.AsFetcher(), &device_params),
+            DeviceParamsUriStatus::kOk);
+  EXPECT_EQ(device_params, CustomDeviceParams());
+  EXPECT_TRUE(fetcher.queried_urls().empty());
+}
+
+TEST(DeviceParamsUriTest, NormalizesCardboardUri) {
+  const std::string params = EncodeBase64Url(CustomDeviceParams());
+  for (const std::string& uri :
+       {"google.com/cardboard/cfg?p=" + params,
+        "http://google.com/cardboard/cfg?p=" + params,
+        "https://google.com/cardboard/cfg?x=1&p=" + params + "&y=2",
+        "https://google.com/cardboard/cfg?p=" + params + "#fragment"}) {
+    std::vector<uint8_t> device_params;
+    ASSERT_EQ(getDeviceParamsFromUri(uri, nullptr, &device_params),
+              DeviceParamsUriStatus::kOk)
+        << uri;
+    EXPECT_EQ(device_params, CustomDeviceParams());
+  }
+}
+
+TEST(DeviceParamsUriTest, RejectsInvalidCardboardUri) {
+  std::vector<uint8_t> truncated = CustomDeviceParams();
+  truncated.pop_back();
+  for (const std::string& uri :
+       {std::string("https://google.com/cardboard/cfg"),
+        std::string("https://google.com/cardboard/cfg?q=AAAA"),
+        std::string("https://google.com/cardboard/cfg?p=!!!!"),
+        kCardboardConfigUri + EncodeBase64Url(truncated)}) {
+    StubFetcher fetcher;
+    std::vector<uint8_t> device_params;
+    EXPECT_EQ(getDeviceParamsFromUri(uri, fetcher.AsFetcher(), &device_params),
+              DeviceParamsUriStatus::kUnexpectedFormat)
+        << uri;
+    EXPECT_TRUE(device_params.empty());
+    EXPECT_TRUE(fetcher.queried_urls().empty());
+  }
+}
+
+TEST(DeviceParamsUriTest, FollowsRedirectsUpToTheLimit) {
+  StubFetcher fetcher;
+  const std::string uri =
+      AddRedirectChain(&fetcher, kMaxRedirects, CustomDeviceParamsUri());
+  std::vector<uint8_t> device_params;
+  ASSERT_EQ(getDeviceParamsFromUri(uri, fetcher.AsFetcher(), &device_params),
+            DeviceParamsUriStatus::kOk);
+  EXPECT_EQ(device_params, CustomDeviceParams());
+  EXPECT_EQ(fetcher.queried_urls().size(), static_cast<size_t>(kMaxRedirects));
+}
+
+TEST(DeviceParamsUriTest, StopsAfterTooManyRedirects) {
+  StubFetcher fetcher;
+  const std::string uri =
+      AddRedirectChain(&fetcher, kMaxRedirects + 1, CustomDeviceParamsUri());
+  std::vector<uint8_t> device_params;
+  EXPECT_EQ(getDeviceParamsFromUri(uri, fetcher.AsFetcher(), &device_params),
+            DeviceParamsUriStatus::kUnexpectedFormat);
+  EXPECT_TRUE(device_params.empty());
+  EXPECT_EQ(fetcher.queried_urls().size(), static_cast<size_t>(kMaxRedirects));
+}
+
+TEST(DeviceParamsUriTest, NormalizesRedirects) {
+  StubFetcher fetcher;
+  fetcher.AddRedirect("https://short.link/0", "http://short.link/1");
+  fetcher.AddRedirect("https://short.link/1", "g.co/cardboard");
+  std::vector<uint8_t> device_params;
+  ASSERT_EQ(getDeviceParamsFromUri("short.link/0", fetcher.AsFetcher(),
+                                   &device_params),
+            DeviceParamsUriStatus::kOk);
+  EXPECT_EQ(device_params, getCardboardV1DeviceParams());
+  EXPECT_EQ(fetcher.queried_urls(),
+            std::vector<std::string>(
+                {"https://short.link/0", "https://short.link/1"}));
+}
+
+TEST(DeviceParamsUriTest, RejectsUnredirectedUri) {
+  StubFetcher fetcher;
+  std::vector<uint8_t> device_params;
+  EXPECT_EQ(getDeviceParamsFromUri("https://example.com", fetcher.AsFetcher(),
+                                   &device_params),
+            DeviceParamsUriStatus::kUnexpectedFormat);
+  EXPECT_EQ(fetcher.queried_urls().size(), 1u);
+}
+
+TEST(DeviceParamsUriTest, RejectsSelfRedirect) {
+  StubFetcher fetcher;
+  fetcher.AddRedirect("https://short.link/0", "http://short.link/0");
+  std::vector<uint8_t> device_params;
+  EXPECT_EQ(getDeviceParamsFromUri("https://short.link/0", fetcher.AsFetcher(),
+                                   &device_params),
+            DeviceParamsUriStatus::kUnexpectedFormat);
+  EXPECT_EQ(fetcher.queried_urls().size(), 1u);
+}
+
+TEST(DeviceParamsUriTest, ReportsConnectionErrors) {
+  StubFetcher fetcher;
+  fetcher.set_status(DeviceParamsUriStatus::kConnectionError);
+  std::vector<uint8_t> device_params;
+  EXPECT_EQ(getDeviceParamsFromUri("https://short.link/0", fetcher.AsFetcher(),
+                                   &device_params),
+            DeviceParamsUriStatus::kConnectionError);
+  EXPECT_TRUE(device_params.empty());
+}
+
+TEST(DeviceParamsUriTest, RejectsShortUrlWithoutFetcher) {
+  std::vector<uint8_t> device_params;
+  EXPECT_EQ(getDeviceParamsFromUri("https://short.link/0", nullptr,
+                                   &device_params),
+            DeviceParamsUriStatus::kUnexpectedFormat);
+}
+
+}  // namespace
+}  // namespace cardboard::qrcode
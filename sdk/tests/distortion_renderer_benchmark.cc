@@ -0,0 +1,190 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// Per-frame timings of the distortion renderers on the fixed scene of the
+// renderer tests. GPU renderers run on headless contexts (e.g. Mesa llvmpipe
+// or lavapipe), so their timings compare code paths, not devices. Each frame
+// waits for the rendering to complete.
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "include/cardboard.h"
+#include "tests/distortion_test_scene.h"
+#ifdef CARDBOARD_HOST_OPENGL
+#include "tests/headless_gl_context.h"
+#endif
+#ifdef CARDBOARD_HOST_VULKAN
+#include "tests/headless_vulkan_context.h"
+#endif
+
+namespace cardboard::testing {
+namespace {
+
+// Arguments: display width, display height and whether the viewer corrects
+// the chromatic aberration.
+void DisplayArguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"width", "height", "chromatic"});
+  for (int chromatic : {0, 1}) {
+    benchmark->Args({1920, 1080, chromatic});
+    benchmark->Args({3120, 1440, chromatic});
+  }
+  benchmark->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+// Same as DisplayArguments(), with the thread count of the CPU renderer as
+// fourth argument. Zero uses one thread per core.
+void CpuDisplayArguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"width", "height", "chromatic", "threads"});
+  for (int chromatic : {0, 1}) {
+    for (int threads : {1, 0}) {
+      benchmark->Args({1920, 1080, chromatic, threads});
+      benchmark->Args({3120, 1440, chromatic, threads});
+    }
+  }
+  benchmark->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+void BM_CpuDistortionRenderer(benchmark::State& state) {
+  const DistortionTestScene scene(state.range(0), state.range(1),
+                                  state.range(2) != 0);
+  const CardboardCpuDistortionRendererConfig config = {
+      static_cast<int>(state.range(3))};
+  CardboardDistortionRenderer* renderer =
+      CardboardCpuDistortionRenderer_create(&config);
+  CardboardDistortionRendererPassConfig pass_config = {};
+  pass_config.color_load_op = kColorLoadOpClearVignette;
+  scene.Configure(renderer, pass_config);
+
+  std::array<CardboardCpuImage, 2> eye_images;
+  std::array<CardboardEyeTextureDescription, 2> descriptions;
+  for (CardboardEye eye : {kLeft, kRight}) {
+    eye_images[eye] = {const_cast<uint8_t*>(scene.eye_pixels(eye).data()),
+                       scene.eye_width(), scene.eye_height(),
+                       scene.eye_width() * 4};
+    descriptions[eye] = scene.GetEyeDescription(
+        eye, reinterpret_cast<uint64_t>(&eye_images[eye]));
+  }
+  std::vector<uint8_t> pixels(static_cast<size_t>(scene.display_width()) *
+                              scene.display_height() * 4);
+  CardboardCpuImage target = {pixels.data(), scene.display_width(),
+                              scene.display_height(),
+                              scene.display_width() * 4};
+  const auto render = [&]() {
+    CardboardDistortionRenderer_renderEyeToDisplay(
+        renderer, reinterpret_cast<uint64_t>(&target), 0, 0,
+        scene.display_width(), scene.display_height(), &descriptions[kLeft],
+        &descriptions[kRight]);
+  };
+  // The first frame rasterizes the meshes. The worker threads are started
+  // once, by CardboardCpuDistortionRenderer_create().
+  render();
+  for (auto _ : state) {
+    render();
+    benchmark::DoNotOptimize(pixels.data());
+  }
+  CardboardDistortionRenderer_destroy(renderer);
+}
+BENCHMARK(BM_CpuDistortionRenderer)->Apply(CpuDisplayArguments);
+
+#ifdef CARDBOARD_HOST_OPENGL
+template <int kMajorVersion>
+void BM_OpenGlEsDistortionRenderer(benchmark::State& state) {
+  const DistortionTestScene scene(state.range(0), state.range(1),
+                                  state.range(2) != 0);
+  std::unique_ptr<HeadlessGlContext> context = HeadlessGlContext::Create(
+      kMajorVersion, scene.display_width(), scene.display_height());
+  if (context == nullptr) {
+    state.SkipWithError("No headless OpenGL ES context.");
+    return;
+  }
+  const CardboardOpenGlEsDistortionRendererConfig config = {kGlTexture2D};
+  CardboardDistortionRenderer* renderer =
+      kMajorVersion == 2 ? CardboardOpenGlEs2DistortionRenderer_create(&config)
+                         : CardboardOpenGlEs3DistortionRenderer_create(&config);
+  CardboardDistortionRendererPassConfig pass_config = {};
+  pass_config.color_load_op = kColorLoadOpClearVignette;
+  scene.Configure(renderer, pass_config);
+  const CardboardEyeTextureDescription left_eye = scene.GetEyeDescription(
+      kLeft, context->CreateTexture(scene.eye_width(), scene.eye_height(),
+                                    scene.eye_pixels(kLeft)));
+  const CardboardEyeTextureDescription right_eye = scene.GetEyeDescription(
+      kRight, context->CreateTexture(scene.eye_width(), scene.eye_height(),
+                                     scene.eye_pixels(kRight)));
+  const auto render = [&]() {
+    CardboardDistortionRenderer_renderEyeToDisplay(
+        renderer, context->framebuffer(), 0, 0, scene.display_width(),
+        scene.display_height(), &left_eye, &right_eye);
+    context->Finish();
+  };
+  // The first frame compiles the shaders.
+  render();
+  for (auto _ : state) {
+    render();
+  }
+  CardboardDistortionRenderer_destroy(renderer);
+}
+BENCHMARK_TEMPLATE(BM_OpenGlEsDistortionRenderer, 2)->Apply(DisplayArguments);
+BENCHMARK_TEMPLATE(BM_OpenGlEsDistortionRenderer, 3)->Apply(DisplayArguments);
+#endif
+
+#ifdef CARDBOARD_HOST_VULKAN
+void BM_VulkanDistortionRenderer(benchmark::State& state) {
+  const DistortionTestScene scene(state.range(0), state.range(1),
+                                  state.range(2) != 0);
+  std::unique_ptr<HeadlessVulkanContext> context =
+      HeadlessVulkanContext::Create(scene.display_width(),
+                                    scene.display_height());
+  if (context == nullptr) {
+    state.SkipWithError("No headless Vulkan context.");
+    return;
+  }
+  const CardboardVulkanDistortionRendererConfig config =
+      context->GetRendererConfig();
+  CardboardDistortionRenderer* renderer =
+      CardboardVulkanDistortionRenderer_create(&config);
+  CardboardDistortionRendererPassConfig pass_config = {};
+  pass_config.color_load_op = kColorLoadOpClearVignette;
+  pass_config.vk_swapchain_image_format = context->swapchain_format();
+  scene.Configure(renderer, pass_config);
+  const CardboardEyeTextureDescription left_eye = scene.GetEyeDescription(
+      kLeft, reinterpret_cast<uint64_t>(context->CreateTexture(
+                 scene.eye_width(), scene.eye_height(),
+                 scene.eye_pixels(kLeft))));
+  const CardboardEyeTextureDescription right_eye = scene.GetEyeDescription(
+      kRight, reinterpret_cast<uint64_t>(context->CreateTexture(
+                  scene.eye_width(), scene.eye_height(),
+                  scene.eye_pixels(kRight))));
+  const auto render = [&](CardboardVulkanDistortionRendererTarget* target) {
+    CardboardDistortionRenderer_renderEyeToDisplay(
+        renderer, reinterpret_cast<uint64_t>(target), 0, 0,
+        scene.display_width(), scene.display_height(), &left_eye, &right_eye);
+  };
+  // The first frame creates the pipelines.
+  context->RenderFrame(render, /*pixels=*/nullptr);
+  for (auto _ : state) {
+    if (!context->RenderFrame(render, /*pixels=*/nullptr)) {
+      state.SkipWithError("The frame could not be rendered.");
+      break;
+    }
+  }
+  CardboardDistortionRenderer_destroy(renderer);
+}
+BENCHMARK(BM_VulkanDistortionRenderer)->Apply(DisplayArguments);
+#endif
+
+}  // namespace
+}  // namespace cardboard::testing
@@ -0,0 +1,189 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "tests/distortion_test_scene.h"
+
+#include <cmath>
+#include <cstdlib>
+
+#include "qrcode/cardboard_v1/cardboard_v1.h"
+#include "tests/host_platform.h"
+
+namespace cardboard::testing {
+namespace {
+
+// Physical size of a 6" 16:9 display.
+constexpr float kScreenWidthMeters = 0.1328f;
+constexpr float kScreenHeightMeters = 0.0747f;
+
+// Per channel scales (red, green, blue) of a viewer with lateral chromatic
+// aberration correction.
+constexpr std::array<float, 3> kChromaticAberrationScales = {0.994f, 1.0f,
+                                                             1.008f};
+
+// Sub rectangle of the eye images that is sampled.
+constexpr float kLeftU = 0.05f;
+constexpr float kRightU = 0.95f;
+constexpr float kBottomV = 0.1f;
+constexpr float kTopV = 0.9f;
+
+// Head rotation between the rendering and the display of the eye images. It
+// is large enough to move the texture coordinates of the mesh borders past
+// the eye texture rectangle.
+constexpr float kReprojectionYawRadians = 0.1f;
+
+// Size of the squares of the eye image checkerboards.
+constexpr int kCheckerSize = 24;
+
+// Appends a packed repeated float field to a serialized protobuf message.
+void AppendPackedFloats(int field_number, const std::array<float, 3>& values,
+                        std::vector<uint8_t>* message) {
+  message->push_back(static_cast<uint8_t>(field_number << 3 | 2));
+  message->push_back(static_cast<uint8_t>(values.size() * sizeof(float)));
+  for (float value : values) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    message->insert(message->end(), bytes, bytes + sizeof(float));
+  }
+}
+
+// Fills an eye image with a smooth gradient overlaid with a checkerboard, so
+// that both low and high frequencies are compared.
+std::vector<uint8_t> MakeEyeImage(int width, int height, CardboardEye eye) {
+  std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      uint8_t* pixel = &pixels[(static_cast<size_t>(y) * width + x) * 4];
+      const bool dark = ((x / kCheckerSize) + (y / kCheckerSize)) % 2 != 0;
+      const int shade = dark ? 64 : 0;
+      pixel[0] = static_cast<uint8_t>(255 * x / width - shade / 2 + 32);
+      pixel[1] = static_cast<uint8_t>(255 * y / height * 3 / 4 + shade / 2);
+      pixel[2] = static_cast<uint8_t>(eye == kLeft ? 200 - shade : 60 + shade);
+      pixel[3] = 255;
+    }
+  }
+  return pixels;
+}
+
+}  // namespace
+
+DistortionTestScene::DistortionTestScene(int display_width, int display_height,
+                                         bool chromatic_aberration)
+    : display_width_(display_width),
+      display_height_(display_height),
+      eye_width_(display_width / 2),
+      eye_height_(display_height) {
+  SetScreenSizeInMeters(kScreenWidthMeters, kScreenHeightMeters);
+  std::vector<uint8_t> device_params = qrcode::getCardboardV1DeviceParams();
+  if (chromatic_aberration) {
+    AppendPackedFloats(/*field_number=*/13, kChromaticAberrationScales,
+                       &device_params);
+  }
+  lens_distortion_ = CardboardLensDistortion_create(
+      device_params.data(), static_cast<int>(device_params.size()),
+      display_width, display_height);
+
+  // Yaw of kReprojectionYawRadians around the vertical axis.
+  const float half_angle = kReprojectionYawRadians / 2.0f;
+  const std::array<float, 4> render_orientation = {0.0f, 0.0f, 0.0f, 1.0f};
+  const std::array<float, 4> display_orientation = {
+      0.0f, std::sin(half_angle), 0.0f, std::cos(half_angle)};
+  for (CardboardEye eye : {kLeft, kRight}) {
+    eye_pixels_[eye] = MakeEyeImage(eye_width_, eye_height_, eye);
+    CardboardLensDistortion_getRotationalReprojection(
+        lens_distortion_, eye, render_orientation.data(),
+        display_orientation.data(), reprojections_[eye].data());
+  }
+}
+
+DistortionTestScene::~DistortionTestScene() {
+  CardboardLensDistortion_destroy(lens_distortion_);
+}
+
+void DistortionTestScene::Configure(
+    CardboardDistortionRenderer* renderer,
+    const CardboardDistortionRendererPassConfig& pass_config) const {
+  for (CardboardEye eye : {kLeft, kRight}) {
+    CardboardChromaticMesh mesh;
+    CardboardLensDistortion_getChromaticDistortionMesh(lens_distortion_, eye,
+                                                       &mesh);
+    CardboardDistortionRenderer_setChromaticMesh(renderer, &mesh, eye);
+    CardboardDistortionRenderer_setReprojection(
+        renderer, reprojections_[eye].data(), eye);
+  }
+  CardboardDistortionRenderer_setPassConfig(renderer, &pass_config);
+}
+
+CardboardEyeTextureDescription DistortionTestScene::GetEyeDescription(
+    CardboardEye /*eye*/, uint64_t texture) const {
+  CardboardEyeTextureDescription description;
+  description.texture = texture;
+  description.left_u = kLeftU;
+  description.right_u = kRightU;
+  description.top_v = kTopV;
+  description.bottom_v = kBottomV;
+  return description;
+}
+
+std::vector<uint8_t> DistortionTestScene::RenderReference() const {
+  const CardboardCpuDistortionRendererConfig config = {/*thread_count=*/0};
+  CardboardDistortionRenderer* renderer =
+      CardboardCpuDistortionRenderer_create(&config);
+  CardboardDistortionRendererPassConfig pass_config = {};
+  pass_config.color_load_op = kColorLoadOpClear;
+  Configure(renderer, pass_config);
+
+  std::array<CardboardCpuImage, 2> eye_images;
+  std::array<CardboardEyeTextureDescription, 2> descriptions;
+  for (CardboardEye eye : {kLeft, kRight}) {
+    eye_images[eye] = {const_cast<uint8_t*>(eye_pixels_[eye].data()),
+                       eye_width_, eye_height_, eye_width_ * 4};
+    descriptions[eye] =
+        GetEyeDescription(eye, reinterpret_cast<uint64_t>(&eye_images[eye]));
+  }
+  std::vector<uint8_t> pixels(static_cast<size_t>(display_width_) *
+                              display_height_ * 4);
+  CardboardCpuImage target = {pixels.data(), display_width_, display_height_,
+                              display_width_ * 4};
+  CardboardDistortionRenderer_renderEyeToDisplay(
+      renderer, reinterpret_cast<uint64_t>(&target), 0, 0, display_width_,
+      display_height_, &descriptions[kLeft], &descriptions[kRight]);
+  CardboardDistortionRenderer_destroy(renderer);
+  return pixels;
+}
+
+ImageDifference CompareImages(const std::vector<uint8_t>& image,
+                              const std::vector<uint8_t>& reference,
+                              int outlier_threshold) {
+  ImageDifference difference = {0.0, 0.0};
+  if (image.size() != reference.size() || image.empty()) {
+    return {255.0, 1.0};
+  }
+  int64_t sum = 0;
+  int64_t outliers = 0;
+  int64_t channels = 0;
+  for (size_t i = 0; i < image.size(); i += 4) {
+    for (size_t c = 0; c < 3; ++c) {
+      const int delta = std::abs(image[i + c] - reference[i + c]);
+      sum += delta;
+      outliers += delta > outlier_threshold ? 1 : 0;
+      ++channels;
+    }
+  }
+  difference.mean = static_cast<double>(sum) / channels;
+  difference.outlier_fraction = static_cast<double>(outliers) / channels;
+  return difference;
+}
+
+}  // namespace cardboard::testing
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_TESTS_DISTORTION_TEST_SCENE_H_
+#define CARDBOARD_SDK_TESTS_DISTORTION_TEST_SCENE_H_
+
+#include <stdint.h>
+
+#include <array>
+#include <vector>
+
+#include "include/cardboard.h"
+
+namespace cardboard::testing {
+
+// Fixed input of the distortion renderer tests and benchmarks: a Cardboard v1
+// viewer on a given display, two eye images with distinct patterns, a sub
+// rectangle of the eye images and a rotational reprojection. Images are
+// RGBA with 8 bits per channel, stored bottom row first as in OpenGL.
+class DistortionTestScene {
+ public:
+  // @param display_width Display width in pixels.
+  // @param display_height Display height in pixels.
+  // @param chromatic_aberration Whether the viewer corrects the lateral
+  //        chromatic aberration of its lenses.
+  DistortionTestScene(int display_width, int display_height,
+                      bool chromatic_aberration);
+  ~DistortionTestScene();
+
+  DistortionTestScene(const DistortionTestScene&) = delete;
+  DistortionTestScene& operator=(const DistortionTestScene&) = delete;
+
+  int display_width() const { return display_width_; }
+  int display_height() const { return display_height_; }
+  int eye_width() const { return eye_width_; }
+  int eye_height() const { return eye_height_; }
+  const std::vector<uint8_t>& eye_pixels(CardboardEye eye) const {
+    return eye_pixels_[eye];
+  }
+  const std::array<float, 9>& reprojection(CardboardEye eye) const {
+    return reprojections_[eye];
+  }
+
+  // Sets the meshes, the reprojections and @p pass_config to @p renderer.
+  void Configure(
+      CardboardDistortionRenderer* renderer,
+      const CardboardDistortionRendererPassConfig& pass_config) const;
+
+  // Returns the description of an eye texture whose contents are
+  // eye_pixels(@p eye).
+  CardboardEyeTextureDescription GetEyeDescription(CardboardEye eye,
+                                                   uint64_t texture) const;
+
+  // Renders the scene to the whole display with the CPU distortion renderer.
+  std::vector<uint8_t> RenderReference() const;
+
+ private:
+  int display_width_;
+  int display_height_;
+  int eye_width_;
+  int eye_height_;
+  CardboardLensDistortion* lens_distortion_;
+  std::array<std::vector<uint8_t>, 2> eye_pixels_;
+  std::array<std::array<float, 9>, 2> reprojections_;
+};
+
+// Differences between two images of the same size.
+struct ImageDifference {
+  // Mean absolute difference of the color channels.
+  double mean;
+  // Fraction of the color channels that differ by more than the threshold
+  // given to CompareImages().
+  double outlier_fraction;
+};
+
+// Compares the RGB channels of two RGBA images of the same size.
+//
+// @param outlier_threshold Channel difference above which a channel counts as
+//        an outlier.
+ImageDifference CompareImages(const std::vector<uint8_t>& image,
+                              const std::vector<uint8_t>& reference,
+                              int outlier_threshold);
+
+}  // namespace cardboard::testing
+
+#endif  // CARDBOARD_SDK_TESTS_DISTORTION_TEST_SCENE_H_
@@ -0,0 +1,198 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "eye_buffer_reuse.h"
+
+#include <array>
+#include <cstdint>
+
+#include "distortion_renderer.h"
+#include "gtest/gtest.h"
+#include "head_tracker.h"
+#include "include/cardboard.h"
+#include "lens_distortion.h"
+#include "qrcode/cardboard_v1/cardboard_v1.h"
+#include "util/clock.h"
+#include "util/reprojection.h"
+#include "util/rotation.h"
+
+namespace cardboard {
+namespace {
+
+constexpr int kDisplayWidth = 1920;
+constexpr int kDisplayHeight = 1080;
+constexpr float kMaxReprojectionAngle = 0.1f;
+constexpr float kReprojectionTolerance = 1e-4f;
+
+// Distortion renderer recording the last pass.
+class RecordingDistortionRenderer : public DistortionRenderer {
+ public:
+  void SetMesh(const CardboardChromaticMesh* /*mesh*/,
+               CardboardEye /*eye*/) override {}
+
+  void SetReprojection(const std::array<float, 9>& reprojection,
+                       CardboardEye eye) override {
+    reprojections_[eye] = reprojection;
+  }
+
+  void SetPassConfig(
+      const CardboardDistortionRendererPassConfig& /*pass_config*/) override {}
+
+  void RenderEyeToDisplay(
+      uint64_t /*target*/, int /*x*/, int /*y*/, int /*width*/,
+      int /*height*/, const CardboardEyeTextureDescription* left_eye,
+      const CardboardEyeTextureDescription* /*right_eye*/) override {
+    left_texture_ = left_eye->texture;
+    pass_count_++;
+  }
+
+  const std::array<float, 9>& reprojection(CardboardEye eye) const {
+    return reprojections_[eye];
+  }
+  uint64_t left_texture() const { return left_texture_; }
+  int pass_count() const { return pass_count_; }
+
+ private:
+  std::array<std::array<float, 9>, 2> reprojections_{IdentityReprojection(),
+                                                     IdentityReprojection()};
+  uint64_t left_texture_ = 0;
+  int pass_count_ = 0;
+};
+
+CardboardEyeTextureDescription EyeTexture(uint64_t texture) {
+  return {texture, 0.0f, 1.0f, 1.0f, 0.0f};
+}
+
+void ExpectIdentity(const std::array<float, 9>& reprojection) {
+  const std::array<float, 9> identity = IdentityReprojection();
+  for (int i = 0; i < 9; i++) {
+    EXPECT_NEAR(reprojection[i], identity[i], kReprojectionTolerance)
+        << "at index " << i;
+  }
+}
+
+class EyeBufferReuseTest : public ::testing::Test {
+ protected:
+  EyeBufferReuseTest()
+      : lens_distortion_(qrcode::getCardboardV1DeviceParams().data(),
+                         static_cast<int>(
+                             qrcode::getCardboardV1DeviceParams().size()),
+                         kDisplayWidth, kDisplayHeight),
+        reuse_(&head_tracker_, &lens_distortion_, &renderer_, GetConfig()) {}
+
+  static CardboardEyeBufferReuseConfig GetConfig() {
+    CardboardEyeBufferReuseConfig config{};
+    config.width = kDisplayWidth;
+    config.height = kDisplayHeight;
+    config.max_reprojection_angle = kMaxReprojectionAngle;
+    return config;
+  }
+
+  std::array<float, 4> GetApplicationOrientation(
+      CardboardViewportOrientation viewport_orientation) {
+    std::array<float, 3> position;
+    std::array<float, 4> orientation;
+    head_tracker_.GetPose(GetBootTimeNano(), viewport_orientation, position,
+                          orientation);
+    return orientation;
+  }
+
+  HeadTracker head_tracker_;
+  LensDistortion lens_distortion_;
+  RecordingDistortionRenderer renderer_;
+  EyeBufferReuse reuse_;
+};
+
+TEST_F(EyeBufferReuseTest, NeedsFrameUntilOneIsSubmitted) {
+  EXPECT_TRUE(reuse_.IsNewFrameNeeded());
+  EXPECT_FALSE(reuse_.RenderEyeToDisplay(1));
+  EXPECT_EQ(renderer_.pass_count(), 0);
+
+  reuse_.SubmitFrame(EyeTexture(1), EyeTexture(2),
+                     GetApplicationOrientation(kLandscapeLeft));
+  EXPECT_FALSE(reuse_.IsNewFrameNeeded());
+  EXPECT_TRUE(reuse_.RenderEyeToDisplay(1));
+  EXPECT_TRUE(reuse_.RenderEyeToDisplay(1));
+  EXPECT_EQ(renderer_.pass_count(), 2);
+  EXPECT_EQ(renderer_.left_texture(), 1u);
+}
+
+// The head does not move, so a frame rendered with a head orientation turned
+// by the maximum angle from the current one is the oldest one still reused.
+TEST_F(EyeBufferReuseTest, NeedsFrameAboveMaxReprojectionAngle) {
+  const std::array<float, 4> orientation =
+      GetApplicationOrientation(kLandscapeLeft);
+  const Rotation current = Rotation::FromQuaternion(Rotation::QuaternionType(
+      orientation[0], orientation[1], orientation[2], orientation[3]));
+  for (float delta : {-1e-3f, 1e-3f}) {
+    const Rotation::QuaternionType turned =
+        (Rotation::FromAxisAndAngle(Vector3(0, 1, 0),
+                                    kMaxReprojectionAngle + delta) *
+         current)
+            .GetQuaternion();
+    reuse_.SubmitFrame(EyeTexture(1), EyeTexture(2),
+                       {static_cast<float>(turned[0]),
+                        static_cast<float>(turned[1]),
+                        static_cast<float>(turned[2]),
+                        static_cast<float>(turned[3])});
+    EXPECT_EQ(reuse_.IsNewFrameNeeded(), delta > 0) << delta;
+  }
+}
+
+// Parameter: viewport orientation of the application.
+class EyeBufferReuseOrientationTest
+    : public EyeBufferReuseTest,
+      public ::testing::WithParamInterface<CardboardViewportOrientation> {};
+
+// The head does not move, so the reused frame must be displayed as rendered,
+// whatever the viewport orientation of the application, and the application
+// poses must be left untouched.
+TEST_P(EyeBufferReuseOrientationTest, FollowsApplicationViewportOrientation) {
+  const std::array<float, 4> render_orientation =
+      GetApplicationOrientation(GetParam());
+  reuse_.SubmitFrame(EyeTexture(1), EyeTexture(2), render_orientation);
+
+  EXPECT_FALSE(reuse_.IsNewFrameNeeded());
+  ASSERT_TRUE(reuse_.RenderEyeToDisplay(1));
+  ExpectIdentity(renderer_.reprojection(kLeft));
+  ExpectIdentity(renderer_.reprojection(kRight));
+
+  const std::array<float, 4> orientation =
+      GetApplicationOrientation(GetParam());
+  for (int i = 0; i < 4; i++) {
+    EXPECT_NEAR(orientation[i], render_orientation[i], kReprojectionTolerance);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AllViewportOrientations, EyeBufferReuseOrientationTest,
+    ::testing::Values(kLandscapeLeft, kLandscapeRight, kPortrait,
+                      kPortraitUpsideDown),
+    [](const ::testing::TestParamInfo<CardboardViewportOrientation>& info) {
+      switch (info.param) {
+        case kLandscapeLeft:
+          return "LandscapeLeft";
+        case kLandscapeRight:
+          return "LandscapeRight";
+        case kPortrait:
+          return "Portrait";
+        case kPortraitUpsideDown:
+        default:
+          return "PortraitUpsideDown";
+      }
+    });
+
+}  // namespace
+}  // namespace cardboard
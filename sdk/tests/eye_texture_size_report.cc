@@ -0,0 +1,105 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// Reports the pixels saved by sizing the eye textures with
+// LensDistortion::GetRecommendedEyeTextureSize() instead of half of the
+// display, for each viewer profile on a few common displays.
+//
+// Usage: eye_texture_size_report [viewer_uri...]
+//
+// Viewer URIs are QR code contents. Only URIs that embed the device parameters
+// (and the Cardboard Viewer v1 URI, the default) resolve, since short URLs
+// need a network connection.
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "lens_distortion.h"
+#include "qrcode/device_params_uri.h"
+#include "tests/host_platform.h"
+
+namespace cardboard::testing {
+namespace {
+
+struct Display {
+  const char* name;
+  int width;
+  int height;
+  float width_meters;
+  float height_meters;
+};
+
+constexpr std::array<Display, 3> kDisplays = {{
+    {"5.5\" 1920x1080", 1920, 1080, 0.1218f, 0.0685f},
+    {"6.4\" 2400x1080", 2400, 1080, 0.1486f, 0.0669f},
+    {"6.1\" 3120x1440", 3120, 1440, 0.1407f, 0.0650f},
+}};
+
+constexpr std::array<float, 4> kCoverages = {1.0f, 0.95f, 0.9f, 0.75f};
+
+void Report(const std::vector<uint8_t>& device_params) {
+  for (const Display& display : kDisplays) {
+    SetScreenSizeInMeters(display.width_meters, display.height_meters);
+    const LensDistortion lens_distortion(
+        device_params.data(), static_cast<int>(device_params.size()),
+        display.width, display.height);
+    const int uniform_pixels = display.width / 2 * display.height;
+    std::printf("  %s, half display %dx%d\n", display.name, display.width / 2,
+                display.height);
+    for (float coverage : kCoverages) {
+      const std::array<int, 2> size =
+          lens_distortion.GetRecommendedEyeTextureSize(kLeft, coverage);
+      const int pixels = size[0] * size[1];
+      std::printf("    coverage %3.0f%%: %5dx%-5d %+6.1f%% pixels\n",
+                  coverage * 100.0f, size[0], size[1],
+                  100.0f * (pixels - uniform_pixels) / uniform_pixels);
+    }
+  }
+}
+
+int Main(int argc, char** argv) {
+  std::vector<std::string> uris(argv + 1, argv + argc);
+  if (uris.empty()) {
+    uris.push_back("https://g.co/cardboard");
+  }
+  const qrcode::RedirectFetcher offline_fetcher =
+      [](const std::string& /*url*/, std::string* /*location*/) {
+        return qrcode::DeviceParamsUriStatus::kConnectionError;
+      };
+
+  int status = 0;
+  for (const std::string& uri : uris) {
+    std::vector<uint8_t> device_params;
+    if (qrcode::getDeviceParamsFromUri(uri, offline_fetcher, &device_params) !=
+        qrcode::DeviceParamsUriStatus::kOk) {
+      std::fprintf(stderr, "%s: cannot resolve the viewer profile\n",
+                   uri.c_str());
+      status = 1;
+      continue;
+    }
+    std::printf("%s\n", uri.c_str());
+    Report(device_params);
+  }
+  return status;
+}
+
+}  // namespace
+}  // namespace cardboard::testing
+
+int main(int argc, char** argv) {
+  return cardboard::testing::Main(argc, argv);
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "frame_timing.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace cardboard {
+namespace {
+
+constexpr int64_t kNanosPerMilli = 1000000;
+constexpr double k60HzPeriodNanos = 1e9 / 60.0;
+constexpr double k90HzPeriodNanos = 1e9 / 90.0;
+
+// Arbitrary boot time at which the traces start.
+constexpr int64_t kTraceStartNanos = 123456789012;
+
+// Generates the vsync timestamps a display would report: an ideal vsync train
+// with a given period, drift and timestamp jitter.
+class VsyncTrace {
+ public:
+  // @param period_ns Initial refresh period.
+  // @param drift_ppm Period change per vsync, in parts per million.
+  // @param jitter_ns Maximum timestamp error, uniformly distributed.
+  VsyncTrace(double period_ns, double drift_ppm, int64_t jitter_ns)
+      : period_ns_(period_ns),
+        drift_ppm_(drift_ppm),
+        vsync_ns_(kTraceStartNanos),
+        jitter_(-jitter_ns, jitter_ns),
+        random_(/*seed=*/42) {}
+
+  // Advances to the next ideal vsync.
+  void Advance() {
+    vsync_ns_ += period_ns_;
+    period_ns_ *= 1.0 + drift_ppm_ * 1e-6;
+  }
+
+  // Returns the reported timestamp of the current vsync.
+  int64_t Report() {
+    return static_cast<int64_t>(vsync_ns_) + jitter_(random_);
+  }
+
+  double vsync_ns() const { return vsync_ns_; }
+  double period_ns() const { return period_ns_; }
+
+ private:
+  double period_ns_;
+  const double drift_ppm_;
+  double vsync_ns_;
+  std::uniform_int_distribution<int64_t> jitter_;
+  std::mt19937 random_;
+};
+
+TEST(FrameTimingTest, FallsBackToFixedPredictionUntilLocked) {
+  FrameTiming frame_timing;
+  const int64_t now_ns = kTraceStartNanos;
+
+  EXPECT_FALSE(frame_timing.IsLocked());
+  EXPECT_EQ(frame_timing.GetNextVsync(now_ns), now_ns);
+  EXPECT_EQ(frame_timing.GetPredictedDisplayTime(now_ns),
+            now_ns + 50 * kNanosPerMilli);
+
+  VsyncTrace trace(k60HzPeriodNanos, 0.0, 0);
+  for (int i = 0; i < 3; ++i, trace.Advance()) {
+    frame_timing.AddVsyncTimestamp(trace.Report());
+    EXPECT_FALSE(frame_timing.IsLocked());
+  }
+  frame_timing.AddVsyncTimestamp(trace.Report());
+  EXPECT_TRUE(frame_timing.IsLocked());
+}
+
+TEST(FrameTimingTest, TracksJitteredVsyncs) {
+  FrameTiming frame_timing;
+  VsyncTrace trace(k60HzPeriodNanos, 0.0, kNanosPerMilli / 2);
+  for (int i = 0; i < 300; ++i, trace.Advance()) {
+    frame_timing.AddVsyncTimestamp(trace.Report());
+  }
+
+  EXPECT_NEAR(frame_timing.GetRefreshPeriod(), k60HzPeriodNanos, 50000);
+
+  // Rendering starts a third of a period after the latest vsync.
+  const double latest_vsync_ns = trace.vsync_ns() - trace.period_ns();
+  const int64_t now_ns = latest_vsync_ns + trace.period_ns() / 3;
+  EXPECT_NEAR(frame_timing.GetNextVsync(now_ns), trace.vsync_ns(),
+              kNanosPerMilli / 2);
+  EXPECT_NEAR(frame_timing.GetPredictedDisplayTime(now_ns),
+              trace.vsync_ns() + 2 * trace.period_ns(), kNanosPerMilli);
+}
+
+TEST(FrameTimingTest, FollowsRefreshRateDrift) {
+  FrameTiming frame_timing;
+  VsyncTrace trace(k90HzPeriodNanos, /*drift_ppm=*/5.0, kNanosPerMilli / 4);
+  for (int i = 0; i < 1000; ++i, trace.Advance()) {
+    frame_timing.AddVsyncTimestamp(trace.Report());
+  }
+
+  // The period has drifted by about 0.5%, i.e. ~55 us.
+  EXPECT_GT(trace.period_ns() - k90HzPeriodNanos, 50000);
+  EXPECT_NEAR(frame_timing.GetRefreshPeriod(), trace.period_ns(), 20000);
+  const int64_t now_ns = trace.vsync_ns() - trace.period_ns() / 2;
+  EXPECT_NEAR(frame_timing.GetNextVsync(now_ns), trace.vsync_ns(),
+              kNanosPerMilli / 2);
+}
+
+TEST(FrameTimingTest, ToleratesMissedAndOutOfOrderVsyncs) {
+  FrameTiming frame_timing;
+  VsyncTrace trace(k60HzPeriodNanos, 0.0, kNanosPerMilli / 4);
+  std::mt19937 random(/*seed=*/7);
+  std::uniform_int_distribution<int> event(0, 9);
+  int64_t previous_ns = 0;
+  for (int i = 0; i < 400; ++i, trace.Advance()) {
+    const int roll = event(random);
+    if (roll < 2) {
+      // The vsync is not reported.
+      continue;
+    }
+    const int64_t timestamp_ns = trace.Report();
+    if (roll == 2 && previous_ns != 0) {
+      // A stale timestamp is reported again before the current one.
+      frame_timing.AddVsyncTimestamp(previous_ns);
+    }
+    frame_timing.AddVsyncTimestamp(timestamp_ns);
+    previous_ns = timestamp_ns;
+  }
+
+  EXPECT_TRUE(frame_timing.IsLocked());
+  EXPECT_NEAR(frame_timing.GetRefreshPeriod(), k60HzPeriodNanos, 50000);
+  const int64_t now_ns = trace.vsync_ns() - trace.period_ns() / 2;
+  EXPECT_NEAR(frame_timing.GetNextVsync(now_ns), trace.vsync_ns(),
+              kNanosPerMilli / 2);
+}
+
+TEST(FrameTimingTest, RestartsAfterLongGapKeepingPeriod) {
+  FrameTiming frame_timing;
+  VsyncTrace trace(k90HzPeriodNanos, 0.0, 0);
+  for (int i = 0; i < 100; ++i, trace.Advance()) {
+    frame_timing.AddVsyncTimestamp(trace.Report());
+  }
+  ASSERT_TRUE(frame_timing.IsLocked());
+
+  // The app is paused for a second, with a phase shift on resume.
+  for (int i = 0; i < 90; ++i) {
+    trace.Advance();
+  }
+  const int64_t resume_ns = trace.Report() + 3 * kNanosPerMilli;
+  frame_timing.AddVsyncTimestamp(resume_ns);
+
+  EXPECT_FALSE(frame_timing.IsLocked());
+  EXPECT_NEAR(frame_timing.GetRefreshPeriod(), k90HzPeriodNanos, 1000);
+
+  for (int i = 1; i < 4; ++i) {
+    frame_timing.AddVsyncTimestamp(resume_ns + i * k90HzPeriodNanos);
+  }
+  EXPECT_TRUE(frame_timing.IsLocked());
+  EXPECT_NEAR(frame_timing.GetNextVsync(resume_ns + 3 * k90HzPeriodNanos + 1),
+              resume_ns + 4 * k90HzPeriodNanos, 100000);
+}
+
+TEST(FrameTimingTest, ResetDiscardsEstimates) {
+  FrameTiming frame_timing;
+  VsyncTrace trace(k90HzPeriodNanos, 0.0, 0);
+  for (int i = 0; i < 10; ++i, trace.Advance()) {
+    frame_timing.AddVsyncTimestamp(trace.Report());
+  }
+  ASSERT_TRUE(frame_timing.IsLocked());
+
+  frame_timing.Reset();
+
+  EXPECT_FALSE(frame_timing.IsLocked());
+  EXPECT_NEAR(frame_timing.GetRefreshPeriod(), k60HzPeriodNanos, 1);
+}
+
+}  // namespace
+}  // namespace cardboard
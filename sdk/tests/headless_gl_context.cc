@@ -0,0 +1,146 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "tests/headless_gl_context.h"
+
+#include <EGL/eglext.h>
+#include <GLES2/gl2ext.h>
+
+#include "util/logging.h"
+
+namespace cardboard::testing {
+namespace {
+
+EGLDisplay GetSurfacelessDisplay() {
+  const auto get_platform_display =
+      reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+          eglGetProcAddress("eglGetPlatformDisplayEXT"));
+  if (get_platform_display == nullptr) {
+    return EGL_NO_DISPLAY;
+  }
+  return get_platform_display(EGL_PLATFORM_SURFACELESS_MESA,
+                              EGL_DEFAULT_DISPLAY, nullptr);
+}
+
+}  // namespace
+
+std::unique_ptr<HeadlessGlContext> HeadlessGlContext::Create(int major_version,
+                                                             int width,
+                                                             int height) {
+  EGLDisplay display = GetSurfacelessDisplay();
+  if (display == EGL_NO_DISPLAY ||
+      !eglInitialize(display, nullptr, nullptr)) {
+    CARDBOARD_LOGE("Cannot initialize a surfaceless EGL display.");
+    return nullptr;
+  }
+
+  const EGLint renderable_type =
+      major_version >= 3 ? EGL_OPENGL_ES3_BIT_KHR : EGL_OPENGL_ES2_BIT;
+  const EGLint config_attributes[] = {EGL_RENDERABLE_TYPE, renderable_type,
+                                      EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+                                      EGL_NONE};
+  EGLConfig config;
+  EGLint config_count = 0;
+  if (!eglBindAPI(EGL_OPENGL_ES_API) ||
+      !eglChooseConfig(display, config_attributes, &config, 1,
+                       &config_count) ||
+      config_count == 0) {
+    CARDBOARD_LOGE("No EGL configuration supports OpenGL ES %d.",
+                   major_version);
+    eglTerminate(display);
+    return nullptr;
+  }
+
+  const EGLint context_attributes[] = {EGL_CONTEXT_MAJOR_VERSION,
+                                       major_version, EGL_NONE};
+  EGLContext context =
+      eglCreateContext(display, config, EGL_NO_CONTEXT, context_attributes);
+  if (context == EGL_NO_CONTEXT ||
+      !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+    CARDBOARD_LOGE("Cannot make a surfaceless OpenGL ES %d context current.",
+                   major_version);
+    if (context != EGL_NO_CONTEXT) {
+      eglDestroyContext(display, context);
+    }
+    eglTerminate(display);
+    return nullptr;
+  }
+
+  std::unique_ptr<HeadlessGlContext> gl_context(
+      new HeadlessGlContext(display, context, width, height));
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    CARDBOARD_LOGE("The offscreen framebuffer is incomplete.");
+    return nullptr;
+  }
+  return gl_context;
+}
+
+HeadlessGlContext::HeadlessGlContext(EGLDisplay display, EGLContext context,
+                                     int width, int height)
+    : display_(display), context_(context), width_(width), height_(height) {
+  glGenRenderbuffers(1, &color_renderbuffer_);
+  glBindRenderbuffer(GL_RENDERBUFFER, color_renderbuffer_);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8_OES, width, height);
+  glGenRenderbuffers(1, &depth_renderbuffer_);
+  glBindRenderbuffer(GL_RENDERBUFFER, depth_renderbuffer_);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16, width, height);
+
+  glGenFramebuffers(1, &framebuffer_);
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                            GL_RENDERBUFFER, color_renderbuffer_);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                            GL_RENDERBUFFER, depth_renderbuffer_);
+}
+
+HeadlessGlContext::~HeadlessGlContext() {
+  glDeleteTextures(static_cast<GLsizei>(textures_.size()), textures_.data());
+  glDeleteFramebuffers(1, &framebuffer_);
+  glDeleteRenderbuffers(1, &color_renderbuffer_);
+  glDeleteRenderbuffers(1, &depth_renderbuffer_);
+  eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  eglDestroyContext(display_, context_);
+  eglTerminate(display_);
+}
+
+GLuint HeadlessGlContext::CreateTexture(int width, int height,
+                                        const std::vector<uint8_t>& pixels) {
+  GLuint texture;
+  glGenTextures(1, &texture);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA,
+               GL_UNSIGNED_BYTE, pixels.data());
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  textures_.push_back(texture);
+  return texture;
+}
+
+void HeadlessGlContext::Finish() const { glFinish(); }
+
+std::vector<uint8_t> HeadlessGlContext::ReadPixels() const {
+  std::vector<uint8_t> pixels(static_cast<size_t>(width_) * height_ * 4);
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, 0, width_, height_, GL_RGBA, GL_UNSIGNED_BYTE,
+               pixels.data());
+  return pixels;
+}
+
+}  // namespace cardboard::testing
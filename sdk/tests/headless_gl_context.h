@@ -0,0 +1,78 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_TESTS_HEADLESS_GL_CONTEXT_H_
+#define CARDBOARD_SDK_TESTS_HEADLESS_GL_CONTEXT_H_
+
+#include <EGL/egl.h>
+#include <GLES2/gl2.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+namespace cardboard::testing {
+
+// OpenGL ES context without any window, e.g. on Mesa llvmpipe, made current on
+// the calling thread. It renders to an RGBA8 framebuffer of a given size.
+class HeadlessGlContext {
+ public:
+  // Creates the context on a surfaceless EGL display.
+  //
+  // @param major_version OpenGL ES major version, 2 or 3.
+  // @param width Framebuffer width in pixels.
+  // @param height Framebuffer height in pixels.
+  // @return nullptr when no such context can be created.
+  static std::unique_ptr<HeadlessGlContext> Create(int major_version,
+                                                   int width, int height);
+
+  ~HeadlessGlContext();
+
+  HeadlessGlContext(const HeadlessGlContext&) = delete;
+  HeadlessGlContext& operator=(const HeadlessGlContext&) = delete;
+
+  // Framebuffer to render to.
+  GLuint framebuffer() const { return framebuffer_; }
+
+  // Creates an RGBA8 texture with bilinear filtering and clamp to edge
+  // addressing. The texture is deleted with the context.
+  //
+  // @param pixels RGBA pixels, bottom row first.
+  GLuint CreateTexture(int width, int height,
+                       const std::vector<uint8_t>& pixels);
+
+  // Waits for the rendering to complete.
+  void Finish() const;
+
+  // Reads the framebuffer back as RGBA pixels, bottom row first.
+  std::vector<uint8_t> ReadPixels() const;
+
+ private:
+  HeadlessGlContext(EGLDisplay display, EGLContext context, int width,
+                    int height);
+
+  EGLDisplay display_;
+  EGLContext context_;
+  int width_;
+  int height_;
+  GLuint framebuffer_ = 0;
+  GLuint color_renderbuffer_ = 0;
+  GLuint depth_renderbuffer_ = 0;
+  std::vector<GLuint> textures_;
+};
+
+}  // namespace cardboard::testing
+
+#endif  // CARDBOARD_SDK_TESTS_HEADLESS_GL_CONTEXT_H_
@@ -0,0 +1,489 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "tests/headless_vulkan_context.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "util/logging.h"
+
+namespace cardboard::testing {
+namespace {
+
+using namespace cardboard::rendering;  // NOLINT: Vulkan entry points.
+
+constexpr uint64_t kTimeoutNanos = 5000000000;
+
+// Returns the index of a memory type allowed by @p type_bits that has all
+// @p properties, or -1.
+int FindMemoryType(VkPhysicalDevice physical_device, uint32_t type_bits,
+                   VkMemoryPropertyFlags properties) {
+  VkPhysicalDeviceMemoryProperties memory_properties;
+  vkGetPhysicalDeviceMemoryProperties(physical_device, &memory_properties);
+  for (uint32_t i = 0; i < memory_properties.memoryTypeCount; i++) {
+    if ((type_bits & (1u << i)) != 0 &&
+        (memory_properties.memoryTypes[i].propertyFlags & properties) ==
+            properties) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+// Records a layout transition of a whole color image.
+void RecordImageBarrier(VkCommandBuffer command_buffer, VkImage image,
+                        VkImageLayout old_layout, VkImageLayout new_layout,
+                        VkAccessFlags src_access, VkAccessFlags dst_access,
+                        VkPipelineStageFlags src_stage,
+                        VkPipelineStageFlags dst_stage) {
+  const VkImageMemoryBarrier barrier = {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+      .srcAccessMask = src_access,
+      .dstAccessMask = dst_access,
+      .oldLayout = old_layout,
+      .newLayout = new_layout,
+      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .image = image,
+      .subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1},
+  };
+  vkCmdPipelineBarrier(command_buffer, src_stage, dst_stage, 0, 0, nullptr, 0,
+                       nullptr, 1, &barrier);
+}
+
+}  // namespace
+
+std::unique_ptr<HeadlessVulkanContext> HeadlessVulkanContext::Create(
+    int width, int height) {
+  if (!LoadVulkan()) {
+    CARDBOARD_LOGE("Cannot load the Vulkan library.");
+    return nullptr;
+  }
+  std::unique_ptr<HeadlessVulkanContext> context(
+      new HeadlessVulkanContext(width, height));
+  if (!context->Initialize()) {
+    return nullptr;
+  }
+  return context;
+}
+
+HeadlessVulkanContext::HeadlessVulkanContext(int width, int height)
+    : width_(width), height_(height) {}
+
+HeadlessVulkanContext::~HeadlessVulkanContext() {
+  if (device_ != VK_NULL_HANDLE) {
+    vkDeviceWaitIdle(device_);
+    for (VkImage texture : textures_) {
+      vkDestroyImage(device_, texture, nullptr);
+    }
+    for (VkDeviceMemory memory : texture_memories_) {
+      vkFreeMemory(device_, memory, nullptr);
+    }
+    vkDestroyBuffer(device_, readback_buffer_, nullptr);
+    vkFreeMemory(device_, readback_memory_, nullptr);
+    vkDestroyFence(device_, fence_, nullptr);
+    vkDestroyCommandPool(device_, command_pool_, nullptr);
+    vkDestroySwapchainKHR(device_, swapchain_, nullptr);
+    vkDestroyDevice(device_, nullptr);
+  }
+  if (instance_ != VK_NULL_HANDLE) {
+    vkDestroySurfaceKHR(instance_, surface_, nullptr);
+    vkDestroyInstance(instance_, nullptr);
+  }
+}
+
+bool HeadlessVulkanContext::Initialize() {
+  const char* instance_extensions[] = {VK_KHR_SURFACE_EXTENSION_NAME,
+                                       VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME};
+  const VkApplicationInfo application_info = {
+      .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+      .pApplicationName = "cardboard_host_tests",
+      .apiVersion = VK_API_VERSION_1_1,
+  };
+  const VkInstanceCreateInfo instance_info = {
+      .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+      .pApplicationInfo = &application_info,
+      .enabledExtensionCount = 2,
+      .ppEnabledExtensionNames = instance_extensions,
+  };
+  if (vkCreateInstance(&instance_info, nullptr, &instance_) != VK_SUCCESS) {
+    CARDBOARD_LOGE("Cannot create a Vulkan instance with headless surfaces.");
+    instance_ = VK_NULL_HANDLE;
+    return false;
+  }
+
+  const auto create_headless_surface =
+      reinterpret_cast<PFN_vkCreateHeadlessSurfaceEXT>(
+          vkGetInstanceProcAddr(instance_, "vkCreateHeadlessSurfaceEXT"));
+  const VkHeadlessSurfaceCreateInfoEXT surface_info = {
+      .sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT,
+  };
+  if (create_headless_surface == nullptr ||
+      create_headless_surface(instance_, &surface_info, nullptr, &surface_) !=
+          VK_SUCCESS) {
+    CARDBOARD_LOGE("Cannot create a Vulkan headless surface.");
+    return false;
+  }
+
+  // Picks the first device with a queue family that renders and presents.
+  uint32_t device_count = 0;
+  vkEnumeratePhysicalDevices(instance_, &device_count, nullptr);
+  std::vector<VkPhysicalDevice> devices(device_count);
+  vkEnumeratePhysicalDevices(instance_, &device_count, devices.data());
+  for (VkPhysicalDevice device : devices) {
+    uint32_t family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(device, &family_count, nullptr);
+    std::vector<VkQueueFamilyProperties> families(family_count);
+    vkGetPhysicalDeviceQueueFamilyProperties(device, &family_count,
+                                             families.data());
+    for (uint32_t i = 0; i < family_count; i++) {
+      VkBool32 can_present = VK_FALSE;
+      vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface_, &can_present);
+      if ((families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0 &&
+          can_present == VK_TRUE) {
+        physical_device_ = device;
+        queue_family_index_ = i;
+        break;
+      }
+    }
+    if (physical_device_ != VK_NULL_HANDLE) {
+      break;
+    }
+  }
+  if (physical_device_ == VK_NULL_HANDLE) {
+    CARDBOARD_LOGE("No Vulkan device presents to headless surfaces.");
+    return false;
+  }
+
+  const float queue_priority = 1.0f;
+  const VkDeviceQueueCreateInfo queue_info = {
+      .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+      .queueFamilyIndex = queue_family_index_,
+      .queueCount = 1,
+      .pQueuePriorities = &queue_priority,
+  };
+  const char* device_extensions[] = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+  const VkDeviceCreateInfo device_info = {
+      .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+      .queueCreateInfoCount = 1,
+      .pQueueCreateInfos = &queue_info,
+      .enabledExtensionCount = 1,
+      .ppEnabledExtensionNames = device_extensions,
+  };
+  if (vkCreateDevice(physical_device_, &device_info, nullptr, &device_) !=
+      VK_SUCCESS) {
+    CARDBOARD_LOGE("Cannot create a Vulkan device.");
+    device_ = VK_NULL_HANDLE;
+    return false;
+  }
+  vkGetDeviceQueue(device_, queue_family_index_, 0, &queue_);
+
+  // The eye textures are sRGB, so is the swapchain.
+  uint32_t format_count = 0;
+  vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device_, surface_,
+                                       &format_count, nullptr);
+  std::vector<VkSurfaceFormatKHR> formats(format_count);
+  vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device_, surface_,
+                                       &format_count, formats.data());
+  for (const VkSurfaceFormatKHR& format : formats) {
+    if (format.format == VK_FORMAT_R8G8B8A8_SRGB ||
+        format.format == VK_FORMAT_B8G8R8A8_SRGB) {
+      swapchain_format_ = format.format;
+      break;
+    }
+  }
+  VkSurfaceCapabilitiesKHR capabilities;
+  vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physical_device_, surface_,
+                                            &capabilities);
+  const VkImageUsageFlags usage =
+      VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+  if (swapchain_format_ == VK_FORMAT_UNDEFINED ||
+      (capabilities.supportedUsageFlags & usage) != usage) {
+    CARDBOARD_LOGE("The headless surface has no readable sRGB format.");
+    return false;
+  }
+
+  const VkSwapchainCreateInfoKHR swapchain_info = {
+      .sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
+      .surface = surface_,
+      .minImageCount = std::max(2u, capabilities.minImageCount),
+      .imageFormat = swapchain_format_,
+      .imageColorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR,
+      .imageExtent = {static_cast<uint32_t>(width_),
+                      static_cast<uint32_t>(height_)},
+      .imageArrayLayers = 1,
+      .imageUsage = usage,
+      .imageSharingMode = VK_SHARING_MODE_EXCLUSIVE,
+      .preTransform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR,
+      .compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR,
+      .presentMode = VK_PRESENT_MODE_FIFO_KHR,
+      .clipped = VK_TRUE,
+  };
+  if (vkCreateSwapchainKHR(device_, &swapchain_info, nullptr, &swapchain_) !=
+      VK_SUCCESS) {
+    CARDBOARD_LOGE("Cannot create a headless swapchain.");
+    swapchain_ = VK_NULL_HANDLE;
+    return false;
+  }
+  uint32_t image_count = 0;
+  vkGetSwapchainImagesKHR(device_, swapchain_, &image_count, nullptr);
+  swapchain_images_.resize(image_count);
+  vkGetSwapchainImagesKHR(device_, swapchain_, &image_count,
+                          swapchain_images_.data());
+
+  const VkCommandPoolCreateInfo pool_info = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+      .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+      .queueFamilyIndex = queue_family_index_,
+  };
+  const VkFenceCreateInfo fence_info = {
+      .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+  };
+  if (vkCreateCommandPool(device_, &pool_info, nullptr, &command_pool_) !=
+          VK_SUCCESS ||
+      vkCreateFence(device_, &fence_info, nullptr, &fence_) != VK_SUCCESS) {
+    return false;
+  }
+  const VkCommandBufferAllocateInfo command_buffer_info = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+      .commandPool = command_pool_,
+      .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+      .commandBufferCount = 1,
+  };
+  if (vkAllocateCommandBuffers(device_, &command_buffer_info,
+                               &command_buffer_) != VK_SUCCESS) {
+    return false;
+  }
+  return CreateBuffer(static_cast<VkDeviceSize>(width_) * height_ * 4,
+                      VK_BUFFER_USAGE_TRANSFER_DST_BIT, &readback_buffer_,
+                      &readback_memory_);
+}
+
+bool HeadlessVulkanContext::CreateBuffer(VkDeviceSize size,
+                                         VkBufferUsageFlags usage,
+                                         VkBuffer* buffer,
+                                         VkDeviceMemory* memory) {
+  const VkBufferCreateInfo buffer_info = {
+      .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+      .size = size,
+      .usage = usage,
+      .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+  };
+  if (vkCreateBuffer(device_, &buffer_info, nullptr, buffer) != VK_SUCCESS) {
+    *buffer = VK_NULL_HANDLE;
+    return false;
+  }
+  VkMemoryRequirements requirements;
+  vkGetBufferMemoryRequirements(device_, *buffer, &requirements);
+  const int memory_type =
+      FindMemoryType(physical_device_, requirements.memoryTypeBits,
+                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                         VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  const VkMemoryAllocateInfo allocate_info = {
+      .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+      .allocationSize = requirements.size,
+      .memoryTypeIndex = static_cast<uint32_t>(memory_type),
+  };
+  if (memory_type < 0 ||
+      vkAllocateMemory(device_, &allocate_info, nullptr, memory) !=
+          VK_SUCCESS) {
+    *memory = VK_NULL_HANDLE;
+    return false;
+  }
+  return vkBindBufferMemory(device_, *buffer, *memory, 0) == VK_SUCCESS;
+}
+
+bool HeadlessVulkanContext::SubmitAndWait() {
+  const VkSubmitInfo submit_info = {
+      .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+      .commandBufferCount = 1,
+      .pCommandBuffers = &command_buffer_,
+  };
+  vkResetFences(device_, 1, &fence_);
+  return vkQueueSubmit(queue_, 1, &submit_info, fence_) == VK_SUCCESS &&
+         vkWaitForFences(device_, 1, &fence_, VK_TRUE, kTimeoutNanos) ==
+             VK_SUCCESS;
+}
+
+CardboardVulkanDistortionRendererConfig
+HeadlessVulkanContext::GetRendererConfig() const {
+  CardboardVulkanDistortionRendererConfig config = {};
+  config.physical_device = reinterpret_cast<uint64_t>(&physical_device_);
+  config.logical_device = reinterpret_cast<uint64_t>(&device_);
+  config.vk_swapchain = reinterpret_cast<uint64_t>(&swapchain_);
+  return config;
+}
+
+VkImage HeadlessVulkanContext::CreateTexture(
+    int width, int height, const std::vector<uint8_t>& pixels) {
+  const VkImageCreateInfo image_info = {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+      .imageType = VK_IMAGE_TYPE_2D,
+      .format = VK_FORMAT_R8G8B8A8_SRGB,
+      .extent = {static_cast<uint32_t>(width), static_cast<uint32_t>(height),
+                 1},
+      .mipLevels = 1,
+      .arrayLayers = 1,
+      .samples = VK_SAMPLE_COUNT_1_BIT,
+      .tiling = VK_IMAGE_TILING_OPTIMAL,
+      .usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+      .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+      .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+  };
+  VkImage image;
+  if (vkCreateImage(device_, &image_info, nullptr, &image) != VK_SUCCESS) {
+    return VK_NULL_HANDLE;
+  }
+  textures_.push_back(image);
+  VkMemoryRequirements requirements;
+  vkGetImageMemoryRequirements(device_, image, &requirements);
+  const int memory_type =
+      FindMemoryType(physical_device_, requirements.memoryTypeBits,
+                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  const VkMemoryAllocateInfo allocate_info = {
+      .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+      .allocationSize = requirements.size,
+      .memoryTypeIndex = static_cast<uint32_t>(memory_type),
+  };
+  VkDeviceMemory memory;
+  if (memory_type < 0 ||
+      vkAllocateMemory(device_, &allocate_info, nullptr, &memory) !=
+          VK_SUCCESS) {
+    return VK_NULL_HANDLE;
+  }
+  texture_memories_.push_back(memory);
+  vkBindImageMemory(device_, image, memory, 0);
+
+  VkBuffer staging_buffer;
+  VkDeviceMemory staging_memory;
+  if (!CreateBuffer(pixels.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                    &staging_buffer, &staging_memory)) {
+    return VK_NULL_HANDLE;
+  }
+  void* data;
+  vkMapMemory(device_, staging_memory, 0, pixels.size(), 0, &data);
+  memcpy(data, pixels.data(), pixels.size());
+  vkUnmapMemory(device_, staging_memory);
+
+  const VkCommandBufferBeginInfo begin_info = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+  };
+  vkBeginCommandBuffer(command_buffer_, &begin_info);
+  RecordImageBarrier(command_buffer_, image, VK_IMAGE_LAYOUT_UNDEFINED,
+                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0,
+                     VK_ACCESS_TRANSFER_WRITE_BIT,
+                     VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                     VK_PIPELINE_STAGE_TRANSFER_BIT);
+  const VkBufferImageCopy region = {
+      .imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+      .imageExtent = image_info.extent,
+  };
+  vkCmdCopyBufferToImage(command_buffer_, staging_buffer, image,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+  RecordImageBarrier(command_buffer_, image,
+                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                     VK_IMAGE_LAYOUT_GENERAL, VK_ACCESS_TRANSFER_WRITE_BIT,
+                     VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                     VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+  vkEndCommandBuffer(command_buffer_);
+  const bool uploaded = SubmitAndWait();
+  vkDestroyBuffer(device_, staging_buffer, nullptr);
+  vkFreeMemory(device_, staging_memory, nullptr);
+  return uploaded ? image : VK_NULL_HANDLE;
+}
+
+bool HeadlessVulkanContext::RenderFrame(
+    const std::function<void(CardboardVulkanDistortionRendererTarget*)>&
+        render,
+    std::vector<uint8_t>* pixels) {
+  uint32_t image_index;
+  vkResetFences(device_, 1, &fence_);
+  if (vkAcquireNextImageKHR(device_, swapchain_, kTimeoutNanos, VK_NULL_HANDLE,
+                            fence_, &image_index) != VK_SUCCESS ||
+      vkWaitForFences(device_, 1, &fence_, VK_TRUE, kTimeoutNanos) !=
+          VK_SUCCESS) {
+    CARDBOARD_LOGE("Cannot acquire a swapchain image.");
+    return false;
+  }
+  const VkImage image = swapchain_images_[image_index];
+
+  const VkCommandBufferBeginInfo begin_info = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+  };
+  vkBeginCommandBuffer(command_buffer_, &begin_info);
+  const VkRenderPass no_render_pass = VK_NULL_HANDLE;
+  CardboardVulkanDistortionRendererTarget target = {
+      .vk_render_pass = reinterpret_cast<uint64_t>(&no_render_pass),
+      .vk_command_buffer = reinterpret_cast<uint64_t>(&command_buffer_),
+      .swapchain_image_index = image_index,
+  };
+  render(&target);
+
+  // The distortion renderer leaves the image ready to be presented.
+  RecordImageBarrier(command_buffer_, image, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                     VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                     VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                     VK_ACCESS_TRANSFER_READ_BIT,
+                     VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                     VK_PIPELINE_STAGE_TRANSFER_BIT);
+  const VkBufferImageCopy region = {
+      .imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+      .imageExtent = {static_cast<uint32_t>(width_),
+                      static_cast<uint32_t>(height_), 1},
+  };
+  vkCmdCopyImageToBuffer(command_buffer_, image,
+                         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                         readback_buffer_, 1, &region);
+  RecordImageBarrier(command_buffer_, image,
+                     VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                     VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                     VK_ACCESS_TRANSFER_READ_BIT, 0,
+                     VK_PIPELINE_STAGE_TRANSFER_BIT,
+                     VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+  vkEndCommandBuffer(command_buffer_);
+  if (!SubmitAndWait()) {
+    CARDBOARD_LOGE("The distortion pass did not complete.");
+    return false;
+  }
+
+  // The rendering is complete, so the image is presented without semaphores.
+  const VkPresentInfoKHR present_info = {
+      .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+      .swapchainCount = 1,
+      .pSwapchains = &swapchain_,
+      .pImageIndices = &image_index,
+  };
+  vkQueuePresentKHR(queue_, &present_info);
+
+  if (pixels != nullptr) {
+    const size_t size = static_cast<size_t>(width_) * height_ * 4;
+    pixels->resize(size);
+    void* data;
+    vkMapMemory(device_, readback_memory_, 0, size, 0, &data);
+    memcpy(pixels->data(), data, size);
+    vkUnmapMemory(device_, readback_memory_);
+    if (swapchain_format_ == VK_FORMAT_B8G8R8A8_SRGB) {
+      for (size_t i = 0; i < size; i += 4) {
+        std::swap((*pixels)[i], (*pixels)[i + 2]);
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace cardboard::testing
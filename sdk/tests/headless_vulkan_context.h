@@ -0,0 +1,107 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_TESTS_HEADLESS_VULKAN_CONTEXT_H_
+#define CARDBOARD_SDK_TESTS_HEADLESS_VULKAN_CONTEXT_H_
+
+#include <stdint.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "include/cardboard.h"
+#include "rendering/android/vulkan/android_vulkan_loader.h"
+
+namespace cardboard::testing {
+
+// Vulkan device without any window, e.g. lavapipe or SwiftShader, with a
+// swapchain on a VK_EXT_headless_surface. Swapchain images are read back
+// after each frame.
+class HeadlessVulkanContext {
+ public:
+  // @param width Swapchain width in pixels.
+  // @param height Swapchain height in pixels.
+  // @return nullptr when no such context can be created.
+  static std::unique_ptr<HeadlessVulkanContext> Create(int width, int height);
+
+  ~HeadlessVulkanContext();
+
+  HeadlessVulkanContext(const HeadlessVulkanContext&) = delete;
+  HeadlessVulkanContext& operator=(const HeadlessVulkanContext&) = delete;
+
+  // Returns the distortion renderer configuration for this context. It points
+  // to members of this object.
+  CardboardVulkanDistortionRendererConfig GetRendererConfig() const;
+
+  // Index of the queue family the command buffers are submitted to.
+  uint32_t queue_family_index() const { return queue_family_index_; }
+
+  // Format of the swapchain images.
+  VkFormat swapchain_format() const { return swapchain_format_; }
+
+  // Creates a sampled R8G8B8A8_SRGB image in the VK_IMAGE_LAYOUT_GENERAL
+  // layout, as the distortion renderer expects. The image is destroyed with
+  // the context.
+  //
+  // @param pixels RGBA pixels, first row at v = 0.
+  VkImage CreateTexture(int width, int height,
+                        const std::vector<uint8_t>& pixels);
+
+  // Acquires a swapchain image, records @p render into a command buffer
+  // followed by the copy of the image to host memory, submits it, waits for
+  // it and presents the image.
+  //
+  // @param render Records the distortion pass for the given target.
+  // @param pixels When not null, receives the RGBA pixels of the swapchain
+  //        image in memory order. Its first row is at y = -1 in normalized
+  //        device coordinates, as in the OpenGL ES and CPU renderer outputs.
+  // @return false on failure.
+  bool RenderFrame(
+      const std::function<void(CardboardVulkanDistortionRendererTarget*)>&
+          render,
+      std::vector<uint8_t>* pixels);
+
+ private:
+  HeadlessVulkanContext(int width, int height);
+
+  bool Initialize();
+  bool CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
+                    VkBuffer* buffer, VkDeviceMemory* memory);
+  bool SubmitAndWait();
+
+  int width_;
+  int height_;
+  VkInstance instance_ = VK_NULL_HANDLE;
+  VkSurfaceKHR surface_ = VK_NULL_HANDLE;
+  VkPhysicalDevice physical_device_ = VK_NULL_HANDLE;
+  VkDevice device_ = VK_NULL_HANDLE;
+  uint32_t queue_family_index_ = 0;
+  VkQueue queue_ = VK_NULL_HANDLE;
+  VkSwapchainKHR swapchain_ = VK_NULL_HANDLE;
+  VkFormat swapchain_format_ = VK_FORMAT_UNDEFINED;
+  std::vector<VkImage> swapchain_images_;
+  VkCommandPool command_pool_ = VK_NULL_HANDLE;
+  VkCommandBuffer command_buffer_ = VK_NULL_HANDLE;
+  VkFence fence_ = VK_NULL_HANDLE;
+  VkBuffer readback_buffer_ = VK_NULL_HANDLE;
+  VkDeviceMemory readback_memory_ = VK_NULL_HANDLE;
+  std::vector<VkImage> textures_;
+  std::vector<VkDeviceMemory> texture_memories_;
+};
+
+}  // namespace cardboard::testing
+
+#endif  // CARDBOARD_SDK_TESTS_HEADLESS_VULKAN_CONTEXT_H_
@@ -0,0 +1,200 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "tests/host_platform.h"
+
+#include <functional>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "qr_code.h"
+#include "qrcode/saved_device_params.h"
+#include "screen_params.h"
+#include "sensors/calibration_storage.h"
+#include "sensors/sensor_event_producer.h"
+#include "util/logging.h"
+
+namespace cardboard {
+namespace {
+
+std::mutex host_mutex;
+float screen_width_meters = 0.1328f;
+float screen_height_meters = 0.0747f;
+std::optional<CardboardHeadTrackerCalibration> saved_calibration;
+std::vector<uint8_t> saved_device_params;
+int saved_device_params_read_count = 0;
+std::function<void()> saved_device_params_read_hook;
+
+// Callback registered by the polling producer of each sensor type.
+template <typename DataType>
+const std::function<void(DataType)>*& PollingCallback() {
+  static const std::function<void(DataType)>* callback = nullptr;
+  return callback;
+}
+
+template <typename DataType>
+bool Inject(const DataType& data) {
+  std::lock_guard<std::mutex> lock(host_mutex);
+  const std::function<void(DataType)>* callback = PollingCallback<DataType>();
+  if (callback == nullptr) {
+    return false;
+  }
+  (*callback)(data);
+  return true;
+}
+
+}  // namespace
+
+namespace screen_params {
+void getScreenSizeInMeters(int /*width_pixels*/, int /*height_pixels*/,
+                           float* out_width_meters, float* out_height_meters) {
+  std::lock_guard<std::mutex> lock(host_mutex);
+  *out_width_meters = screen_width_meters;
+  *out_height_meters = screen_height_meters;
+}
+}  // namespace screen_params
+
+namespace sensors {
+std::string getMotionSensorId() { return "host"; }
+
+bool readCalibration(CardboardHeadTrackerCalibration* calibration) {
+  std::lock_guard<std::mutex> lock(host_mutex);
+  if (!saved_calibration) {
+    return false;
+  }
+  *calibration = *saved_calibration;
+  return true;
+}
+
+void writeCalibration(const CardboardHeadTrackerCalibration& calibration) {
+  std::lock_guard<std::mutex> lock(host_mutex);
+  saved_calibration = calibration;
+}
+}  // namespace sensors
+
+namespace qrcode {
+std::vector<uint8_t> getCurrentSavedDeviceParams() {
+  std::vector<uint8_t> device_params;
+  std::function<void()> hook;
+  {
+    std::lock_guard<std::mutex> lock(host_mutex);
+    ++saved_device_params_read_count;
+    device_params = saved_device_params;
+    hook = saved_device_params_read_hook;
+  }
+  if (hook) {
+    hook();
+  }
+  return device_params;
+}
+
+// There is no QR code scanner on host: the scan completes without saving
+// anything.
+void scanQrCodeAndSaveDeviceParams() { notifyDeviceParamsChanged(); }
+
+void saveDeviceParams(const uint8_t* /*uri*/, int /*size*/) {
+  CARDBOARD_LOGE("Saving device parameters from a URI is not supported.");
+}
+}  // namespace qrcode
+
+// Host sensors only produce the samples injected by the tests.
+template <typename DataType>
+struct SensorEventProducer<DataType>::EventProducer {};
+
+template <typename DataType>
+SensorEventProducer<DataType>::SensorEventProducer()
+    : event_producer_(new EventProducer()), on_event_callback_(nullptr) {}
+
+template <typename DataType>
+SensorEventProducer<DataType>::~SensorEventProducer() {
+  StopSensorPolling();
+}
+
+template <typename DataType>
+void SensorEventProducer<DataType>::StartSensorPolling(
+    const std::function<void(DataType)>* on_event_callback) {
+  std::lock_guard<std::mutex> lock(host_mutex);
+  on_event_callback_ = on_event_callback;
+  StartSensorPollingLocked();
+}
+
+template <typename DataType>
+void SensorEventProducer<DataType>::StopSensorPolling() {
+  std::lock_guard<std::mutex> lock(host_mutex);
+  StopSensorPollingLocked();
+}
+
+template <typename DataType>
+void SensorEventProducer<DataType>::PauseSensorPolling() {
+  StopSensorPolling();
+}
+
+template <typename DataType>
+void SensorEventProducer<DataType>::StartSensorPollingLocked() {
+  PollingCallback<DataType>() = on_event_callback_;
+}
+
+template <typename DataType>
+void SensorEventProducer<DataType>::StopSensorPollingLocked() {
+  if (PollingCallback<DataType>() == on_event_callback_) {
+    PollingCallback<DataType>() = nullptr;
+  }
+}
+
+template <typename DataType>
+void SensorEventProducer<DataType>::WorkFn() {}
+
+template class SensorEventProducer<AccelerometerData>;
+template class SensorEventProducer<GyroscopeData>;
+
+namespace testing {
+
+void SetScreenSizeInMeters(float width_meters, float height_meters) {
+  std::lock_guard<std::mutex> lock(host_mutex);
+  screen_width_meters = width_meters;
+  screen_height_meters = height_meters;
+}
+
+bool InjectAccelerometerData(const AccelerometerData& data) {
+  return Inject(data);
+}
+
+bool InjectGyroscopeData(const GyroscopeData& data) { return Inject(data); }
+
+void ClearSavedCalibration() {
+  std::lock_guard<std::mutex> lock(host_mutex);
+  saved_calibration.reset();
+}
+
+void SetSavedDeviceParams(const std::vector<uint8_t>& encoded_device_params) {
+  std::lock_guard<std::mutex> lock(host_mutex);
+  saved_device_params = encoded_device_params;
+}
+
+int GetSavedDeviceParamsReadCount() {
+  std::lock_guard<std::mutex> lock(host_mutex);
+  return saved_device_params_read_count;
+}
+
+void SetSavedDeviceParamsReadHook(std::function<void()> hook) {
+  std::lock_guard<std::mutex> lock(host_mutex);
+  saved_device_params_read_hook = std::move(hook);
+}
+
+}  // namespace testing
+}  // namespace cardboard
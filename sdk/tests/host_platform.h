@@ -0,0 +1,76 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_TESTS_HOST_PLATFORM_H_
+#define CARDBOARD_SDK_TESTS_HOST_PLATFORM_H_
+
+#include <stdint.h>
+
+#include <functional>
+#include <vector>
+
+#include "sensors/accelerometer_data.h"
+#include "sensors/gyroscope_data.h"
+
+// Host replacements of the platform hooks of the SDK (screen size, sensors
+// and calibration storage) so that the platform independent sources can be
+// unit tested on a desktop machine.
+namespace cardboard::testing {
+
+// Sets the physical screen size reported by
+// screen_params::getScreenSizeInMeters(). Defaults to a 6" 16:9 phone screen.
+//
+// @param width_meters Screen width in meters.
+// @param height_meters Screen height in meters.
+void SetScreenSizeInMeters(float width_meters, float height_meters);
+
+// Delivers @p data to the accelerometer callback registered through
+// SensorEventProducer::StartSensorPolling(), if any.
+//
+// @param data Sample to deliver.
+// @return false when no callback is registered.
+bool InjectAccelerometerData(const AccelerometerData& data);
+
+// Delivers @p data to the gyroscope callback registered through
+// SensorEventProducer::StartSensorPolling(), if any.
+//
+// @param data Sample to deliver.
+// @return false when no callback is registered.
+bool InjectGyroscopeData(const GyroscopeData& data);
+
+// Discards the calibration saved through sensors::writeCalibration().
+void ClearSavedCalibration();
+
+// Sets the device parameters returned by
+// qrcode::getCurrentSavedDeviceParams(). It does not notify the change.
+//
+// @param encoded_device_params Device parameters serialized using
+//                              cardboard_device.proto, or empty for none.
+void SetSavedDeviceParams(const std::vector<uint8_t>& encoded_device_params);
+
+// Returns the number of times qrcode::getCurrentSavedDeviceParams() has read
+// the saved device parameters.
+int GetSavedDeviceParamsReadCount();
+
+// Sets a function that qrcode::getCurrentSavedDeviceParams() calls after
+// copying the saved device parameters, without holding any lock, to simulate a
+// slow storage read.
+//
+// @param hook Function to call, or nullptr for none.
+void SetSavedDeviceParamsReadHook(std::function<void()> hook);
+
+}  // namespace cardboard::testing
+
+#endif  // CARDBOARD_SDK_TESTS_HOST_PLATFORM_H_
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// Latency of the lens distortion set up for a Cardboard v1 viewer: decoding
+// the device parameters alone, and the whole CardboardLensDistortion_create()
+// call, which also computes the field of view and both distortion meshes.
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "device_params/device_params.h"
+#include "include/cardboard.h"
+#include "qrcode/cardboard_v1/cardboard_v1.h"
+#include "tests/host_platform.h"
+
+namespace cardboard::testing {
+namespace {
+
+// Arguments: display width and height.
+void DisplayArguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"width", "height"});
+  benchmark->Args({1920, 1080});
+  benchmark->Args({3120, 1440});
+  benchmark->Unit(benchmark::kMicrosecond);
+}
+
+void BM_DeviceParamsParseFromArray(benchmark::State& state) {
+  const std::vector<uint8_t> encoded = qrcode::getCardboardV1DeviceParams();
+  device_params::DeviceParams params;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(params.ParseFromArray(
+        encoded.data(), static_cast<int>(encoded.size())));
+  }
+}
+BENCHMARK(BM_DeviceParamsParseFromArray);
+
+void BM_CardboardLensDistortion_create(benchmark::State& state) {
+  const std::vector<uint8_t> encoded = qrcode::getCardboardV1DeviceParams();
+  for (auto _ : state) {
+    CardboardLensDistortion* lens_distortion = CardboardLensDistortion_create(
+        encoded.data(), static_cast<int>(encoded.size()),
+        static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    benchmark::DoNotOptimize(lens_distortion);
+    CardboardLensDistortion_destroy(lens_distortion);
+  }
+}
+BENCHMARK(BM_CardboardLensDistortion_create)->Apply(DisplayArguments);
+
+// Same as above, without decoding the device parameters.
+void BM_CardboardLensDistortion_createFromDeviceParams(
+    benchmark::State& state) {
+  SetSavedDeviceParams(qrcode::getCardboardV1DeviceParams());
+  CardboardDeviceParams* device_params =
+      CardboardQrCode_acquireSavedDeviceParams();
+  for (auto _ : state) {
+    CardboardLensDistortion* lens_distortion =
+        CardboardLensDistortion_createFromDeviceParams(
+            device_params, static_cast<int>(state.range(0)),
+            static_cast<int>(state.range(1)));
+    benchmark::DoNotOptimize(lens_distortion);
+    CardboardLensDistortion_destroy(lens_distortion);
+  }
+  CardboardDeviceParams_release(device_params);
+  SetSavedDeviceParams({});
+}
+BENCHMARK(BM_CardboardLensDistortion_createFromDeviceParams)
+    ->Apply(DisplayArguments);
+
+}  // namespace
+}  // namespace cardboard::testing
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "lens_distortion.h"
+
+#include <array>
+
+#include "gtest/gtest.h"
+#include "include/cardboard.h"
+#include "qrcode/cardboard_v1/cardboard_v1.h"
+#include "tests/host_platform.h"
+
+namespace cardboard {
+namespace {
+
+constexpr int kDisplayWidth = 2400;
+constexpr int kDisplayHeight = 1080;
+
+class LensDistortionTest : public ::testing::Test {
+ protected:
+  LensDistortionTest()
+      : lens_distortion_(qrcode::getCardboardV1DeviceParams().data(),
+                         static_cast<int>(
+                             qrcode::getCardboardV1DeviceParams().size()),
+                         kDisplayWidth, kDisplayHeight) {}
+
+  LensDistortion lens_distortion_;
+};
+
+TEST_F(LensDistortionTest, RecommendedSizeGrowsWithCoverage) {
+  std::array<int, 2> previous_size = {0, 0};
+  for (float coverage : {0.0f, 0.5f, 0.75f, 0.9f, 1.0f}) {
+    const std::array<int, 2> size =
+        lens_distortion_.GetRecommendedEyeTextureSize(kLeft, coverage);
+    EXPECT_GT(size[0], 0);
+    EXPECT_GT(size[1], 0);
+    EXPECT_GE(size[0], previous_size[0]) << "at coverage " << coverage;
+    EXPECT_GE(size[1], previous_size[1]) << "at coverage " << coverage;
+    previous_size = size;
+  }
+}
+
+TEST_F(LensDistortionTest, FullCoverageIsSizedForTheDensestRegion) {
+  // The lens center needs the most texels, so covering the whole texture costs
+  // noticeably more than leaving its densest tenth slightly undersampled, even
+  // with the cap at half the display.
+  const std::array<int, 2> full_size =
+      lens_distortion_.GetRecommendedEyeTextureSize(kLeft, 1.0f);
+  const std::array<int, 2> default_size =
+      lens_distortion_.GetRecommendedEyeTextureSize(kLeft);
+  EXPECT_GT(full_size[0] * full_size[1],
+            default_size[0] * default_size[1] * 21 / 20);
+}
+
+TEST_F(LensDistortionTest, DefaultCoverageSavesPixels) {
+  const std::array<int, 2> size =
+      lens_distortion_.GetRecommendedEyeTextureSize(kLeft);
+  EXPECT_LT(size[0] * size[1], kDisplayWidth / 2 * kDisplayHeight);
+}
+
+// On a 5.5" 1920x1080 display, the lenses resolve more than the display
+// pixels over 90% of the texture area, which would exceed half the display.
+TEST(LensDistortionDisplayTest, RecommendedSizeIsCappedAtHalfTheDisplay) {
+  constexpr int kWidth = 1920;
+  constexpr int kHeight = 1080;
+  testing::SetScreenSizeInMeters(0.1218f, 0.0685f);
+  const LensDistortion lens_distortion(
+      qrcode::getCardboardV1DeviceParams().data(),
+      static_cast<int>(qrcode::getCardboardV1DeviceParams().size()), kWidth,
+      kHeight);
+  testing::SetScreenSizeInMeters(0.1328f, 0.0747f);
+  for (float coverage : {0.9f, 1.0f}) {
+    const std::array<int, 2> size =
+        lens_distortion.GetRecommendedEyeTextureSize(kLeft, coverage);
+    EXPECT_LE(size[0], kWidth / 2) << "at coverage " << coverage;
+    EXPECT_LE(size[1], kHeight) << "at coverage " << coverage;
+  }
+}
+
+TEST_F(LensDistortionTest, CoverageIsClamped) {
+  EXPECT_EQ(lens_distortion_.GetRecommendedEyeTextureSize(kLeft, 2.0f),
+            lens_distortion_.GetRecommendedEyeTextureSize(kLeft, 1.0f));
+  EXPECT_EQ(lens_distortion_.GetRecommendedEyeTextureSize(kLeft, -1.0f),
+            lens_distortion_.GetRecommendedEyeTextureSize(kLeft, 0.0f));
+}
+
+TEST_F(LensDistortionTest, RecommendedSizeIsSymmetric) {
+  for (float coverage : {0.5f, 0.9f, 1.0f}) {
+    const std::array<int, 2> left =
+        lens_distortion_.GetRecommendedEyeTextureSize(kLeft, coverage);
+    const std::array<int, 2> right =
+        lens_distortion_.GetRecommendedEyeTextureSize(kRight, coverage);
+    EXPECT_NEAR(left[0], right[0], 1) << "at coverage " << coverage;
+    EXPECT_NEAR(left[1], right[1], 1) << "at coverage " << coverage;
+  }
+}
+
+// Viewers without chromatic aberration correction sample every color channel
+// at the plain mesh UV coordinates.
+TEST_F(LensDistortionTest, ChromaticMeshWithoutCorrection) {
+  for (CardboardEye eye : {kLeft, kRight}) {
+    const CardboardMesh mesh = lens_distortion_.GetDistortionMesh(eye);
+    const CardboardChromaticMesh chromatic_mesh =
+        lens_distortion_.GetChromaticDistortionMesh(eye);
+    EXPECT_EQ(chromatic_mesh.mesh.indices, mesh.indices);
+    EXPECT_EQ(chromatic_mesh.mesh.n_indices, mesh.n_indices);
+    EXPECT_EQ(chromatic_mesh.mesh.vertices, mesh.vertices);
+    EXPECT_EQ(chromatic_mesh.mesh.uvs, mesh.uvs);
+    EXPECT_EQ(chromatic_mesh.mesh.n_vertices, mesh.n_vertices);
+    EXPECT_EQ(chromatic_mesh.red_uvs, nullptr);
+    EXPECT_EQ(chromatic_mesh.blue_uvs, nullptr);
+  }
+}
+
+}  // namespace
+}  // namespace cardboard
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <memory>
+#include <string>
+#include <tuple>
+
+#include "gtest/gtest.h"
+#include "include/cardboard.h"
+#include "tests/distortion_test_scene.h"
+#include "tests/headless_gl_context.h"
+
+namespace cardboard::testing {
+namespace {
+
+constexpr int kDisplayWidth = 640;
+constexpr int kDisplayHeight = 360;
+
+// The GPU renderers interpolate the texture coordinates and filter the eye
+// textures with less precision than the CPU renderer, so a few texels on the
+// checkerboard edges may differ significantly.
+constexpr double kMaxMeanDifference = 1.0;
+constexpr int kOutlierThreshold = 16;
+constexpr double kMaxOutlierFraction = 0.005;
+
+// Parameters: OpenGL ES major version, whether the viewer corrects the
+// chromatic aberration and whether the program is prewarmed, so that the
+// renderer restores it from its binary when supported.
+class OpenGlDistortionRendererTest
+    : public ::testing::TestWithParam<std::tuple<int, bool, bool>> {};
+
+TEST_P(OpenGlDistortionRendererTest, MatchesCpuRenderer) {
+  const auto [major_version, chromatic_aberration, prewarm] = GetParam();
+  const DistortionTestScene scene(kDisplayWidth, kDisplayHeight,
+                                  chromatic_aberration);
+  std::unique_ptr<HeadlessGlContext> context =
+      HeadlessGlContext::Create(major_version, kDisplayWidth, kDisplayHeight);
+  if (context == nullptr) {
+    GTEST_SKIP() << "No headless OpenGL ES " << major_version << " context.";
+  }
+
+  const CardboardOpenGlEsDistortionRendererConfig config = {kGlTexture2D};
+  if (prewarm) {
+    while (glGetError() != GL_NO_ERROR) {
+    }
+    if (major_version == 2) {
+      CardboardOpenGlEs2DistortionRenderer_prewarm(&config);
+    } else {
+      CardboardOpenGlEs3DistortionRenderer_prewarm(&config);
+    }
+    // Detecting the program binary support must not raise any error.
+    EXPECT_EQ(glGetError(), static_cast<GLenum>(GL_NO_ERROR));
+  }
+  CardboardDistortionRenderer* renderer =
+      major_version == 2 ? CardboardOpenGlEs2DistortionRenderer_create(&config)
+                         : CardboardOpenGlEs3DistortionRenderer_create(&config);
+  ASSERT_NE(renderer, nullptr);
+  CardboardDistortionRendererPassConfig pass_config = {};
+  pass_config.color_load_op = kColorLoadOpClear;
+  scene.Configure(renderer, pass_config);
+
+  const CardboardEyeTextureDescription left_eye = scene.GetEyeDescription(
+      kLeft, context->CreateTexture(scene.eye_width(), scene.eye_height(),
+                                    scene.eye_pixels(kLeft)));
+  const CardboardEyeTextureDescription right_eye = scene.GetEyeDescription(
+      kRight, context->CreateTexture(scene.eye_width(), scene.eye_height(),
+                                     scene.eye_pixels(kRight)));
+  CardboardDistortionRenderer_renderEyeToDisplay(
+      renderer, context->framebuffer(), 0, 0, kDisplayWidth, kDisplayHeight,
+      &left_eye, &right_eye);
+  const std::vector<uint8_t> pixels = context->ReadPixels();
+  CardboardDistortionRenderer_destroy(renderer);
+
+  const ImageDifference difference =
+      CompareImages(pixels, scene.RenderReference(), kOutlierThreshold);
+  EXPECT_LT(difference.mean, kMaxMeanDifference);
+  EXPECT_LT(difference.outlier_fraction, kMaxOutlierFraction);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AllVersions, OpenGlDistortionRendererTest,
+    ::testing::Combine(::testing::Values(2, 3), ::testing::Bool(),
+                       ::testing::Bool()),
+    [](const ::testing::TestParamInfo<std::tuple<int, bool, bool>>& info) {
+      return "Es" + std::to_string(std::get<0>(info.param)) +
+             (std::get<1>(info.param) ? "Chromatic" : "") +
+             (std::get<2>(info.param) ? "Prewarmed" : "");
+    });
+
+}  // namespace
+}  // namespace cardboard::testing
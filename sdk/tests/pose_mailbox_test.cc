@@ -0,0 +1,223 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "unity/xr_unity_plugin/pose_mailbox.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>  // NOLINT
+
+#include "gtest/gtest.h"
+#include "include/cardboard.h"
+
+namespace cardboard::unity {
+namespace {
+
+constexpr int kConcurrentPoseCount = 200000;
+
+// Returns a pose whose values all derive from @p value, so that a pose mixing
+// two publications is detected.
+HeadPose MakePose(uint64_t value) {
+  const float v = static_cast<float>(value);
+  return {0, {v, v + 1.0f, v + 2.0f}, {v + 3.0f, v + 4.0f, v + 5.0f, v + 6.0f},
+          static_cast<CardboardViewportOrientation>(value % 4)};
+}
+
+void ExpectPose(const HeadPose& pose, uint64_t value) {
+  const HeadPose expected = MakePose(value);
+  EXPECT_EQ(pose.position, expected.position);
+  EXPECT_EQ(pose.orientation, expected.orientation);
+  EXPECT_EQ(pose.viewport_orientation, expected.viewport_orientation);
+}
+
+TEST(PoseMailboxTest, ReadsUnpublishedPose) {
+  PoseMailbox mailbox;
+  HeadPose pose;
+  EXPECT_EQ(mailbox.Read(0, &pose), PoseMailbox::ReadResult::kNotPublished);
+  EXPECT_EQ(mailbox.Read(1, &pose), PoseMailbox::ReadResult::kNotPublished);
+
+  const uint64_t sequence = mailbox.Publish(MakePose(10));
+  EXPECT_EQ(mailbox.Read(sequence + 1, &pose),
+            PoseMailbox::ReadResult::kNotPublished);
+}
+
+TEST(PoseMailboxTest, ReadsExactPoseAfterNewerOnes) {
+  PoseMailbox mailbox;
+  const uint64_t first = mailbox.Publish(MakePose(10));
+  const uint64_t second = mailbox.Publish(MakePose(20));
+  EXPECT_EQ(second, first + 1);
+  for (int i = 2; i < PoseMailbox::kCapacity; ++i) {
+    mailbox.Publish(MakePose(30 + i));
+  }
+
+  HeadPose pose;
+  ASSERT_EQ(mailbox.Read(first, &pose), PoseMailbox::ReadResult::kSuccess);
+  EXPECT_EQ(pose.sequence, first);
+  ExpectPose(pose, 10);
+  ASSERT_EQ(mailbox.Read(second, &pose), PoseMailbox::ReadResult::kSuccess);
+  EXPECT_EQ(pose.sequence, second);
+  ExpectPose(pose, 20);
+}
+
+TEST(PoseMailboxTest, FailsWhenPoseWasOverwritten) {
+  PoseMailbox mailbox;
+  const uint64_t first = mailbox.Publish(MakePose(10));
+  for (int i = 0; i < PoseMailbox::kCapacity; ++i) {
+    mailbox.Publish(MakePose(20 + i));
+  }
+
+  HeadPose pose = MakePose(99);
+  EXPECT_EQ(mailbox.Read(first, &pose), PoseMailbox::ReadResult::kOverwritten);
+  // The output is left untouched.
+  ExpectPose(pose, 99);
+  EXPECT_EQ(mailbox.Read(first + 1, &pose),
+            PoseMailbox::ReadResult::kSuccess);
+}
+
+TEST(PoseMailboxTest, ClearDropsPublishedPoses) {
+  PoseMailbox mailbox;
+  const uint64_t first = mailbox.Publish(MakePose(10));
+  mailbox.Clear();
+
+  HeadPose pose;
+  EXPECT_EQ(mailbox.Read(first, &pose), PoseMailbox::ReadResult::kOverwritten);
+  const uint64_t second = mailbox.Publish(MakePose(20));
+  EXPECT_GT(second, first);
+  ASSERT_EQ(mailbox.Read(second, &pose), PoseMailbox::ReadResult::kSuccess);
+  ExpectPose(pose, 20);
+}
+
+TEST(PoseMailboxTest, ReadsFramesInOrder) {
+  PoseMailbox mailbox;
+  HeadPose pose;
+  EXPECT_EQ(mailbox.ReadNextFrame(&pose),
+            PoseMailbox::ReadResult::kNotPublished);
+
+  // The next frame is tagged before the first one is read.
+  const uint64_t first = mailbox.Publish(MakePose(10));
+  mailbox.TagFrame(first);
+  mailbox.Publish(MakePose(20));
+  const uint64_t second = mailbox.Publish(MakePose(30));
+  mailbox.TagFrame(second);
+
+  ASSERT_EQ(mailbox.ReadNextFrame(&pose), PoseMailbox::ReadResult::kSuccess);
+  EXPECT_EQ(pose.sequence, first);
+  ExpectPose(pose, 10);
+  ASSERT_EQ(mailbox.ReadNextFrame(&pose), PoseMailbox::ReadResult::kSuccess);
+  EXPECT_EQ(pose.sequence, second);
+  ExpectPose(pose, 30);
+  EXPECT_EQ(mailbox.ReadNextFrame(&pose),
+            PoseMailbox::ReadResult::kNotPublished);
+}
+
+TEST(PoseMailboxTest, SkipsToLatestFrameWhenTagsWereOverwritten) {
+  PoseMailbox mailbox;
+  uint64_t sequence = 0;
+  for (int i = 0; i <= PoseMailbox::kCapacity; ++i) {
+    sequence = mailbox.Publish(MakePose(10 + i));
+    mailbox.TagFrame(sequence);
+  }
+
+  HeadPose pose;
+  EXPECT_EQ(mailbox.ReadNextFrame(&pose),
+            PoseMailbox::ReadResult::kOverwritten);
+  ASSERT_EQ(mailbox.ReadNextFrame(&pose), PoseMailbox::ReadResult::kSuccess);
+  EXPECT_EQ(pose.sequence, sequence);
+  ExpectPose(pose, 10 + PoseMailbox::kCapacity);
+}
+
+TEST(PoseMailboxTest, ClearDropsTaggedFrames) {
+  PoseMailbox mailbox;
+  mailbox.TagFrame(mailbox.Publish(MakePose(10)));
+  mailbox.Clear();
+
+  HeadPose pose;
+  EXPECT_EQ(mailbox.ReadNextFrame(&pose),
+            PoseMailbox::ReadResult::kNotPublished);
+  mailbox.TagFrame(mailbox.Publish(MakePose(20)));
+  ASSERT_EQ(mailbox.ReadNextFrame(&pose), PoseMailbox::ReadResult::kSuccess);
+  ExpectPose(pose, 20);
+}
+
+// The consumer reads the pose of the latest tagged sequence while the producer
+// keeps publishing: it either gets that exact pose or an explicit failure,
+// never a torn pose.
+TEST(PoseMailboxTest, NeverReadsTornPoses) {
+  PoseMailbox mailbox;
+  std::atomic<uint64_t> tagged_sequence{0};
+  std::thread producer([&] {
+    for (int i = 1; i <= kConcurrentPoseCount; ++i) {
+      tagged_sequence.store(mailbox.Publish(MakePose(i)),
+                            std::memory_order_release);
+    }
+  });
+
+  int success_count = 0;
+  uint64_t sequence = 0;
+  while (sequence < kConcurrentPoseCount) {
+    sequence = tagged_sequence.load(std::memory_order_acquire);
+    HeadPose pose;
+    if (mailbox.Read(sequence, &pose) == PoseMailbox::ReadResult::kSuccess) {
+      ASSERT_EQ(pose.sequence, sequence);
+      // Sequence numbers start at 1, like the published values.
+      const HeadPose expected = MakePose(sequence);
+      ASSERT_EQ(pose.position, expected.position);
+      ASSERT_EQ(pose.orientation, expected.orientation);
+      ASSERT_EQ(pose.viewport_orientation, expected.viewport_orientation);
+      ++success_count;
+    }
+  }
+  producer.join();
+  EXPECT_GT(success_count, 0);
+}
+
+// The consumer reads tagged frames while the producer keeps publishing and
+// tagging them: it gets their exact poses in order, or explicit failures.
+TEST(PoseMailboxTest, ReadsTaggedFramesConcurrently) {
+  PoseMailbox mailbox;
+  std::atomic<bool> done{false};
+  std::thread producer([&] {
+    for (int i = 1; i <= kConcurrentPoseCount; ++i) {
+      mailbox.TagFrame(mailbox.Publish(MakePose(i)));
+    }
+    done.store(true, std::memory_order_release);
+  });
+
+  int success_count = 0;
+  uint64_t last_sequence = 0;
+  while (true) {
+    const bool is_done = done.load(std::memory_order_acquire);
+    HeadPose pose;
+    const PoseMailbox::ReadResult result = mailbox.ReadNextFrame(&pose);
+    // Once the producer is done, the remaining frames are drained.
+    if (is_done && result == PoseMailbox::ReadResult::kNotPublished) {
+      break;
+    }
+    if (result == PoseMailbox::ReadResult::kSuccess) {
+      ASSERT_GT(pose.sequence, last_sequence);
+      last_sequence = pose.sequence;
+      const HeadPose expected = MakePose(pose.sequence);
+      ASSERT_EQ(pose.position, expected.position);
+      ASSERT_EQ(pose.orientation, expected.orientation);
+      ASSERT_EQ(pose.viewport_orientation, expected.viewport_orientation);
+      ++success_count;
+    }
+  }
+  producer.join();
+  EXPECT_GT(success_count, 0);
+}
+
+}  // namespace
+}  // namespace cardboard::unity
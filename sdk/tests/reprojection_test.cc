@@ -0,0 +1,164 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "util/reprojection.h"
+
+#include <array>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "util/rotation.h"
+#include "util/vector.h"
+
+namespace cardboard {
+namespace {
+
+constexpr float kTolerance = 1e-5f;
+// Eye field of view half angles of 45 degrees: texture coordinates span
+// [-1, 1] in the tangent space, so a ray at angle a from the view direction
+// lands at a distance tan(a) / 2 from the texture center.
+constexpr float kQuarterPi = static_cast<float>(M_PI / 4.0);
+constexpr std::array<float, 4> kFov = {kQuarterPi, kQuarterPi, kQuarterPi,
+                                       kQuarterPi};
+constexpr std::array<float, 2> kCenter = {0.5f, 0.5f};
+
+std::array<float, 4> ToOrientation(const Rotation& rotation) {
+  const Rotation::QuaternionType& quaternion = rotation.GetQuaternion();
+  return {static_cast<float>(quaternion[0]), static_cast<float>(quaternion[1]),
+          static_cast<float>(quaternion[2]), static_cast<float>(quaternion[3])};
+}
+
+// Orientation of a head that turned by @p angle around @p axis, in head
+// coordinates, from @p orientation.
+std::array<float, 4> Turn(const std::array<float, 4>& orientation,
+                          const Vector3& axis, double angle) {
+  const Rotation from = Rotation::FromQuaternion(Rotation::QuaternionType(
+      orientation[0], orientation[1], orientation[2], orientation[3]));
+  return ToOrientation(Rotation::FromAxisAndAngle(axis, angle) * from);
+}
+
+// Some non trivial head orientation the rotations start from.
+std::array<float, 4> StartOrientation() {
+  return ToOrientation(Rotation::FromYawPitchRoll(0.3, -0.2, 0.1));
+}
+
+const Vector3 kYawAxis(0, 1, 0);
+const Vector3 kRollAxis(0, 0, 1);
+
+TEST(ReprojectionTest, AngleIsZeroWithoutRotation) {
+  const std::array<float, 4> orientation = StartOrientation();
+  EXPECT_NEAR(ComputeReprojectionAngle(orientation, orientation), 0.0f,
+              kTolerance);
+  // q and -q, or a scaled q, are the same orientation.
+  const std::array<float, 4> negated = {-orientation[0], -orientation[1],
+                                        -orientation[2], -orientation[3]};
+  EXPECT_NEAR(ComputeReprojectionAngle(orientation, negated), 0.0f,
+              kTolerance);
+  const std::array<float, 4> scaled = {2 * orientation[0], 2 * orientation[1],
+                                       2 * orientation[2], 2 * orientation[3]};
+  EXPECT_NEAR(ComputeReprojectionAngle(orientation, scaled), 0.0f, kTolerance);
+}
+
+TEST(ReprojectionTest, AngleOfPureYaw) {
+  const std::array<float, 4> render = StartOrientation();
+  for (double angle : {0.01, 0.2, -0.2, 1.5, M_PI}) {
+    EXPECT_NEAR(ComputeReprojectionAngle(render, Turn(render, kYawAxis, angle)),
+                std::abs(angle), kTolerance)
+        << angle;
+  }
+}
+
+TEST(ReprojectionTest, AngleOfPureRoll) {
+  const std::array<float, 4> render = StartOrientation();
+  for (double angle : {0.01, 0.2, -0.2, 1.5, M_PI}) {
+    EXPECT_NEAR(
+        ComputeReprojectionAngle(render, Turn(render, kRollAxis, angle)),
+        std::abs(angle), kTolerance)
+        << angle;
+  }
+}
+
+// Eye buffer reuse asks for a new frame when the angle is above its maximum,
+// so the angle must stay on the right side of it for rotations just below and
+// above the maximum.
+TEST(ReprojectionTest, AngleAroundThreshold) {
+  const std::array<float, 4> render = StartOrientation();
+  for (float threshold : {0.02f, 0.1f, 0.5f}) {
+    const std::array<float, 4> below = Turn(render, kYawAxis, threshold - 1e-3);
+    const std::array<float, 4> above = Turn(render, kYawAxis, threshold + 1e-3);
+    EXPECT_LT(ComputeReprojectionAngle(render, below), threshold) << threshold;
+    EXPECT_GT(ComputeReprojectionAngle(render, above), threshold) << threshold;
+  }
+}
+
+TEST(ReprojectionTest, IdentityWithoutRotation) {
+  const std::array<float, 4> orientation = StartOrientation();
+  const std::array<float, 9> reprojection =
+      ComputeRotationalReprojection(orientation, orientation, kFov);
+  const std::array<float, 9> identity = IdentityReprojection();
+  for (int i = 0; i < 9; ++i) {
+    EXPECT_NEAR(reprojection[i], identity[i], kTolerance) << "at index " << i;
+  }
+}
+
+// A yaw moves the contents horizontally only.
+TEST(ReprojectionTest, PureYawShiftsHorizontally) {
+  const std::array<float, 4> render = StartOrientation();
+  for (double angle : {0.1, -0.1, 0.4}) {
+    const std::array<float, 2> uv = ApplyReprojection(
+        ComputeRotationalReprojection(render, Turn(render, kYawAxis, angle),
+                                      kFov),
+        kCenter);
+    EXPECT_NEAR(std::abs(uv[0] - kCenter[0]), std::tan(std::abs(angle)) / 2,
+                kTolerance)
+        << angle;
+    EXPECT_NEAR(uv[1], kCenter[1], kTolerance) << angle;
+  }
+  // Opposite yaws shift the contents in opposite directions.
+  const std::array<float, 2> left = ApplyReprojection(
+      ComputeRotationalReprojection(render, Turn(render, kYawAxis, 0.1), kFov),
+      kCenter);
+  const std::array<float, 2> right = ApplyReprojection(
+      ComputeRotationalReprojection(render, Turn(render, kYawAxis, -0.1),
+                                    kFov),
+      kCenter);
+  EXPECT_LT((left[0] - kCenter[0]) * (right[0] - kCenter[0]), 0.0f);
+}
+
+// A roll rotates the contents around the view center.
+TEST(ReprojectionTest, PureRollRotatesAroundCenter) {
+  const std::array<float, 4> render = StartOrientation();
+  for (double angle : {0.1, -0.1, 0.4}) {
+    const std::array<float, 9> reprojection = ComputeRotationalReprojection(
+        render, Turn(render, kRollAxis, angle), kFov);
+    const std::array<float, 2> center =
+        ApplyReprojection(reprojection, kCenter);
+    EXPECT_NEAR(center[0], kCenter[0], kTolerance) << angle;
+    EXPECT_NEAR(center[1], kCenter[1], kTolerance) << angle;
+
+    // The middle of the right edge turns around the center.
+    const std::array<float, 2> edge =
+        ApplyReprojection(reprojection, {1.0f, 0.5f});
+    EXPECT_NEAR(std::hypot(edge[0] - kCenter[0], edge[1] - kCenter[1]), 0.5f,
+                kTolerance)
+        << angle;
+    EXPECT_NEAR(std::abs(edge[1] - kCenter[1]), std::sin(std::abs(angle)) / 2,
+                kTolerance)
+        << angle;
+  }
+}
+
+}  // namespace
+}  // namespace cardboard
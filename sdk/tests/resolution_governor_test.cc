@@ -0,0 +1,147 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "unity/xr_unity_plugin/resolution_governor.h"
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace cardboard::unity {
+namespace {
+
+// 60 Hz display.
+constexpr int64_t kVsyncNanos = 16666667;
+
+// Reports @p count frames presented every @p vsyncs display refreshes.
+void AddFrames(ResolutionGovernor* governor, int count, int vsyncs = 1) {
+  for (int i = 0; i < count; ++i) {
+    governor->AddFrame(vsyncs * kVsyncNanos);
+  }
+}
+
+// Reports @p count frames missing every other vsync.
+void AddHalfMissedFrames(ResolutionGovernor* governor, int count) {
+  for (int i = 0; i < count; ++i) {
+    governor->AddFrame((1 + i % 2) * kVsyncNanos);
+  }
+}
+
+// Reports frames missing every other vsync until the scale decreases.
+//
+// @return The number of frames reported, or -1 if the scale did not decrease.
+int MissFramesUntilDecrease(ResolutionGovernor* governor) {
+  const float scale = governor->GetScale();
+  for (int i = 1; i <= 1000; ++i) {
+    governor->AddFrame((1 + i % 2) * kVsyncNanos);
+    if (governor->GetScale() < scale) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+TEST(ResolutionGovernorTest, KeepsFullResolutionAtDisplayRate) {
+  ResolutionGovernor governor;
+  AddFrames(&governor, 1000);
+  EXPECT_EQ(governor.GetScale(), 1.0f);
+}
+
+TEST(ResolutionGovernorTest, DecreasesWhenFramesMissVsync) {
+  ResolutionGovernor governor;
+  AddFrames(&governor, 100);
+  const int frame_count = MissFramesUntilDecrease(&governor);
+  EXPECT_GT(frame_count, 0);
+  EXPECT_LE(frame_count, 10);
+}
+
+TEST(ResolutionGovernorTest, DecreasesAtMostOnceDuringCooldown) {
+  ResolutionGovernor governor;
+  AddFrames(&governor, 100);
+  ASSERT_GT(MissFramesUntilDecrease(&governor), 0);
+  const float scale = governor.GetScale();
+  AddHalfMissedFrames(&governor, 30);
+  EXPECT_EQ(governor.GetScale(), scale);
+  // Frames keep missing at the lower scale, so it decreases again.
+  EXPECT_GT(MissFramesUntilDecrease(&governor), 0);
+}
+
+TEST(ResolutionGovernorTest, IgnoresIsolatedMisses) {
+  ResolutionGovernor governor;
+  for (int i = 0; i < 20; ++i) {
+    AddFrames(&governor, 50);
+    AddFrames(&governor, 1, /*vsyncs=*/3);
+  }
+  EXPECT_EQ(governor.GetScale(), 1.0f);
+}
+
+TEST(ResolutionGovernorTest, ProbesHigherResolutionAfterStableFrames) {
+  ResolutionGovernor governor;
+  AddFrames(&governor, 100);
+  ASSERT_GT(MissFramesUntilDecrease(&governor), 0);
+  const float scale = governor.GetScale();
+
+  AddFrames(&governor, 200);
+  EXPECT_EQ(governor.GetScale(), scale);
+  AddFrames(&governor, 200);
+  EXPECT_GT(governor.GetScale(), scale);
+}
+
+TEST(ResolutionGovernorTest, BacksOffAfterFailedProbe) {
+  ResolutionGovernor governor;
+  AddFrames(&governor, 100);
+  ASSERT_GT(MissFramesUntilDecrease(&governor), 0);
+  const float scale = governor.GetScale();
+
+  // The first probe happens after 300 stable frames and fails.
+  AddFrames(&governor, 300);
+  ASSERT_GT(governor.GetScale(), scale);
+  AddFrames(&governor, 30);
+  ASSERT_GT(MissFramesUntilDecrease(&governor), 0);
+  ASSERT_EQ(governor.GetScale(), scale);
+
+  // The next probe waits twice as long.
+  AddFrames(&governor, 400);
+  EXPECT_EQ(governor.GetScale(), scale);
+  AddFrames(&governor, 300);
+  EXPECT_GT(governor.GetScale(), scale);
+}
+
+TEST(ResolutionGovernorTest, FollowsRefreshRate) {
+  // At 30 Hz, frames presented every 33 ms hit every vsync.
+  ResolutionGovernor governor;
+  AddFrames(&governor, 2000, /*vsyncs=*/2);
+  EXPECT_EQ(governor.GetScale(), 1.0f);
+}
+
+TEST(ResolutionGovernorTest, IgnoresUnknownIntervals) {
+  ResolutionGovernor governor;
+  AddFrames(&governor, 100);
+  for (int i = 0; i < 100; ++i) {
+    governor.AddFrame(0);
+  }
+  EXPECT_EQ(governor.GetScale(), 1.0f);
+}
+
+TEST(ResolutionGovernorTest, ResetRestoresFullResolution) {
+  ResolutionGovernor governor;
+  AddFrames(&governor, 100);
+  ASSERT_GT(MissFramesUntilDecrease(&governor), 0);
+  governor.Reset();
+  EXPECT_EQ(governor.GetScale(), 1.0f);
+}
+
+}  // namespace
+}  // namespace cardboard::unity
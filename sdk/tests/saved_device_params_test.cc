@@ -0,0 +1,184 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "qrcode/saved_device_params.h"
+
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <future>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "include/cardboard.h"
+#include "qrcode/cardboard_v1/cardboard_v1.h"
+#include "tests/host_platform.h"
+
+namespace cardboard::qrcode {
+namespace {
+
+constexpr std::chrono::seconds kWaitTimeout(5);
+
+// Cardboard v1 parameters with another model name.
+std::vector<uint8_t> OtherDeviceParams() {
+  std::vector<uint8_t> encoded = getCardboardV1DeviceParams();
+  const std::vector<uint8_t> model = {0x12, 0x05, 'O', 't', 'h', 'e', 'r'};
+  encoded.insert(encoded.end(), model.begin(), model.end());
+  return encoded;
+}
+
+// Blocks the storage reads until Release() is called.
+class ReadBlocker {
+ public:
+  // Blocks the calling thread, unless it is released.
+  void Block() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++blocked_count_;
+    condition_.notify_all();
+    condition_.wait(lock, [this] { return is_released_; });
+  }
+
+  // Waits until a read is blocked. Returns false on timeout.
+  bool WaitForBlockedRead() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return condition_.wait_for(lock, kWaitTimeout,
+                               [this] { return blocked_count_ > 0; });
+  }
+
+  void Release() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_released_ = true;
+    condition_.notify_all();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  int blocked_count_ = 0;
+  bool is_released_ = false;
+};
+
+class SavedDeviceParamsTest : public ::testing::Test {
+ protected:
+  SavedDeviceParamsTest() {
+    testing::SetSavedDeviceParams(getCardboardV1DeviceParams());
+    notifyDeviceParamsChanged();
+  }
+
+  ~SavedDeviceParamsTest() override {
+    testing::SetSavedDeviceParamsReadHook(nullptr);
+    testing::SetSavedDeviceParams({});
+    notifyDeviceParamsChanged();
+  }
+
+  // Blocks the next storage read only, until @p blocker is released.
+  void BlockNextRead(ReadBlocker* blocker) {
+    auto is_blocking = std::make_shared<std::atomic<bool>>(true);
+    testing::SetSavedDeviceParamsReadHook([blocker, is_blocking] {
+      if (is_blocking->exchange(false)) {
+        blocker->Block();
+      }
+    });
+  }
+};
+
+TEST_F(SavedDeviceParamsTest, ReadsStorageOncePerChange) {
+  const int read_count = testing::GetSavedDeviceParamsReadCount();
+  const std::shared_ptr<const SavedDeviceParams> device_params =
+      getSavedDeviceParams();
+  EXPECT_EQ(device_params->encoded, getCardboardV1DeviceParams());
+  EXPECT_EQ(getSavedDeviceParams(), device_params);
+  EXPECT_EQ(testing::GetSavedDeviceParamsReadCount(), read_count + 1);
+
+  testing::SetSavedDeviceParams(OtherDeviceParams());
+  notifyDeviceParamsChanged();
+  const std::shared_ptr<const SavedDeviceParams> other_device_params =
+      getSavedDeviceParams();
+  EXPECT_EQ(other_device_params->decoded.model(), "Other");
+  EXPECT_EQ(testing::GetSavedDeviceParamsReadCount(), read_count + 2);
+  // The previous snapshot is left untouched.
+  EXPECT_EQ(device_params->decoded.model(), kCardboardV1Model);
+}
+
+TEST_F(SavedDeviceParamsTest, FlagsUndecodableParams) {
+  EXPECT_TRUE(getSavedDeviceParams()->is_decoded);
+  CardboardDeviceParams* decodable = CardboardQrCode_acquireSavedDeviceParams();
+  EXPECT_NE(decodable, nullptr);
+  CardboardDeviceParams_release(decodable);
+
+  // A length delimited field longer than the message.
+  const std::vector<uint8_t> truncated = {0x0a, 0x10, 'G', 'o', 'o'};
+  testing::SetSavedDeviceParams(truncated);
+  notifyDeviceParamsChanged();
+  const std::shared_ptr<const SavedDeviceParams> device_params =
+      getSavedDeviceParams();
+  EXPECT_EQ(device_params->encoded, truncated);
+  EXPECT_FALSE(device_params->is_decoded);
+  EXPECT_EQ(CardboardQrCode_acquireSavedDeviceParams(), nullptr);
+
+  testing::SetSavedDeviceParams({});
+  notifyDeviceParamsChanged();
+  EXPECT_FALSE(getSavedDeviceParams()->is_decoded);
+  EXPECT_EQ(CardboardQrCode_acquireSavedDeviceParams(), nullptr);
+}
+
+TEST_F(SavedDeviceParamsTest, ReadsStorageWithoutHoldingTheCache) {
+  ReadBlocker blocker;
+  BlockNextRead(&blocker);
+  std::future<std::shared_ptr<const SavedDeviceParams>> slow_read =
+      std::async(std::launch::async, getSavedDeviceParams);
+  ASSERT_TRUE(blocker.WaitForBlockedRead());
+
+  // Another caller is not blocked behind the slow read.
+  std::future<std::shared_ptr<const SavedDeviceParams>> read =
+      std::async(std::launch::async, getSavedDeviceParams);
+  const bool is_read_done =
+      read.wait_for(kWaitTimeout) == std::future_status::ready;
+  blocker.Release();
+  ASSERT_TRUE(is_read_done);
+  EXPECT_EQ(read.get()->encoded, getCardboardV1DeviceParams());
+  EXPECT_EQ(slow_read.get()->encoded, getCardboardV1DeviceParams());
+}
+
+TEST_F(SavedDeviceParamsTest, StaleReadDoesNotReplaceNewerParams) {
+  // A read of the Cardboard v1 parameters stalls...
+  ReadBlocker blocker;
+  BlockNextRead(&blocker);
+  std::future<std::shared_ptr<const SavedDeviceParams>> slow_read =
+      std::async(std::launch::async, getSavedDeviceParams);
+  ASSERT_TRUE(blocker.WaitForBlockedRead());
+
+  // ...while other parameters are saved and read.
+  testing::SetSavedDeviceParams(OtherDeviceParams());
+  notifyDeviceParamsChanged();
+  std::future<std::shared_ptr<const SavedDeviceParams>> read =
+      std::async(std::launch::async, getSavedDeviceParams);
+  const bool is_read_done =
+      read.wait_for(kWaitTimeout) == std::future_status::ready;
+  const int read_count = testing::GetSavedDeviceParamsReadCount();
+  blocker.Release();
+  ASSERT_TRUE(is_read_done);
+  EXPECT_EQ(read.get()->decoded.model(), "Other");
+
+  EXPECT_EQ(slow_read.get()->decoded.model(), "Other");
+  EXPECT_EQ(getSavedDeviceParams()->decoded.model(), "Other");
+  EXPECT_EQ(testing::GetSavedDeviceParamsReadCount(), read_count);
+}
+
+}  // namespace
+}  // namespace cardboard::qrcode
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "util/stats.h"
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "include/cardboard.h"
+
+namespace cardboard::util {
+namespace {
+
+// Relative error bound of the histogram percentiles.
+constexpr float kPercentileTolerance = 0.125f;
+
+constexpr int64_t kNanosPerMicro = 1000;
+
+class StatsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    Stats::SetEnabled(true);
+    GetStats().Reset();
+  }
+
+  void TearDown() override {
+    Stats::SetEnabled(false);
+    GetStats().Reset();
+  }
+};
+
+TEST(LatencyHistogramTest, EstimatesPercentiles) {
+  LatencyHistogram histogram;
+  for (int64_t i = 1; i <= 100; i++) {
+    histogram.Record(i * kNanosPerMicro);
+  }
+
+  const CardboardStatsLatency latency = histogram.Get();
+  EXPECT_EQ(latency.count, 100);
+  EXPECT_NEAR(latency.p50_us, 50.0f, 50.0f * kPercentileTolerance);
+  EXPECT_NEAR(latency.p90_us, 90.0f, 90.0f * kPercentileTolerance);
+  EXPECT_NEAR(latency.p99_us, 99.0f, 99.0f * kPercentileTolerance);
+  EXPECT_FLOAT_EQ(latency.max_us, 100.0f);
+}
+
+TEST(LatencyHistogramTest, GetKeepsDurations) {
+  LatencyHistogram histogram;
+  histogram.Record(10 * kNanosPerMicro);
+
+  EXPECT_EQ(histogram.Get().count, 1);
+  EXPECT_EQ(histogram.Get().count, 1);
+}
+
+TEST(LatencyHistogramTest, GetAndResetClearsDurations) {
+  LatencyHistogram histogram;
+  for (int i = 0; i < 10; i++) {
+    histogram.Record(1000 * kNanosPerMicro);
+  }
+
+  const CardboardStatsLatency first = histogram.GetAndReset();
+  EXPECT_EQ(first.count, 10);
+  EXPECT_FLOAT_EQ(first.max_us, 1000.0f);
+
+  const CardboardStatsLatency empty = histogram.Get();
+  EXPECT_EQ(empty.count, 0);
+  EXPECT_EQ(empty.max_us, 0.0f);
+
+  // The next period only reflects its own durations.
+  histogram.Record(10 * kNanosPerMicro);
+  const CardboardStatsLatency second = histogram.GetAndReset();
+  EXPECT_EQ(second.count, 1);
+  EXPECT_NEAR(second.p99_us, 10.0f, 10.0f * kPercentileTolerance);
+  EXPECT_FLOAT_EQ(second.max_us, 10.0f);
+}
+
+TEST_F(StatsTest, GetAndResetClearsCountersAndKeepsBiasState) {
+  Stats& stats = GetStats();
+  stats.get_pose.Record(20 * kNanosPerMicro);
+  stats.dropped_sample_count = 3;
+  stats.late_gyroscope_sample_count = 2;
+  stats.gyroscope_bias_converged = true;
+
+  CardboardStats reported;
+  stats.GetAndReset(&reported);
+  EXPECT_EQ(reported.get_pose.count, 1);
+  EXPECT_EQ(reported.dropped_sample_count, 3);
+  EXPECT_EQ(reported.late_gyroscope_sample_count, 2);
+  EXPECT_EQ(reported.gyroscope_bias_converged, 1);
+
+  stats.Get(&reported);
+  EXPECT_EQ(reported.get_pose.count, 0);
+  EXPECT_EQ(reported.dropped_sample_count, 0);
+  EXPECT_EQ(reported.late_gyroscope_sample_count, 0);
+  // The bias state is not a per period value.
+  EXPECT_EQ(reported.gyroscope_bias_converged, 1);
+}
+
+TEST_F(StatsTest, ScopedLatencyRecordsOnlyWhenEnabled) {
+  { ScopedLatency latency(&GetStats().distortion_pass); }
+  EXPECT_EQ(GetStats().distortion_pass.Get().count, 1);
+
+  Stats::SetEnabled(false);
+  { ScopedLatency latency(&GetStats().distortion_pass); }
+  EXPECT_EQ(GetStats().distortion_pass.Get().count, 1);
+}
+
+TEST_F(StatsTest, CApiGetAndResetClearsStats) {
+  GetStats().gyroscope_interval.Record(10000 * kNanosPerMicro);
+  GetStats().dropped_sample_count = 1;
+
+  CardboardStats reported;
+  CardboardStats_getAndReset(&reported);
+  EXPECT_EQ(reported.gyroscope_interval.count, 1);
+  EXPECT_NEAR(reported.gyroscope_sample_rate_hz, 100.0f,
+              100.0f * kPercentileTolerance);
+  EXPECT_EQ(reported.dropped_sample_count, 1);
+
+  CardboardStats_get(&reported);
+  EXPECT_EQ(reported.gyroscope_interval.count, 0);
+  EXPECT_EQ(reported.dropped_sample_count, 0);
+}
+
+}  // namespace
+}  // namespace cardboard::util
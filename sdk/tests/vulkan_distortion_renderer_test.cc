@@ -0,0 +1,126 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <array>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "include/cardboard.h"
+#include "tests/distortion_test_scene.h"
+#include "tests/headless_vulkan_context.h"
+
+namespace cardboard::testing {
+namespace {
+
+constexpr int kDisplayWidth = 640;
+constexpr int kDisplayHeight = 360;
+
+// Besides the interpolation precision, the Vulkan renderer filters the eye
+// textures after the sRGB decoding, so edges differ a bit more than with
+// OpenGL ES.
+constexpr double kMaxMeanDifference = 1.5;
+constexpr int kOutlierThreshold = 16;
+constexpr double kMaxOutlierFraction = 0.01;
+
+// Frames rendered with each reprojection. More than the swapchain images, so
+// that each of them is rendered again.
+constexpr int kFrameCount = 8;
+
+// Parameters: whether the viewer corrects the chromatic aberration and
+// whether the renderer records into secondary command buffers.
+class VulkanDistortionRendererTest
+    : public ::testing::TestWithParam<std::tuple<bool, bool>> {};
+
+// Frames are first rendered without reprojection, then with the one of the
+// scene, so reused secondary command buffers must follow the reprojection
+// and mesh changes.
+TEST_P(VulkanDistortionRendererTest, MatchesCpuRenderer) {
+  const auto [chromatic_aberration, use_secondary_command_buffers] =
+      GetParam();
+  const DistortionTestScene scene(kDisplayWidth, kDisplayHeight,
+                                  chromatic_aberration);
+  std::unique_ptr<HeadlessVulkanContext> context =
+      HeadlessVulkanContext::Create(kDisplayWidth, kDisplayHeight);
+  if (context == nullptr) {
+    GTEST_SKIP() << "No headless Vulkan context.";
+  }
+
+  const CardboardVulkanDistortionRendererConfig config =
+      context->GetRendererConfig();
+  CardboardVulkanDistortionRendererOptions options = {};
+  options.use_secondary_command_buffers = use_secondary_command_buffers;
+  options.queue_family_index = context->queue_family_index();
+  // RenderFrame() waits for each frame to complete.
+  options.max_frames_in_flight = 1;
+  CardboardDistortionRenderer* renderer =
+      CardboardVulkanDistortionRenderer_createWithOptions(&config, &options);
+  ASSERT_NE(renderer, nullptr);
+  CardboardDistortionRendererPassConfig pass_config = {};
+  pass_config.color_load_op = kColorLoadOpClear;
+  pass_config.vk_swapchain_image_format = context->swapchain_format();
+
+  const VkImage left_texture = context->CreateTexture(
+      scene.eye_width(), scene.eye_height(), scene.eye_pixels(kLeft));
+  const VkImage right_texture = context->CreateTexture(
+      scene.eye_width(), scene.eye_height(), scene.eye_pixels(kRight));
+  ASSERT_NE(left_texture, VK_NULL_HANDLE);
+  ASSERT_NE(right_texture, VK_NULL_HANDLE);
+  const CardboardEyeTextureDescription left_eye = scene.GetEyeDescription(
+      kLeft, reinterpret_cast<uint64_t>(left_texture));
+  const CardboardEyeTextureDescription right_eye = scene.GetEyeDescription(
+      kRight, reinterpret_cast<uint64_t>(right_texture));
+
+  const auto render = [&](CardboardVulkanDistortionRendererTarget* target) {
+    CardboardDistortionRenderer_renderEyeToDisplay(
+        renderer, reinterpret_cast<uint64_t>(target), 0, 0, kDisplayWidth,
+        kDisplayHeight, &left_eye, &right_eye);
+  };
+  const std::array<float, 9> identity = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+  std::vector<uint8_t> pixels;
+  for (const bool reproject : {false, true}) {
+    // Setting the meshes again replaces the buffers used by the previous
+    // frames.
+    scene.Configure(renderer, pass_config);
+    for (CardboardEye eye : {kLeft, kRight}) {
+      CardboardDistortionRenderer_setReprojection(
+          renderer,
+          reproject ? scene.reprojection(eye).data() : identity.data(), eye);
+    }
+    for (int i = 0; i < kFrameCount; i++) {
+      ASSERT_TRUE(context->RenderFrame(render, &pixels));
+    }
+  }
+  CardboardDistortionRenderer_destroy(renderer);
+
+  const ImageDifference difference =
+      CompareImages(pixels, scene.RenderReference(), kOutlierThreshold);
+  EXPECT_LT(difference.mean, kMaxMeanDifference);
+  EXPECT_LT(difference.outlier_fraction, kMaxOutlierFraction);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AllViewers, VulkanDistortionRendererTest,
+    ::testing::Combine(::testing::Bool(), ::testing::Bool()),
+    [](const ::testing::TestParamInfo<std::tuple<bool, bool>>& info) {
+      return std::string(std::get<0>(info.param) ? "Chromatic"
+                                                 : "Achromatic") +
+             (std::get<1>(info.param) ? "Secondary" : "");
+    });
+
+}  // namespace
+}  // namespace cardboard::testing
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "util/worker_pool.h"
+
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <set>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace cardboard::util {
+namespace {
+
+TEST(WorkerPoolTest, ClampsWorkerCount) {
+  EXPECT_EQ(WorkerPool(0).worker_count(), 1);
+  EXPECT_EQ(WorkerPool(-1).worker_count(), 1);
+  EXPECT_EQ(WorkerPool(3).worker_count(), 3);
+}
+
+TEST(WorkerPoolTest, RunsEachTaskOnce) {
+  for (int worker_count : {1, 2, 4}) {
+    WorkerPool pool(worker_count);
+    for (int task_count : {0, 1, 2, 100}) {
+      std::vector<std::atomic<int>> calls(task_count);
+      pool.Run(task_count, [&](int task, int worker) {
+        EXPECT_GE(worker, 0);
+        EXPECT_LT(worker, worker_count);
+        calls[task]++;
+      });
+      for (int task = 0; task < task_count; ++task) {
+        EXPECT_EQ(calls[task], 1) << "task " << task << " of " << task_count
+                                  << " with " << worker_count << " workers";
+      }
+    }
+  }
+}
+
+// Jobs run on the calling thread and the threads started by the constructor.
+TEST(WorkerPoolTest, ReusesItsThreads) {
+  constexpr int kWorkerCount = 4;
+  WorkerPool pool(kWorkerCount);
+  std::mutex mutex;
+  std::set<std::thread::id> thread_ids;
+  for (int job = 0; job < 200; ++job) {
+    pool.Run(16, [&](int /*task*/, int /*worker*/) {
+      std::lock_guard<std::mutex> lock(mutex);
+      thread_ids.insert(std::this_thread::get_id());
+    });
+  }
+  EXPECT_LE(static_cast<int>(thread_ids.size()), kWorkerCount);
+}
+
+// Each worker index is used by a single thread, worker 0 being the calling
+// thread, so that workers may own scratch buffers.
+TEST(WorkerPoolTest, WorkerIndexIdentifiesThread) {
+  constexpr int kWorkerCount = 3;
+  WorkerPool pool(kWorkerCount);
+  const std::thread::id caller = std::this_thread::get_id();
+  std::mutex mutex;
+  std::vector<std::set<std::thread::id>> threads_per_worker(kWorkerCount);
+  for (int job = 0; job < 50; ++job) {
+    pool.Run(kWorkerCount * 4, [&](int /*task*/, int worker) {
+      std::lock_guard<std::mutex> lock(mutex);
+      threads_per_worker[worker].insert(std::this_thread::get_id());
+    });
+  }
+  for (int worker = 0; worker < kWorkerCount; ++worker) {
+    EXPECT_LE(threads_per_worker[worker].size(), 1u) << "worker " << worker;
+  }
+  for (const std::thread::id& thread : threads_per_worker[0]) {
+    EXPECT_EQ(thread, caller);
+  }
+}
+
+}  // namespace
+}  // namespace cardboard::util
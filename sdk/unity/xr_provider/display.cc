@@ -15,15 +15,17 @@
  */
 #include <array>
 #include <cassert>
-#include <map>
+#include <chrono>  // NOLINT
 #include <memory>
 
+#include "include/cardboard.h"
 #include "util/is_arg_null.h"
 #include "unity/xr_provider/load.h"
 #include "unity/xr_provider/math_tools.h"
 #include "unity/xr_unity_plugin/cardboard_display_api.h"
 #include "IUnityInterface.h"
 #include "IUnityXRDisplay.h"
+#include "IUnityXRStats.h"
 #include "IUnityXRTrace.h"
 #include "UnitySubsystemTypes.h"
 
@@ -43,6 +45,7 @@ class CardboardDisplayProvider {
     }
     display_ = xr_interfaces_->Get<IUnityXRDisplayInterface>();
     trace_ = xr_interfaces_->Get<IUnityXRTrace>();
+    stats_ = xr_interfaces_->Get<IUnityXRStats>();
   }
 
   IUnityXRDisplayInterface* GetDisplay() { return display_; }
@@ -78,6 +81,7 @@ class CardboardDisplayProvider {
   ///         the error.
   UnitySubsystemErrorCode Initialize(UnitySubsystemHandle handle) {
     SetHandle(handle);
+    RegisterStats();
 
     // Register for callbacks on the graphics thread.
     UnityXRDisplayGraphicsThreadProvider gfx_thread_provider{};
@@ -127,7 +131,11 @@ class CardboardDisplayProvider {
 
   void Stop() const {}
 
-  void Shutdown() const {}
+  void Shutdown() {
+    if (stats_ != nullptr) {
+      stats_->UnregisterStatSource(handle_);
+    }
+  }
 
   UnitySubsystemErrorCode GfxThread_Start(
       UnityXRRenderingCapabilities* rendering_caps) const {
@@ -150,14 +158,14 @@ class CardboardDisplayProvider {
     cardboard_display_api_->RenderEyesToDisplay();
     cardboard_display_api_->RenderWidgets();
     cardboard_display_api_->RunRenderingPostProcessing();
+    UpdateStats();
     return kUnitySubsystemErrorCodeSuccess;
   }
 
   UnitySubsystemErrorCode GfxThread_PopulateNextFrameDesc(
       const UnityXRFrameSetupHints* frame_hints,
       UnityXRNextFrameDesc* next_frame) {
-    // Allocate new color texture descriptors if needed and update device
-    // parameters in Cardboard SDK.
+    // Update device parameters in Cardboard SDK if needed.
     if ((frame_hints->changedFlags &
          kUnityXRFrameSetupHintsChangedTextureResolutionScale) != 0 ||
         !is_initialized_ ||
@@ -168,89 +176,59 @@ class CardboardDisplayProvider {
       cardboard_display_api_.reset(new cardboard::unity::CardboardDisplayApi());
       // Deallocate old textures since we're completely reallocating new
       // textures for Cardboard SDK.
-      for (auto&& tex : tex_map_) {
-        display_->DestroyTexture(handle_, tex.second);
-      }
-      tex_map_.clear();
+      DestroyTextures();
 
-      cardboard::unity::CardboardDisplayApi::GetScreenParams(&width_, &height_);
       cardboard_display_api_->UpdateDeviceParams();
+      cardboard_display_api_->GetEyeTextureSize(&width_, &height_);
       is_initialized_ = true;
-
-      // Initialize texture descriptors.
-      for (size_t i = 0; i < texture_descriptors_.size(); ++i) {
-        texture_descriptors_[i] = {};
-        texture_descriptors_[i].width = width_ / 2;
-        texture_descriptors_[i].height = height_;
-        texture_descriptors_[i].flags = 0;
-
-        texture_descriptors_[i].depthFormat =
-            kUnityXRDepthTextureFormat24bitOrGreater;
-      }
     }
 
-    // Setup render passes + texture ids for eye textures and layers.
-    for (size_t i = 0; i < texture_descriptors_.size(); ++i) {
-      // Sets the color texture ID to Unity texture descriptors.
-      const uint64_t texture_color_buffer_id =
-          i == 0 ? cardboard_display_api_->GetLeftTextureColorBufferId()
-                 : cardboard_display_api_->GetRightTextureColorBufferId();
-      const uint64_t texture_depth_buffer_id =
-          i == 0 ? cardboard_display_api_->GetLeftTextureDepthBufferId()
-                 : cardboard_display_api_->GetRightTextureDepthBufferId();
-
-      UnityXRRenderTextureId unity_texture_id = 0;
-      const auto found = tex_map_.find(texture_color_buffer_id);
-      if (found == tex_map_.end()) {
-        UnityXRRenderTextureDesc texture_descriptor = texture_descriptors_[i];
-        texture_descriptor.color.nativePtr =
-            ToVoidPointer(texture_color_buffer_id);
-        texture_descriptor.depth.nativePtr =
-            ToVoidPointer(texture_depth_buffer_id);
-        display_->CreateTexture(handle_, &texture_descriptor,
-                                &unity_texture_id);
-        tex_map_[texture_color_buffer_id] = unity_texture_id;
-      } else {
-        unity_texture_id = found->second;
-      }
-      next_frame->renderPasses[i].textureId = unity_texture_id;
+    // Eye textures and matrices only change along with the texture
+    // generation, so the per-eye descriptors are rebuilt just then.
+    const uint32_t texture_generation =
+        cardboard_display_api_->GetTextureGeneration();
+    if (texture_generation != eye_render_passes_generation_) {
+      UpdateEyeRenderPasses();
+      eye_render_passes_generation_ = texture_generation;
     }
 
-    {
-      auto* left_eye_params = &next_frame->renderPasses[0].renderParams[0];
-      auto* right_eye_params = &next_frame->renderPasses[1].renderParams[0];
-
-      for (int i = 0; i < 2; ++i) {
-        std::array<float, 4> fov;
-        std::array<float, 16> eye_from_head;
-        cardboard_display_api_->GetEyeMatrices(i, eye_from_head.data(),
-                                               fov.data());
-
-        auto* eye_params = i == 0 ? left_eye_params : right_eye_params;
-        // Update pose for rendering.
-        eye_params->deviceAnchorToEyePose =
-            cardboard::unity::CardboardTransformToUnityPose(eye_from_head);
-        // Field of view and viewport.
-        eye_params->viewportRect = frame_hints->appSetup.renderViewport;
-        ConfigureFieldOfView(fov, &eye_params->projection);
-      }
-
-      // Configure the culling passes for both eyes.
-      // - Left eye: index == 0.
-      // - Right eye: index == 1.
-      next_frame->renderPasses[0].cullingPassIndex = 0;
-      next_frame->cullingPasses[0].deviceAnchorToCullingPose =
-          left_eye_params->deviceAnchorToEyePose;
-      next_frame->cullingPasses[0].projection = left_eye_params->projection;
-      next_frame->cullingPasses[0].separation = kCullingSphereDiameter;
-
-      next_frame->renderPasses[1].cullingPassIndex = 1;
-      next_frame->cullingPasses[1].deviceAnchorToCullingPose =
-          right_eye_params->deviceAnchorToEyePose;
-      next_frame->cullingPasses[1].projection = right_eye_params->projection;
-      next_frame->cullingPasses[1].separation = kCullingSphereDiameter;
+    // Eye textures are allocated once. Lower resolutions render into their
+    // lower left corner, which is the region the distortion pass samples.
+    const float eye_texture_scale =
+        cardboard_display_api_->UpdateEyeTextureScale();
+
+    // Unity renders into the next eye texture slot while the previous frame
+    // may still be distorted from another one.
+    const int slot = cardboard_display_api_->AcquireNextEyeTextureSlot();
+
+    // Setup render passes + texture ids for eye textures.
+    // - Left eye: index == 0.
+    // - Right eye: index == 1.
+    for (size_t i = 0; i < eye_render_passes_.size(); ++i) {
+      const EyeRenderPass& eye_render_pass = eye_render_passes_[i];
+      auto& render_pass = next_frame->renderPasses[i];
+      render_pass.textureId = texture_ids_[slot * 2 + i];
+
+      auto& eye_params = render_pass.renderParams[0];
+      eye_params.deviceAnchorToEyePose = eye_render_pass.eye_pose;
+      eye_params.projection = eye_render_pass.projection;
+      // Viewport.
+      eye_params.viewportRect = frame_hints->appSetup.renderViewport;
+      eye_params.viewportRect.width *= eye_texture_scale;
+      eye_params.viewportRect.height *= eye_texture_scale;
+
+      // Configure the culling pass of the eye.
+      render_pass.cullingPassIndex = static_cast<uint32_t>(i);
+      next_frame->cullingPasses[i].deviceAnchorToCullingPose =
+          eye_render_pass.eye_pose;
+      next_frame->cullingPasses[i].projection = eye_render_pass.projection;
+      next_frame->cullingPasses[i].separation = kCullingSphereDiameter;
     }
 
+    // Keep the orientation the eye textures are going to be rendered with so
+    // the distortion pass can late-latch the head pose.
+    cardboard_display_api_->LatchRenderHeadOrientation();
+
     // Configure multipass rendering with one pass for each eye.
     next_frame->renderPassesCount = 2;
     next_frame->renderPasses[0].renderParamsCount = 1;
@@ -266,6 +244,166 @@ class CardboardDisplayProvider {
   }
 
  private:
+  /// @brief Describes a Cardboard SDK runtime statistic reported to Unity.
+  struct StatDefinition {
+    /// @brief Unity stat tag.
+    const char* tag;
+    /// @brief Gets the statistic value.
+    float (*get_value)(const CardboardStats& stats);
+  };
+
+  /// @brief Per-eye render pass state that only changes along with the eye
+  ///        textures.
+  struct EyeRenderPass {
+    /// @brief Eye pose relative to the head.
+    UnityXRPose eye_pose;
+    /// @brief Eye projection.
+    UnityXRProjection projection;
+  };
+
+  /// @brief Period over which the runtime statistics are reported.
+  static constexpr std::chrono::seconds kStatsReportPeriod{1};
+
+  /// @brief Cardboard SDK runtime statistics reported to Unity.
+  static constexpr std::array<StatDefinition, 12> kStatDefinitions = {{
+      {"Cardboard.GyroscopeSampleRateHz",
+       [](const CardboardStats& s) { return s.gyroscope_sample_rate_hz; }},
+      {"Cardboard.GyroscopeJitterUs",
+       [](const CardboardStats& s) { return s.gyroscope_jitter_us; }},
+      {"Cardboard.AccelerometerSampleRateHz",
+       [](const CardboardStats& s) { return s.accelerometer_sample_rate_hz; }},
+      {"Cardboard.AccelerometerJitterUs",
+       [](const CardboardStats& s) { return s.accelerometer_jitter_us; }},
+      {"Cardboard.DroppedSampleCount",
+       [](const CardboardStats& s) {
+         return static_cast<float>(s.dropped_sample_count);
+       }},
+      {"Cardboard.LateGyroscopeSampleCount",
+       [](const CardboardStats& s) {
+         return static_cast<float>(s.late_gyroscope_sample_count);
+       }},
+      {"Cardboard.SensorFusionLockWaitP99Us",
+       [](const CardboardStats& s) {
+         return s.sensor_fusion_lock_wait.p99_us;
+       }},
+      {"Cardboard.GetPoseP50Us",
+       [](const CardboardStats& s) { return s.get_pose.p50_us; }},
+      {"Cardboard.GetPoseP99Us",
+       [](const CardboardStats& s) { return s.get_pose.p99_us; }},
+      {"Cardboard.DistortionPassP50Us",
+       [](const CardboardStats& s) { return s.distortion_pass.p50_us; }},
+      {"Cardboard.DistortionPassP99Us",
+       [](const CardboardStats& s) { return s.distortion_pass.p99_us; }},
+      {"Cardboard.GyroscopeBiasConverged",
+       [](const CardboardStats& s) {
+         return static_cast<float>(s.gyroscope_bias_converged);
+       }},
+  }};
+
+  /// @brief Registers the display subsystem as a Unity XR stats source. The
+  ///        statistics are only collected and reported once enabled with
+  ///        CardboardUnity_setStatsEnabled().
+  void RegisterStats() {
+    if (stats_ == nullptr ||
+        stats_->RegisterStatSource(handle_) !=
+            kUnitySubsystemErrorCodeSuccess) {
+      CARDBOARD_DISPLAY_XR_TRACE_LOG(trace_, "Cannot register XR stats.");
+      stats_ = nullptr;
+      return;
+    }
+    for (size_t i = 0; i < kStatDefinitions.size(); ++i) {
+      stat_ids_[i] = stats_->RegisterStatDefinition(
+          handle_, kStatDefinitions[i].tag, kUnityXRStatOptionNone);
+    }
+  }
+
+  /// @brief Reports the Cardboard SDK runtime statistics to Unity.
+  /// @details Statistics are collected over consecutive periods of
+  ///          kStatsReportPeriod and cleared after each one, so percentiles
+  ///          and counts describe the last period rather than the whole
+  ///          session. Every frame reports the last complete period.
+  void UpdateStats() {
+    if (stats_ == nullptr ||
+        !cardboard::unity::CardboardDisplayApi::IsStatsEnabled()) {
+      is_stats_period_started_ = false;
+      return;
+    }
+    const std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+    if (!is_stats_period_started_) {
+      // Drops the values collected before the reports (re)started.
+      CardboardStats_getAndReset(&reported_stats_);
+      reported_stats_ = {};
+      stats_period_start_ = now;
+      is_stats_period_started_ = true;
+    } else if (now - stats_period_start_ >= kStatsReportPeriod) {
+      CardboardStats_getAndReset(&reported_stats_);
+      stats_period_start_ = now;
+    }
+    for (size_t i = 0; i < kStatDefinitions.size(); ++i) {
+      if (stat_ids_[i] != kUnityInvalidXRStatId) {
+        stats_->SetStatFloat(stat_ids_[i],
+                             kStatDefinitions[i].get_value(reported_stats_));
+      }
+    }
+  }
+
+  /// @brief Destroys the Unity XR textures wrapping the eye textures.
+  void DestroyTextures() {
+    for (UnityXRRenderTextureId& texture_id : texture_ids_) {
+      if (texture_id != kUnityXRRenderTextureIdDontCare) {
+        display_->DestroyTexture(handle_, texture_id);
+        texture_id = kUnityXRRenderTextureIdDontCare;
+      }
+    }
+    eye_render_passes_generation_ = 0;
+  }
+
+  /// @brief Wraps the eye textures of every slot into Unity XR textures and
+  ///        caches the eye poses and projections.
+  void UpdateEyeRenderPasses() {
+    DestroyTextures();
+
+    for (int slot = 0; slot < cardboard_display_api_->GetEyeTextureSlotCount();
+         ++slot) {
+      const uint64_t color_buffer_ids[] = {
+          cardboard_display_api_->GetLeftTextureColorBufferId(slot),
+          cardboard_display_api_->GetRightTextureColorBufferId(slot)};
+      const uint64_t depth_buffer_ids[] = {
+          cardboard_display_api_->GetLeftTextureDepthBufferId(slot),
+          cardboard_display_api_->GetRightTextureDepthBufferId(slot)};
+      for (int eye = 0; eye < 2; ++eye) {
+        UnityXRRenderTextureDesc texture_descriptor{};
+        texture_descriptor.width = width_;
+        texture_descriptor.height = height_;
+        // Unity resolves multisampled eye textures on chip and allocates
+        // their transient depth buffer.
+        texture_descriptor.flags =
+            cardboard_display_api_->AreEyeTexturesMultisampled()
+                ? kUnityXRRenderTextureFlagsAutoResolve
+                : 0;
+        texture_descriptor.depthFormat =
+            kUnityXRDepthTextureFormat24bitOrGreater;
+        texture_descriptor.color.nativePtr =
+            ToVoidPointer(color_buffer_ids[eye]);
+        texture_descriptor.depth.nativePtr =
+            ToVoidPointer(depth_buffer_ids[eye]);
+        display_->CreateTexture(handle_, &texture_descriptor,
+                                &texture_ids_[slot * 2 + eye]);
+      }
+    }
+
+    for (size_t i = 0; i < eye_render_passes_.size(); ++i) {
+      std::array<float, 4> fov;
+      std::array<float, 16> eye_from_head;
+      cardboard_display_api_->GetEyeMatrices(static_cast<int>(i),
+                                             eye_from_head.data(), fov.data());
+      eye_render_passes_[i].eye_pose =
+          cardboard::unity::CardboardTransformToUnityPose(eye_from_head);
+      ConfigureFieldOfView(fov, &eye_render_passes_[i].projection);
+    }
+  }
+
   /// @brief Diameter of the bounding sphere used for culling.
   /// TODO(b/155084408): Properly document this constant value.
   static constexpr float kCullingSphereDiameter = 0.064f;
@@ -296,6 +434,22 @@ class CardboardDisplayProvider {
   /// @brief Points to Unity XR Display interface.
   IUnityXRDisplayInterface* display_ = nullptr;
 
+  /// @brief Points to Unity XR Stats interface. It may be nullptr.
+  IUnityXRStats* stats_ = nullptr;
+
+  /// @brief Unity stat IDs, indexed like kStatDefinitions.
+  std::array<UnityXRStatId, kStatDefinitions.size()> stat_ids_{};
+
+  /// @brief Statistics of the last complete report period.
+  CardboardStats reported_stats_{};
+
+  /// @brief Start of the current report period.
+  std::chrono::steady_clock::time_point stats_period_start_;
+
+  /// @brief Whether `stats_period_start_` holds the start of the current
+  ///        report period.
+  bool is_stats_period_started_ = false;
+
   /// @brief Opaque Unity pointer type passed between plugins.
   UnitySubsystemHandle handle_;
 
@@ -303,20 +457,27 @@ class CardboardDisplayProvider {
   /// the CardboardDisplayApi::UpdateDeviceParams() is called and returns true.
   bool is_initialized_ = false;
 
-  /// @brief Screen width in pixels.
+  /// @brief Eye texture width in pixels.
   int width_;
 
-  /// @brief Screen height in pixels.
+  /// @brief Eye texture height in pixels.
   int height_;
 
   /// @brief Cardboard SDK API wrapper.
   std::unique_ptr<cardboard::unity::CardboardDisplayApi> cardboard_display_api_;
 
-  /// @brief Unity XR texture descriptors.
-  std::array<UnityXRRenderTextureDesc, 2> texture_descriptors_{};
+  /// @brief Unity XR texture IDs of the eye textures, indexed by
+  ///        `slot * 2 + eye`. kUnityXRRenderTextureIdDontCare when not created.
+  std::array<UnityXRRenderTextureId,
+             2 * cardboard::unity::Renderer::kMaxEyeTextureSlotCount>
+      texture_ids_{};
+
+  /// @brief Cached render pass state, indexed by eye.
+  std::array<EyeRenderPass, 2> eye_render_passes_{};
 
-  /// @brief Map to link Cardboard API and Unity XR texture IDs.
-  std::map<uint64_t, UnityXRRenderTextureId> tex_map_{};
+  /// @brief Eye texture generation `texture_ids_` and `eye_render_passes_`
+  ///        were built for. Zero when they are not built.
+  uint32_t eye_render_passes_generation_ = 0;
 
   /// @brief Holds the unique instance of this class. It is accessible via
   ///        GetInstance().
@@ -17,6 +17,7 @@
 
 #include <array>
 #include <cmath>
+#include <cstdint>
 
 #include "unity/xr_provider/load.h"
 #include "unity/xr_provider/math_tools.h"
@@ -57,8 +58,8 @@ class CardboardInputProvider {
     UnityXRInputProvider input_provider;
     input_provider.userData = nullptr;
     input_provider.Tick = [](UnitySubsystemHandle, void*,
-                             UnityXRInputUpdateType) {
-      return GetInstance()->Tick();
+                             UnityXRInputUpdateType update_type) {
+      return GetInstance()->Tick(update_type);
     };
     input_provider.FillDeviceDefinition =
         [](UnitySubsystemHandle, void*, UnityXRInternalInputDeviceId device_id,
@@ -129,11 +130,15 @@ class CardboardInputProvider {
     cardboard_input_api_->PauseHeadTracker();
   }
 
-  UnitySubsystemErrorCode Tick() {
+  UnitySubsystemErrorCode Tick(UnityXRInputUpdateType update_type) {
     std::array<float, 4> out_orientation;
     std::array<float, 3> out_position;
-    cardboard_input_api_->GetHeadTrackerPose(out_position.data(),
-                                             out_orientation.data());
+    const uint64_t pose_sequence = cardboard_input_api_->GetHeadTrackerPose(
+        out_position.data(), out_orientation.data());
+    // Cameras are set up with the pose of the tick right before rendering.
+    if (update_type == kUnityXRInputUpdateTypeBeforeRender) {
+      cardboard::unity::CardboardInputApi::SetFramePoseSequence(pose_sequence);
+    }
     // TODO(b/151817737): Compute pose position within SDK with custom rotation.
     head_pose_ =
         cardboard::unity::CardboardRotationToUnityPose(out_orientation);
@@ -57,4 +57,15 @@ UnitySubsystemErrorCode LoadInput(IUnityInterfaces* xr_interfaces);
 /// @brief Unloads the Unity XR Input subsystem.
 void UnloadInput();
 
+/// @brief Forwards the Cardboard SDK trace events to the Unity Profiler.
+///
+/// @details Only effective when the SDK is built with CARDBOARD_ENABLE_TRACING
+///          and the Unity Profiler is available, i.e. in development players.
+///          Otherwise, trace events keep going to the platform sink.
+/// @param unity_interfaces Unity Interfaces pointer.
+void LoadProfiler(IUnityInterfaces* unity_interfaces);
+
+/// @brief Restores the platform trace sink.
+void UnloadProfiler();
+
 #endif  // CARDBOARD_SDK_UNITY_XR_PROVIDER_LOAD_H_
@@ -81,6 +81,8 @@ extern "C" {
 // @param unity_interfaces Unity Interface pointer.
 void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API
 UnityPluginLoad(IUnityInterfaces *unity_interfaces) {
+  LoadProfiler(unity_interfaces);
+
 #ifdef __ANDROID__
   // Cache the Unity interfaces since it will be used by the callback function.
   global_unity_interfaces = unity_interfaces;
@@ -100,6 +102,7 @@ UnityPluginLoad(IUnityInterfaces *unity_interfaces) {
 void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API UnityPluginUnload() {
   UnloadDisplay();
   UnloadInput();
+  UnloadProfiler();
 #ifdef __ANDROID__
   global_unity_interfaces->Get<IUnityGraphics>()->UnregisterDeviceEventCallback(
       OnGraphicsDeviceEvent);
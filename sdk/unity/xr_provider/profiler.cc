@@ -0,0 +1,145 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "unity/xr_provider/load.h"
+#include "util/trace.h"
+#include "IUnityInterface.h"
+
+#ifdef CARDBOARD_ENABLE_TRACING
+
+#include <mutex>
+#include <unordered_map>
+
+#include "IUnityProfiler.h"
+#include "IUnityXRTrace.h"
+
+#define CARDBOARD_PROFILER_XR_TRACE_LOG(trace, message) \
+  XR_TRACE_LOG(trace, "[CardboardXrProfiler]: " message "\n")
+
+namespace {
+
+// Forwards the SDK trace events to Unity Profiler markers. Markers are created
+// the first time a span or counter name is seen. Names are string literals, so
+// they are keyed by address.
+class UnityProfilerTraceSink {
+ public:
+  explicit UnityProfilerTraceSink(IUnityProfiler* profiler)
+      : profiler_(profiler) {}
+
+  static uint64_t BeginSection(const char* name, void* user_data) {
+    auto* sink = static_cast<UnityProfilerTraceSink*>(user_data);
+    const UnityProfilerMarkerDesc* marker = sink->GetSectionMarker(name);
+    if (marker != nullptr) {
+      sink->profiler_->BeginSample(marker);
+    }
+    return reinterpret_cast<uint64_t>(marker);
+  }
+
+  static void EndSection(const char* /*name*/, uint64_t token,
+                         void* user_data) {
+    auto* sink = static_cast<UnityProfilerTraceSink*>(user_data);
+    const auto* marker = reinterpret_cast<const UnityProfilerMarkerDesc*>(token);
+    if (marker != nullptr) {
+      sink->profiler_->EndSample(marker);
+    }
+  }
+
+  static void SetCounter(const char* name, int64_t value, void* user_data) {
+    auto* sink = static_cast<UnityProfilerTraceSink*>(user_data);
+    const UnityProfilerMarkerDesc* marker = sink->GetCounterMarker(name);
+    if (marker == nullptr) {
+      return;
+    }
+    UnityProfilerMarkerData data = {};
+    data.type = kUnityProfilerMarkerDataTypeInt64;
+    data.size = sizeof(value);
+    data.ptr = &value;
+    sink->profiler_->EmitEvent(marker, kUnityProfilerMarkerEventTypeSingle, 1,
+                               &data);
+  }
+
+ private:
+  const UnityProfilerMarkerDesc* GetSectionMarker(const char* name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = section_markers_.find(name);
+    if (it != section_markers_.end()) {
+      return it->second;
+    }
+    const UnityProfilerMarkerDesc* marker = nullptr;
+    if (profiler_->CreateMarker(&marker, name, kUnityProfilerCategoryVR,
+                                kUnityProfilerMarkerFlagDefault, 0) != 0) {
+      marker = nullptr;
+    }
+    section_markers_[name] = marker;
+    return marker;
+  }
+
+  const UnityProfilerMarkerDesc* GetCounterMarker(const char* name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = counter_markers_.find(name);
+    if (it != counter_markers_.end()) {
+      return it->second;
+    }
+    const UnityProfilerMarkerDesc* marker = nullptr;
+    if (profiler_->CreateMarker(&marker, name, kUnityProfilerCategoryVR,
+                                kUnityProfilerMarkerFlagCounter, 1) != 0 ||
+        profiler_->SetMarkerMetadataName(
+            marker, 0, "value", kUnityProfilerMarkerDataTypeInt64,
+            kUnityProfilerMarkerDataUnitCount) != 0) {
+      marker = nullptr;
+    }
+    counter_markers_[name] = marker;
+    return marker;
+  }
+
+  IUnityProfiler* profiler_;
+  std::mutex mutex_;
+  std::unordered_map<const char*, const UnityProfilerMarkerDesc*>
+      section_markers_;
+  std::unordered_map<const char*, const UnityProfilerMarkerDesc*>
+      counter_markers_;
+};
+
+}  // namespace
+
+void LoadProfiler(IUnityInterfaces* unity_interfaces) {
+  auto* profiler = unity_interfaces->Get<IUnityProfiler>();
+  if (profiler == nullptr || !profiler->IsAvailable()) {
+    // The Unity Profiler is compiled out of release players. The platform
+    // sink keeps receiving the events.
+    CARDBOARD_PROFILER_XR_TRACE_LOG(unity_interfaces->Get<IUnityXRTrace>(),
+                                    "Unity Profiler is not available.");
+    return;
+  }
+
+  // Spans may still be open on the sink when the plugin is unloaded, so it is
+  // never destroyed.
+  static UnityProfilerTraceSink* unity_profiler_trace_sink =
+      new UnityProfilerTraceSink(profiler);
+  static const cardboard::util::TraceSink trace_sink = {
+      UnityProfilerTraceSink::BeginSection, UnityProfilerTraceSink::EndSection,
+      UnityProfilerTraceSink::SetCounter, unity_profiler_trace_sink};
+  cardboard::util::SetTraceSink(&trace_sink);
+}
+
+void UnloadProfiler() { cardboard::util::SetTraceSink(nullptr); }
+
+#else
+
+void LoadProfiler(IUnityInterfaces* /*unity_interfaces*/) {}
+
+void UnloadProfiler() {}
+
+#endif  // CARDBOARD_ENABLE_TRACING
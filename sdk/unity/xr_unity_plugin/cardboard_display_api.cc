@@ -18,6 +18,7 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cstdint>
@@ -27,6 +28,8 @@
 #include <string>
 #include <vector>
 
+#include "unity/xr_unity_plugin/cardboard_input_api.h"
+
 // The following block makes log macros available for Android and iOS.
 #if defined(__ANDROID__)
 #include <android/log.h>
@@ -75,6 +78,18 @@ std::mutex CardboardDisplayApi::widget_mutex_;
 
 std::atomic<bool> CardboardDisplayApi::device_params_changed_(true);
 
+std::atomic<bool> CardboardDisplayApi::reduced_resolution_eye_textures_enabled_(
+    false);
+
+std::atomic<bool> CardboardDisplayApi::dynamic_resolution_enabled_(false);
+
+std::atomic<bool> CardboardDisplayApi::stats_enabled_(false);
+
+std::atomic<int> CardboardDisplayApi::eye_texture_slot_count_(1);
+
+std::atomic<bool> CardboardDisplayApi::multisampled_eye_textures_enabled_(
+    false);
+
 std::atomic<CardboardGraphicsApi> CardboardDisplayApi::selected_graphics_api_(
     kNone);
 
@@ -106,9 +121,34 @@ CardboardDisplayApi::CardboardDisplayApi() {
           static_cast<int>(selected_graphics_api_));
       break;
   }
+
+  // Builds the shader programs now, on the rendering thread, so that
+  // UpdateDeviceParams() restores them from their binaries each time the
+  // device parameters change.
+  if (renderer_ != nullptr) {
+    renderer_->PrewarmPrograms();
+  }
+  const CardboardOpenGlEsDistortionRendererConfig
+      opengl_distortion_renderer_config{kGlTexture2D};
+  if (selected_graphics_api_ == CardboardGraphicsApi::kOpenGlEs2) {
+    CardboardOpenGlEs2DistortionRenderer_prewarm(
+        &opengl_distortion_renderer_config);
+  } else if (selected_graphics_api_ == CardboardGraphicsApi::kOpenGlEs3) {
+    // #gles3 - This call is only needed if OpenGL ES 3.0 support is desired.
+    CardboardOpenGlEs3DistortionRenderer_prewarm(
+        &opengl_distortion_renderer_config);
+  }
+
+  // Reloads the device parameters as soon as new ones are saved instead of
+  // waiting for the application to flag the change.
+  CardboardQrCode_setDeviceParamsChangedCallback(
+      [](void* /*user_data*/) { device_params_changed_ = true; }, nullptr);
 }
 
-CardboardDisplayApi::~CardboardDisplayApi() { RenderingResourcesTeardown(); }
+CardboardDisplayApi::~CardboardDisplayApi() {
+  CardboardQrCode_setDeviceParamsChangedCallback(nullptr, nullptr);
+  RenderingResourcesTeardown();
+}
 
 void CardboardDisplayApi::ScanDeviceParams() {
   CardboardQrCode_scanQrCodeAndSaveDeviceParams();
@@ -125,24 +165,26 @@ void CardboardDisplayApi::UpdateDeviceParams() {
   // Updates the screen size.
   screen_params_ = unity_screen_params_;
 
-  // Get saved device parameters
-  uint8_t* data;
-  int size;
-  CardboardQrCode_getSavedDeviceParams(&data, &size);
-  CardboardLensDistortion* lens_distortion;
-  if (size == 0) {
+  // Get saved device parameters. They are shared with the SDK, so neither
+  // copied nor parsed again.
+  CardboardDeviceParams* device_params =
+      CardboardQrCode_acquireSavedDeviceParams();
+  if (device_params == nullptr) {
     // Loads Cardboard V1 device parameters when no device parameters are
     // available.
+    uint8_t* data;
+    int size;
     CardboardQrCode_getCardboardV1DeviceParams(&data, &size);
-    lens_distortion = CardboardLensDistortion_create(
+    lens_distortion_.reset(CardboardLensDistortion_create(
         data, size, screen_params_.viewport_width,
-        screen_params_.viewport_height);
+        screen_params_.viewport_height));
   } else {
-    lens_distortion = CardboardLensDistortion_create(
-        data, size, screen_params_.viewport_width,
-        screen_params_.viewport_height);
-    CardboardQrCode_destroy(data);
+    lens_distortion_.reset(CardboardLensDistortion_createFromDeviceParams(
+        device_params, screen_params_.viewport_width,
+        screen_params_.viewport_height));
+    CardboardDeviceParams_release(device_params);
   }
+  CardboardLensDistortion* lens_distortion = lens_distortion_.get();
   device_params_changed_ = false;
 
   RenderingResourcesSetup();
@@ -181,17 +223,17 @@ void CardboardDisplayApi::UpdateDeviceParams() {
       break;
   }
 
-  CardboardLensDistortion_getDistortionMesh(
+  CardboardLensDistortion_getChromaticDistortionMesh(
       lens_distortion, CardboardEye::kLeft,
       &eye_data_[CardboardEye::kLeft].distortion_mesh);
-  CardboardLensDistortion_getDistortionMesh(
+  CardboardLensDistortion_getChromaticDistortionMesh(
       lens_distortion, CardboardEye::kRight,
       &eye_data_[CardboardEye::kRight].distortion_mesh);
 
-  CardboardDistortionRenderer_setMesh(
+  CardboardDistortionRenderer_setChromaticMesh(
       distortion_renderer_.get(),
       &eye_data_[CardboardEye::kLeft].distortion_mesh, CardboardEye::kLeft);
-  CardboardDistortionRenderer_setMesh(
+  CardboardDistortionRenderer_setChromaticMesh(
       distortion_renderer_.get(),
       &eye_data_[CardboardEye::kRight].distortion_mesh, CardboardEye::kRight);
 
@@ -206,8 +248,6 @@ void CardboardDisplayApi::UpdateDeviceParams() {
                                          eye_data_[CardboardEye::kLeft].fov);
   CardboardLensDistortion_getFieldOfView(lens_distortion, CardboardEye::kRight,
                                          eye_data_[CardboardEye::kRight].fov);
-
-  CardboardLensDistortion_destroy(lens_distortion);
 }
 
 void CardboardDisplayApi::GetEyeMatrices(int eye, float* eye_from_head,
@@ -217,12 +257,46 @@ void CardboardDisplayApi::GetEyeMatrices(int eye, float* eye_from_head,
   std::memcpy(fov, eye_data_[eye].fov, sizeof(float) * 4);
 }
 
+void CardboardDisplayApi::LatchRenderHeadOrientation() {
+  // Reads the pose the simulation thread set the cameras up with, which may
+  // not be the latest one.
+  is_render_pose_valid_ =
+      CardboardInputApi::GetFrameHeadTrackerPose(&render_pose_);
+}
+
+float CardboardDisplayApi::UpdateEyeTextureScale() {
+  // Presenting blocks while the GPU is behind, so the frame setup interval
+  // includes the GPU cost of the previous frames.
+  const std::chrono::steady_clock::time_point now =
+      std::chrono::steady_clock::now();
+  if (is_frame_started_) {
+    resolution_governor_.AddFrame(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            now - frame_start_time_)
+            .count());
+  }
+  frame_start_time_ = now;
+  is_frame_started_ = true;
+
+  const float scale =
+      dynamic_resolution_enabled_ ? resolution_governor_.GetScale() : 1.0f;
+  for (EyeData& eye_data : eye_data_) {
+    eye_data.texture.right_u = scale;
+    eye_data.texture.top_v = scale;
+  }
+  return scale;
+}
+
 void CardboardDisplayApi::RenderEyesToDisplay() {
+  LateLatchHeadOrientation();
   const Renderer::ScreenParams screen_params =
       ScreenParamsToRendererScreenParams(screen_params_);
   renderer_->RenderEyesToDisplay(distortion_renderer_.get(), screen_params,
                                  &eye_data_[CardboardEye::kLeft].texture,
                                  &eye_data_[CardboardEye::kRight].texture);
+  if (render_textures_.size() > 1) {
+    renderer_->ReleaseEyeTextureSlot(eye_texture_slot_);
+  }
 }
 
 void CardboardDisplayApi::RenderWidgets() {
@@ -242,20 +316,53 @@ void CardboardDisplayApi::RunRenderingPostProcessing() {
   renderer_->RunRenderingPostProcessing();
 }
 
-uint64_t CardboardDisplayApi::GetLeftTextureColorBufferId() {
-  return render_textures_[CardboardEye::kLeft].color_buffer;
+uint64_t CardboardDisplayApi::GetLeftTextureColorBufferId(int slot) {
+  return render_textures_[slot][CardboardEye::kLeft].color_buffer;
+}
+
+uint64_t CardboardDisplayApi::GetRightTextureColorBufferId(int slot) {
+  return render_textures_[slot][CardboardEye::kRight].color_buffer;
+}
+
+uint64_t CardboardDisplayApi::GetLeftTextureDepthBufferId(int slot) {
+  return render_textures_[slot][CardboardEye::kLeft].depth_buffer;
 }
 
-uint64_t CardboardDisplayApi::GetRightTextureColorBufferId() {
-  return render_textures_[CardboardEye::kRight].color_buffer;
+uint64_t CardboardDisplayApi::GetRightTextureDepthBufferId(int slot) {
+  return render_textures_[slot][CardboardEye::kRight].depth_buffer;
 }
 
-uint64_t CardboardDisplayApi::GetLeftTextureDepthBufferId() {
-  return render_textures_[CardboardEye::kLeft].depth_buffer;
+void CardboardDisplayApi::GetEyeTextureSize(int* width, int* height) {
+  *width = eye_texture_width_;
+  *height = eye_texture_height_;
+}
+
+uint32_t CardboardDisplayApi::GetTextureGeneration() const {
+  return render_textures_.empty() ? 0 : texture_generation_;
+}
+
+int CardboardDisplayApi::GetEyeTextureSlotCount() const {
+  return static_cast<int>(render_textures_.size());
+}
+
+int CardboardDisplayApi::AcquireNextEyeTextureSlot() {
+  if (render_textures_.size() <= 1) {
+    // With a single slot, Unity and the distortion pass share the eye textures
+    // and the driver serializes them.
+    return 0;
+  }
+  eye_texture_slot_ = (eye_texture_slot_ + 1) % GetEyeTextureSlotCount();
+  renderer_->AcquireEyeTextureSlot(eye_texture_slot_);
+  for (CardboardEye eye : {CardboardEye::kLeft, CardboardEye::kRight}) {
+    eye_data_[eye].texture.texture =
+        render_textures_[eye_texture_slot_][eye].color_buffer;
+  }
+  return eye_texture_slot_;
 }
 
-uint64_t CardboardDisplayApi::GetRightTextureDepthBufferId() {
-  return render_textures_[CardboardEye::kRight].depth_buffer;
+bool CardboardDisplayApi::AreEyeTexturesMultisampled() const {
+  return !render_textures_.empty() &&
+         render_textures_[0][CardboardEye::kLeft].multisampled;
 }
 
 void CardboardDisplayApi::GetScreenParams(int* width, int* height) {
@@ -299,6 +406,40 @@ void CardboardDisplayApi::SetWidgetParams(
   widget_params_[i] = params;
 }
 
+void CardboardDisplayApi::SetReducedResolutionEyeTexturesEnabled(
+    bool enabled) {
+  if (reduced_resolution_eye_textures_enabled_.exchange(enabled) != enabled) {
+    // Eye textures must be reallocated.
+    device_params_changed_ = true;
+  }
+}
+
+void CardboardDisplayApi::SetDynamicResolutionEnabled(bool enabled) {
+  dynamic_resolution_enabled_ = enabled;
+}
+
+void CardboardDisplayApi::SetStatsEnabled(bool enabled) {
+  stats_enabled_ = enabled;
+  CardboardStats_setEnabled(enabled ? 1 : 0);
+}
+
+bool CardboardDisplayApi::IsStatsEnabled() { return stats_enabled_; }
+
+void CardboardDisplayApi::SetMultisampledEyeTexturesEnabled(bool enabled) {
+  if (multisampled_eye_textures_enabled_.exchange(enabled) != enabled) {
+    // Eye textures must be reallocated.
+    device_params_changed_ = true;
+  }
+}
+
+void CardboardDisplayApi::SetEyeTextureSlotCount(int count) {
+  count = std::clamp(count, 1, Renderer::kMaxEyeTextureSlotCount);
+  if (eye_texture_slot_count_.exchange(count) != count) {
+    // Eye textures must be reallocated.
+    device_params_changed_ = true;
+  }
+}
+
 void CardboardDisplayApi::SetGraphicsApi(CardboardGraphicsApi graphics_api) {
   selected_graphics_api_ = graphics_api;
 }
@@ -320,29 +461,56 @@ void CardboardDisplayApi::RenderingResourcesSetup() {
     return;
   }
 
-  if (render_textures_[0].color_buffer != 0) {
+  if (!render_textures_.empty()) {
     RenderingResourcesTeardown();
   }
 
-  // Create render texture, depth buffer for both eyes and setup widgets.
-  renderer_->CreateRenderTexture(&render_textures_[CardboardEye::kLeft],
-                                 screen_params_.viewport_width,
-                                 screen_params_.viewport_height);
-  renderer_->CreateRenderTexture(&render_textures_[CardboardEye::kRight],
-                                 screen_params_.viewport_width,
-                                 screen_params_.viewport_height);
+  // Each eye texture covers half of the rendering area by default. The lenses
+  // magnify the texture, so it may be shrunk down to the pixel density they
+  // can resolve. Both eyes share the size given that their meshes mirror.
+  eye_texture_width_ = screen_params_.viewport_width / 2;
+  eye_texture_height_ = screen_params_.viewport_height;
+  if (reduced_resolution_eye_textures_enabled_) {
+    int width;
+    int height;
+    CardboardLensDistortion_getRecommendedEyeTextureSize(
+        lens_distortion_.get(), CardboardEye::kLeft, &width, &height);
+    if (width > 0 && height > 0) {
+      eye_texture_width_ = std::min(eye_texture_width_, width);
+      eye_texture_height_ = std::min(eye_texture_height_, height);
+    }
+  }
+
+  // Create render texture, depth buffer for both eyes of every slot and setup
+  // widgets.
+  render_textures_.resize(eye_texture_slot_count_);
+  for (std::array<Renderer::RenderTexture, 2>& slot : render_textures_) {
+    for (Renderer::RenderTexture& render_texture : slot) {
+      renderer_->CreateRenderTexture(
+          &render_texture, screen_params_.viewport_width,
+          screen_params_.viewport_height, eye_texture_width_,
+          eye_texture_height_, multisampled_eye_textures_enabled_);
+    }
+  }
+  if (multisampled_eye_textures_enabled_ && !AreEyeTexturesMultisampled()) {
+    LOGW(
+        "Multisampled eye textures are not supported by the selected Graphics "
+        "API or device.");
+  }
   renderer_->SetupWidgets();
+  eye_texture_slot_ = 0;
+  ++texture_generation_;
 
   // Set texture description structures.
   eye_data_[CardboardEye::kLeft].texture.texture =
-      render_textures_[CardboardEye::kLeft].color_buffer;
+      render_textures_[0][CardboardEye::kLeft].color_buffer;
   eye_data_[CardboardEye::kLeft].texture.left_u = 0;
   eye_data_[CardboardEye::kLeft].texture.right_u = 1;
   eye_data_[CardboardEye::kLeft].texture.top_v = 1;
   eye_data_[CardboardEye::kLeft].texture.bottom_v = 0;
 
   eye_data_[CardboardEye::kRight].texture.texture =
-      render_textures_[CardboardEye::kRight].color_buffer;
+      render_textures_[0][CardboardEye::kRight].color_buffer;
   eye_data_[CardboardEye::kRight].texture.left_u = 0;
   eye_data_[CardboardEye::kRight].texture.right_u = 1;
   eye_data_[CardboardEye::kRight].texture.top_v = 1;
@@ -350,14 +518,37 @@ void CardboardDisplayApi::RenderingResourcesSetup() {
 }
 
 void CardboardDisplayApi::RenderingResourcesTeardown() {
-  if (render_textures_[0].color_buffer == 0) {
+  if (render_textures_.empty()) {
     return;
   }
-  renderer_->DestroyRenderTexture(&render_textures_[CardboardEye::kLeft]);
-  renderer_->DestroyRenderTexture(&render_textures_[CardboardEye::kRight]);
+  for (std::array<Renderer::RenderTexture, 2>& slot : render_textures_) {
+    for (Renderer::RenderTexture& render_texture : slot) {
+      renderer_->DestroyRenderTexture(&render_texture);
+    }
+  }
+  render_textures_.clear();
   renderer_->TeardownWidgets();
 }
 
+void CardboardDisplayApi::LateLatchHeadOrientation() {
+  std::array<float, 4> display_orientation;
+  if (!is_render_pose_valid_ ||
+      !CardboardInputApi::GetLateLatchedHeadTrackerOrientation(
+          render_pose_.viewport_orientation, display_orientation.data())) {
+    // Without both orientations, the eye textures are distorted as rendered.
+    display_orientation = render_pose_.orientation;
+  }
+
+  for (CardboardEye eye : {CardboardEye::kLeft, CardboardEye::kRight}) {
+    std::array<float, 9> reprojection;
+    CardboardLensDistortion_getRotationalReprojection(
+        lens_distortion_.get(), eye, render_pose_.orientation.data(),
+        display_orientation.data(), reprojection.data());
+    CardboardDistortionRenderer_setReprojection(
+        distortion_renderer_.get(), reprojection.data(), eye);
+  }
+}
+
 Renderer::ScreenParams CardboardDisplayApi::ScreenParamsToRendererScreenParams(
     const ScreenParams& screen_params) const {
   return Renderer::ScreenParams{
@@ -429,6 +620,28 @@ void CardboardUnity_setGraphicsApi(CardboardGraphicsApi graphics_api) {
   }
 }
 
+void CardboardUnity_setReducedResolutionEyeTexturesEnabled(bool enabled) {
+  cardboard::unity::CardboardDisplayApi::SetReducedResolutionEyeTexturesEnabled(
+      enabled);
+}
+
+void CardboardUnity_setDynamicResolutionEnabled(bool enabled) {
+  cardboard::unity::CardboardDisplayApi::SetDynamicResolutionEnabled(enabled);
+}
+
+void CardboardUnity_setStatsEnabled(bool enabled) {
+  cardboard::unity::CardboardDisplayApi::SetStatsEnabled(enabled);
+}
+
+void CardboardUnity_setEyeTextureSlotCount(int count) {
+  cardboard::unity::CardboardDisplayApi::SetEyeTextureSlotCount(count);
+}
+
+void CardboardUnity_setMultisampledEyeTexturesEnabled(bool enabled) {
+  cardboard::unity::CardboardDisplayApi::SetMultisampledEyeTexturesEnabled(
+      enabled);
+}
+
 #ifdef __cplusplus
 }
 #endif
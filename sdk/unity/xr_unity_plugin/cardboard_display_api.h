@@ -18,6 +18,7 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
 #include <cstdint>
 #include <memory>
 #include <mutex>
@@ -25,7 +26,9 @@
 #include <vector>
 
 #include "include/cardboard.h"
+#include "unity/xr_unity_plugin/pose_mailbox.h"
 #include "unity/xr_unity_plugin/renderer.h"
+#include "unity/xr_unity_plugin/resolution_governor.h"
 #include "IUnityInterface.h"
 
 /// @brief Determines the supported graphics APIs.
@@ -75,7 +78,33 @@ class CardboardDisplayApi {
   ///             bottom, top] field of view angles in radians.
   void GetEyeMatrices(int eye, float* eye_from_head, float* fov);
 
+  /// @brief Latches the head pose the next frame is rendered with.
+  /// @details It must be called once every time the next frame is set up,
+  ///          since frame tags are read back in order. It reads, without
+  ///          blocking, the exact pose the simulation thread tagged the frame
+  ///          with, so it matches the one used to render the eye textures
+  ///          even when newer poses were computed or the following frame was
+  ///          tagged since. When that pose is not available, the frame is
+  ///          distorted without late-latching.
+  /// @pre It must be called from the rendering thread.
+  void LatchRenderHeadOrientation();
+
+  /// @brief Selects the eye texture resolution scale for the next frame.
+  /// @details When dynamic resolution is enabled, the scale follows the
+  ///          display pacing of the previous frames. The next frame must be
+  ///          rendered into the lower left sub-rectangle of the eye textures
+  ///          spanning the returned fraction of each dimension, which is the
+  ///          one the distortion pass samples. Eye textures are never
+  ///          reallocated.
+  /// @pre It must be called from the rendering thread, once per frame when it
+  ///      is set up.
+  /// @return The eye texture resolution scale in (0, 1].
+  float UpdateEyeTextureScale();
+
   /// @brief Renders both distortion meshes to the screen.
+  /// @details Before distortion, the head pose is queried again and the eye
+  ///          textures are reprojected to compensate the head rotation since
+  ///          LatchRenderHeadOrientation() was called.
   /// @pre It must be called from the rendering thread.
   void RenderEyesToDisplay();
 
@@ -94,34 +123,88 @@ class CardboardDisplayApi {
   /// @brief Gets the left eye texture color buffer ID.
   /// @pre UpdateDeviceParams() must have been successfully called.
   ///
+  /// @param slot Index of the eye texture slot in [0,
+  ///        GetEyeTextureSlotCount()).
+  ///
   /// @return The left eye texture color buffer ID. When using OpenGL ES 2.x and
   ///     OpenGL ES 3.x, the returned value holds a GLuint variable. When using
   ///     Metal, the returned value holds an IOSurfaceRef variable.
-  uint64_t GetLeftTextureColorBufferId();
+  uint64_t GetLeftTextureColorBufferId(int slot);
 
   /// @brief Gets the right eye texture color buffer ID.
   /// @pre UpdateDeviceParams() must have been successfully called.
   ///
+  /// @param slot Index of the eye texture slot in [0,
+  ///        GetEyeTextureSlotCount()).
+  ///
   /// @return The right eye texture color buffer ID. When using OpenGL ES 2.x
   ///     and OpenGL ES 3.x, the returned value holds a GLuint variable. When
   ///     using Metal, the returned value holds an IOSurfaceRef variable.
-  uint64_t GetRightTextureColorBufferId();
+  uint64_t GetRightTextureColorBufferId(int slot);
 
   /// @brief Gets the left eye texture depth buffer ID.
   /// @pre UpdateDeviceParams() must have been successfully called.
   ///
+  /// @param slot Index of the eye texture slot in [0,
+  ///        GetEyeTextureSlotCount()).
+  ///
   /// @return The left eye texture depth buffer ID. When using OpenGL ES 2.x and
   ///     OpenGL ES 3.x, the returned value holds a GLuint variable. When using
   ///     Metal, the returned value is zero.
-  uint64_t GetLeftTextureDepthBufferId();
+  uint64_t GetLeftTextureDepthBufferId(int slot);
 
   /// @brief Gets the right eye texture depth buffer ID.
   /// @pre UpdateDeviceParams() must have been successfully called.
   ///
+  /// @param slot Index of the eye texture slot in [0,
+  ///        GetEyeTextureSlotCount()).
+  ///
   /// @return The right eye texture depth buffer ID. When using OpenGL ES 2.x
   ///     and OpenGL ES 3.x, the returned value holds a GLuint variable. When
   ///     using Metal, the returned value is zero.
-  uint64_t GetRightTextureDepthBufferId();
+  uint64_t GetRightTextureDepthBufferId(int slot);
+
+  /// @brief Gets the eye texture size in pixels.
+  /// @pre UpdateDeviceParams() must have been successfully called.
+  ///
+  /// @param[out] width Pointer to an int to load the eye texture width in
+  ///             pixels.
+  /// @param[out] height Pointer to an int to load the eye texture height in
+  ///             pixels.
+  void GetEyeTextureSize(int* width, int* height);
+
+  /// @brief Gets the generation of the eye textures.
+  /// @details It changes every time the eye textures are reallocated, so
+  ///          their IDs and the eye matrices may be cached until then.
+  ///
+  /// @return The eye texture generation. Zero when no eye texture exists.
+  uint32_t GetTextureGeneration() const;
+
+  /// @brief Gets the number of eye texture slots.
+  /// @details Unity renders each frame into the eye textures of the next slot
+  ///          while the distortion pass still samples those of the previous
+  ///          frame, so both overlap on the GPU.
+  ///
+  /// @return The number of eye texture slots. Zero when no eye texture exists.
+  int GetEyeTextureSlotCount() const;
+
+  /// @brief Selects the eye texture slot the next frame is rendered into.
+  /// @details It waits until the GPU no longer samples the eye textures of the
+  ///          slot, which bounds how far the CPU runs ahead of the GPU.
+  /// @pre It must be called from the rendering thread, once per frame when it
+  ///      is set up.
+  ///
+  /// @return Index of the eye texture slot in [0, GetEyeTextureSlotCount()).
+  int AcquireNextEyeTextureSlot();
+
+  /// @brief Gets whether Unity must render into the eye textures with on-chip
+  ///        multisampling.
+  /// @details When true, the eye textures have no depth buffer and must be
+  ///          created with the auto resolve flag, so Unity allocates a
+  ///          transient multisampled depth buffer.
+  ///
+  /// @return true When the eye textures are multisampled, otherwise false.
+  bool AreEyeTexturesMultisampled() const;
 
   /// @brief Gets the rectangle size in pixels to draw into.
   ///
@@ -168,6 +251,46 @@ class CardboardDisplayApi {
   /// @return true When device parameters changed.
   static bool GetDeviceParametersChanged();
 
+  /// @brief Sets whether eye textures are sized to the pixel density the
+  ///        lenses can resolve instead of half of the rendering area.
+  /// @details The change takes effect the next time device parameters are
+  ///          updated, which this call requests.
+  /// @param enabled Whether reduced resolution eye textures are enabled.
+  static void SetReducedResolutionEyeTexturesEnabled(bool enabled);
+
+  /// @brief Sets whether the eye texture resolution scale adapts to the
+  ///        rendering cost.
+  /// @param enabled Whether dynamic resolution is enabled.
+  static void SetDynamicResolutionEnabled(bool enabled);
+
+  /// @brief Sets whether the Cardboard SDK runtime statistics are collected
+  ///        and reported to Unity XR stats.
+  /// @details It also enables or disables the collection in the Cardboard
+  ///          SDK, see CardboardStats_setEnabled().
+  /// @param enabled Whether runtime statistics are enabled.
+  static void SetStatsEnabled(bool enabled);
+
+  /// @brief Gets whether the runtime statistics are enabled.
+  /// @return Whether SetStatsEnabled() last enabled them.
+  static bool IsStatsEnabled();
+
+  /// @brief Sets the number of eye texture slots.
+  /// @details The change takes effect the next time device parameters are
+  ///          updated, which this call requests.
+  /// @param count The number of eye texture slots. It is clamped to [1,
+  ///        Renderer::kMaxEyeTextureSlotCount].
+  static void SetEyeTextureSlotCount(int count);
+
+  /// @brief Sets whether Unity renders into the eye textures with on-chip
+  ///        multisampling.
+  /// @details It requires OpenGL ES 3.0 and
+  ///          GL_EXT_multisampled_render_to_texture, it is ignored otherwise.
+  ///          The sample count follows the Unity anti-aliasing quality
+  ///          setting. The change takes effect the next time device
+  ///          parameters are updated, which this call requests.
+  /// @param enabled Whether multisampled eye textures are enabled.
+  static void SetMultisampledEyeTexturesEnabled(bool enabled);
+
   /// @brief Sets the Graphics API that should be used.
   /// @param graphics_api One of the possible CardboardGraphicsApi
   ///        implementations.
@@ -211,7 +334,7 @@ class CardboardDisplayApi {
     float fov[4];
 
     // @brief Cardboard distortion mesh for the eye.
-    CardboardMesh distortion_mesh;
+    CardboardChromaticMesh distortion_mesh;
 
     // @brief Cardboard texture description for the eye.
     CardboardEyeTextureDescription texture;
@@ -224,6 +347,17 @@ class CardboardDisplayApi {
     }
   };
 
+  // @brief Custom deleter for LensDistortion.
+  struct CardboardLensDistortionDeleter {
+    void operator()(CardboardLensDistortion* lens_distortion) {
+      CardboardLensDistortion_destroy(lens_distortion);
+    }
+  };
+
+  // @brief Sets the eye textures reprojection to compensate the head rotation
+  //        between the latched render orientation and a fresh orientation.
+  void LateLatchHeadOrientation();
+
   // @brief Configures rendering resources.
   void RenderingResourcesSetup();
 
@@ -257,6 +391,17 @@ class CardboardDisplayApi {
                   CardboardDistortionRendererDeleter>
       distortion_renderer_;
 
+  // @brief LensDistortion native pointer.
+  std::unique_ptr<CardboardLensDistortion, CardboardLensDistortionDeleter>
+      lens_distortion_;
+
+  // @brief Head pose the current frame was rendered with.
+  HeadPose render_pose_{
+      0, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f}, kLandscapeLeft};
+
+  // @brief Whether `render_pose_` holds a latched pose.
+  bool is_render_pose_valid_ = false;
+
   // @brief Screen parameters.
   // @details Must be used by rendering calls (or those to set up the pipeline).
   ScreenParams screen_params_;
@@ -266,8 +411,30 @@ class CardboardDisplayApi {
   //          `CardboardEye::kRight` holds the right eye data.
   std::array<EyeData, 2> eye_data_;
 
-  // @brief Holds the render texture information for each eye.
-  std::array<Renderer::RenderTexture, 2> render_textures_;
+  // @brief Eye texture width in pixels.
+  int eye_texture_width_ = 0;
+
+  // @brief Eye texture height in pixels.
+  int eye_texture_height_ = 0;
+
+  // @brief Chooses the eye texture resolution scale.
+  ResolutionGovernor resolution_governor_;
+
+  // @brief Start time of the frame being rendered.
+  std::chrono::steady_clock::time_point frame_start_time_;
+
+  // @brief Whether `frame_start_time_` holds the start of the current frame.
+  bool is_frame_started_ = false;
+
+  // @brief Holds the render texture information for each eye of each eye
+  // texture slot. It is empty when the eye textures are not allocated.
+  std::vector<std::array<Renderer::RenderTexture, 2>> render_textures_;
+
+  // @brief Index of the eye texture slot of the current frame.
+  int eye_texture_slot_ = 0;
+
+  // @brief Incremented every time `render_textures_` are reallocated.
+  uint32_t texture_generation_ = 0;
 
   // @brief Manages the rendering elements lifecycle.
   std::unique_ptr<Renderer> renderer_;
@@ -284,6 +451,23 @@ class CardboardDisplayApi {
   // @brief Track changes to device parameters.
   static std::atomic<bool> device_params_changed_;
 
+  // @brief Whether eye textures are sized from the lens pixel density.
+  static std::atomic<bool> reduced_resolution_eye_textures_enabled_;
+
+  // @brief Whether the eye texture resolution scale adapts to the rendering
+  // cost.
+  static std::atomic<bool> dynamic_resolution_enabled_;
+
+  // @brief Whether the runtime statistics are collected and reported.
+  static std::atomic<bool> stats_enabled_;
+
+  // @brief Number of eye texture slots to allocate. Apps opt into more than
+  // one through SetEyeTextureSlotCount().
+  static std::atomic<int> eye_texture_slot_count_;
+
+  // @brief Whether eye textures are rendered with on-chip multisampling.
+  static std::atomic<bool> multisampled_eye_textures_enabled_;
+
   // @brief Holds the selected graphics API.
   static std::atomic<CardboardGraphicsApi> selected_graphics_api_;
 
@@ -340,6 +524,34 @@ void CardboardUnity_setDeviceParametersChanged();
 /// @param graphics_api The graphics API to use.
 void CardboardUnity_setGraphicsApi(CardboardGraphicsApi graphics_api);
 
+/// @brief Sets whether eye textures are sized to the pixel density the lenses
+///        can resolve instead of half of the rendering area.
+/// @param enabled Whether reduced resolution eye textures are enabled.
+void CardboardUnity_setReducedResolutionEyeTexturesEnabled(bool enabled);
+
+/// @brief Sets whether the eye texture resolution scale adapts to the
+///        rendering cost.
+/// @param enabled Whether dynamic resolution is enabled.
+void CardboardUnity_setDynamicResolutionEnabled(bool enabled);
+
+/// @brief Sets whether the Cardboard SDK runtime statistics are collected and
+///        reported to Unity XR stats. They are disabled by default.
+/// @param enabled Whether runtime statistics are enabled.
+void CardboardUnity_setStatsEnabled(bool enabled);
+
+/// @brief Sets the number of eye texture slots rendered in turns. One slot
+///        serializes Unity rendering against the distortion pass, while each
+///        additional slot lets them overlap at the cost of another pair of
+///        eye textures.
+/// @param count The number of eye texture slots, in [1, 4]. Defaults to 1.
+void CardboardUnity_setEyeTextureSlotCount(int count);
+
+/// @brief Sets whether Unity renders into the eye textures with on-chip
+///        multisampling and resolve. It requires OpenGL ES 3.0 and
+///        GL_EXT_multisampled_render_to_texture.
+/// @param enabled Whether multisampled eye textures are enabled.
+void CardboardUnity_setMultisampledEyeTexturesEnabled(bool enabled);
+
 #ifdef __cplusplus
 }
 #endif
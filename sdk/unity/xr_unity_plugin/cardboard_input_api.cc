@@ -15,10 +15,14 @@
  */
 #include "unity/xr_unity_plugin/cardboard_input_api.h"
 
+#include <array>
 #include <atomic>
 #include <cstdint>
+#include <cstring>
+#include <mutex>  // NOLINT(build/c++11)
 
 #include "include/cardboard.h"
+#include "unity/xr_unity_plugin/pose_mailbox.h"
 
 // The following block makes log macros available for Android and iOS.
 #if defined(__ANDROID__)
@@ -59,14 +63,29 @@ void NSLog(CFStringRef format, ...);
 
 namespace cardboard::unity {
 
-std::atomic<CardboardViewportOrientation>
-    CardboardInputApi::selected_viewport_orientation_(kLandscapeLeft);
+std::atomic<uint32_t> CardboardInputApi::pending_control_(kLandscapeLeft);
 
-std::atomic<bool> CardboardInputApi::head_tracker_recenter_requested_(false);
+std::mutex CardboardInputApi::late_latch_mutex_;
+
+CardboardHeadTracker* CardboardInputApi::late_latch_head_tracker_{nullptr};
+
+PoseMailbox CardboardInputApi::pose_mailbox_;
+
+CardboardInputApi::~CardboardInputApi() {
+  std::lock_guard<std::mutex> l(late_latch_mutex_);
+  if (late_latch_head_tracker_ == head_tracker_.get()) {
+    late_latch_head_tracker_ = nullptr;
+    // The instance is destroyed on the simulation thread once it stopped
+    // computing poses, so it is still the mailbox producer.
+    pose_mailbox_.Clear();
+  }
+}
 
 void CardboardInputApi::InitHeadTracker() {
   if (head_tracker_ == nullptr) {
     head_tracker_.reset(CardboardHeadTracker_create());
+    std::lock_guard<std::mutex> l(late_latch_mutex_);
+    late_latch_head_tracker_ = head_tracker_.get();
   }
   CardboardHeadTracker_resume(head_tracker_.get());
 }
@@ -87,8 +106,8 @@ void CardboardInputApi::ResumeHeadTracker() {
   CardboardHeadTracker_resume(head_tracker_.get());
 }
 
-void CardboardInputApi::GetHeadTrackerPose(float* position,
-                                           float* orientation) {
+uint64_t CardboardInputApi::GetHeadTrackerPose(float* position,
+                                               float* orientation) {
   if (head_tracker_ == nullptr) {
     LOGW("Uninitialized head tracker was queried for the pose.");
     position[0] = 0.0f;
@@ -98,37 +117,84 @@ void CardboardInputApi::GetHeadTrackerPose(float* position,
     orientation[1] = 0.0f;
     orientation[2] = 0.0f;
     orientation[3] = 1.0f;
-    return;
+    return 0;
   }
 
-  // Checks whether a head tracker recentering has been requested.
-  if (head_tracker_recenter_requested_) {
+  // Consumes the recentering request and reads the viewport orientation at
+  // once.
+  const uint32_t control = pending_control_.fetch_and(
+      ~kRecenterRequestedFlag, std::memory_order_acq_rel);
+
+  HeadPose pose;
+  pose.viewport_orientation = static_cast<CardboardViewportOrientation>(
+      control & kViewportOrientationMask);
+  // The HeadTracker is owned by this instance and is thread-safe, so it is
+  // queried without waiting for a concurrent late-latch query.
+  if ((control & kRecenterRequestedFlag) != 0) {
     CardboardHeadTracker_recenter(head_tracker_.get());
-    head_tracker_recenter_requested_ = false;
   }
-
   CardboardHeadTracker_getPose(
-      head_tracker_.get(), GetBootTimeNano() + kPredictionTimeWithoutVsyncNanos,
-      selected_viewport_orientation_, position, orientation);
+      head_tracker_.get(),
+      CardboardHeadTracker_getPredictedDisplayTime(head_tracker_.get()),
+      pose.viewport_orientation, pose.position.data(),
+      pose.orientation.data());
+  const uint64_t sequence = pose_mailbox_.Publish(pose);
+
+  std::memcpy(position, pose.position.data(), sizeof(float) * 3);
+  std::memcpy(orientation, pose.orientation.data(), sizeof(float) * 4);
+  return sequence;
+}
+
+void CardboardInputApi::SetFramePoseSequence(uint64_t sequence) {
+  pose_mailbox_.TagFrame(sequence);
 }
 
 void CardboardInputApi::SetViewportOrientation(
     CardboardViewportOrientation viewport_orientation) {
-  selected_viewport_orientation_ = viewport_orientation;
+  // Keeps a pending recentering request.
+  uint32_t control = pending_control_.load(std::memory_order_relaxed);
+  while (!pending_control_.compare_exchange_weak(
+      control,
+      (control & ~kViewportOrientationMask) |
+          static_cast<uint32_t>(viewport_orientation),
+      std::memory_order_acq_rel)) {
+  }
 }
 
 void CardboardInputApi::SetHeadTrackerRecenterRequested() {
-  head_tracker_recenter_requested_ = true;
+  pending_control_.fetch_or(kRecenterRequestedFlag, std::memory_order_acq_rel);
 }
 
-int64_t CardboardInputApi::GetBootTimeNano() {
-  struct timespec res;
-#if defined(__ANDROID__)
-  clock_gettime(CLOCK_BOOTTIME, &res);
-#elif defined(__APPLE__)
-  clock_gettime(CLOCK_UPTIME_RAW, &res);
-#endif
-  return (res.tv_sec * CardboardInputApi::kNanosInSeconds) + res.tv_nsec;
+bool CardboardInputApi::GetFrameHeadTrackerPose(HeadPose* pose) {
+  switch (pose_mailbox_.ReadNextFrame(pose)) {
+    case PoseMailbox::ReadResult::kSuccess:
+      return true;
+    case PoseMailbox::ReadResult::kOverwritten:
+      LOGE(
+          "The head pose the frame was set up with was overwritten. The "
+          "rendering thread is more than %d poses or frames late.",
+          PoseMailbox::kCapacity);
+      return false;
+    case PoseMailbox::ReadResult::kNotPublished:
+    default:
+      return false;
+  }
+}
+
+bool CardboardInputApi::GetLateLatchedHeadTrackerOrientation(
+    CardboardViewportOrientation viewport_orientation, float* orientation) {
+  std::lock_guard<std::mutex> l(late_latch_mutex_);
+  if (late_latch_head_tracker_ == nullptr) {
+    return false;
+  }
+  // The distortion pass is submitted right after this call, so it is shown
+  // when a frame whose rendering starts now is.
+  std::array<float, 3> position;
+  CardboardHeadTracker_getPose(
+      late_latch_head_tracker_,
+      CardboardHeadTracker_getPredictedDisplayTime(late_latch_head_tracker_),
+      viewport_orientation, position.data(), orientation);
+  return true;
 }
 
 }  // namespace cardboard::unity
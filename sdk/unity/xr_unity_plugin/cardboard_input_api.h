@@ -16,11 +16,14 @@
 #ifndef CARDBOARD_SDK_UNITY_XR_UNITY_PLUGIN_CARDBOARD_INPUT_API_H_
 #define CARDBOARD_SDK_UNITY_XR_UNITY_PLUGIN_CARDBOARD_INPUT_API_H_
 
+#include <array>
 #include <atomic>
 #include <cstdint>
 #include <memory>
+#include <mutex>  // NOLINT(build/c++11)
 
 #include "include/cardboard.h"
+#include "unity/xr_unity_plugin/pose_mailbox.h"
 
 namespace cardboard::unity {
 
@@ -30,7 +33,7 @@ namespace cardboard::unity {
 class CardboardInputApi {
  public:
   CardboardInputApi() = default;
-  ~CardboardInputApi() = default;
+  ~CardboardInputApi();
 
   /// @brief Initializes and resumes the HeadTracker module.
   /// @pre Requires a prior call to @c Cardboard_initializeAndroid on Android
@@ -44,14 +47,30 @@ class CardboardInputApi {
   void ResumeHeadTracker();
 
   /// @brief Gets the pose of the HeadTracker module.
-  /// @details When the HeadTracker has not been initialized, @p position and
+  /// @details Pending recentering requests and viewport orientation changes
+  ///          are applied right before the HeadTracker is queried, so the pose
+  ///          always reflects all of them. The pose is then published with the
+  ///          next sequence number for the rendering thread. When the
+  ///          HeadTracker has not been initialized, @p position and
   ///          @p rotation are zeroed.
+  /// @pre It must only be called from the simulation thread.
   /// @param[out] position A pointer to an array with three floats to fill in
   ///             the position of the head.
   /// @param[out] orientation A pointer to an array with four floats to fill in
   ///             the quaternion that denotes the orientation of the head.
+  /// @return The sequence number of the published pose, or 0 when the
+  ///         HeadTracker has not been initialized.
   // TODO(b/154305848): Move argument types to std::array*.
-  void GetHeadTrackerPose(float* position, float* orientation);
+  uint64_t GetHeadTrackerPose(float* position, float* orientation);
+
+  /// @brief Tags the next frame with the pose its cameras are set up with.
+  /// @details Tags are queued and read back in order by
+  ///          GetFrameHeadTrackerPose(), so the simulation thread may tag the
+  ///          next frame before the rendering thread set up the current one.
+  /// @pre It must only be called from the simulation thread.
+  /// @param sequence The sequence number GetHeadTrackerPose() returned for
+  ///        the pose.
+  static void SetFramePoseSequence(uint64_t sequence);
 
   /// @brief Sets the viewport orientation that will be used.
   /// @param viewport_orientation one of the possible orientations of the
@@ -62,6 +81,34 @@ class CardboardInputApi {
   /// @brief Flags a head tracker recentering request.
   static void SetHeadTrackerRecenterRequested();
 
+  /// @brief Gets the pose the frame being set up was tagged with by
+  ///        SetFramePoseSequence().
+  /// @details It dequeues the oldest frame tag, so it must be called once for
+  ///          every frame set up. It never blocks nor queries the HeadTracker
+  ///          module. When the simulation thread published so many poses
+  ///          since the tagged one that it was overwritten, it fails and logs
+  ///          an error rather than returning a pose the frame was not
+  ///          rendered with.
+  /// @pre It must only be called from the rendering thread.
+  /// @param[out] pose The pose and its sequence number.
+  /// @return false When no frame tag is queued or the tagged pose was
+  ///         overwritten, otherwise true.
+  static bool GetFrameHeadTrackerPose(HeadPose* pose);
+
+  /// @brief Queries the HeadTracker module for a fresh orientation predicted
+  ///        for the time the distortion pass reaches the display.
+  /// @details It is meant to be called from the rendering thread right before
+  ///          distortion to late-latch the head pose.
+  /// @param viewport_orientation The viewport orientation of the pose the
+  ///        frame was rendered with, so both orientations share the same
+  ///        frame of reference.
+  /// @param[out] orientation A pointer to an array with four floats to fill in
+  ///             the quaternion that denotes the orientation of the head.
+  /// @return false When the HeadTracker has not been initialized, otherwise
+  ///         true.
+  static bool GetLateLatchedHeadTrackerOrientation(
+      CardboardViewportOrientation viewport_orientation, float* orientation);
+
  private:
   // @brief Custom deleter for HeadTracker.
   struct CardboardHeadTrackerDeleter {
@@ -70,26 +117,33 @@ class CardboardInputApi {
     }
   };
 
-  // @brief Computes the system boot time in nanoseconds.
-  // @return The system boot time count in nanoseconds.
-  static int64_t GetBootTimeNano();
-
-  // @brief Default prediction excess time in nano seconds.
-  static constexpr int64_t kPredictionTimeWithoutVsyncNanos = 50000000;
-
-  // @brief Constant to convert seconds into nano seconds.
-  static constexpr int64_t kNanosInSeconds = 1000000000;
-
   // @brief HeadTracker native pointer.
   std::unique_ptr<CardboardHeadTracker, CardboardHeadTrackerDeleter>
       head_tracker_;
 
-  // @brief Holds the selected viewport orientation.
-  static std::atomic<CardboardViewportOrientation>
-      selected_viewport_orientation_;
+  // @brief Flag set in `pending_control_` when a recentering is requested.
+  static constexpr uint32_t kRecenterRequestedFlag = 0x100;
+
+  // @brief Mask of the viewport orientation in `pending_control_`.
+  static constexpr uint32_t kViewportOrientationMask = 0xff;
+
+  // @brief Holds the selected viewport orientation and the recentering
+  // request flag. They share one atomic word so that GetHeadTrackerPose()
+  // consumes both with a single exchange and never sees a torn update.
+  static std::atomic<uint32_t> pending_control_;
+
+  // @brief Guards `late_latch_head_tracker_`, so the HeadTracker is not
+  // destroyed while the rendering thread late-latches the pose. HeadTracker
+  // queries themselves are thread-safe and are not serialized.
+  static std::mutex late_latch_mutex_;
+
+  // @brief HeadTracker used to late-latch the pose. It is the one owned by the
+  // live CardboardInputApi instance, or nullptr.
+  static CardboardHeadTracker* late_latch_head_tracker_;
 
-  // @brief Tracks head tracker recentering requests.
-  static std::atomic<bool> head_tracker_recenter_requested_;
+  // @brief Poses published by GetHeadTrackerPose() and the frames tagged with
+  // them, for the rendering thread.
+  static PoseMailbox pose_mailbox_;
 };
 
 #ifdef __cplusplus
@@ -16,7 +16,6 @@
 #import <MetalKit/MetalKit.h>
 #import <simd/simd.h>
 
-#include <array>
 #include <memory>
 #include <vector>
 
@@ -173,6 +172,14 @@ class MetalRenderer : public Renderer {
     }
   }
 
+  void ReleaseEyeTextureSlot(int /*slot*/) override {
+    // Nothing to do. Metal tracks the hazards of the eye textures.
+  }
+
+  void AcquireEyeTextureSlot(int /*slot*/) override {
+    // Nothing to do.
+  }
+
   void RunRenderingPreProcessing(
       const ScreenParams& /* screen_params */) override {
     // Nothing to do.
@@ -186,22 +193,23 @@ class MetalRenderer : public Renderer {
     CARDBOARD_LOGD("TeardownWidgets is a no-op method when using Metal.");
   }
 
-  void CreateRenderTexture(RenderTexture* render_texture, int screen_width,
-                           int screen_height) override {
+  void CreateRenderTexture(RenderTexture* render_texture, int screen_width, int screen_height,
+                           int texture_width, int texture_height,
+                           bool /*multisampled*/) override {
     id<MTLDevice> mtl_device = metal_interface_->MetalDevice();
 
     // Create texture color buffer.
     NSDictionary* color_surface_attribs = @{
-      (NSString*)kIOSurfaceWidth : @(screen_width / 2),
-      (NSString*)kIOSurfaceHeight : @(screen_height),
+      (NSString*)kIOSurfaceWidth : @(texture_width),
+      (NSString*)kIOSurfaceHeight : @(texture_height),
       (NSString*)kIOSurfaceBytesPerElement : @4u
     };
     IOSurfaceRef color_surface = IOSurfaceCreate((CFDictionaryRef)color_surface_attribs);
 
     MTLTextureDescriptor* texture_color_buffer_descriptor = [MTLTextureDescriptorClass new];
     texture_color_buffer_descriptor.textureType = MTLTextureType2D;
-    texture_color_buffer_descriptor.width = screen_width / 2;
-    texture_color_buffer_descriptor.height = screen_height;
+    texture_color_buffer_descriptor.width = texture_width;
+    texture_color_buffer_descriptor.height = texture_height;
     texture_color_buffer_descriptor.pixelFormat = MTLPixelFormatRGBA8Unorm;
     texture_color_buffer_descriptor.usage = MTLTextureUsageRenderTarget | MTLTextureUsageShaderRead;
     id<MTLTexture> color_texture =
@@ -215,10 +223,7 @@ class MetalRenderer : public Renderer {
     render_texture->depth_buffer = 0;
 
     // Store created buffer elements.
-    color_buffer_[eye_] = {color_surface, color_texture};
-
-    // Switch eye for the next CreateRenderTexture call.
-    eye_ = eye_ == kLeft ? kRight : kLeft;
+    color_buffers_.push_back({color_surface, color_texture});
 
     // Create a black texture. It is used to hide a rendering previously performed by Unity.
     // TODO(b/185478026): Prevent Unity from drawing a monocular scene when using Metal.
@@ -246,6 +251,12 @@ class MetalRenderer : public Renderer {
   }
 
   void DestroyRenderTexture(RenderTexture* render_texture) override {
+    for (auto it = color_buffers_.begin(); it != color_buffers_.end(); ++it) {
+      if (reinterpret_cast<uint64_t>(it->surface) == render_texture->color_buffer) {
+        color_buffers_.erase(it);
+        break;
+      }
+    }
     render_texture->color_buffer = 0;
     render_texture->depth_buffer = 0;
   }
@@ -264,10 +275,10 @@ class MetalRenderer : public Renderer {
     // An IOSurfaceRef was passed to Unity for drawing, but a reference to an id<MTLTexture> using
     // it must be passed to the SDK.
     CardboardEyeTextureDescription left_eye_description = *left_eye;
-    CFTypeRef left_color_texture = CFBridgingRetain(color_buffer_[kLeft].texture);
+    CFTypeRef left_color_texture = CFBridgingRetain(GetColorTexture(left_eye->texture));
     left_eye_description.texture = reinterpret_cast<uint64_t>(left_color_texture);
     CardboardEyeTextureDescription right_eye_description = *right_eye;
-    CFTypeRef right_color_texture = CFBridgingRetain(color_buffer_[kRight].texture);
+    CFTypeRef right_color_texture = CFBridgingRetain(GetColorTexture(right_eye->texture));
     right_eye_description.texture = reinterpret_cast<uint64_t>(right_color_texture);
 
     CardboardDistortionRenderer_renderEyeToDisplay(
@@ -285,6 +296,16 @@ class MetalRenderer : public Renderer {
     return start + (end - start) * val;
   }
 
+  // Returns the texture using the IOSurfaceRef handed to Unity as @p color_buffer.
+  id<MTLTexture> GetColorTexture(uint64_t color_buffer) const {
+    for (const ColorBuffer& buffer : color_buffers_) {
+      if (reinterpret_cast<uint64_t>(buffer.surface) == color_buffer) {
+        return buffer.texture;
+      }
+    }
+    return nil;
+  }
+
   void RenderWidget(id<MTLRenderCommandEncoder> mtl_render_command_encoder, int screen_width,
                     int screen_height, const WidgetParams& params) {
     // Convert coordinates to normalized space (-1,-1 - +1,+1).
@@ -349,8 +370,8 @@ class MetalRenderer : public Renderer {
     id<MTLTexture> texture;
   };
 
-  std::array<ColorBuffer, 2> color_buffer_;
-  CardboardEye eye_{kLeft};
+  // Color buffers of all the eye texture slots.
+  std::vector<ColorBuffer> color_buffers_;
 
   id<MTLTexture> black_texture_;
   id<MTLBuffer> black_texture_vertices_buffer_;
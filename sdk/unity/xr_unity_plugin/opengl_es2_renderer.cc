@@ -19,6 +19,7 @@
 #ifdef __APPLE__
 #include <OpenGLES/ES2/gl.h>
 #endif
+#include "rendering/opengl_program_cache.h"
 #include "util/logging.h"
 #include "unity/xr_unity_plugin/renderer.h"
 
@@ -145,13 +146,20 @@ class OpenGlEs2Renderer : public Renderer {
   OpenGlEs2Renderer() = default;
   ~OpenGlEs2Renderer() { TeardownWidgets(); }
 
+  void PrewarmPrograms() override {
+    cardboard::rendering::PrewarmCachedProgram(
+        kWidgetVertexShaderOpenGlEs2, kWidgetFragmentShaderOpenGlEs2,
+        CreateProgram);
+  }
+
   void SetupWidgets() override {
     if (widget_program_ != 0) {
       return;
     }
 
-    widget_program_ = CreateProgram(kWidgetVertexShaderOpenGlEs2,
-                                    kWidgetFragmentShaderOpenGlEs2);
+    widget_program_ = cardboard::rendering::CreateCachedProgram(
+        kWidgetVertexShaderOpenGlEs2, kWidgetFragmentShaderOpenGlEs2,
+        CreateProgram);
     widget_attrib_position_ =
         glGetAttribLocation(widget_program_, "a_Position");
     widget_attrib_tex_coords_ =
@@ -186,8 +194,10 @@ class OpenGlEs2Renderer : public Renderer {
     widget_program_ = 0;
   }
 
-  void CreateRenderTexture(RenderTexture* render_texture, int screen_width,
-                           int screen_height) override {
+  void CreateRenderTexture(RenderTexture* render_texture, int /*screen_width*/,
+                           int /*screen_height*/, int texture_width,
+                           int texture_height,
+                           bool /*multisampled*/) override {
     // Create texture color buffer.
     GLuint tmp = 0;
     glGenTextures(1, &tmp);
@@ -196,7 +206,7 @@ class OpenGlEs2Renderer : public Renderer {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, screen_width / 2, screen_height, 0,
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, texture_width, texture_height, 0,
                  GL_RGB, GL_UNSIGNED_BYTE, 0);
     CHECKGLERROR("Create texture color buffer.");
     render_texture->color_buffer = tmp;
@@ -206,7 +216,7 @@ class OpenGlEs2Renderer : public Renderer {
     glGenRenderbuffers(1, &tmp);
     glBindRenderbuffer(GL_RENDERBUFFER, tmp);
     glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16,
-                          screen_width / 2, screen_height);
+                          texture_width, texture_height);
     CHECKGLERROR("Create texture depth buffer.");
     render_texture->depth_buffer = tmp;
   }
@@ -233,6 +243,15 @@ class OpenGlEs2Renderer : public Renderer {
         screen_params.viewport_height, left_eye, right_eye);
   }
 
+  void ReleaseEyeTextureSlot(int /*slot*/) override {
+    // OpenGL ES 2.0 has no fences. The driver orders the accesses to the eye
+    // textures.
+  }
+
+  void AcquireEyeTextureSlot(int /*slot*/) override {
+    // Nothing to do.
+  }
+
   void RunRenderingPreProcessing(
       const ScreenParams& /* screen_params */) override {
     // Nothing to do.
@@ -19,6 +19,10 @@
 #ifdef __APPLE__
 #include <OpenGLES/ES3/gl.h>
 #endif
+#include <array>
+#include <cstring>
+
+#include "rendering/opengl_program_cache.h"
 #include "util/logging.h"
 #include "unity/xr_unity_plugin/renderer.h"
 
@@ -45,6 +49,16 @@ void CheckGlError(const char* file, int line, const char* label) {
   }
 }
 
+// Returns whether the current context can render into a single sample texture
+// with on-chip multisampling.
+bool IsMultisampledRenderToTextureSupported() {
+  const char* extensions =
+      reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+  return extensions != nullptr &&
+         strstr(extensions, "GL_EXT_multisampled_render_to_texture") !=
+             nullptr;
+}
+
 // TODO(b/155457703): De-dupe GL utility function here and in
 // distortion_renderer.cc
 GLuint LoadShader(GLenum shader_type, const char* source) {
@@ -144,15 +158,29 @@ const char kWidgetFragmentShaderOpenGlEs3[] =
 class OpenGlEs3Renderer : public Renderer {
  public:
   OpenGlEs3Renderer() = default;
-  ~OpenGlEs3Renderer() { TeardownWidgets(); }
+  ~OpenGlEs3Renderer() {
+    TeardownWidgets();
+    for (GLsync fence : eye_texture_slot_fences_) {
+      if (fence != nullptr) {
+        glDeleteSync(fence);
+      }
+    }
+  }
+
+  void PrewarmPrograms() override {
+    cardboard::rendering::PrewarmCachedProgram(
+        kWidgetVertexShaderOpenGlEs3, kWidgetFragmentShaderOpenGlEs3,
+        CreateProgram);
+  }
 
   void SetupWidgets() override {
     if (widget_program_ != 0) {
       return;
     }
 
-    widget_program_ = CreateProgram(kWidgetVertexShaderOpenGlEs3,
-                                    kWidgetFragmentShaderOpenGlEs3);
+    widget_program_ = cardboard::rendering::CreateCachedProgram(
+        kWidgetVertexShaderOpenGlEs3, kWidgetFragmentShaderOpenGlEs3,
+        CreateProgram);
     widget_attrib_position_ =
         glGetAttribLocation(widget_program_, "a_Position");
     widget_attrib_tex_coords_ =
@@ -187,8 +215,9 @@ class OpenGlEs3Renderer : public Renderer {
     widget_program_ = 0;
   }
 
-  void CreateRenderTexture(RenderTexture* render_texture, int screen_width,
-                           int screen_height) override {
+  void CreateRenderTexture(RenderTexture* render_texture, int /*screen_width*/,
+                           int /*screen_height*/, int texture_width,
+                           int texture_height, bool multisampled) override {
     // Create texture color buffer.
     GLuint tmp = 0;
     glGenTextures(1, &tmp);
@@ -197,17 +226,29 @@ class OpenGlEs3Renderer : public Renderer {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, screen_width / 2, screen_height, 0,
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, texture_width, texture_height, 0,
                  GL_RGB, GL_UNSIGNED_BYTE, 0);
     CHECKGLERROR("Create texture color buffer.");
     render_texture->color_buffer = tmp;
 
+    // With GL_EXT_multisampled_render_to_texture, Unity attaches the texture
+    // with glFramebufferTexture2DMultisampleEXT(): samples live in tile memory
+    // and are resolved when the tile is written back. Unity then owns the
+    // multisampled depth buffer and invalidates it at the end of the pass, so
+    // it never reaches DRAM.
+    render_texture->multisampled =
+        multisampled && IsMultisampledRenderToTextureSupported();
+    if (render_texture->multisampled) {
+      render_texture->depth_buffer = 0;
+      return;
+    }
+
     // Create texture depth buffer.
     tmp = 0;
     glGenRenderbuffers(1, &tmp);
     glBindRenderbuffer(GL_RENDERBUFFER, tmp);
     glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16,
-                          screen_width / 2, screen_height);
+                          texture_width, texture_height);
     CHECKGLERROR("Create texture depth buffer.");
     render_texture->depth_buffer = tmp;
   }
@@ -235,6 +276,29 @@ class OpenGlEs3Renderer : public Renderer {
         screen_params.viewport_height, left_eye, right_eye);
   }
 
+  void ReleaseEyeTextureSlot(int slot) override {
+    if (eye_texture_slot_fences_[slot] != nullptr) {
+      glDeleteSync(eye_texture_slot_fences_[slot]);
+    }
+    eye_texture_slot_fences_[slot] =
+        glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  }
+
+  void AcquireEyeTextureSlot(int slot) override {
+    GLsync fence = eye_texture_slot_fences_[slot];
+    if (fence == nullptr) {
+      return;
+    }
+    // The distortion pass sampling the slot was submitted a few frames ago,
+    // so the wait only throttles the CPU when it runs too far ahead.
+    if (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                         kEyeTextureSlotTimeoutNs) == GL_TIMEOUT_EXPIRED) {
+      CARDBOARD_LOGD("Timed out waiting for eye texture slot %d.", slot);
+    }
+    glDeleteSync(fence);
+    eye_texture_slot_fences_[slot] = nullptr;
+  }
+
   void RunRenderingPreProcessing(
       const ScreenParams& /* screen_params */) override {
     // Nothing to do.
@@ -294,9 +358,16 @@ class OpenGlEs3Renderer : public Renderer {
     CHECKGLERROR("RenderWidget");
   }
 
+  // @brief Maximum time to wait for an eye texture slot.
+  static constexpr GLuint64 kEyeTextureSlotTimeoutNs = 100000000;
+
   // @brief Widgets GL program.
   GLuint widget_program_{0};
 
+  // @brief Fences signaled when the distortion pass of each eye texture slot
+  // completes, or nullptr.
+  std::array<GLsync, kMaxEyeTextureSlotCount> eye_texture_slot_fences_{};
+
   // @brief Widgets "a_Position" attrib location.
   GLint widget_attrib_position_;
 
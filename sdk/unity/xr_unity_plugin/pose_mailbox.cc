@@ -0,0 +1,126 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "unity/xr_unity_plugin/pose_mailbox.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "include/cardboard.h"
+
+namespace cardboard::unity {
+
+PoseMailbox::PoseMailbox() : sequence_(0), first_sequence_(1) {}
+
+uint64_t PoseMailbox::Publish(const HeadPose& pose) {
+  const uint64_t sequence = sequence_.load(std::memory_order_relaxed) + 1;
+  Slot& slot = slots_[sequence % kCapacity];
+  // Marks the slot as being written before any of its values changes.
+  slot.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (size_t i = 0; i < pose.position.size(); ++i) {
+    slot.position[i].store(pose.position[i], std::memory_order_relaxed);
+  }
+  for (size_t i = 0; i < pose.orientation.size(); ++i) {
+    slot.orientation[i].store(pose.orientation[i], std::memory_order_relaxed);
+  }
+  slot.viewport_orientation.store(pose.viewport_orientation,
+                                  std::memory_order_relaxed);
+  slot.sequence.store(sequence, std::memory_order_release);
+  sequence_.store(sequence, std::memory_order_release);
+  return sequence;
+}
+
+void PoseMailbox::TagFrame(uint64_t sequence) {
+  const uint64_t frame = frame_count_.load(std::memory_order_relaxed);
+  FrameTag& tag = frame_tags_[frame % kCapacity];
+  // Marks the tag as being written before its sequence number changes.
+  tag.frame.store(kNoFrame, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  tag.sequence.store(sequence, std::memory_order_relaxed);
+  tag.frame.store(frame, std::memory_order_release);
+  frame_count_.store(frame + 1, std::memory_order_release);
+}
+
+void PoseMailbox::Clear() {
+  first_sequence_.store(sequence_.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_release);
+  first_frame_.store(frame_count_.load(std::memory_order_relaxed),
+                     std::memory_order_release);
+}
+
+PoseMailbox::ReadResult PoseMailbox::Read(uint64_t sequence,
+                                          HeadPose* pose) const {
+  if (sequence == 0 || sequence > sequence_.load(std::memory_order_acquire)) {
+    return ReadResult::kNotPublished;
+  }
+  if (sequence < first_sequence_.load(std::memory_order_acquire)) {
+    return ReadResult::kOverwritten;
+  }
+  const Slot& slot = slots_[sequence % kCapacity];
+  if (slot.sequence.load(std::memory_order_acquire) != sequence) {
+    return ReadResult::kOverwritten;
+  }
+
+  HeadPose copy;
+  copy.sequence = sequence;
+  for (size_t i = 0; i < copy.position.size(); ++i) {
+    copy.position[i] = slot.position[i].load(std::memory_order_relaxed);
+  }
+  for (size_t i = 0; i < copy.orientation.size(); ++i) {
+    copy.orientation[i] = slot.orientation[i].load(std::memory_order_relaxed);
+  }
+  copy.viewport_orientation = static_cast<CardboardViewportOrientation>(
+      slot.viewport_orientation.load(std::memory_order_relaxed));
+  // Orders the copy before checking that the producer did not start to
+  // rewrite the slot meanwhile.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+    return ReadResult::kOverwritten;
+  }
+  *pose = copy;
+  return ReadResult::kSuccess;
+}
+
+PoseMailbox::ReadResult PoseMailbox::ReadNextFrame(HeadPose* pose) {
+  const uint64_t frame_count = frame_count_.load(std::memory_order_acquire);
+  next_frame_ =
+      std::max(next_frame_, first_frame_.load(std::memory_order_acquire));
+  if (next_frame_ >= frame_count) {
+    return ReadResult::kNotPublished;
+  }
+  if (frame_count - next_frame_ > kCapacity) {
+    next_frame_ = frame_count - 1;
+    return ReadResult::kOverwritten;
+  }
+
+  const uint64_t frame = next_frame_++;
+  const FrameTag& tag = frame_tags_[frame % kCapacity];
+  if (tag.frame.load(std::memory_order_acquire) != frame) {
+    return ReadResult::kOverwritten;
+  }
+  const uint64_t sequence = tag.sequence.load(std::memory_order_relaxed);
+  // Orders the copy before checking that the producer did not start to
+  // rewrite the tag meanwhile.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (tag.frame.load(std::memory_order_relaxed) != frame) {
+    return ReadResult::kOverwritten;
+  }
+  return Read(sequence, pose);
+}
+
+}  // namespace cardboard::unity
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_UNITY_XR_UNITY_PLUGIN_POSE_MAILBOX_H_
+#define CARDBOARD_SDK_UNITY_XR_UNITY_PLUGIN_POSE_MAILBOX_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "include/cardboard.h"
+
+namespace cardboard::unity {
+
+/// @brief Head pose computed for a frame.
+struct HeadPose {
+  /// @brief Sequence number of the frame the pose was computed for. It
+  ///        increases with every published pose. Zero denotes no pose.
+  uint64_t sequence;
+  /// @brief Position of the head.
+  std::array<float, 3> position;
+  /// @brief Quaternion that denotes the orientation of the head.
+  std::array<float, 4> orientation;
+  /// @brief Viewport orientation the pose was computed with.
+  CardboardViewportOrientation viewport_orientation;
+};
+
+/// @brief Single-producer/single-consumer mailbox holding the latest head
+///        poses, each one retrievable by its sequence number.
+/// @details The poses are kept in a ring of kCapacity slots guarded by a
+///          sequence lock: the producer never blocks and the consumer copies
+///          a pose without locking, then checks that the producer did not
+///          overwrite it meanwhile. A consumer tagging a frame with the
+///          sequence number of the pose it was set up with therefore gets
+///          exactly that pose, or an explicit failure once kCapacity newer
+///          poses were published.
+///          Frames are tagged with the sequence number of their pose through
+///          a queue of kCapacity tags, read back in order. A frame tagged
+///          before the consumer read the tag of the previous one therefore
+///          does not replace it.
+class PoseMailbox {
+ public:
+  /// @brief Result of a Read() call.
+  enum class ReadResult {
+    /// @brief The requested pose was read.
+    kSuccess,
+    /// @brief No pose with the requested sequence number has been published
+    ///        since the mailbox was created or cleared.
+    kNotPublished,
+    /// @brief The requested pose was overwritten by newer ones or dropped by
+    ///        Clear().
+    kOverwritten,
+  };
+
+  /// @brief Number of latest poses retrievable by their sequence number.
+  static constexpr int kCapacity = 8;
+
+  /// @brief Constructs an empty PoseMailbox.
+  PoseMailbox();
+
+  /// @brief Publishes a pose, stamping it with the next sequence number.
+  /// @pre It must only be called from the producer thread.
+  /// @param pose The pose to publish. Its sequence number is ignored.
+  /// @return The sequence number of the published pose.
+  uint64_t Publish(const HeadPose& pose);
+
+  /// @brief Queues the sequence number of the pose the next frame is set up
+  ///        with.
+  /// @pre It must only be called from the producer thread.
+  /// @param sequence The sequence number returned by Publish().
+  void TagFrame(uint64_t sequence);
+
+  /// @brief Drops the published poses and the queued frame tags, so the
+  ///        consumer stops using them. Sequence numbers keep increasing.
+  /// @pre It must only be called from the producer thread.
+  void Clear();
+
+  /// @brief Gets the pose published with sequence number @p sequence.
+  /// @pre It must only be called from the consumer thread.
+  /// @param sequence The sequence number returned by Publish().
+  /// @param[out] pose The requested pose. It is only set on success.
+  /// @return The read result.
+  ReadResult Read(uint64_t sequence, HeadPose* pose) const;
+
+  /// @brief Dequeues the oldest frame tag and gets the pose it refers to.
+  /// @details When more than kCapacity frames were tagged since the previous
+  ///          call, the oldest tags are lost: it fails and the next call
+  ///          reads the latest tag.
+  /// @pre It must only be called from the consumer thread.
+  /// @param[out] pose The pose of the frame. It is only set on success.
+  /// @return kNotPublished when no frame tag is queued, otherwise the read
+  ///         result of the tagged pose.
+  ReadResult ReadNextFrame(HeadPose* pose);
+
+ private:
+  // @brief Pose slot. The pose is made of relaxed atomics so the consumer may
+  // copy it while the producer rewrites it; `sequence` tells whether the copy
+  // is consistent.
+  struct Slot {
+    // @brief Sequence number of the pose held by the slot, 0 while it is
+    // written or empty.
+    std::atomic<uint64_t> sequence{0};
+    std::array<std::atomic<float>, 3> position{};
+    std::array<std::atomic<float>, 4> orientation{};
+    std::atomic<int> viewport_orientation{kLandscapeLeft};
+  };
+
+  // @brief FrameTag::frame value of an empty frame tag slot.
+  static constexpr uint64_t kNoFrame = ~uint64_t{0};
+
+  // @brief Frame tag slot, guarded like the pose slots by `frame`.
+  struct FrameTag {
+    // @brief Index of the tagged frame, kNoFrame while it is written or empty.
+    std::atomic<uint64_t> frame{kNoFrame};
+    // @brief Sequence number of the pose of the frame.
+    std::atomic<uint64_t> sequence{0};
+  };
+
+  // @brief Pose slots, indexed by sequence number modulo kCapacity.
+  std::array<Slot, kCapacity> slots_;
+
+  // @brief Frame tag slots, indexed by frame index modulo kCapacity.
+  std::array<FrameTag, kCapacity> frame_tags_;
+
+  // @brief Sequence number of the latest published pose. Only written by the
+  // producer.
+  std::atomic<uint64_t> sequence_;
+
+  // @brief Sequence number of the oldest pose that Read() may return. Poses
+  // published before the latest Clear() call are older.
+  std::atomic<uint64_t> first_sequence_;
+
+  // @brief Number of tagged frames, which is the index of the next one. Only
+  // written by the producer.
+  std::atomic<uint64_t> frame_count_{0};
+
+  // @brief Index of the oldest frame whose tag ReadNextFrame() may return.
+  // Frames tagged before the latest Clear() call are older.
+  std::atomic<uint64_t> first_frame_{0};
+
+  // @brief Index of the frame ReadNextFrame() dequeues next. Only used by the
+  // consumer.
+  uint64_t next_frame_ = 0;
+};
+
+}  // namespace cardboard::unity
+
+#endif  // CARDBOARD_SDK_UNITY_XR_UNITY_PLUGIN_POSE_MAILBOX_H_
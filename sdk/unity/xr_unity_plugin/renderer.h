@@ -75,10 +75,25 @@ class Renderer {
     ///     ES 3.x, this field holds a GLuint variable. When using Metal, this
     ///     field is unused.
     uint64_t depth_buffer = 0;
+    /// @brief Whether Unity must render into the texture with on-chip
+    ///     multisampling and resolve it when the render pass ends. When set,
+    ///     depth_buffer is zero: Unity allocates a transient depth buffer and
+    ///     discards it at the end of the pass.
+    bool multisampled = false;
   };
 
+  /// @brief Maximum number of eye texture slots, i.e. sets of left and right
+  ///        eye textures rendered in turns.
+  static constexpr int kMaxEyeTextureSlotCount = 4;
+
   virtual ~Renderer() = default;
 
+  /// @brief Builds ahead of time the shader programs SetupWidgets() creates,
+  ///        so that setting up the widgets again, e.g. after the device
+  ///        parameters change, does not compile them. Does nothing by default.
+  /// @pre It must be called from the rendering thread.
+  virtual void PrewarmPrograms() {}
+
   /// @brief Initializes resources.
   /// @pre It must be called from the rendering thread.
   virtual void SetupWidgets() = 0;
@@ -100,8 +115,15 @@ class Renderer {
   /// @param render_texture A RenderTexture to load its resources.
   /// @param screen_width The width in pixels of the rectangle.
   /// @param screen_height The height in pixels of the rectangle.
+  /// @param texture_width The width in pixels of the eye texture.
+  /// @param texture_height The height in pixels of the eye texture.
+  /// @param multisampled Whether to create a texture Unity renders into with
+  ///        on-chip multisampling. Renderers which cannot resolve on chip
+  ///        ignore it, see RenderTexture::multisampled.
   virtual void CreateRenderTexture(RenderTexture* render_texture,
-                                   int screen_width, int screen_height) = 0;
+                                   int screen_width, int screen_height,
+                                   int texture_width, int texture_height,
+                                   bool multisampled) = 0;
 
   /// @brief Releases resources in a RenderTexture.
   ///
@@ -119,6 +141,25 @@ class Renderer {
       const CardboardEyeTextureDescription* left_eye,
       const CardboardEyeTextureDescription* right_eye) = 0;
 
+  /// @brief Marks the end of the commands sampling the eye textures of a
+  ///        slot.
+  /// @details It must be called right after the eye textures of @p slot were
+  ///          rendered onto the display.
+  ///
+  /// @param slot Index of the eye texture slot in [0,
+  ///        kMaxEyeTextureSlotCount).
+  virtual void ReleaseEyeTextureSlot(int slot) = 0;
+
+  /// @brief Waits until the commands recorded by the latest
+  ///        ReleaseEyeTextureSlot() call for a slot are completed.
+  /// @details It must be called before the eye textures of @p slot are handed
+  ///          to Unity again. Rendering APIs which track the texture hazards
+  ///          themselves do not wait.
+  ///
+  /// @param slot Index of the eye texture slot in [0,
+  ///        kMaxEyeTextureSlotCount).
+  virtual void AcquireEyeTextureSlot(int slot) = 0;
+
   /// @brief Runs commands needed before rendering.
   ///
   /// @param[in] screen_params The screen and rendering area details.
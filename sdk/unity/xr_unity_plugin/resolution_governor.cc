@@ -0,0 +1,128 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "unity/xr_unity_plugin/resolution_governor.h"
+
+#include <algorithm>
+#include <array>
+
+namespace cardboard::unity {
+
+namespace {
+
+// Eye texture resolution scales, from full resolution down. The pixel count
+// falls roughly 20% per level.
+constexpr std::array<float, ResolutionGovernor::kScaleLevelCount> kScaleLevels{
+    1.0f, 0.9f, 0.8f, 0.72f, 0.64f, 0.56f};
+
+// Frame budget assumed until frame intervals are reported: 60 Hz.
+constexpr double kDefaultFrameBudgetNanos = 1e9 / 60.0;
+
+// Shortest frame budget accepted: 120 Hz.
+constexpr double kMinFrameBudgetNanos = 1e9 / 120.0;
+
+// Factor by which the frame budget estimate relaxes every frame, so it
+// follows refresh rate decreases.
+constexpr double kFrameBudgetRelaxation = 1.001;
+
+// Frame intervals longer than this fraction of the budget missed a vsync.
+// Intervals jitter around the budget, and a missed vsync doubles it.
+constexpr double kMissedFrameBudgetFraction = 1.5;
+
+// Weight of the latest frame in the missed frame rate average.
+constexpr double kMissedFrameRateSmoothing = 0.05;
+
+// Missed frame rate above which the scale decreases. A few consecutive misses
+// reach it, isolated ones (e.g. a garbage collection) do not.
+constexpr double kDecreaseMissedFrameRate = 0.1;
+
+// Frames without a missed vsync before the next level up is first probed:
+// about 5 seconds at 60 Hz.
+constexpr int kInitialProbeFrames = 300;
+
+// Longest wait before probing a level whose previous probes failed.
+constexpr int kMaxProbeFrames = 16 * kInitialProbeFrames;
+
+// Frames after a scale increase during which a decrease fails the probe.
+constexpr int kProbeWindowFrames = 120;
+
+// Frames to wait after a scale change, so the measurements reflect the new
+// scale.
+constexpr int kCooldownFrames = 30;
+
+}  // namespace
+
+ResolutionGovernor::ResolutionGovernor() { Reset(); }
+
+void ResolutionGovernor::AddFrame(int64_t frame_interval_ns) {
+  if (frame_interval_ns <= 0) {
+    return;
+  }
+  frame_budget_ns_ = std::max(
+      kMinFrameBudgetNanos, std::min(frame_budget_ns_ * kFrameBudgetRelaxation,
+                                     static_cast<double>(frame_interval_ns)));
+  const bool is_missed =
+      frame_interval_ns > kMissedFrameBudgetFraction * frame_budget_ns_;
+  missed_frame_rate_ += kMissedFrameRateSmoothing *
+                        ((is_missed ? 1.0 : 0.0) - missed_frame_rate_);
+  frames_since_miss_ = is_missed ? 0 : frames_since_miss_ + 1;
+  if (probe_frames_left_ > 0) {
+    --probe_frames_left_;
+  }
+
+  if (cooldown_frames_ > 0) {
+    --cooldown_frames_;
+    return;
+  }
+
+  if (missed_frame_rate_ > kDecreaseMissedFrameRate &&
+      level_ < kScaleLevelCount - 1) {
+    if (probe_frames_left_ > 0) {
+      // The current level was just probed and cannot keep up: back off.
+      probe_frames_[level_] =
+          std::min(2 * probe_frames_[level_], kMaxProbeFrames);
+    }
+    SetLevel(level_ + 1);
+    return;
+  }
+
+  if (level_ > 0 && frames_since_miss_ >= probe_frames_[level_ - 1]) {
+    SetLevel(level_ - 1);
+    probe_frames_left_ = kProbeWindowFrames;
+  }
+}
+
+float ResolutionGovernor::GetScale() const { return kScaleLevels[level_]; }
+
+void ResolutionGovernor::Reset() {
+  level_ = 0;
+  frame_budget_ns_ = kDefaultFrameBudgetNanos;
+  missed_frame_rate_ = 0.0;
+  cooldown_frames_ = kCooldownFrames;
+  frames_since_miss_ = 0;
+  probe_frames_.fill(kInitialProbeFrames);
+  probe_frames_left_ = 0;
+}
+
+void ResolutionGovernor::SetLevel(int level) {
+  level_ = level;
+  // Misses measured at the previous scale say nothing about the new one.
+  missed_frame_rate_ = 0.0;
+  frames_since_miss_ = 0;
+  cooldown_frames_ = kCooldownFrames;
+  probe_frames_left_ = 0;
+}
+
+}  // namespace cardboard::unity
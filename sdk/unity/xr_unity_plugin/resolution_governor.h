@@ -0,0 +1,88 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_UNITY_XR_UNITY_PLUGIN_RESOLUTION_GOVERNOR_H_
+#define CARDBOARD_SDK_UNITY_XR_UNITY_PLUGIN_RESOLUTION_GOVERNOR_H_
+
+#include <array>
+#include <cstdint>
+
+namespace cardboard::unity {
+
+/// @brief Picks the eye texture resolution scale from the display pacing.
+/// @details Every frame reports the interval since the previous one. The
+///          smallest interval tracks the display refresh period, which is the
+///          frame budget, and longer intervals are frames that missed a
+///          vsync. Unlike CPU timings, intervals include the GPU cost of the
+///          frame on every graphics API, since presenting blocks while the GPU
+///          is behind. The scale steps down through a fixed set of levels when
+///          frames keep missing vsync. As intervals carry no headroom
+///          information, it probes the next level up after a run of frames
+///          without misses, and waits twice as long before probing a level
+///          again each time the probe fails. Changes are rate limited to avoid
+///          oscillations. It holds no graphics API state.
+class ResolutionGovernor {
+ public:
+  /// @brief Number of resolution scale levels.
+  static constexpr int kScaleLevelCount = 6;
+
+  /// @brief Constructs a ResolutionGovernor at full resolution.
+  ResolutionGovernor();
+
+  /// @brief Reports the start of a frame.
+  /// @param frame_interval_ns Time in nanoseconds since the previous frame
+  ///        started. Zero or negative when unknown, in which case the frame
+  ///        is ignored.
+  void AddFrame(int64_t frame_interval_ns);
+
+  /// @brief Gets the eye texture resolution scale to use.
+  /// @return A scale in (0, 1] applied to both eye texture dimensions.
+  float GetScale() const;
+
+  /// @brief Restores full resolution and discards the measurements.
+  void Reset();
+
+ private:
+  // @brief Switches to @p level and restarts the measurements.
+  void SetLevel(int level);
+
+  // @brief Index in the scale levels of the current scale.
+  int level_;
+
+  // @brief Estimated frame budget.
+  double frame_budget_ns_;
+
+  // @brief Exponential moving average of the fraction of frames that missed
+  // a vsync.
+  double missed_frame_rate_;
+
+  // @brief Frames left before the scale may change again.
+  int cooldown_frames_;
+
+  // @brief Consecutive frames without a missed vsync.
+  int frames_since_miss_;
+
+  // @brief Frames without a missed vsync needed before probing the next level
+  // up, per level.
+  std::array<int, kScaleLevelCount> probe_frames_;
+
+  // @brief Frames left during which a miss rate increase fails the probe of
+  // the current level. Zero when not probing.
+  int probe_frames_left_;
+};
+
+}  // namespace cardboard::unity
+
+#endif  // CARDBOARD_SDK_UNITY_XR_UNITY_PLUGIN_RESOLUTION_GOVERNOR_H_
@@ -377,8 +377,10 @@ class VulkanRenderer : public Renderer {
     }
   }
 
-  void CreateRenderTexture(RenderTexture* render_texture, int screen_width,
-                           int screen_height) override {
+  void CreateRenderTexture(RenderTexture* render_texture, int /*screen_width*/,
+                           int /*screen_height*/, int texture_width,
+                           int texture_height,
+                           bool /*multisampled*/) override {
     VkImageCreateInfo imageInfo = {
         .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
         .flags = VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT,
@@ -386,8 +388,8 @@ class VulkanRenderer : public Renderer {
         .format = VK_FORMAT_R8G8B8A8_SRGB,
         .extent =
             {
-                .width = static_cast<uint32_t>(screen_width / 2),
-                .height = static_cast<uint32_t>(screen_height),
+                .width = static_cast<uint32_t>(texture_width),
+                .height = static_cast<uint32_t>(texture_height),
                 .depth = 1,
             },
         .mipLevels = 1,
@@ -461,6 +463,15 @@ class VulkanRenderer : public Renderer {
         right_eye);
   }
 
+  void ReleaseEyeTextureSlot(int /*slot*/) override {
+    // Nothing to do. The eye image layout transitions are pipeline barriers
+    // which order the accesses of Unity and the distortion pass.
+  }
+
+  void AcquireEyeTextureSlot(int /*slot*/) override {
+    // Nothing to do.
+  }
+
   void RunRenderingPreProcessing(const ScreenParams& screen_params) override {
     if (!VkSwapchainCache::IsCacheUpToDate(swapchain_version_)) {
       return;
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "util/clock.h"
+
+#include <time.h>
+
+namespace cardboard {
+
+namespace {
+
+constexpr int64_t kNanosInSeconds = 1000000000;
+
+}  // namespace
+
+int64_t GetBootTimeNano() {
+  struct timespec res;
+#if defined(__ANDROID__)
+  clock_gettime(CLOCK_BOOTTIME, &res);
+#elif defined(__APPLE__)
+  clock_gettime(CLOCK_UPTIME_RAW, &res);
+#else
+  clock_gettime(CLOCK_MONOTONIC, &res);
+#endif
+  return (res.tv_sec * kNanosInSeconds) + res.tv_nsec;
+}
+
+}  // namespace cardboard
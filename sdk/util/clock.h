@@ -0,0 +1,31 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_UTIL_CLOCK_H_
+#define CARDBOARD_SDK_UTIL_CLOCK_H_
+
+#include <cstdint>
+
+namespace cardboard {
+
+// Returns the current time in nanoseconds in the clock used to timestamp the
+// sensor events, and therefore the one HeadTracker::GetPose() expects:
+// CLOCK_BOOTTIME on Android and CLOCK_UPTIME_RAW on iOS. Other platforms use
+// CLOCK_MONOTONIC.
+int64_t GetBootTimeNano();
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_UTIL_CLOCK_H_
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "util/reprojection.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "util/matrix_3x3.h"
+#include "util/matrixutils.h"
+
+namespace cardboard {
+
+namespace {
+
+// Smallest homogeneous coordinate accepted before considering that a point
+// falls behind the eye.
+constexpr float kMinHomogeneousCoordinate = 1e-6f;
+
+Rotation RotationFromOrientation(const std::array<float, 4>& orientation) {
+  return Rotation::FromQuaternion(Rotation::QuaternionType(
+      orientation[0], orientation[1], orientation[2], orientation[3]));
+}
+
+}  // namespace
+
+std::array<float, 9> ComputeRotationalReprojection(
+    const Rotation& render_from_display, const std::array<float, 4>& fov) {
+  const double tan_left = std::tan(fov[0]);
+  const double tan_bottom = std::tan(fov[2]);
+  const double width = tan_left + std::tan(fov[1]);
+  const double height = tan_bottom + std::tan(fov[3]);
+
+  // Maps a homogeneous texture coordinate into a ray in the eye frame, looking
+  // down the -z axis.
+  const Matrix3x3 ray_from_uv(width, 0, -tan_left,    //
+                              0, height, -tan_bottom,  //
+                              0, 0, -1);
+  // Maps a ray in the eye frame into a homogeneous texture coordinate.
+  const Matrix3x3 uv_from_ray(1.0 / width, 0, -tan_left / width,      //
+                              0, 1.0 / height, -tan_bottom / height,  //
+                              0, 0, -1);
+
+  const Matrix3x3 transform =
+      uv_from_ray * RotationMatrixNH(render_from_display) * ray_from_uv;
+
+  std::array<float, 9> column_major;
+  for (int col = 0; col < 3; ++col) {
+    for (int row = 0; row < 3; ++row) {
+      column_major[col * 3 + row] = static_cast<float>(transform(row, col));
+    }
+  }
+  return column_major;
+}
+
+std::array<float, 9> ComputeRotationalReprojection(
+    const std::array<float, 4>& render_orientation,
+    const std::array<float, 4>& display_orientation,
+    const std::array<float, 4>& fov) {
+  // Head tracker orientations rotate world coordinates into head coordinates.
+  const Rotation render_from_world =
+      RotationFromOrientation(render_orientation);
+  const Rotation display_from_world =
+      RotationFromOrientation(display_orientation);
+  return ComputeRotationalReprojection(render_from_world * -display_from_world,
+                                       fov);
+}
+
+float ComputeReprojectionAngle(
+    const std::array<float, 4>& render_orientation,
+    const std::array<float, 4>& display_orientation) {
+  double dot = 0.0;
+  double render_norm = 0.0;
+  double display_norm = 0.0;
+  for (int i = 0; i < 4; ++i) {
+    dot += static_cast<double>(render_orientation[i]) * display_orientation[i];
+    render_norm +=
+        static_cast<double>(render_orientation[i]) * render_orientation[i];
+    display_norm +=
+        static_cast<double>(display_orientation[i]) * display_orientation[i];
+  }
+  if (render_norm == 0.0 || display_norm == 0.0) {
+    return 0.0f;
+  }
+  // q and -q are the same rotation, hence the absolute value. Rounding may
+  // push the cosine slightly above one.
+  const double cos_half_angle = std::min(
+      1.0, std::abs(dot) / std::sqrt(render_norm * display_norm));
+  return static_cast<float>(2.0 * std::acos(cos_half_angle));
+}
+
+std::array<float, 2> ApplyReprojection(const std::array<float, 9>& transform,
+                                       const std::array<float, 2>& uv) {
+  const float x = transform[0] * uv[0] + transform[3] * uv[1] + transform[6];
+  const float y = transform[1] * uv[0] + transform[4] * uv[1] + transform[7];
+  const float w = transform[2] * uv[0] + transform[5] * uv[1] + transform[8];
+  if (w < kMinHomogeneousCoordinate) {
+    return uv;
+  }
+  return {x / w, y / w};
+}
+
+std::array<float, 9> IdentityReprojection() {
+  return {1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+}
+
+}  // namespace cardboard
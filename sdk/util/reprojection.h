@@ -0,0 +1,76 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_UTIL_REPROJECTION_H_
+#define CARDBOARD_SDK_UTIL_REPROJECTION_H_
+
+#include <array>
+
+#include "util/rotation.h"
+
+namespace cardboard {
+
+// Computes the homogeneous transformation that maps eye texture coordinates
+// seen from the display pose into eye texture coordinates of the texture that
+// was rendered with the render pose. It is the standard rotational timewarp:
+// only the orientation difference between both poses is compensated.
+//
+// Texture coordinates are in [0, 1] and span the eye field of view, i.e. u = 0
+// maps to -tan(fov[0]) and v = 0 maps to -tan(fov[2]). Given a texture
+// coordinate (u, v) and the returned matrix M, the sampled coordinate is
+// (p.x / p.z, p.y / p.z) where p = M * (u, v, 1).
+//
+// @param render_from_display Rotation from the display head frame to the
+//        render head frame. When poses are expressed as head-from-world
+//        rotations (as returned by HeadTracker::GetPose()), it is
+//        render_pose * -display_pose.
+// @param fov Eye field of view half angles [left, right, bottom, top] in
+//        radians.
+// @return A 3x3 matrix stored in column-major order.
+std::array<float, 9> ComputeRotationalReprojection(
+    const Rotation& render_from_display, const std::array<float, 4>& fov);
+
+// Same as above, with the head orientations the eye texture was rendered and
+// is displayed with. Orientations are quaternions as returned by
+// HeadTracker::GetPose().
+std::array<float, 9> ComputeRotationalReprojection(
+    const std::array<float, 4>& render_orientation,
+    const std::array<float, 4>& display_orientation,
+    const std::array<float, 4>& fov);
+
+// Returns the angle, in radians and in [0, pi], of the head rotation between
+// two orientations. It bounds how far the reprojection moves the eye texture
+// contents, so it tells when an eye texture is too stale to be reused.
+// Orientations are quaternions as returned by HeadTracker::GetPose(); they do
+// not need to be normalized.
+float ComputeReprojectionAngle(const std::array<float, 4>& render_orientation,
+                               const std::array<float, 4>& display_orientation);
+
+// Applies a transformation computed by ComputeRotationalReprojection() to a
+// texture coordinate.
+//
+// @param transform A 3x3 matrix stored in column-major order.
+// @param uv Texture coordinate to transform.
+// @return The transformed texture coordinate. When the point falls behind the
+//         render eye, @p uv is returned unchanged.
+std::array<float, 2> ApplyReprojection(const std::array<float, 9>& transform,
+                                       const std::array<float, 2>& uv);
+
+// Returns the identity reprojection.
+std::array<float, 9> IdentityReprojection();
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_UTIL_REPROJECTION_H_
@@ -0,0 +1,192 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "util/stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cardboard::util {
+
+namespace {
+
+constexpr float kNanosToMicros = 1e-3f;
+constexpr float kMicrosToHertz = 1e6f;
+
+// Fills the sample rate and jitter of a sensor from its sample intervals.
+void GetSampleRate(const CardboardStatsLatency& interval, float* rate_hz,
+                   float* jitter_us) {
+  *rate_hz = interval.p50_us > 0.f ? kMicrosToHertz / interval.p50_us : 0.f;
+  *jitter_us = interval.p99_us - interval.p50_us;
+}
+
+}  // anonymous namespace
+
+LatencyHistogram::LatencyHistogram() { Reset(); }
+
+void LatencyHistogram::Record(int64_t duration_ns) {
+  duration_ns = std::max<int64_t>(duration_ns, 0);
+  buckets_[GetBucketIndex(duration_ns)].fetch_add(1, std::memory_order_relaxed);
+
+  int64_t max_duration_ns = max_duration_ns_.load(std::memory_order_relaxed);
+  while (duration_ns > max_duration_ns &&
+         !max_duration_ns_.compare_exchange_weak(max_duration_ns, duration_ns,
+                                                 std::memory_order_relaxed)) {
+  }
+}
+
+void LatencyHistogram::Reset() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  max_duration_ns_.store(0, std::memory_order_relaxed);
+}
+
+CardboardStatsLatency LatencyHistogram::Get() const {
+  std::array<uint32_t, kBucketCount> buckets;
+  for (int i = 0; i < kBucketCount; ++i) {
+    buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+  }
+  return GetLatency(buckets,
+                    max_duration_ns_.load(std::memory_order_relaxed));
+}
+
+CardboardStatsLatency LatencyHistogram::GetAndReset() {
+  // Each bucket is emptied atomically, so no recorded duration is lost. The
+  // maximum may belong to a duration left for the next call.
+  std::array<uint32_t, kBucketCount> buckets;
+  for (int i = 0; i < kBucketCount; ++i) {
+    buckets[i] = buckets_[i].exchange(0, std::memory_order_relaxed);
+  }
+  return GetLatency(buckets,
+                    max_duration_ns_.exchange(0, std::memory_order_relaxed));
+}
+
+CardboardStatsLatency LatencyHistogram::GetLatency(
+    const std::array<uint32_t, kBucketCount>& buckets,
+    int64_t max_duration_ns) {
+  int64_t count = 0;
+  for (uint32_t bucket_count : buckets) {
+    count += bucket_count;
+  }
+
+  CardboardStatsLatency latency{};
+  latency.count = count;
+  latency.max_us = static_cast<float>(max_duration_ns) * kNanosToMicros;
+  if (count == 0) {
+    return latency;
+  }
+
+  const std::array<float, 3> percentiles = {0.5f, 0.9f, 0.99f};
+  std::array<float*, 3> results = {&latency.p50_us, &latency.p90_us,
+                                   &latency.p99_us};
+  int64_t accumulated = 0;
+  int bucket = 0;
+  for (size_t i = 0; i < percentiles.size(); ++i) {
+    const int64_t rank = std::max<int64_t>(
+        1, static_cast<int64_t>(std::ceil(percentiles[i] * count)));
+    while (accumulated + buckets[bucket] < rank) {
+      accumulated += buckets[bucket];
+      ++bucket;
+    }
+    // The midpoint may exceed the largest duration of the last bucket.
+    const int64_t duration_ns =
+        std::min(GetBucketMidpoint(bucket), max_duration_ns);
+    *results[i] = static_cast<float>(duration_ns) * kNanosToMicros;
+  }
+  return latency;
+}
+
+int LatencyHistogram::GetBucketIndex(int64_t duration_ns) {
+  duration_ns = std::min(duration_ns, (int64_t{1} << kMaxExponent) - 1);
+  if (duration_ns < kSubBucketCount) {
+    return static_cast<int>(duration_ns);
+  }
+  const int exponent =
+      63 - __builtin_clzll(static_cast<uint64_t>(duration_ns));
+  const int sub_bucket = static_cast<int>(
+      (duration_ns >> (exponent - kSubBucketBits)) & (kSubBucketCount - 1));
+  return (exponent - kSubBucketBits + 1) * kSubBucketCount + sub_bucket;
+}
+
+int64_t LatencyHistogram::GetBucketMidpoint(int index) {
+  if (index < kSubBucketCount) {
+    return index;
+  }
+  const int shift = index / kSubBucketCount - 1;
+  const int64_t lower_bound =
+      static_cast<int64_t>(kSubBucketCount + index % kSubBucketCount) << shift;
+  return lower_bound + (int64_t{1} << shift) / 2;
+}
+
+std::atomic<bool> Stats::enabled_(false);
+
+void Stats::SetEnabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void Stats::Reset() {
+  gyroscope_interval.Reset();
+  accelerometer_interval.Reset();
+  sensor_fusion_lock_wait.Reset();
+  get_pose.Reset();
+  distortion_pass.Reset();
+  dropped_sample_count.store(0, std::memory_order_relaxed);
+  late_gyroscope_sample_count.store(0, std::memory_order_relaxed);
+}
+
+void Stats::Get(CardboardStats* stats) const {
+  stats->gyroscope_interval = gyroscope_interval.Get();
+  stats->accelerometer_interval = accelerometer_interval.Get();
+  stats->dropped_sample_count =
+      dropped_sample_count.load(std::memory_order_relaxed);
+  stats->late_gyroscope_sample_count =
+      late_gyroscope_sample_count.load(std::memory_order_relaxed);
+  stats->sensor_fusion_lock_wait = sensor_fusion_lock_wait.Get();
+  stats->get_pose = get_pose.Get();
+  stats->distortion_pass = distortion_pass.Get();
+  FillDerivedStats(stats);
+}
+
+void Stats::GetAndReset(CardboardStats* stats) {
+  stats->gyroscope_interval = gyroscope_interval.GetAndReset();
+  stats->accelerometer_interval = accelerometer_interval.GetAndReset();
+  stats->dropped_sample_count =
+      dropped_sample_count.exchange(0, std::memory_order_relaxed);
+  stats->late_gyroscope_sample_count =
+      late_gyroscope_sample_count.exchange(0, std::memory_order_relaxed);
+  stats->sensor_fusion_lock_wait = sensor_fusion_lock_wait.GetAndReset();
+  stats->get_pose = get_pose.GetAndReset();
+  stats->distortion_pass = distortion_pass.GetAndReset();
+  FillDerivedStats(stats);
+}
+
+void Stats::FillDerivedStats(CardboardStats* stats) const {
+  GetSampleRate(stats->gyroscope_interval, &stats->gyroscope_sample_rate_hz,
+                &stats->gyroscope_jitter_us);
+  GetSampleRate(stats->accelerometer_interval,
+                &stats->accelerometer_sample_rate_hz,
+                &stats->accelerometer_jitter_us);
+  // A state, not an accumulated value: it is never reset.
+  stats->gyroscope_bias_converged =
+      gyroscope_bias_converged.load(std::memory_order_relaxed) ? 1 : 0;
+}
+
+Stats& GetStats() {
+  static Stats* stats = new Stats();
+  return *stats;
+}
+
+}  // namespace cardboard::util
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_UTIL_STATS_H_
+#define CARDBOARD_SDK_UTIL_STATS_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "include/cardboard.h"
+#include "util/clock.h"
+
+namespace cardboard::util {
+
+// Histogram of durations with a fixed number of buckets. Each power of two is
+// split in 8 linear buckets, so percentiles have a relative error below 12.5%.
+// Recording only performs relaxed atomic operations: it never blocks nor
+// allocates and may be called concurrently from any thread.
+class LatencyHistogram {
+ public:
+  LatencyHistogram();
+
+  // Records a duration. Negative durations are recorded as zero.
+  void Record(int64_t duration_ns);
+
+  // Clears all the recorded durations.
+  void Reset();
+
+  // Returns the number of recorded durations and their estimated percentiles.
+  CardboardStatsLatency Get() const;
+
+  // Same as Get(), and clears the returned durations. Durations recorded
+  // concurrently are either returned or kept for the next call.
+  CardboardStatsLatency GetAndReset();
+
+ private:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int kSubBucketCount = 1 << kSubBucketBits;
+  // Durations of 2^kMaxExponent ns (about 68 s) or more share the last bucket.
+  static constexpr int kMaxExponent = 36;
+  static constexpr int kBucketCount =
+      (kMaxExponent - kSubBucketBits + 1) * kSubBucketCount;
+
+  static int GetBucketIndex(int64_t duration_ns);
+  static int64_t GetBucketMidpoint(int index);
+  static CardboardStatsLatency GetLatency(
+      const std::array<uint32_t, kBucketCount>& buckets,
+      int64_t max_duration_ns);
+
+  std::array<std::atomic<uint32_t>, kBucketCount> buckets_;
+  std::atomic<int64_t> max_duration_ns_;
+};
+
+// Process wide runtime statistics backing the CardboardStats API. Collection
+// is disabled by default; while disabled, instrumented code only performs a
+// relaxed atomic load.
+class Stats {
+ public:
+  static bool IsEnabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+  static void SetEnabled(bool enabled);
+
+  // Clears all the statistics.
+  void Reset();
+
+  // Fills @p stats with the current statistics.
+  void Get(CardboardStats* stats) const;
+
+  // Same as Get(), and clears the returned statistics, so that the next call
+  // covers the values recorded in between.
+  void GetAndReset(CardboardStats* stats);
+
+  LatencyHistogram gyroscope_interval;
+  LatencyHistogram accelerometer_interval;
+  LatencyHistogram sensor_fusion_lock_wait;
+  LatencyHistogram get_pose;
+  LatencyHistogram distortion_pass;
+  std::atomic<int64_t> dropped_sample_count{0};
+  std::atomic<int64_t> late_gyroscope_sample_count{0};
+  std::atomic<bool> gyroscope_bias_converged{false};
+
+ private:
+  // Fills the values of @p stats derived from the collected ones, and the
+  // gyroscope bias state.
+  void FillDerivedStats(CardboardStats* stats) const;
+
+  static std::atomic<bool> enabled_;
+};
+
+// Returns the process wide statistics.
+Stats& GetStats();
+
+// Records the time spent in its scope to a histogram when statistics are
+// enabled. The clock is not read otherwise.
+class ScopedLatency {
+ public:
+  explicit ScopedLatency(LatencyHistogram* histogram)
+      : histogram_(Stats::IsEnabled() ? histogram : nullptr),
+        start_ns_(histogram_ != nullptr ? GetBootTimeNano() : 0) {}
+  ~ScopedLatency() {
+    if (histogram_ != nullptr) {
+      histogram_->Record(GetBootTimeNano() - start_ns_);
+    }
+  }
+
+  ScopedLatency(const ScopedLatency&) = delete;
+  ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+ private:
+  LatencyHistogram* histogram_;
+  int64_t start_ns_;
+};
+
+}  // namespace cardboard::util
+
+#endif  // CARDBOARD_SDK_UTIL_STATS_H_
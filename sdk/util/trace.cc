@@ -0,0 +1,210 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "util/trace.h"
+
+#ifdef CARDBOARD_ENABLE_TRACING
+
+#include <atomic>
+
+#if defined(__ANDROID__)
+#include <android/trace.h>
+#include <dlfcn.h>
+#elif defined(__APPLE__)
+#include <os/signpost.h>
+#else
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+
+#include "util/clock.h"
+#endif
+
+#include "util/logging.h"
+
+namespace cardboard::util {
+
+namespace {
+
+#if defined(__ANDROID__)
+
+using ATraceSetCounterFunction = void (*)(const char*, int64_t);
+
+// ATrace_setCounter() is only available from API level 29, so it is looked up
+// at runtime rather than linked.
+ATraceSetCounterFunction LoadATraceSetCounter() {
+  void* library = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+  if (library == nullptr) {
+    return nullptr;
+  }
+  return reinterpret_cast<ATraceSetCounterFunction>(
+      dlsym(library, "ATrace_setCounter"));
+}
+
+uint64_t BeginSection(const char* name, void* /*user_data*/) {
+  ATrace_beginSection(name);
+  return 0;
+}
+
+void EndSection(const char* /*name*/, uint64_t /*token*/,
+                void* /*user_data*/) {
+  ATrace_endSection();
+}
+
+void SetCounter(const char* name, int64_t value, void* /*user_data*/) {
+  static const ATraceSetCounterFunction set_counter = LoadATraceSetCounter();
+  if (set_counter != nullptr) {
+    set_counter(name, value);
+  }
+}
+
+#elif defined(__APPLE__)
+
+// Signpost names must be string literals, so every span shares the same name
+// and carries the actual one in its message.
+os_log_t GetSignpostLog() {
+  static const os_log_t log = os_log_create(
+      "com.google.cardboard.sdk", OS_LOG_CATEGORY_POINTS_OF_INTEREST);
+  return log;
+}
+
+uint64_t BeginSection(const char* name, void* /*user_data*/) {
+  const os_signpost_id_t id = os_signpost_id_generate(GetSignpostLog());
+  os_signpost_interval_begin(GetSignpostLog(), id, "CardboardTrace",
+                             "%{public}s", name);
+  return id;
+}
+
+void EndSection(const char* name, uint64_t token, void* /*user_data*/) {
+  os_signpost_interval_end(GetSignpostLog(), token, "CardboardTrace",
+                           "%{public}s", name);
+}
+
+void SetCounter(const char* name, int64_t value, void* /*user_data*/) {
+  os_signpost_event_emit(GetSignpostLog(), OS_SIGNPOST_ID_EXCLUSIVE,
+                         "CardboardCounter", "%{public}s: %lld", name,
+                         static_cast<long long>(value));
+}
+
+#else
+
+// Writes trace events in the Chrome JSON array format. The array is never
+// closed, which trace viewers accept, so the file stays readable when the
+// process does not exit cleanly.
+class ChromeTraceFile {
+ public:
+  static ChromeTraceFile& Get() {
+    static ChromeTraceFile* trace_file = new ChromeTraceFile();
+    return *trace_file;
+  }
+
+  void WriteSectionEvent(char phase, const char* name) {
+    if (file_ == nullptr) {
+      return;
+    }
+    const double timestamp_us = GetTimestampMicros();
+    const int thread_id = GetThreadId();
+    std::lock_guard<std::mutex> lock(mutex_);
+    fprintf(file_,
+            "{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,"
+            "\"tid\":%d},\n",
+            name, phase, timestamp_us, process_id_, thread_id);
+    fflush(file_);
+  }
+
+  void WriteCounterEvent(const char* name, int64_t value) {
+    if (file_ == nullptr) {
+      return;
+    }
+    const double timestamp_us = GetTimestampMicros();
+    std::lock_guard<std::mutex> lock(mutex_);
+    fprintf(file_,
+            "{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%d,"
+            "\"args\":{\"value\":%lld}},\n",
+            name, timestamp_us, process_id_, static_cast<long long>(value));
+    fflush(file_);
+  }
+
+ private:
+  ChromeTraceFile() : file_(nullptr), process_id_(getpid()) {
+    const char* path = getenv("CARDBOARD_TRACE_FILE");
+    if (path == nullptr || path[0] == '\0') {
+      return;
+    }
+    file_ = fopen(path, "w");
+    if (file_ == nullptr) {
+      CARDBOARD_LOGE("Cannot open trace file %s.\n", path);
+      return;
+    }
+    fputs("[\n", file_);
+  }
+
+  static double GetTimestampMicros() {
+    return static_cast<double>(GetBootTimeNano()) / 1000.0;
+  }
+
+  // Small sequential ids are easier to read than the native thread ids.
+  static int GetThreadId() {
+    static std::atomic<int> next_thread_id(1);
+    thread_local const int thread_id = next_thread_id++;
+    return thread_id;
+  }
+
+  std::mutex mutex_;
+  FILE* file_;
+  const int process_id_;
+};
+
+uint64_t BeginSection(const char* name, void* /*user_data*/) {
+  ChromeTraceFile::Get().WriteSectionEvent('B', name);
+  return 0;
+}
+
+void EndSection(const char* name, uint64_t /*token*/, void* /*user_data*/) {
+  ChromeTraceFile::Get().WriteSectionEvent('E', name);
+}
+
+void SetCounter(const char* name, int64_t value, void* /*user_data*/) {
+  ChromeTraceFile::Get().WriteCounterEvent(name, value);
+}
+
+#endif
+
+constexpr TraceSink kPlatformTraceSink = {BeginSection, EndSection,
+                                          SetCounter, nullptr};
+
+std::atomic<const TraceSink*> trace_sink(&kPlatformTraceSink);
+
+}  // anonymous namespace
+
+void SetTraceSink(const TraceSink* sink) {
+  trace_sink.store(sink != nullptr ? sink : &kPlatformTraceSink,
+                   std::memory_order_release);
+}
+
+const TraceSink* GetTraceSink() {
+  return trace_sink.load(std::memory_order_acquire);
+}
+
+void TraceCounter(const char* name, int64_t value) {
+  const TraceSink* sink = GetTraceSink();
+  sink->set_counter(name, value, sink->user_data);
+}
+
+}  // namespace cardboard::util
+
+#endif  // CARDBOARD_ENABLE_TRACING
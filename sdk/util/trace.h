@@ -0,0 +1,102 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_UTIL_TRACE_H_
+#define CARDBOARD_SDK_UTIL_TRACE_H_
+
+#include <cstdint>
+
+/// @def CARDBOARD_TRACE_SCOPE(name)
+/// Traces the enclosing scope as a span named @p name. @p name must be a string
+/// literal that needs no JSON escaping.
+///
+/// @def CARDBOARD_TRACE_COUNTER(name, value)
+/// Records @p value as the current value of the counter named @p name. @p name
+/// follows the same rules as in CARDBOARD_TRACE_SCOPE().
+///
+/// Both macros expand to nothing unless CARDBOARD_ENABLE_TRACING is defined,
+/// so instrumented code has no cost in regular builds.
+
+#ifdef CARDBOARD_ENABLE_TRACING
+
+#define CARDBOARD_TRACE_CONCAT_INNER(a, b) a##b
+#define CARDBOARD_TRACE_CONCAT(a, b) CARDBOARD_TRACE_CONCAT_INNER(a, b)
+
+#define CARDBOARD_TRACE_SCOPE(name)            \
+  const cardboard::util::ScopedTrace           \
+  CARDBOARD_TRACE_CONCAT(cardboard_trace_scope_, __LINE__)(name)
+
+#define CARDBOARD_TRACE_COUNTER(name, value) \
+  cardboard::util::TraceCounter(name, static_cast<int64_t>(value))
+
+namespace cardboard::util {
+
+/// Destination of trace events. By default, events are forwarded to ATrace on
+/// Android, to os_signpost on iOS and, on other platforms, to a Chrome trace
+/// JSON file named by the CARDBOARD_TRACE_FILE environment variable.
+struct TraceSink {
+  /// Begins a span on the calling thread. The returned token is passed back to
+  /// @c end_section.
+  uint64_t (*begin_section)(const char* name, void* user_data);
+  /// Ends the span begun on the calling thread that returned @p token.
+  void (*end_section)(const char* name, uint64_t token, void* user_data);
+  /// Records the current value of a counter.
+  void (*set_counter)(const char* name, int64_t value, void* user_data);
+  /// Opaque pointer passed back to the callbacks.
+  void* user_data;
+};
+
+/// Replaces the platform sink by @p sink.
+///
+/// @details Spans are ended on the sink they were begun on, so @p sink must
+///          remain valid until the process exits.
+/// @param[in]      sink                    Sink to use. nullptr restores the
+///                                         platform sink.
+void SetTraceSink(const TraceSink* sink);
+
+/// Returns the sink trace events are currently sent to.
+const TraceSink* GetTraceSink();
+
+/// Records @p value as the current value of the counter named @p name.
+void TraceCounter(const char* name, int64_t value);
+
+/// Traces a span from construction to destruction.
+class ScopedTrace {
+ public:
+  explicit ScopedTrace(const char* name)
+      : name_(name),
+        sink_(GetTraceSink()),
+        token_(sink_->begin_section(name, sink_->user_data)) {}
+  ~ScopedTrace() { sink_->end_section(name_, token_, sink_->user_data); }
+
+  ScopedTrace(const ScopedTrace&) = delete;
+  ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+ private:
+  const char* name_;
+  const TraceSink* sink_;
+  uint64_t token_;
+};
+
+}  // namespace cardboard::util
+
+#else
+
+#define CARDBOARD_TRACE_SCOPE(name)
+#define CARDBOARD_TRACE_COUNTER(name, value)
+
+#endif  // CARDBOARD_ENABLE_TRACING
+
+#endif  // CARDBOARD_SDK_UTIL_TRACE_H_
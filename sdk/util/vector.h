@@ -43,7 +43,7 @@ class Vector {
   double& operator[](int index) { return elem_[index]; }
 
   // Element accessor.
-  double operator[](int index) const { return elem_[index]; }
+  constexpr double operator[](int index) const { return elem_[index]; }
 
   // Returns a Vector containing all zeroes.
   static Vector Zero();
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "util/vignette.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace cardboard {
+
+namespace {
+
+constexpr std::array<float, 4> kEmptyBounds = {0.f, 0.f, 0.f, 0.f};
+
+bool IsEmpty(const PixelRect& rect) {
+  return rect.width <= 0 || rect.height <= 0;
+}
+
+// Returns the pixels of @p eye_rect within @p covered_bounds when they are
+// mapped to @p viewport.
+PixelRect GetCoveredRect(const std::array<float, 4>& covered_bounds,
+                         const PixelRect& viewport, const PixelRect& eye_rect) {
+  // Maps normalized device coordinates to pixels, rounding towards the inside
+  // of the covered bounds.
+  const float half_width = 0.5f * static_cast<float>(viewport.width);
+  const float half_height = 0.5f * static_cast<float>(viewport.height);
+  const int left = viewport.x + static_cast<int>(std::ceil(
+                                    (covered_bounds[0] + 1.f) * half_width));
+  const int bottom = viewport.y + static_cast<int>(std::ceil(
+                                      (covered_bounds[1] + 1.f) * half_height));
+  const int right = viewport.x + static_cast<int>(std::floor(
+                                     (covered_bounds[2] + 1.f) * half_width));
+  const int top = viewport.y + static_cast<int>(std::floor(
+                                   (covered_bounds[3] + 1.f) * half_height));
+
+  const int x = std::max(left, eye_rect.x);
+  const int y = std::max(bottom, eye_rect.y);
+  const int width = std::min(right, eye_rect.x + eye_rect.width) - x;
+  const int height = std::min(top, eye_rect.y + eye_rect.height) - y;
+  if (width <= 0 || height <= 0) {
+    return {0, 0, 0, 0};
+  }
+  return {x, y, width, height};
+}
+
+// Splits the pixels of @p eye_rect outside of @p covered_rect, which is empty
+// or lies within @p eye_rect, in up to 4 rectangles appended to
+// @p vignette_rects from @p count. Returns the new number of rectangles.
+int AppendVignetteRects(
+    const PixelRect& eye_rect, const PixelRect& covered_rect, int count,
+    std::array<PixelRect, kMaxVignetteRectCount>* vignette_rects) {
+  if (IsEmpty(eye_rect)) {
+    return count;
+  }
+  if (IsEmpty(covered_rect)) {
+    (*vignette_rects)[count++] = eye_rect;
+    return count;
+  }
+
+  // Bottom and top bands span the whole eye width, left and right bands the
+  // covered height.
+  const std::array<PixelRect, 4> bands = {{
+      {eye_rect.x, eye_rect.y, eye_rect.width, covered_rect.y - eye_rect.y},
+      {eye_rect.x, covered_rect.y + covered_rect.height, eye_rect.width,
+       eye_rect.y + eye_rect.height - covered_rect.y - covered_rect.height},
+      {eye_rect.x, covered_rect.y, covered_rect.x - eye_rect.x,
+       covered_rect.height},
+      {covered_rect.x + covered_rect.width, covered_rect.y,
+       eye_rect.x + eye_rect.width - covered_rect.x - covered_rect.width,
+       covered_rect.height},
+  }};
+  for (const PixelRect& band : bands) {
+    if (!IsEmpty(band)) {
+      (*vignette_rects)[count++] = band;
+    }
+  }
+  return count;
+}
+
+}  // anonymous namespace
+
+std::array<float, 4> GetMeshCoveredBounds(const CardboardMesh& mesh) {
+  const int resolution =
+      static_cast<int>(std::lround(std::sqrt(std::max(mesh.n_vertices, 0))));
+  if (mesh.vertices == nullptr || resolution < 2 ||
+      resolution * resolution != mesh.n_vertices) {
+    return kEmptyBounds;
+  }
+
+  // Returns the coordinate @p component of the vertex at @p row and @p col.
+  auto vertex = [&mesh, resolution](int row, int col, int component) {
+    return mesh.vertices[(row * resolution + col) * 2 + component];
+  };
+
+  constexpr float kMax = std::numeric_limits<float>::max();
+  std::array<float, 4> bounds = {-kMax, -kMax, kMax, kMax};
+  for (int i = 0; i < resolution; ++i) {
+    bounds[0] = std::max(bounds[0], vertex(i, 0, 0));
+    bounds[1] = std::max(bounds[1], vertex(0, i, 1));
+    bounds[2] = std::min(bounds[2], vertex(i, resolution - 1, 0));
+    bounds[3] = std::min(bounds[3], vertex(resolution - 1, i, 1));
+  }
+  if (bounds[0] >= bounds[2] || bounds[1] >= bounds[3]) {
+    return kEmptyBounds;
+  }
+  return bounds;
+}
+
+int GetVignetteRects(
+    const std::array<std::array<float, 4>, 2>& covered_bounds,
+    const PixelRect& viewport,
+    std::array<PixelRect, kMaxVignetteRectCount>* vignette_rects) {
+  // Matches the scissor rectangles of the distortion renderers.
+  const int half_width = viewport.width / 2;
+  const std::array<PixelRect, 2> scissor_rects = {{
+      {viewport.x, viewport.y, half_width, viewport.height},
+      {viewport.x + half_width, viewport.y, half_width, viewport.height},
+  }};
+  int count = 0;
+  for (int eye = 0; eye < 2; ++eye) {
+    PixelRect eye_rect = scissor_rects[eye];
+    // The last column of odd widths is not rendered to by any mesh.
+    if (eye == 1) {
+      eye_rect.width = viewport.width - half_width;
+    }
+    count = AppendVignetteRects(
+        eye_rect,
+        GetCoveredRect(covered_bounds[eye], viewport, scissor_rects[eye]),
+        count, vignette_rects);
+  }
+  return count;
+}
+
+}  // namespace cardboard
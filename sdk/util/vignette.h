@@ -0,0 +1,61 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_UTIL_VIGNETTE_H_
+#define CARDBOARD_SDK_UTIL_VIGNETTE_H_
+
+#include <array>
+
+#include "include/cardboard.h"
+
+namespace cardboard {
+
+// Rectangle in pixels. (x, y) is its lower left corner.
+struct PixelRect {
+  int x;
+  int y;
+  int width;
+  int height;
+};
+
+// Returns the bounds [left, bottom, right, top], in normalized device
+// coordinates, of an axis aligned rectangle that is entirely covered by a
+// distortion mesh. The mesh must be a square grid of vertices in row-major
+// order whose first row is the bottom one and whose first column is the left
+// one, as built by DistortionMesh. The rectangle is bounded by the innermost
+// vertex of each boundary row and column, which assumes that the boundary does
+// not fold back on itself as is the case for radial distortions. Empty bounds
+// are returned for any other mesh.
+std::array<float, 4> GetMeshCoveredBounds(const CardboardMesh& mesh);
+
+// Maximum number of rectangles returned by GetVignetteRects().
+constexpr int kMaxVignetteRectCount = 8;
+
+// Splits the pixels of @p viewport that are not covered by the distortion
+// meshes, i.e. the vignette, in non overlapping rectangles and returns their
+// number. The left eye mesh is rendered to the left half of @p viewport and the
+// right eye mesh to the other half, both stretched over the whole viewport.
+// Partially covered pixels belong to the vignette.
+//
+// @param covered_bounds Bounds returned by GetMeshCoveredBounds() for the left
+//        and right eye meshes.
+int GetVignetteRects(
+    const std::array<std::array<float, 4>, 2>& covered_bounds,
+    const PixelRect& viewport,
+    std::array<PixelRect, kMaxVignetteRectCount>* vignette_rects);
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_UTIL_VIGNETTE_H_
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "util/worker_pool.h"
+
+#include <algorithm>
+
+namespace cardboard::util {
+
+WorkerPool::WorkerPool(int worker_count) {
+  for (int worker = 1; worker < std::max(worker_count, 1); ++worker) {
+    threads_.emplace_back(&WorkerPool::WorkerLoop, this, worker);
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  job_condition_.notify_all();
+  for (std::thread& thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkerPool::Run(int task_count, const Task& task) {
+  // Waking the threads costs more than running a single task.
+  if (threads_.empty() || task_count <= 1) {
+    for (int i = 0; i < task_count; ++i) {
+      task(i, 0);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    task_count_ = task_count;
+    busy_thread_count_ = static_cast<int>(threads_.size());
+    next_task_.store(0, std::memory_order_relaxed);
+    ++job_id_;
+  }
+  job_condition_.notify_all();
+  RunTasks(task, task_count, /*worker=*/0);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_condition_.wait(lock, [this] { return busy_thread_count_ == 0; });
+  task_ = nullptr;
+}
+
+void WorkerPool::WorkerLoop(int worker) {
+  uint64_t last_job_id = 0;
+  while (true) {
+    const Task* task;
+    int task_count;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      job_condition_.wait(
+          lock, [&] { return is_stopping_ || job_id_ != last_job_id; });
+      if (is_stopping_) {
+        return;
+      }
+      last_job_id = job_id_;
+      task = task_;
+      task_count = task_count_;
+    }
+
+    RunTasks(*task, task_count, worker);
+
+    bool is_last_thread;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      is_last_thread = --busy_thread_count_ == 0;
+    }
+    if (is_last_thread) {
+      done_condition_.notify_one();
+    }
+  }
+}
+
+void WorkerPool::RunTasks(const Task& task, int task_count, int worker) {
+  for (int i = next_task_.fetch_add(1, std::memory_order_relaxed);
+       i < task_count; i = next_task_.fetch_add(1, std::memory_order_relaxed)) {
+    task(i, worker);
+  }
+}
+
+}  // namespace cardboard::util
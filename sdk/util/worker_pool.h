@@ -0,0 +1,78 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_UTIL_WORKER_POOL_H_
+#define CARDBOARD_SDK_UTIL_WORKER_POOL_H_
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <functional>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace cardboard::util {
+
+// Fixed set of threads running the tasks of one job at a time. The threads
+// are started once, by the constructor, and wait on a condition variable
+// between jobs, so running a job does not create any thread.
+class WorkerPool {
+ public:
+  // Task of a job: called with the index of the task, in [0, task_count),
+  // and the index of the worker running it, in [0, worker_count()).
+  using Task = std::function<void(int task, int worker)>;
+
+  // Creates a pool of @p worker_count workers, clamped to at least one. The
+  // thread calling Run() is worker 0, so worker_count - 1 threads are
+  // started.
+  explicit WorkerPool(int worker_count);
+
+  // Stops and joins the threads.
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  int worker_count() const { return static_cast<int>(threads_.size()) + 1; }
+
+  // Calls @p task once with each index in [0, task_count), spread across the
+  // workers, and returns when all the calls returned. Must not be called
+  // concurrently nor from a task.
+  void Run(int task_count, const Task& task);
+
+ private:
+  void WorkerLoop(int worker);
+  void RunTasks(const Task& task, int task_count, int worker);
+
+  std::mutex mutex_;
+  // Signaled when a job starts or the pool stops.
+  std::condition_variable job_condition_;
+  // Signaled when the last thread finishes its share of a job.
+  std::condition_variable done_condition_;
+  // @{ Current job, guarded by mutex_.
+  uint64_t job_id_ = 0;
+  const Task* task_ = nullptr;
+  int task_count_ = 0;
+  int busy_thread_count_ = 0;
+  bool is_stopping_ = false;
+  // @}
+  std::atomic<int> next_task_{0};
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace cardboard::util
+
+#endif  // CARDBOARD_SDK_UTIL_WORKER_POOL_H_